@@ -15,14 +15,17 @@
 #include "open_spiel/algorithms/alpha_zero/alpha_zero.h"
 
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <random>
 #include <string>
 #include <vector>
 
 #include "open_spiel/abseil-cpp/absl/algorithm/container.h"
 #include "open_spiel/abseil-cpp/absl/random/uniform_real_distribution.h"
+#include "open_spiel/abseil-cpp/absl/strings/match.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_join.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_split.h"
@@ -30,6 +33,10 @@
 #include "open_spiel/abseil-cpp/absl/time/clock.h"
 #include "open_spiel/abseil-cpp/absl/time/time.h"
 #include "open_spiel/algorithms/alpha_zero/device_manager.h"
+#include "open_spiel/algorithms/alpha_zero/native_vpnet.h"
+#include "open_spiel/algorithms/alpha_zero/parameter_store.h"
+#include "open_spiel/algorithms/alpha_zero/replay_buffer.h"
+#include "open_spiel/algorithms/alpha_zero/shared_memory.h"
 #include "open_spiel/algorithms/alpha_zero/vpevaluator.h"
 #include "open_spiel/algorithms/alpha_zero/vpnet.h"
 #include "open_spiel/algorithms/mcts.h"
@@ -61,6 +68,80 @@ struct Trajectory {
   std::vector<double> returns;
 };
 
+// Trajectories from actor processes arrive in this binary format. Observations
+// are sent as floats, as that's how the replay buffer stores them anyway.
+template <typename T>
+void AppendRaw(const T& value, std::string* out) {
+  out->append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T ReadRaw(absl::string_view in, int64_t* pos) {
+  SPIEL_CHECK_LE(*pos + sizeof(T), in.size());
+  T value;
+  std::memcpy(&value, in.data() + *pos, sizeof(T));
+  *pos += sizeof(T);
+  return value;
+}
+
+std::string EncodeTrajectory(const Trajectory& trajectory) {
+  std::string out;
+  AppendRaw<uint32_t>(trajectory.returns.size(), &out);
+  for (double r : trajectory.returns) AppendRaw(r, &out);
+  AppendRaw<uint32_t>(trajectory.states.size(), &out);
+  for (const Trajectory::State& state : trajectory.states) {
+    AppendRaw<int32_t>(state.current_player, &out);
+    AppendRaw<int64_t>(state.action, &out);
+    AppendRaw(state.value, &out);
+    AppendRaw<uint32_t>(state.observation.size(), &out);
+    for (double o : state.observation) AppendRaw<float>(o, &out);
+    AppendRaw<uint32_t>(state.legal_actions.size(), &out);
+    for (Action a : state.legal_actions) AppendRaw<int64_t>(a, &out);
+    AppendRaw<uint32_t>(state.policy.size(), &out);
+    for (const auto& [action, prob] : state.policy) {
+      AppendRaw<int64_t>(action, &out);
+      AppendRaw(prob, &out);
+    }
+  }
+  return out;
+}
+
+Trajectory DecodeTrajectory(absl::string_view in) {
+  int64_t pos = 0;
+  Trajectory trajectory;
+  trajectory.returns.resize(ReadRaw<uint32_t>(in, &pos));
+  for (double& r : trajectory.returns) r = ReadRaw<double>(in, &pos);
+  trajectory.states.resize(ReadRaw<uint32_t>(in, &pos));
+  for (Trajectory::State& state : trajectory.states) {
+    state.current_player = ReadRaw<int32_t>(in, &pos);
+    state.action = ReadRaw<int64_t>(in, &pos);
+    state.value = ReadRaw<double>(in, &pos);
+    state.observation.resize(ReadRaw<uint32_t>(in, &pos));
+    for (double& o : state.observation) o = ReadRaw<float>(in, &pos);
+    state.legal_actions.resize(ReadRaw<uint32_t>(in, &pos));
+    for (Action& a : state.legal_actions) a = ReadRaw<int64_t>(in, &pos);
+    state.policy.resize(ReadRaw<uint32_t>(in, &pos));
+    for (auto& [action, prob] : state.policy) {
+      action = ReadRaw<int64_t>(in, &pos);
+      prob = ReadRaw<double>(in, &pos);
+    }
+  }
+  SPIEL_CHECK_EQ(pos, in.size());
+  return trajectory;
+}
+
+// Where an actor process and the learner exchange data. The ring is big
+// enough for several long games, and tmpfs only backs the pages in use.
+constexpr int64_t kActorProcessRingBytes = int64_t{1} << 26;
+
+std::string ActorProcessRingPath(const AlphaZeroConfig& config, int num) {
+  return absl::StrCat(config.path, "/actor-process-", num, ".ring");
+}
+
+std::string SharedWeightsPath(const AlphaZeroConfig& config) {
+  return absl::StrCat(config.path, "/weights.shm");
+}
+
 Trajectory PlayGame(
     Logger* logger,
     int game_num,
@@ -138,10 +219,10 @@ std::unique_ptr<MCTSBot> InitAZBot(
 void actor(const open_spiel::Game& game, const AlphaZeroConfig& config, int num,
            ThreadedQueue<Trajectory>* trajectory_queue,
            std::shared_ptr<VPNetEvaluator> vp_eval,
-           StopToken* stop) {
+           StopToken* stop, const std::string& name = "actor") {
   std::unique_ptr<Logger> logger;
   if (num < 20) {  // Limit the number of open files.
-    logger.reset(new FileLogger(config.path, absl::StrCat("actor-", num)));
+    logger.reset(new FileLogger(config.path, absl::StrCat(name, "-", num)));
   } else {
     logger.reset(new NoopLogger());
   }
@@ -218,6 +299,9 @@ void evaluator(const open_spiel::Game& game, const AlphaZeroConfig& config,
   FileLogger logger(config.path, absl::StrCat("evaluator-", num));
   std::mt19937 rng;
   auto rand_evaluator = std::make_shared<RandomRolloutEvaluator>(1, num);
+  // Evaluation games are few and each waits on its own inference, so let them
+  // skip ahead of the actors.
+  auto az_evaluator = std::make_shared<HighPriorityVPNetEvaluator>(vp_eval);
 
   for (int game_num = 1; !stop->StopRequested(); ++game_num) {
     auto [difficulty, first] = results->Next();
@@ -226,7 +310,7 @@ void evaluator(const open_spiel::Game& game, const AlphaZeroConfig& config,
         10, difficulty / 2.0);
     std::vector<std::unique_ptr<MCTSBot>> bots;
     bots.reserve(2);
-    bots.push_back(InitAZBot(config, game, vp_eval, true));
+    bots.push_back(InitAZBot(config, game, az_evaluator, true));
     bots.push_back(std::make_unique<MCTSBot>(
             game,
             rand_evaluator,
@@ -255,6 +339,75 @@ void evaluator(const open_spiel::Game& game, const AlphaZeroConfig& config,
   logger.Print("Got a quit.");
 }
 
+// Moves trajectories from the actor processes to the learner's queue.
+void collector(const AlphaZeroConfig& config,
+               ThreadedQueue<Trajectory>* trajectory_queue, StopToken* stop) {
+  FileLogger logger(config.path, "collector");
+  std::vector<std::unique_ptr<SharedRing>> rings;
+  for (int i = 0; i < config.actor_processes; ++i) {
+    rings.push_back(std::make_unique<SharedRing>(
+        ActorProcessRingPath(config, i), kActorProcessRingBytes));
+  }
+  while (!stop->StopRequested()) {
+    bool idle = true;
+    for (auto& ring : rings) {
+      if (std::optional<std::string> record = ring->Read()) {
+        idle = false;
+        if (!trajectory_queue->Push(DecodeTrajectory(*record),
+                                    absl::Seconds(10))) {
+          logger.Print("Failed to push a trajectory after 10 seconds.");
+        }
+      }
+    }
+    if (idle) {
+      absl::SleepFor(absl::Milliseconds(1));
+    }
+  }
+  logger.Print("Got a quit.");
+}
+
+// Copies each new version of the weights to all the inference devices other
+// than the learner, and to the actor processes if there are any. Skips
+// straight to the latest version if it falls behind. The evaluator's cache is
+// cleared once every device has the new weights, so it never keeps results
+// from the old ones.
+void broadcaster(const AlphaZeroConfig& config, DeviceManager* device_manager,
+                 int learner_device, ParameterStore* store,
+                 SharedBlob* shared_weights, VPNetEvaluator* eval) {
+  FileLogger logger(config.path, "broadcaster");
+  int64_t version = store->Version();
+  while (std::optional<ParameterStore::Snapshot> snapshot =
+             store->WaitForNewer(version, absl::InfiniteDuration())) {
+    for (int i = 0; i < device_manager->Count(); ++i) {
+      if (i != learner_device) {
+        device_manager->Get(0, i)->SetWeights(*snapshot->weights);
+      }
+    }
+    eval->ClearCache();
+    if (shared_weights != nullptr) {
+      shared_weights->Publish(SerializeVPNetWeights(*snapshot->weights));
+    }
+    if (snapshot->version > version + 1) {
+      logger.Print("Skipped %d versions.", snapshot->version - version - 1);
+    }
+    version = snapshot->version;
+  }
+  logger.Print("Got a quit.");
+}
+
+// Writes checkpoints off the learner thread. Learning waits while a checkpoint
+// is being saved, but playing games doesn't.
+void checkpointer(const AlphaZeroConfig& config, DeviceManager* device_manager,
+                  int learner_device, ThreadedQueue<int>* steps) {
+  FileLogger logger(config.path, "checkpointer");
+  while (std::optional<int> step = steps->Pop()) {
+    std::string checkpoint_path =
+        device_manager->Get(0, learner_device)->SaveCheckpoint(*step);
+    logger.Print("Checkpoint saved: %s", checkpoint_path);
+  }
+  logger.Print("Got a quit.");
+}
+
 void learner(const open_spiel::Game& game,
              const AlphaZeroConfig& config,
              DeviceManager* device_manager,
@@ -270,8 +423,34 @@ void learner(const open_spiel::Game& game,
   logger.Print("Running the learner on device %d: %s", device_id,
                device_manager->Get(0, device_id)->Device());
 
-  CircularBuffer<VPNetModel::TrainInputs> replay_buffer(
-      config.replay_buffer_size);
+  // New weights reach the other devices through the store rather than through
+  // checkpoint files, and checkpoints are written in the background.
+  ParameterStore store;
+  store.Publish(device_manager->Get(0, device_id)->GetWeights());
+  std::unique_ptr<SharedBlob> shared_weights;
+  if (config.actor_processes > 0) {
+    std::string initial = SerializeVPNetWeights(*store.Latest().weights);
+    shared_weights = std::make_unique<SharedBlob>(SharedWeightsPath(config),
+                                                  initial.size());
+    shared_weights->Publish(initial);
+  }
+  Thread broadcast_thread([&]() {
+    broadcaster(config, device_manager, device_id, &store,
+                shared_weights.get(), eval.get());
+  });
+  ThreadedQueue<int> checkpoint_queue(2);
+  Thread checkpoint_thread([&]() {
+    checkpointer(config, device_manager, device_id, &checkpoint_queue);
+  });
+
+  ReplayBuffer replay_buffer(
+      game.ObservationTensorSize(), game.NumDistinctActions(),
+      config.replay_buffer_size,
+      config.replay_buffer_persist ? config.path + "/replay_buffer" : "");
+  if (!replay_buffer.Empty()) {
+    logger.Print("Resuming with %d states in the replay buffer.",
+                 replay_buffer.Size());
+  }
   int learn_rate = config.replay_buffer_size / config.replay_buffer_reuse;
   int64_t total_trajectories = 0;
 
@@ -314,12 +493,8 @@ void learner(const open_spiel::Game& game,
         outcomes.Add(p1_outcome > 0 ? 0 : (p1_outcome < 0 ? 1 : 2));
 
         for (const Trajectory::State& state : trajectory->states) {
-          replay_buffer.Add(
-              VPNetModel::TrainInputs{
-                  state.legal_actions,
-                  state.observation,
-                  state.policy,
-                  p1_outcome});
+          replay_buffer.Add(state.observation, state.legal_actions,
+                            state.policy, p1_outcome);
           num_states += 1;
         }
 
@@ -352,31 +527,32 @@ void learner(const open_spiel::Game& game,
 
     last = now;
 
-    VPNetModel::LossInfo losses;
+    VPNetModelBase::LossInfo losses;
     {  // Extra scope to return the device for use for inference asap.
       DeviceManager::DeviceLoan learn_model =
           device_manager->Get(config.train_batch_size, device_id);
 
       // Learn from them.
       for (int i = 0; i < replay_buffer.Size() / config.train_batch_size; i++) {
-        losses += learn_model->Learn(replay_buffer.Sample(
-            &rng, config.train_batch_size));
+        losses += learn_model->Learn(replay_buffer, config.train_batch_size,
+                                     &rng);
       }
     }
 
-    // Always save a checkpoint, either for keeping or for loading the weights
-    // to the other sessions. It only allows numbers, so use -1 as "latest".
-    std::string checkpoint_path =
-        device_manager->Get(0, device_id)->SaveCheckpoint(
-            step % config.checkpoint_freq == 0 ? step : -1);
-    if (device_manager->Count() > 0) {
-      for (int i = 0; i < device_manager->Count(); ++i) {
-        if (i != device_id) {
-          device_manager->Get(0, i)->LoadCheckpoint(checkpoint_path);
-        }
+    // Read the cache stats before sharing the new weights, as the broadcaster
+    // clears the cache once they're on every device.
+    LRUCacheInfo cache_info = eval->CacheInfo();
+
+    // Share the new weights with the other devices, and save a checkpoint
+    // every so often. Both happen on other threads.
+    int64_t weights_version =
+        store.Publish(device_manager->Get(0, device_id)->GetWeights());
+    if (step % config.checkpoint_freq == 0) {
+      checkpoint_queue.Push(step);
+      if (!replay_buffer.Flush()) {
+        logger.Print("Failed to flush the replay buffer.");
       }
     }
-    logger.Print("Checkpoint saved: %s", checkpoint_path);
 
     DataLogger::Record record = {
         {"step", step},
@@ -386,6 +562,7 @@ void learner(const open_spiel::Game& game,
         {"total_trajectories", total_trajectories},
         {"trajectories_per_s", num_trajectories / seconds},
         {"queue_size", queue_size},
+        {"weights_version", weights_version},
         {"game_length", game_lengths.ToJson()},
         {"game_length_hist", game_lengths_hist.ToJson()},
         {"outcomes", outcomes.ToJson()},
@@ -399,6 +576,7 @@ void learner(const open_spiel::Game& game,
         })},
         {"batch_size", eval->BatchSizeStats().ToJson()},
         {"batch_size_hist", eval->BatchSizeHistogram().ToJson()},
+        {"inference", eval->SchedulerStats()},
         {"loss", json::Object({
              {"policy", losses.Policy()},
              {"value", losses.Value()},
@@ -410,13 +588,11 @@ void learner(const open_spiel::Game& game,
     logger.Print("Losses: policy: %.4f, value: %.4f, l2: %.4f, sum: %.4f",
                  losses.Policy(), losses.Value(), losses.L2(), losses.Total());
 
-    LRUCacheInfo cache_info = eval->CacheInfo();
     if (cache_info.size > 0) {
       logger.Print(absl::StrFormat(
           "Cache size: %d/%d: %.1f%%, hits: %d, misses: %d, hit rate: %.3f%%",
           cache_info.size, cache_info.max_size, 100.0 * cache_info.Usage(),
           cache_info.hits, cache_info.misses, 100.0 * cache_info.HitRate()));
-      eval->ClearCache();
     }
     record.emplace("cache", json::Object({
         {"size", cache_info.size},
@@ -433,6 +609,27 @@ void learner(const open_spiel::Game& game,
     data_logger.Write(record);
     logger.Print("");
   }
+
+  // Let the last checkpoints finish, but skip any pending broadcast.
+  store.Close();
+  checkpoint_queue.BlockNewValues();
+  broadcast_thread.join();
+  checkpoint_thread.join();
+}
+
+// Devices named "native..." run inference in process without TensorFlow.
+void AddDevices(const AlphaZeroConfig& config, const open_spiel::Game& game,
+                DeviceManager* device_manager) {
+  for (const absl::string_view& device : absl::StrSplit(config.devices, ',')) {
+    if (absl::StartsWith(device, "native")) {
+      device_manager->AddDevice(std::make_unique<NativeVPNetModel>(
+          game, config.nn_model, config.nn_width, config.nn_depth,
+          std::string(device)));
+    } else {
+      device_manager->AddDevice(std::make_unique<VPNetModel>(
+          game, config.path, config.graph_def, std::string(device)));
+    }
+  }
 }
 
 bool AlphaZero(AlphaZeroConfig config, StopToken* stop) {
@@ -491,27 +688,31 @@ bool AlphaZero(AlphaZeroConfig config, StopToken* stop) {
     fd.Write(json::ToString(config.ToJson(), true) + "\n");
   }
 
+  // The learner always uses the first device, so that one must be TensorFlow.
   DeviceManager device_manager;
-  for (const absl::string_view& device : absl::StrSplit(config.devices, ',')) {
-    device_manager.AddDevice(VPNetModel(
-        *game, config.path, config.graph_def, std::string(device)));
-  }
-
+  AddDevices(config, *game, &device_manager);
   if (device_manager.Count() == 0) {
     std::cerr << "No devices specified?" << std::endl;
     return false;
   }
+  if (absl::StartsWith(device_manager.Get(0)->Device(), "native")) {
+    std::cerr << "The first device is used for learning, so can't be native."
+              << std::endl;
+    return false;
+  }
 
   {  // Make sure they're all in sync.
-    std::string first_checkpoint = device_manager.Get(0)->SaveCheckpoint(0);
+    device_manager.Get(0)->SaveCheckpoint(0);
+    VPNetWeights weights = device_manager.Get(0)->GetWeights();
     for (int i = 1; i < device_manager.Count(); ++i) {
-      device_manager.Get(0, i)->LoadCheckpoint(first_checkpoint);
+      device_manager.Get(0, i)->SetWeights(weights);
     }
   }
 
   auto eval = std::make_shared<VPNetEvaluator>(
       &device_manager, config.inference_batch_size, config.inference_threads,
-      config.inference_cache, (config.actors + config.evaluators) / 16);
+      config.inference_cache, (config.actors + config.evaluators) / 16,
+      absl::Microseconds(config.inference_max_wait_us));
 
   ThreadedQueue<Trajectory> trajectory_queue(
       config.replay_buffer_size / config.replay_buffer_reuse);
@@ -530,6 +731,11 @@ bool AlphaZero(AlphaZeroConfig config, StopToken* stop) {
     evaluators.emplace_back(
         [&, i]() { evaluator(*game, config, i, &eval_results, eval, stop); });
   }
+  std::optional<Thread> collector_thread;
+  if (config.actor_processes > 0) {
+    collector_thread.emplace(
+        [&]() { collector(config, &trajectory_queue, stop); });
+  }
   learner(*game, config, &device_manager, eval, &trajectory_queue,
           &eval_results, stop);
 
@@ -548,8 +754,107 @@ bool AlphaZero(AlphaZeroConfig config, StopToken* stop) {
   for (auto& t : evaluators) {
     t.join();
   }
+  if (collector_thread) {
+    collector_thread->join();
+  }
   std::cout << "Exiting cleanly." << std::endl;
   return true;
 }
 
+bool AlphaZeroActorProcess(AlphaZeroConfig config, int process_id,
+                           StopToken* stop) {
+  std::shared_ptr<const open_spiel::Game> game =
+      open_spiel::LoadGame(config.game);
+  if (config.graph_def.empty()) {
+    config.graph_def = "vpnet.pb";
+  }
+  FileLogger logger(config.path, absl::StrCat("actor-process-", process_id));
+
+  // The learner creates the weights, so wait for it to start.
+  std::string weights_path = SharedWeightsPath(config);
+  while (!file::Exists(weights_path)) {
+    if (stop->StopRequested()) return false;
+    logger.Print("Waiting for the learner to publish weights.");
+    absl::SleepFor(absl::Seconds(1));
+  }
+  SharedBlob shared_weights(weights_path, 0);
+
+  DeviceManager device_manager;
+  AddDevices(config, *game, &device_manager);
+  if (device_manager.Count() == 0) {
+    std::cerr << "No devices specified?" << std::endl;
+    return false;
+  }
+
+  auto eval = std::make_shared<VPNetEvaluator>(
+      &device_manager, config.inference_batch_size, config.inference_threads,
+      config.inference_cache, config.actors / 16,
+      absl::Microseconds(config.inference_max_wait_us));
+
+  // Picks up new weights as the learner publishes them. Returns whether there
+  // were any.
+  int64_t weights_version = 0;
+  auto update_weights = [&]() {
+    if (shared_weights.Version() <= weights_version) return false;
+    std::optional<std::pair<int64_t, std::string>> latest =
+        shared_weights.Read();
+    if (!latest) return false;
+    VPNetWeights weights = DeserializeVPNetWeights(latest->second);
+    for (int i = 0; i < device_manager.Count(); ++i) {
+      device_manager.Get(0, i)->SetWeights(weights);
+    }
+    eval->ClearCache();
+    weights_version = latest->first;
+    return true;
+  };
+  while (!update_weights()) {
+    if (stop->StopRequested()) return false;
+    absl::SleepFor(absl::Milliseconds(100));
+  }
+  logger.Print("Starting with weights version %d", weights_version);
+
+  SharedRing ring(ActorProcessRingPath(config, process_id),
+                  kActorProcessRingBytes);
+  ThreadedQueue<Trajectory> trajectory_queue(std::max(1, config.actors));
+  std::string name = absl::StrCat("actor-process-", process_id, "-actor");
+  std::vector<Thread> actors;
+  actors.reserve(config.actors);
+  for (int i = 0; i < config.actors; ++i) {
+    actors.emplace_back([&, i]() {
+      actor(*game, config, i, &trajectory_queue, eval, stop, name);
+    });
+  }
+  Thread weights_thread([&]() {
+    while (!stop->StopRequested()) {
+      absl::SleepFor(absl::Milliseconds(100));
+      update_weights();
+    }
+  });
+
+  int64_t sent = 0;
+  while (!stop->StopRequested()) {
+    std::optional<Trajectory> trajectory =
+        trajectory_queue.Pop(absl::Seconds(1));
+    if (!trajectory) continue;
+    std::string record = EncodeTrajectory(*trajectory);
+    while (!ring.Write(record, absl::Now() + absl::Seconds(10))) {
+      logger.Print("The learner hasn't taken a trajectory in 10 seconds.");
+      if (stop->StopRequested()) break;
+    }
+    if (++sent % 100 == 0) {
+      logger.Print("Sent %d trajectories, weights version %d", sent,
+                   shared_weights.Version());
+    }
+  }
+
+  trajectory_queue.BlockNewValues();
+  trajectory_queue.Clear();
+  for (auto& t : actors) {
+    t.join();
+  }
+  weights_thread.join();
+  logger.Print("Got a quit.");
+  return true;
+}
+
 }  // namespace open_spiel::algorithms
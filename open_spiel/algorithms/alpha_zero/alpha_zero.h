@@ -35,8 +35,10 @@ struct AlphaZeroConfig {
   int inference_batch_size;
   int inference_threads;
   int inference_cache;
+  int inference_max_wait_us;
   int replay_buffer_size;
   int replay_buffer_reuse;
+  bool replay_buffer_persist;
   int checkpoint_freq;
   int evaluation_window;
 
@@ -54,6 +56,10 @@ struct AlphaZeroConfig {
   int eval_levels;
   int max_steps;
 
+  // How many separate actor processes feed the learner, see
+  // AlphaZeroActorProcess.
+  int actor_processes;
+
   json::Object ToJson() const {
     return json::Object({
         {"game", game},
@@ -69,8 +75,10 @@ struct AlphaZeroConfig {
         {"inference_batch_size", inference_batch_size},
         {"inference_threads", inference_threads},
         {"inference_cache", inference_cache},
+        {"inference_max_wait_us", inference_max_wait_us},
         {"replay_buffer_size", replay_buffer_size},
         {"replay_buffer_reuse", replay_buffer_reuse},
+        {"replay_buffer_persist", replay_buffer_persist},
         {"checkpoint_freq", checkpoint_freq},
         {"evaluation_window", evaluation_window},
         {"uct_c", uct_c},
@@ -85,12 +93,23 @@ struct AlphaZeroConfig {
         {"evaluators", evaluators},
         {"eval_levels", eval_levels},
         {"max_steps", max_steps},
+        {"actor_processes", actor_processes},
     });
   }
 };
 
 bool AlphaZero(AlphaZeroConfig config, StopToken* stop);
 
+// Run `config.actors` actors in a separate process that feeds the learner of
+// the AlphaZero run in `config.path`, on the same host. Trajectories go to the
+// learner and new weights come back over shared memory files in
+// `config.path`, so this process has its own allocator, inference devices and
+// VPNetEvaluator. The config should otherwise match the learner's. The learner
+// reads from `config.actor_processes` of these, numbered from 0, and any of
+// them can be stopped and restarted without interrupting training.
+bool AlphaZeroActorProcess(AlphaZeroConfig config, int process_id,
+                           StopToken* stop);
+
 }  // namespace open_spiel::algorithms
 
 #endif  // OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_ALPHA_ZERO_H_
@@ -0,0 +1,223 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_BATCH_SCHEDULER_H_
+#define OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_BATCH_SCHEDULER_H_
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/utils/json.h"
+#include "open_spiel/utils/stats.h"
+
+namespace open_spiel::algorithms {
+
+// Groups requests into batches for inference. Waiting longer gives bigger,
+// more efficient batches, but every request in the batch waits too, so rather
+// than always waiting for a full batch it picks a target size for each batch:
+// what's already queued plus what's expected to arrive while one batch runs,
+// based on the observed arrival rate and inference latency. It waits for that
+// many, but never longer than `max_wait` after the oldest request arrived.
+//
+// High priority requests, eg from searches that are waiting on each result,
+// go to the front of the batch and are taken first when a batch is full.
+template <typename T>
+class BatchScheduler {
+ public:
+  enum class Priority { kNormal, kHigh };
+
+  BatchScheduler(int max_batch_size, absl::Duration max_wait,
+                 int max_queue_size)
+      : max_batch_size_(max_batch_size),
+        max_wait_(max_wait),
+        max_queue_size_(std::max(max_queue_size, max_batch_size)),
+        batch_size_hist_(max_batch_size + 1) {}
+
+  // Add a request, waiting for space if the queue is full. Returns false if
+  // the scheduler was closed.
+  bool Push(T item, Priority priority = Priority::kNormal) {
+    absl::MutexLock lock(&m_);
+    while (Size() >= max_queue_size_ && !closed_) {
+      cv_.Wait(&m_);
+    }
+    if (closed_) return false;
+    absl::Time now = absl::Now();
+    if (last_arrival_ != absl::InfinitePast()) {
+      UpdateAverage(absl::ToDoubleSeconds(now - last_arrival_),
+                    &arrival_interval_);
+    }
+    last_arrival_ = now;
+    queues_[static_cast<int>(priority)].push_back(Entry{std::move(item), now});
+    cv_.SignalAll();
+    return true;
+  }
+
+  // Wait for the next batch. Only returns an empty batch once closed.
+  std::vector<T> PopBatch() {
+    absl::MutexLock lock(&m_);
+    while (Size() == 0 && !closed_) {
+      cv_.Wait(&m_);
+    }
+    if (closed_) return {};
+
+    int target = Target();
+    absl::Time deadline = Oldest() + max_wait_;
+    while (Size() < target && !closed_) {
+      if (cv_.WaitWithDeadline(&m_, deadline)) break;
+    }
+    bool reached_target = Size() >= target;
+
+    absl::Time now = absl::Now();
+    std::vector<T> batch;
+    batch.reserve(std::min(Size(), max_batch_size_));
+    for (int p = kNumPriorities - 1; p >= 0; --p) {
+      std::deque<Entry>& queue = queues_[p];
+      while (!queue.empty() && batch.size() < max_batch_size_) {
+        queue_wait_ms_.Add(absl::ToDoubleMilliseconds(now - queue.front().time));
+        if (p > 0) ++high_priority_;
+        batch.push_back(std::move(queue.front().item));
+        queue.pop_front();
+      }
+    }
+    batch_size_.Add(batch.size());
+    batch_size_hist_.Add(batch.size());
+    target_.Add(target);
+    if (!reached_target) ++deadline_flushes_;
+    cv_.SignalAll();  // Wake anyone waiting for space.
+    return batch;
+  }
+
+  // Report how long running a batch took, used to pick the next targets.
+  void RecordLatency(absl::Duration latency) {
+    absl::MutexLock lock(&m_);
+    double seconds = absl::ToDoubleSeconds(latency);
+    UpdateAverage(seconds, &latency_);
+    latency_ms_.Add(seconds * 1000);
+  }
+
+  // Make all waiting and future calls return immediately.
+  void Close() {
+    absl::MutexLock lock(&m_);
+    closed_ = true;
+    cv_.SignalAll();
+  }
+
+  // Drop all queued requests.
+  void Clear() {
+    absl::MutexLock lock(&m_);
+    for (auto& queue : queues_) queue.clear();
+    cv_.SignalAll();
+  }
+
+  BasicStats BatchSizeStats() {
+    absl::MutexLock lock(&m_);
+    return batch_size_;
+  }
+
+  HistogramNumbered BatchSizeHistogram() {
+    absl::MutexLock lock(&m_);
+    return batch_size_hist_;
+  }
+
+  json::Object StatsJson() {
+    absl::MutexLock lock(&m_);
+    return json::Object({
+        {"batch_size", batch_size_.ToJson()},
+        {"target", target_.ToJson()},
+        {"queue_wait_ms", queue_wait_ms_.ToJson()},
+        {"latency_ms", latency_ms_.ToJson()},
+        {"deadline_flushes", deadline_flushes_},
+        {"high_priority", high_priority_},
+        {"arrival_interval_ms", arrival_interval_ * 1000},
+    });
+  }
+
+  void ResetStats() {
+    absl::MutexLock lock(&m_);
+    batch_size_.Reset();
+    batch_size_hist_.Reset();
+    target_.Reset();
+    queue_wait_ms_.Reset();
+    latency_ms_.Reset();
+    deadline_flushes_ = 0;
+    high_priority_ = 0;
+  }
+
+ private:
+  static constexpr int kNumPriorities = 2;
+  // Weight of the newest observation in the moving averages.
+  static constexpr double kSmoothing = 0.1;
+
+  struct Entry {
+    T item;
+    absl::Time time;
+  };
+
+  static void UpdateAverage(double value, double* average) {
+    *average = *average < 0 ? value
+                            : kSmoothing * value + (1 - kSmoothing) * *average;
+  }
+
+  int Size() const { return queues_[0].size() + queues_[1].size(); }
+
+  absl::Time Oldest() const {
+    absl::Time oldest = absl::InfiniteFuture();
+    for (const auto& queue : queues_) {
+      if (!queue.empty()) oldest = std::min(oldest, queue.front().time);
+    }
+    return oldest;
+  }
+
+  // Waiting longer than a batch takes to run is worse than running a smaller
+  // batch now and another later, so expect what arrives within the latency.
+  int Target() const {
+    if (latency_ < 0 || arrival_interval_ < 0) return max_batch_size_;
+    double window = std::min(latency_, absl::ToDoubleSeconds(max_wait_));
+    double expected = arrival_interval_ > 0 ? window / arrival_interval_
+                                            : max_batch_size_;
+    return std::clamp(static_cast<int>(std::round(Size() + expected)), 1,
+                      max_batch_size_);
+  }
+
+  const int max_batch_size_;
+  const absl::Duration max_wait_;
+  const int max_queue_size_;
+
+  absl::Mutex m_;
+  absl::CondVar cv_;
+  std::deque<Entry> queues_[kNumPriorities];
+  bool closed_ = false;
+
+  // Moving averages in seconds, negative until the first observation.
+  absl::Time last_arrival_ = absl::InfinitePast();
+  double arrival_interval_ = -1;
+  double latency_ = -1;
+
+  BasicStats batch_size_;
+  HistogramNumbered batch_size_hist_;
+  BasicStats target_;
+  BasicStats queue_wait_ms_;
+  BasicStats latency_ms_;
+  int64_t deadline_flushes_ = 0;
+  int64_t high_priority_ = 0;
+};
+
+}  // namespace open_spiel::algorithms
+
+#endif  // OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_BATCH_SCHEDULER_H_
@@ -0,0 +1,88 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/alpha_zero/batch_scheduler.h"
+
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
+
+namespace open_spiel::algorithms {
+namespace {
+
+using Scheduler = BatchScheduler<int>;
+
+void TestFullBatch() {
+  Scheduler scheduler(4, absl::Seconds(60), 16);
+  for (int i = 0; i < 6; ++i) scheduler.Push(i);
+  // Without any latency observed it waits for a full batch, which is there.
+  SPIEL_CHECK_EQ(scheduler.PopBatch(), std::vector<int>({0, 1, 2, 3}));
+}
+
+void TestDeadline() {
+  Scheduler scheduler(4, absl::Milliseconds(10), 16);
+  scheduler.Push(1);
+  absl::Time start = absl::Now();
+  SPIEL_CHECK_EQ(scheduler.PopBatch(), std::vector<int>({1}));
+  SPIEL_CHECK_GE(absl::Now() - start, absl::Milliseconds(9));
+  SPIEL_CHECK_EQ(std::get<int64_t>(scheduler.StatsJson()["deadline_flushes"]),
+                 1);
+}
+
+void TestPriority() {
+  Scheduler scheduler(3, absl::Seconds(60), 16);
+  scheduler.Push(1);
+  scheduler.Push(2);
+  scheduler.Push(3, Scheduler::Priority::kHigh);
+  scheduler.Push(4);
+  scheduler.Push(5, Scheduler::Priority::kHigh);
+  SPIEL_CHECK_EQ(scheduler.PopBatch(), std::vector<int>({3, 5, 1}));
+}
+
+void TestAdaptiveTarget() {
+  // Once inference is known to be fast compared to the rate of requests, it
+  // doesn't wait for a full batch, nor for the deadline.
+  Scheduler scheduler(64, absl::Seconds(60), 128);
+  scheduler.RecordLatency(absl::Microseconds(1));
+  scheduler.Push(1);
+  absl::SleepFor(absl::Milliseconds(5));
+  scheduler.Push(2);
+  absl::Time start = absl::Now();
+  SPIEL_CHECK_EQ(scheduler.PopBatch(), std::vector<int>({1, 2}));
+  SPIEL_CHECK_LT(absl::Now() - start, absl::Seconds(10));
+}
+
+void TestClose() {
+  Scheduler scheduler(4, absl::Seconds(60), 4);
+  std::vector<int> batch = {1};
+  Thread waiter([&]() { batch = scheduler.PopBatch(); });
+  scheduler.Close();
+  waiter.join();
+  SPIEL_CHECK_TRUE(batch.empty());
+  SPIEL_CHECK_FALSE(scheduler.Push(1));
+}
+
+}  // namespace
+}  // namespace open_spiel::algorithms
+
+int main(int argc, char** argv) {
+  open_spiel::algorithms::TestFullBatch();
+  open_spiel::algorithms::TestDeadline();
+  open_spiel::algorithms::TestPriority();
+  open_spiel::algorithms::TestAdaptiveTarget();
+  open_spiel::algorithms::TestClose();
+}
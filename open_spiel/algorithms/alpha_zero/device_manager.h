@@ -15,22 +15,24 @@
 #ifndef OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_DEVICE_MANAGER_H_
 #define OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_DEVICE_MANAGER_H_
 
+#include <memory>
 #include <vector>
 
 #include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
-#include "open_spiel/algorithms/alpha_zero/vpnet.h"
+#include "open_spiel/algorithms/alpha_zero/vpnet_base.h"
 
 namespace open_spiel::algorithms {
 
 // Keeps track of a bunch of VPNet models, intended to be one per device, and
 // gives them out based on usage. When you request a device you specify how much
 // work you're going to give it, which is assumed done once the loan is
-// returned.
+// returned. The models needn't all be the same type, eg a TensorFlow VPNetModel
+// for the learner alongside NativeVPNetModels for inference.
 class DeviceManager {
  public:
   DeviceManager() {}
 
-  void AddDevice(VPNetModel model) {  // Not thread safe.
+  void AddDevice(std::unique_ptr<VPNetModelBase> model) {  // Not thread safe.
     devices.emplace_back(Device{std::move(model)});
   }
 
@@ -44,15 +46,15 @@ class DeviceManager {
     DeviceLoan& operator=(const DeviceLoan&) = delete;
 
     ~DeviceLoan() { manager_->Return(device_id_, requests_); }
-    VPNetModel* operator->() { return model_; }
+    VPNetModelBase* operator->() { return model_; }
 
    private:
-    DeviceLoan(DeviceManager* manager, VPNetModel* model, int device_id,
+    DeviceLoan(DeviceManager* manager, VPNetModelBase* model, int device_id,
                int requests)
         : manager_(manager), model_(model), device_id_(device_id),
           requests_(requests) {}
     DeviceManager* manager_;
-    VPNetModel* model_;
+    VPNetModelBase* model_;
     int device_id_;
     int requests_;
     friend DeviceManager;
@@ -70,7 +72,8 @@ class DeviceManager {
       }
     }
     devices[device_id].requests += requests;
-    return DeviceLoan(this, &devices[device_id].model, device_id, requests);
+    return DeviceLoan(this, devices[device_id].model.get(), device_id,
+                      requests);
   }
 
   int Count() const { return devices.size(); }
@@ -82,7 +85,7 @@ class DeviceManager {
   }
 
   struct Device {
-    VPNetModel model;
+    std::unique_ptr<VPNetModelBase> model;
     int requests = 0;
   };
 
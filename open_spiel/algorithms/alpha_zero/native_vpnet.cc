@@ -0,0 +1,427 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/alpha_zero/native_vpnet.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_join.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+// Keras' default for BatchNormalization.
+constexpr float kBatchNormEpsilon = 1e-3;
+
+// c[m, n] = a[m, k] * b[k, n] + bias[n], all row-major.
+//
+// Four rows of `a` are processed together so each row of `b` is loaded once
+// per four output rows, and the innermost loop runs over contiguous memory so
+// the compiler vectorizes it.
+void MatMul(const float* __restrict a, const float* __restrict b,
+            const float* __restrict bias, int m, int k, int n,
+            float* __restrict c) {
+  int i = 0;
+  for (; i + 4 <= m; i += 4) {
+    float* c0 = c + (i + 0) * n;
+    float* c1 = c + (i + 1) * n;
+    float* c2 = c + (i + 2) * n;
+    float* c3 = c + (i + 3) * n;
+    std::copy(bias, bias + n, c0);
+    std::copy(bias, bias + n, c1);
+    std::copy(bias, bias + n, c2);
+    std::copy(bias, bias + n, c3);
+    const float* a0 = a + (i + 0) * k;
+    const float* a1 = a + (i + 1) * k;
+    const float* a2 = a + (i + 2) * k;
+    const float* a3 = a + (i + 3) * k;
+    for (int p = 0; p < k; ++p) {
+      float v0 = a0[p], v1 = a1[p], v2 = a2[p], v3 = a3[p];
+      if (v0 == 0 && v1 == 0 && v2 == 0 && v3 == 0) {
+        continue;  // Observations and relu outputs are often sparse.
+      }
+      const float* b_row = b + p * n;
+      for (int j = 0; j < n; ++j) {
+        float bv = b_row[j];
+        c0[j] += v0 * bv;
+        c1[j] += v1 * bv;
+        c2[j] += v2 * bv;
+        c3[j] += v3 * bv;
+      }
+    }
+  }
+  for (; i < m; ++i) {
+    float* c_row = c + i * n;
+    std::copy(bias, bias + n, c_row);
+    const float* a_row = a + i * k;
+    for (int p = 0; p < k; ++p) {
+      float v = a_row[p];
+      if (v == 0) continue;
+      const float* b_row = b + p * n;
+      for (int j = 0; j < n; ++j) {
+        c_row[j] += v * b_row[j];
+      }
+    }
+  }
+}
+
+void Relu(std::vector<float>* x) {
+  for (float& v : *x) {
+    v = std::max(v, 0.0f);
+  }
+}
+
+// A dense layer: out = in * kernel + bias.
+struct Dense {
+  int in = 0;
+  int out = 0;
+  std::vector<float> kernel;  // [in, out]
+  std::vector<float> bias;    // [out]
+
+  void Apply(const std::vector<float>& x, int batch,
+             std::vector<float>* y) const {
+    y->resize(batch * out);
+    MatMul(x.data(), kernel.data(), bias.data(), batch, in, out, y->data());
+  }
+};
+
+// A 2d convolution with "same" padding over NHWC inputs, with the following
+// batch norm folded into the kernel and bias.
+struct Conv {
+  int size = 0;  // The kernel is size x size.
+  int in = 0;
+  int out = 0;
+  std::vector<float> kernel;  // [size, size, in, out], ie [size*size*in, out]
+  std::vector<float> bias;    // [out]
+
+  void Apply(const std::vector<float>& x, int batch, int height, int width,
+             std::vector<float>* scratch, std::vector<float>* y) const {
+    int rows = batch * height * width;
+    y->resize(rows * out);
+    if (size == 1) {
+      MatMul(x.data(), kernel.data(), bias.data(), rows, in, out, y->data());
+      return;
+    }
+    // im2col: gather each output pixel's receptive field into one row, so the
+    // whole convolution becomes a single matrix multiply.
+    int pad = size / 2;
+    int cols = size * size * in;
+    scratch->assign(static_cast<int64_t>(rows) * cols, 0);
+    for (int b = 0; b < batch; ++b) {
+      for (int h = 0; h < height; ++h) {
+        for (int w = 0; w < width; ++w) {
+          float* row =
+              scratch->data() + ((b * height + h) * width + w) * cols;
+          for (int dy = 0; dy < size; ++dy) {
+            int sh = h + dy - pad;
+            if (sh < 0 || sh >= height) continue;
+            for (int dx = 0; dx < size; ++dx) {
+              int sw = w + dx - pad;
+              if (sw < 0 || sw >= width) continue;
+              std::memcpy(row + (dy * size + dx) * in,
+                          x.data() + ((b * height + sh) * width + sw) * in,
+                          in * sizeof(float));
+            }
+          }
+        }
+      }
+    }
+    MatMul(scratch->data(), kernel.data(), bias.data(), rows, cols, out,
+           y->data());
+  }
+};
+
+const VPNetWeight& GetWeight(const VPNetWeights& weights,
+                             const std::string& name,
+                             const std::vector<int>& shape) {
+  auto it = weights.find(name);
+  if (it == weights.end()) {
+    SpielFatalError(absl::StrCat("Missing weight: ", name));
+  }
+  if (it->second.shape != shape) {
+    SpielFatalError(absl::StrCat(
+        "Weight ", name, " has shape [", absl::StrJoin(it->second.shape, ", "),
+        "], expected [", absl::StrJoin(shape, ", "), "]"));
+  }
+  return it->second;
+}
+
+Dense MakeDense(const VPNetWeights& weights, const std::string& name, int in,
+                int out) {
+  Dense dense;
+  dense.in = in;
+  dense.out = out;
+  dense.kernel = GetWeight(weights, name + "/kernel", {in, out}).data;
+  dense.bias = GetWeight(weights, name + "/bias", {out}).data;
+  return dense;
+}
+
+Conv MakeConv(const VPNetWeights& weights, const std::string& conv_name,
+              const std::string& batch_norm_name, int size, int in, int out) {
+  Conv conv;
+  conv.size = size;
+  conv.in = in;
+  conv.out = out;
+  conv.kernel =
+      GetWeight(weights, conv_name + "/kernel", {size, size, in, out}).data;
+  conv.bias = GetWeight(weights, conv_name + "/bias", {out}).data;
+
+  const std::vector<float>& gamma =
+      GetWeight(weights, batch_norm_name + "/gamma", {out}).data;
+  const std::vector<float>& beta =
+      GetWeight(weights, batch_norm_name + "/beta", {out}).data;
+  const std::vector<float>& mean =
+      GetWeight(weights, batch_norm_name + "/moving_mean", {out}).data;
+  const std::vector<float>& variance =
+      GetWeight(weights, batch_norm_name + "/moving_variance", {out}).data;
+  for (int o = 0; o < out; ++o) {
+    float scale = gamma[o] / std::sqrt(variance[o] + kBatchNormEpsilon);
+    for (int i = o; i < conv.kernel.size(); i += out) {
+      conv.kernel[i] *= scale;
+    }
+    conv.bias[o] = (conv.bias[o] - mean[o]) * scale + beta[o];
+  }
+  return conv;
+}
+
+}  // namespace
+
+// The layers of one of the networks from export_model.py.
+struct NativeVPNetModel::Network {
+  bool mlp;
+  bool resnet;
+  int height = 1;
+  int width = 1;
+
+  std::vector<Dense> torso_dense;  // mlp only.
+  // conv2d: one per layer. resnet: the input conv, then two per res block.
+  std::vector<Conv> torso_conv;
+  Conv policy_conv;  // Conv models only.
+  Conv value_conv;   // Conv models only.
+  Dense policy_dense;  // mlp only.
+  Dense policy;
+  Dense value_dense;
+  Dense value;
+};
+
+NativeVPNetModel::NativeVPNetModel(const Game& game,
+                                   const std::string& nn_model, int nn_width,
+                                   int nn_depth, const std::string& device)
+    : device_(device),
+      nn_model_(nn_model),
+      nn_width_(nn_width),
+      nn_depth_(nn_depth),
+      input_shape_(game.ObservationTensorShape()),
+      flat_input_size_(game.ObservationTensorSize()),
+      num_actions_(game.NumDistinctActions()) {
+  // Same assumptions as VPNetModel.
+  SPIEL_CHECK_EQ(game.NumPlayers(), 2);
+  SPIEL_CHECK_EQ(game.GetType().utility, GameType::Utility::kZeroSum);
+  if (nn_model != "mlp" && nn_model != "conv2d" && nn_model != "resnet") {
+    SpielFatalError(absl::StrCat("Unknown nn_model: ", nn_model));
+  }
+  if (nn_model != "mlp" && input_shape_.size() != 3) {
+    SpielFatalError(absl::StrCat(
+        nn_model, " needs a 3d observation, got [",
+        absl::StrJoin(input_shape_, ", "), "]"));
+  }
+}
+
+NativeVPNetModel::~NativeVPNetModel() = default;
+
+void NativeVPNetModel::SetWeights(const VPNetWeights& weights) {
+  auto network = std::make_shared<Network>();
+  network->mlp = nn_model_ == "mlp";
+  network->resnet = nn_model_ == "resnet";
+  if (network->mlp) {
+    int in = flat_input_size_;
+    for (int i = 0; i < nn_depth_; ++i) {
+      network->torso_dense.push_back(MakeDense(
+          weights, absl::StrCat("torso_", i, "_dense"), in, nn_width_));
+      in = nn_width_;
+    }
+    network->policy_dense =
+        MakeDense(weights, "policy_dense", in, nn_width_);
+    network->policy = MakeDense(weights, "policy", nn_width_, num_actions_);
+    network->value_dense = MakeDense(weights, "value_dense", in, nn_width_);
+  } else {
+    // Keras treats the observation shape as [height, width, channels].
+    network->height = input_shape_[0];
+    network->width = input_shape_[1];
+    int channels = input_shape_[2];
+    int pixels = network->height * network->width;
+    if (network->resnet) {
+      network->torso_conv.push_back(MakeConv(
+          weights, "torso_in_conv", "torso_in_batch_norm", 3, channels,
+          nn_width_));
+      for (int i = 0; i < nn_depth_; ++i) {
+        for (int j : {1, 2}) {
+          network->torso_conv.push_back(MakeConv(
+              weights, absl::StrCat("torso_", i, "_res_conv", j),
+              absl::StrCat("torso_", i, "_res_batch_norm", j), 3, nn_width_,
+              nn_width_));
+        }
+      }
+    } else {
+      int in = channels;
+      for (int i = 0; i < nn_depth_; ++i) {
+        network->torso_conv.push_back(MakeConv(
+            weights, absl::StrCat("torso_", i, "_conv"),
+            absl::StrCat("torso_", i, "_batch_norm"), 3, in, nn_width_));
+        in = nn_width_;
+      }
+    }
+    network->policy_conv = MakeConv(
+        weights, "policy_conv", "policy_batch_norm", 1, nn_width_, 2);
+    network->value_conv = MakeConv(
+        weights, "value_conv", "value_batch_norm", 1, nn_width_, 1);
+    network->policy =
+        MakeDense(weights, "policy", pixels * 2, num_actions_);
+    network->value_dense =
+        MakeDense(weights, "value_dense", pixels, nn_width_);
+  }
+  network->value = MakeDense(weights, "value", nn_width_, 1);
+
+  auto weights_copy = std::make_shared<const VPNetWeights>(weights);
+  absl::MutexLock lock(&m_);
+  network_ = std::move(network);
+  weights_ = std::move(weights_copy);
+}
+
+VPNetWeights NativeVPNetModel::GetWeights() {
+  absl::MutexLock lock(&m_);
+  if (!weights_) {
+    SpielFatalError("NativeVPNetModel: no weights loaded.");
+  }
+  return *weights_;
+}
+
+void NativeVPNetModel::LoadCheckpoint(const std::string& path) {
+  SetWeights(ReadVPNetWeights(absl::StrCat(path, ".weights")));
+}
+
+std::vector<VPNetModelBase::InferenceOutputs> NativeVPNetModel::Inference(
+    const std::vector<InferenceInputs>& inputs) {
+  std::shared_ptr<const Network> network;
+  {
+    absl::MutexLock lock(&m_);
+    network = network_;
+  }
+  if (!network) {
+    SpielFatalError("NativeVPNetModel: no weights loaded.");
+  }
+
+  int batch = inputs.size();
+  std::vector<float> x(batch * flat_input_size_);
+  for (int b = 0; b < batch; ++b) {
+    SPIEL_CHECK_EQ(inputs[b].observations.size(), flat_input_size_);
+    std::copy(inputs[b].observations.begin(), inputs[b].observations.end(),
+              x.begin() + b * flat_input_size_);
+  }
+
+  // Scratch buffers are local, so concurrent calls don't interfere.
+  std::vector<float> y, scratch, policy_head, value_head, logits, values;
+  if (network->mlp) {
+    for (const Dense& dense : network->torso_dense) {
+      dense.Apply(x, batch, &y);
+      Relu(&y);
+      std::swap(x, y);
+    }
+    network->policy_dense.Apply(x, batch, &policy_head);
+    Relu(&policy_head);
+    network->value_dense.Apply(x, batch, &value_head);
+  } else {
+    int height = network->height;
+    int width = network->width;
+    std::vector<float> skip;
+    for (int i = 0; i < network->torso_conv.size(); ++i) {
+      // Res blocks are the pairs after the input conv: conv-bn-relu, then
+      // conv-bn, add the block input, relu.
+      bool block_start = network->resnet && i % 2 == 1;
+      bool block_end = network->resnet && i > 0 && i % 2 == 0;
+      if (block_start) skip = x;
+      network->torso_conv[i].Apply(x, batch, height, width, &scratch, &y);
+      if (block_end) {
+        for (int j = 0; j < y.size(); ++j) y[j] += skip[j];
+      }
+      Relu(&y);
+      std::swap(x, y);
+    }
+    // The NHWC layout means a [batch * pixels, filters] matrix is already the
+    // flattened [batch, pixels * filters] one the dense layers expect.
+    network->policy_conv.Apply(x, batch, height, width, &scratch,
+                               &policy_head);
+    Relu(&policy_head);
+    network->value_conv.Apply(x, batch, height, width, &scratch, &y);
+    Relu(&y);
+    network->value_dense.Apply(y, batch, &value_head);
+  }
+  Relu(&value_head);
+  network->policy.Apply(policy_head, batch, &logits);
+  network->value.Apply(value_head, batch, &values);
+
+  std::vector<InferenceOutputs> out;
+  out.reserve(batch);
+  for (int b = 0; b < batch; ++b) {
+    // Softmax over the legal actions only, same as masking the illegal ones
+    // with a huge negative logit.
+    const float* row = logits.data() + b * num_actions_;
+    const std::vector<Action>& legal_actions = inputs[b].legal_actions;
+    float max_logit = -std::numeric_limits<float>::infinity();
+    for (Action action : legal_actions) {
+      max_logit = std::max(max_logit, row[action]);
+    }
+    ActionsAndProbs policy;
+    policy.reserve(legal_actions.size());
+    double total = 0;
+    for (Action action : legal_actions) {
+      double p = std::exp(row[action] - max_logit);
+      policy.push_back({action, p});
+      total += p;
+    }
+    for (auto& [action, prob] : policy) {
+      prob /= total;
+    }
+    out.push_back({std::tanh(values[b]), std::move(policy)});
+  }
+  return out;
+}
+
+VPNetModelBase::LossInfo NativeVPNetModel::Learn(
+    const std::vector<TrainInputs>& inputs) {
+  SpielFatalError("NativeVPNetModel only supports inference.");
+}
+
+VPNetModelBase::LossInfo NativeVPNetModel::Learn(
+    const ReplayBuffer& replay_buffer, int batch_size, std::mt19937* rng) {
+  SpielFatalError("NativeVPNetModel only supports inference.");
+}
+
+std::string NativeVPNetModel::SaveCheckpoint(int step) {
+  SpielFatalError("NativeVPNetModel can only load checkpoints.");
+}
+
+}  // namespace algorithms
+}  // namespace open_spiel
@@ -0,0 +1,86 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_NATIVE_VPNET_H_
+#define OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_NATIVE_VPNET_H_
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+#include "open_spiel/algorithms/alpha_zero/vpnet_base.h"
+#include "open_spiel/spiel.h"
+
+namespace open_spiel {
+namespace algorithms {
+
+// Runs inference for the same networks as export_model.py builds (mlp, conv2d
+// and resnet), but in plain C++ on the calling thread. That avoids the
+// TensorFlow session overhead on the small batches typical for actors, and
+// lets actors run without linking TensorFlow at all. Batch norm layers are
+// folded into the preceding convolution when the weights are loaded.
+//
+// This model can't be trained. Instead, load the weights that VPNetModel writes
+// alongside its checkpoints.
+class NativeVPNetModel : public VPNetModelBase {
+ public:
+  NativeVPNetModel(const Game& game, const std::string& nn_model, int nn_width,
+                   int nn_depth, const std::string& device = "native");
+  ~NativeVPNetModel() override;
+
+  // Not copyable.
+  NativeVPNetModel(const NativeVPNetModel&) = delete;
+  NativeVPNetModel& operator=(const NativeVPNetModel&) = delete;
+
+  // Thread safe, including against concurrent calls to SetWeights.
+  std::vector<InferenceOutputs> Inference(
+      const std::vector<InferenceInputs>& inputs) override;
+
+  // Training isn't supported.
+  LossInfo Learn(const std::vector<TrainInputs>& inputs) override;
+  LossInfo Learn(const ReplayBuffer& replay_buffer, int batch_size,
+                 std::mt19937* rng) override;
+  std::string SaveCheckpoint(int step) override;
+
+  // Load the weights written alongside a VPNetModel checkpoint.
+  void LoadCheckpoint(const std::string& path) override;
+
+  // Inference calls already running finish with the old weights.
+  void SetWeights(const VPNetWeights& weights) override;
+  VPNetWeights GetWeights() override;
+
+  const std::string Device() const override { return device_; }
+
+ private:
+  struct Network;
+
+  std::string device_;
+  std::string nn_model_;
+  int nn_width_;
+  int nn_depth_;
+  std::vector<int> input_shape_;
+  int flat_input_size_;
+  int num_actions_;
+
+  absl::Mutex m_;
+  std::shared_ptr<const Network> network_;
+  std::shared_ptr<const VPNetWeights> weights_;
+};
+
+}  // namespace algorithms
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_NATIVE_VPNET_H_
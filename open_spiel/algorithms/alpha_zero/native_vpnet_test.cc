@@ -0,0 +1,304 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/alpha_zero/native_vpnet.h"
+
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+constexpr int kWidth = 8;
+constexpr int kDepth = 2;
+
+// Random weights for a model with the same variables as model.py builds.
+class WeightBuilder {
+ public:
+  explicit WeightBuilder(int seed) : rng_(seed) {}
+
+  void Dense(const std::string& name, int in, int out) {
+    Add(name + "/kernel", {in, out});
+    Add(name + "/bias", {out});
+  }
+
+  void ConvBatchNorm(const std::string& conv, const std::string& batch_norm,
+                     int size, int in, int out) {
+    Add(conv + "/kernel", {size, size, in, out});
+    Add(conv + "/bias", {out});
+    Add(batch_norm + "/gamma", {out});
+    Add(batch_norm + "/beta", {out});
+    Add(batch_norm + "/moving_mean", {out});
+    Add(batch_norm + "/moving_variance", {out}, /*positive=*/true);
+  }
+
+  VPNetWeights weights;
+
+ private:
+  void Add(const std::string& name, std::vector<int> shape,
+           bool positive = false) {
+    int size = 1;
+    for (int d : shape) size *= d;
+    VPNetWeight& w = weights[name];
+    w.shape = shape;
+    std::uniform_real_distribution<float> dist(positive ? 0.5 : -0.5, 1.0);
+    for (int i = 0; i < size; ++i) w.data.push_back(dist(rng_) * 0.5);
+  }
+
+  std::mt19937 rng_;
+};
+
+VPNetWeights RandomWeights(const Game& game, const std::string& nn_model) {
+  WeightBuilder b(1234);
+  int num_actions = game.NumDistinctActions();
+  if (nn_model == "mlp") {
+    int in = game.ObservationTensorSize();
+    for (int i = 0; i < kDepth; ++i) {
+      b.Dense(absl::StrCat("torso_", i, "_dense"), in, kWidth);
+      in = kWidth;
+    }
+    b.Dense("policy_dense", kWidth, kWidth);
+    b.Dense("policy", kWidth, num_actions);
+    b.Dense("value_dense", kWidth, kWidth);
+  } else {
+    std::vector<int> shape = game.ObservationTensorShape();
+    int pixels = shape[0] * shape[1];
+    if (nn_model == "resnet") {
+      b.ConvBatchNorm("torso_in_conv", "torso_in_batch_norm", 3, shape[2],
+                      kWidth);
+      for (int i = 0; i < kDepth; ++i) {
+        for (int j : {1, 2}) {
+          b.ConvBatchNorm(absl::StrCat("torso_", i, "_res_conv", j),
+                          absl::StrCat("torso_", i, "_res_batch_norm", j), 3,
+                          kWidth, kWidth);
+        }
+      }
+    } else {
+      int in = shape[2];
+      for (int i = 0; i < kDepth; ++i) {
+        b.ConvBatchNorm(absl::StrCat("torso_", i, "_conv"),
+                        absl::StrCat("torso_", i, "_batch_norm"), 3, in,
+                        kWidth);
+        in = kWidth;
+      }
+    }
+    b.ConvBatchNorm("policy_conv", "policy_batch_norm", 1, kWidth, 2);
+    b.ConvBatchNorm("value_conv", "value_batch_norm", 1, kWidth, 1);
+    b.Dense("policy", pixels * 2, num_actions);
+    b.Dense("value_dense", pixels, kWidth);
+  }
+  b.Dense("value", kWidth, 1);
+  return b.weights;
+}
+
+// A straightforward, unoptimized version of the model.py network for a single
+// example, to compare against.
+class Reference {
+ public:
+  Reference(const VPNetWeights& weights, std::vector<int> shape)
+      : w_(weights), shape_(shape) {}
+
+  std::vector<double> Dense(const std::vector<double>& input,
+                            const std::string& name, bool relu) const {
+    const VPNetWeight& kernel = w_.at(name + "/kernel");
+    const VPNetWeight& bias = w_.at(name + "/bias");
+    int in = kernel.shape[0], out = kernel.shape[1];
+    SPIEL_CHECK_EQ(input.size(), in);
+    std::vector<double> y(out);
+    for (int o = 0; o < out; ++o) {
+      double v = bias.data[o];
+      for (int i = 0; i < in; ++i) v += input[i] * kernel.data[i * out + o];
+      y[o] = relu ? std::max(v, 0.0) : v;
+    }
+    return y;
+  }
+
+  // Conv with same padding then batch norm, on a [height, width, in] input.
+  std::vector<double> ConvBatchNorm(const std::vector<double>& x,
+                                    const std::string& conv,
+                                    const std::string& batch_norm) const {
+    const VPNetWeight& kernel = w_.at(conv + "/kernel");
+    const VPNetWeight& bias = w_.at(conv + "/bias");
+    int size = kernel.shape[0], in = kernel.shape[2], out = kernel.shape[3];
+    int height = shape_[0], width = shape_[1];
+    std::vector<double> y(height * width * out);
+    for (int h = 0; h < height; ++h) {
+      for (int w = 0; w < width; ++w) {
+        for (int o = 0; o < out; ++o) {
+          double v = bias.data[o];
+          for (int dy = 0; dy < size; ++dy) {
+            for (int dx = 0; dx < size; ++dx) {
+              int sh = h + dy - size / 2, sw = w + dx - size / 2;
+              if (sh < 0 || sh >= height || sw < 0 || sw >= width) continue;
+              for (int i = 0; i < in; ++i) {
+                v += x[(sh * width + sw) * in + i] *
+                     kernel.data[((dy * size + dx) * in + i) * out + o];
+              }
+            }
+          }
+          v = (v - w_.at(batch_norm + "/moving_mean").data[o]) /
+              std::sqrt(w_.at(batch_norm + "/moving_variance").data[o] +
+                        1e-3);
+          v = v * w_.at(batch_norm + "/gamma").data[o] +
+              w_.at(batch_norm + "/beta").data[o];
+          y[(h * width + w) * out + o] = v;
+        }
+      }
+    }
+    return y;
+  }
+
+  static std::vector<double> Relu(std::vector<double> x) {
+    for (double& v : x) v = std::max(v, 0.0);
+    return x;
+  }
+
+ private:
+  const VPNetWeights& w_;
+  std::vector<int> shape_;
+};
+
+// Returns the value and the full policy logits for one observation.
+std::pair<double, std::vector<double>> ReferenceInference(
+    const VPNetWeights& weights, const Game& game, const std::string& nn_model,
+    const std::vector<double>& obs) {
+  Reference r(weights, game.ObservationTensorShape());
+  std::vector<double> policy_head, value_head;
+  if (nn_model == "mlp") {
+    std::vector<double> x = obs;
+    for (int i = 0; i < kDepth; ++i) {
+      x = r.Dense(x, absl::StrCat("torso_", i, "_dense"), true);
+    }
+    policy_head = r.Dense(x, "policy_dense", true);
+    value_head = x;
+  } else {
+    std::vector<double> x;
+    if (nn_model == "resnet") {
+      x = Reference::Relu(
+          r.ConvBatchNorm(obs, "torso_in_conv", "torso_in_batch_norm"));
+      for (int i = 0; i < kDepth; ++i) {
+        std::vector<double> y = Reference::Relu(r.ConvBatchNorm(
+            x, absl::StrCat("torso_", i, "_res_conv1"),
+            absl::StrCat("torso_", i, "_res_batch_norm1")));
+        y = r.ConvBatchNorm(y, absl::StrCat("torso_", i, "_res_conv2"),
+                            absl::StrCat("torso_", i, "_res_batch_norm2"));
+        for (int j = 0; j < y.size(); ++j) y[j] += x[j];
+        x = Reference::Relu(y);
+      }
+    } else {
+      x = obs;
+      for (int i = 0; i < kDepth; ++i) {
+        x = Reference::Relu(
+            r.ConvBatchNorm(x, absl::StrCat("torso_", i, "_conv"),
+                            absl::StrCat("torso_", i, "_batch_norm")));
+      }
+    }
+    policy_head = Reference::Relu(
+        r.ConvBatchNorm(x, "policy_conv", "policy_batch_norm"));
+    value_head = Reference::Relu(
+        r.ConvBatchNorm(x, "value_conv", "value_batch_norm"));
+  }
+  std::vector<double> logits = r.Dense(policy_head, "policy", false);
+  double value = std::tanh(
+      r.Dense(r.Dense(value_head, "value_dense", true), "value", false)[0]);
+  return {value, logits};
+}
+
+void TestNativeInferenceMatchesReference(const std::string& nn_model) {
+  std::cout << "TestNativeInferenceMatchesReference: " << nn_model
+            << std::endl;
+  std::shared_ptr<const Game> game = LoadGame("tic_tac_toe");
+  VPNetWeights weights = RandomWeights(*game, nn_model);
+  NativeVPNetModel model(*game, nn_model, kWidth, kDepth);
+  model.SetWeights(weights);
+
+  // A batch of states along a game, so the batch isn't a multiple of 4.
+  std::vector<VPNetModelBase::InferenceInputs> inputs;
+  std::unique_ptr<State> state = game->NewInitialState();
+  std::mt19937 rng(7);
+  while (!state->IsTerminal()) {
+    inputs.push_back({state->LegalActions(), state->ObservationTensor()});
+    std::vector<Action> legal_actions = state->LegalActions();
+    state->ApplyAction(legal_actions[rng() % legal_actions.size()]);
+  }
+  std::vector<VPNetModelBase::InferenceOutputs> outputs =
+      model.Inference(inputs);
+  SPIEL_CHECK_EQ(outputs.size(), inputs.size());
+
+  for (int b = 0; b < inputs.size(); ++b) {
+    auto [value, logits] =
+        ReferenceInference(weights, *game, nn_model, inputs[b].observations);
+    SPIEL_CHECK_FLOAT_NEAR(outputs[b].value, value, 1e-4);
+
+    double total = 0;
+    for (Action action : inputs[b].legal_actions) {
+      total += std::exp(logits[action]);
+    }
+    SPIEL_CHECK_EQ(outputs[b].policy.size(), inputs[b].legal_actions.size());
+    for (const auto& [action, prob] : outputs[b].policy) {
+      SPIEL_CHECK_FLOAT_NEAR(prob, std::exp(logits[action]) / total, 1e-4);
+    }
+  }
+}
+
+void TestWeightsRoundTrip() {
+  std::shared_ptr<const Game> game = LoadGame("tic_tac_toe");
+  VPNetWeights weights = RandomWeights(*game, "resnet");
+  std::string checkpoint = absl::StrCat(
+      file::GetTmpDir(), "/open_spiel-native-vpnet-test-", std::rand());
+  std::string path = checkpoint + ".weights";
+  SPIEL_CHECK_TRUE(WriteVPNetWeights(path, weights));
+  VPNetWeights loaded = ReadVPNetWeights(path);
+  SPIEL_CHECK_EQ(loaded.size(), weights.size());
+  for (const auto& [name, weight] : weights) {
+    SPIEL_CHECK_TRUE(loaded.contains(name));
+    SPIEL_CHECK_EQ(loaded[name].shape, weight.shape);
+    SPIEL_CHECK_EQ(loaded[name].data, weight.data);
+  }
+
+  // Loading a checkpoint picks up the weights file next to it.
+  NativeVPNetModel model(*game, "resnet", kWidth, kDepth);
+  model.LoadCheckpoint(checkpoint);
+  std::unique_ptr<State> state = game->NewInitialState();
+  model.Inference({{state->LegalActions(), state->ObservationTensor()}});
+  SPIEL_CHECK_TRUE(file::Remove(path));
+
+  // The model hands back exactly the weights it was given.
+  VPNetWeights current = model.GetWeights();
+  SPIEL_CHECK_EQ(current.size(), weights.size());
+  for (const auto& [name, weight] : weights) {
+    SPIEL_CHECK_EQ(current[name].data, weight.data);
+  }
+}
+
+}  // namespace
+}  // namespace algorithms
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::algorithms::TestNativeInferenceMatchesReference("mlp");
+  open_spiel::algorithms::TestNativeInferenceMatchesReference("conv2d");
+  open_spiel::algorithms::TestNativeInferenceMatchesReference("resnet");
+  open_spiel::algorithms::TestWeightsRoundTrip();
+}
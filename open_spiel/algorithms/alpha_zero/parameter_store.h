@@ -0,0 +1,95 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_PARAMETER_STORE_H_
+#define OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_PARAMETER_STORE_H_
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/algorithms/alpha_zero/vpnet_base.h"
+
+namespace open_spiel::algorithms {
+
+// An in-memory, versioned copy of the latest model weights. The learner
+// publishes new weights after each step and consumers pick up the newest
+// version whenever they're ready. Only the latest version is kept, so a slow
+// consumer skips intermediate versions rather than falling behind. Weights are
+// shared immutably, so readers never block the publisher for longer than a
+// pointer swap.
+class ParameterStore {
+ public:
+  struct Snapshot {
+    int64_t version;
+    std::shared_ptr<const VPNetWeights> weights;
+  };
+
+  // Publish new weights, returning their version. Versions start at 1.
+  int64_t Publish(VPNetWeights weights) {
+    auto shared = std::make_shared<const VPNetWeights>(std::move(weights));
+    absl::MutexLock lock(&m_);
+    latest_ = Snapshot{latest_.version + 1, std::move(shared)};
+    cv_.SignalAll();
+    return latest_.version;
+  }
+
+  // The latest weights, with version 0 and no weights if none were published.
+  Snapshot Latest() {
+    absl::MutexLock lock(&m_);
+    return latest_;
+  }
+
+  int64_t Version() {
+    absl::MutexLock lock(&m_);
+    return latest_.version;
+  }
+
+  // Wait for a version newer than `version`. Returns nullopt on hitting the
+  // deadline or if the store is closed.
+  std::optional<Snapshot> WaitForNewer(int64_t version, absl::Duration wait) {
+    return WaitForNewer(version, absl::Now() + wait);
+  }
+  std::optional<Snapshot> WaitForNewer(int64_t version, absl::Time deadline) {
+    absl::MutexLock lock(&m_);
+    while (latest_.version <= version) {
+      if (absl::Now() > deadline || closed_) {
+        return std::nullopt;
+      }
+      cv_.WaitWithDeadline(&m_, deadline);
+    }
+    return latest_;
+  }
+
+  // Wake up all waiters and make future waits return immediately. Useful for
+  // shutting down.
+  void Close() {
+    absl::MutexLock lock(&m_);
+    closed_ = true;
+    cv_.SignalAll();
+  }
+
+ private:
+  Snapshot latest_ = {0, nullptr};
+  bool closed_ = false;
+  absl::Mutex m_;
+  absl::CondVar cv_;
+};
+
+}  // namespace open_spiel::algorithms
+
+#endif  // OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_PARAMETER_STORE_H_
@@ -0,0 +1,77 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/alpha_zero/parameter_store.h"
+
+#include <optional>
+
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
+
+namespace open_spiel::algorithms {
+namespace {
+
+VPNetWeights MakeWeights(float value) {
+  VPNetWeights weights;
+  weights["w"] = VPNetWeight{{1}, {value}};
+  return weights;
+}
+
+void TestParameterStore() {
+  ParameterStore store;
+  SPIEL_CHECK_EQ(store.Version(), 0);
+  SPIEL_CHECK_TRUE(store.Latest().weights == nullptr);
+  SPIEL_CHECK_FALSE(store.WaitForNewer(0, absl::Milliseconds(1)));
+
+  SPIEL_CHECK_EQ(store.Publish(MakeWeights(1)), 1);
+  ParameterStore::Snapshot first = store.Latest();
+  SPIEL_CHECK_EQ(first.version, 1);
+  SPIEL_CHECK_EQ(first.weights->at("w").data[0], 1);
+
+  // Only the latest version is kept, but older snapshots stay valid.
+  SPIEL_CHECK_EQ(store.Publish(MakeWeights(2)), 2);
+  SPIEL_CHECK_EQ(store.Publish(MakeWeights(3)), 3);
+  std::optional<ParameterStore::Snapshot> newer =
+      store.WaitForNewer(1, absl::Milliseconds(1));
+  SPIEL_CHECK_TRUE(newer);
+  SPIEL_CHECK_EQ(newer->version, 3);
+  SPIEL_CHECK_EQ(newer->weights->at("w").data[0], 3);
+  SPIEL_CHECK_EQ(first.weights->at("w").data[0], 1);
+}
+
+void TestParameterStoreWaits() {
+  ParameterStore store;
+  std::optional<ParameterStore::Snapshot> result;
+  Thread waiter([&]() { result = store.WaitForNewer(0, absl::Seconds(60)); });
+  store.Publish(MakeWeights(4));
+  waiter.join();
+  SPIEL_CHECK_TRUE(result);
+  SPIEL_CHECK_EQ(result->version, 1);
+
+  // Closing wakes up waiters.
+  Thread closed_waiter(
+      [&]() { result = store.WaitForNewer(1, absl::Seconds(60)); });
+  store.Close();
+  closed_waiter.join();
+  SPIEL_CHECK_FALSE(result);
+}
+
+}  // namespace
+}  // namespace open_spiel::algorithms
+
+int main(int argc, char** argv) {
+  open_spiel::algorithms::TestParameterStore();
+  open_spiel::algorithms::TestParameterStoreWaits();
+}
@@ -0,0 +1,226 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/alpha_zero/replay_buffer.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_set.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel::algorithms {
+namespace {
+
+// Identifies replay buffer files, to avoid mapping something unrelated.
+constexpr uint64_t kMagic = 0x4655425f59414c50;
+constexpr int kVersion = 1;
+
+int64_t SlotStride(int observation_size, int num_actions, int mask_words) {
+  return mask_words * sizeof(uint64_t) +
+         // Round the floats up to keep every slot 8-byte aligned.
+         ((observation_size + num_actions + 1 + 1) / 2) * 2 * sizeof(float);
+}
+
+}  // namespace
+
+// Stored at the start of the buffer, and so at the start of the file.
+struct ReplayBuffer::Header {
+  uint64_t magic;
+  int32_t version;
+  int32_t observation_size;
+  int32_t num_actions;
+  int32_t max_size;
+  int64_t total_added;
+  char padding[32];
+};
+
+ReplayBuffer::ReplayBuffer(int observation_size, int num_actions, int max_size,
+                           const std::string& path)
+    : observation_size_(observation_size),
+      num_actions_(num_actions),
+      max_size_(max_size),
+      mask_words_((num_actions + 63) / 64),
+      stride_(SlotStride(observation_size, num_actions, mask_words_)),
+      length_(sizeof(Header) + stride_ * max_size) {
+  SPIEL_CHECK_GT(observation_size, 0);
+  SPIEL_CHECK_GT(num_actions, 0);
+  SPIEL_CHECK_GT(max_size, 0);
+  static_assert(sizeof(Header) == 64, "The header is part of the file format.");
+
+  if (path.empty()) {
+    storage_.resize(length_ / sizeof(uint64_t));
+    data_ = reinterpret_cast<char*>(storage_.data());
+  } else {
+    fd_ = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) {
+      SpielFatalError(absl::StrCat("Failed to open replay buffer: ", path));
+    }
+    struct stat st;
+    SPIEL_CHECK_EQ(fstat(fd_, &st), 0);
+    bool existing = st.st_size > 0;
+    if (existing && st.st_size != length_) {
+      SpielFatalError(absl::StrCat(
+          "Replay buffer ", path, " has size ", st.st_size, ", expected ",
+          length_, ". Was it created with a different game or buffer size?"));
+    }
+    if (!existing && ftruncate(fd_, length_) != 0) {
+      SpielFatalError(absl::StrCat("Failed to resize replay buffer: ", path));
+    }
+    void* addr = mmap(nullptr, length_, PROT_READ | PROT_WRITE, MAP_SHARED,
+                      fd_, 0);
+    if (addr == MAP_FAILED) {
+      SpielFatalError(absl::StrCat("Failed to mmap replay buffer: ", path));
+    }
+    data_ = static_cast<char*>(addr);
+    if (existing) {
+      const Header& h = header();
+      if (h.magic != kMagic || h.version != kVersion ||
+          h.observation_size != observation_size ||
+          h.num_actions != num_actions || h.max_size != max_size) {
+        SpielFatalError(absl::StrCat(
+            "Replay buffer ", path, " doesn't match the requested shape."));
+      }
+      return;
+    }
+  }
+
+  Header& h = header();
+  h.magic = kMagic;
+  h.version = kVersion;
+  h.observation_size = observation_size;
+  h.num_actions = num_actions;
+  h.max_size = max_size;
+  h.total_added = 0;
+}
+
+ReplayBuffer::~ReplayBuffer() {
+  if (fd_ >= 0) {
+    Flush();
+    munmap(data_, length_);
+    close(fd_);
+  }
+}
+
+const char* ReplayBuffer::Slot(int i) const {
+  return data_ + sizeof(Header) + stride_ * i;
+}
+
+char* ReplayBuffer::Slot(int i) {
+  return data_ + sizeof(Header) + stride_ * i;
+}
+
+const float* ReplayBuffer::SlotFloats(int i) const {
+  return reinterpret_cast<const float*>(Slot(i) +
+                                        mask_words_ * sizeof(uint64_t));
+}
+
+void ReplayBuffer::Add(absl::Span<const double> observation,
+                       absl::Span<const Action> legal_actions,
+                       const ActionsAndProbs& policy, double value) {
+  SPIEL_CHECK_EQ(observation.size(), observation_size_);
+  char* slot = Slot(header().total_added % max_size_);
+  std::memset(slot, 0, stride_);
+
+  uint64_t* mask = reinterpret_cast<uint64_t*>(slot);
+  for (Action action : legal_actions) {
+    SPIEL_CHECK_LT(action, num_actions_);
+    mask[action / 64] |= uint64_t{1} << (action % 64);
+  }
+
+  float* floats =
+      reinterpret_cast<float*>(slot + mask_words_ * sizeof(uint64_t));
+  std::copy(observation.begin(), observation.end(), floats);
+  float* policy_out = floats + observation_size_;
+  for (const auto& [action, prob] : policy) {
+    policy_out[action] = prob;
+  }
+  policy_out[num_actions_] = value;
+
+  // Only count the slot once it has been fully written.
+  header().total_added += 1;
+}
+
+int ReplayBuffer::Sample(std::mt19937* rng, int num, float* observations,
+                         bool* legal_mask, float* policy, float* value) const {
+  int size = Size();
+  num = std::min(num, size);
+
+  // Floyd's algorithm: `num` distinct indices in O(num), independent of the
+  // size of the buffer.
+  std::vector<int> indices;
+  indices.reserve(num);
+  absl::flat_hash_set<int> chosen;
+  chosen.reserve(num);
+  for (int j = size - num; j < size; ++j) {
+    int t = std::uniform_int_distribution<int>(0, j)(*rng);
+    int index = chosen.contains(t) ? j : t;
+    chosen.insert(index);
+    indices.push_back(index);
+  }
+
+  for (int b = 0; b < num; ++b) {
+    const char* slot = Slot(indices[b]);
+    const uint64_t* mask = reinterpret_cast<const uint64_t*>(slot);
+    for (int a = 0; a < num_actions_; ++a) {
+      legal_mask[b * num_actions_ + a] = (mask[a / 64] >> (a % 64)) & 1;
+    }
+    const float* floats = SlotFloats(indices[b]);
+    std::memcpy(observations + b * observation_size_, floats,
+                observation_size_ * sizeof(float));
+    std::memcpy(policy + b * num_actions_, floats + observation_size_,
+                num_actions_ * sizeof(float));
+    value[b] = floats[observation_size_ + num_actions_];
+  }
+  return num;
+}
+
+absl::Span<const float> ReplayBuffer::Observation(int i) const {
+  return absl::MakeConstSpan(SlotFloats(i), observation_size_);
+}
+
+absl::Span<const float> ReplayBuffer::Policy(int i) const {
+  return absl::MakeConstSpan(SlotFloats(i) + observation_size_, num_actions_);
+}
+
+bool ReplayBuffer::IsLegal(int i, Action action) const {
+  const uint64_t* mask = reinterpret_cast<const uint64_t*>(Slot(i));
+  return (mask[action / 64] >> (action % 64)) & 1;
+}
+
+float ReplayBuffer::Value(int i) const {
+  return SlotFloats(i)[observation_size_ + num_actions_];
+}
+
+bool ReplayBuffer::Flush() {
+  if (fd_ < 0) return true;
+  return msync(data_, length_, MS_SYNC) == 0;
+}
+
+int ReplayBuffer::Size() const {
+  return std::min<int64_t>(header().total_added, max_size_);
+}
+
+int64_t ReplayBuffer::TotalAdded() const { return header().total_added; }
+
+}  // namespace open_spiel::algorithms
@@ -0,0 +1,107 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_REPLAY_BUFFER_H_
+#define OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_REPLAY_BUFFER_H_
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/spiel.h"
+
+namespace open_spiel::algorithms {
+
+// A circular buffer of AlphaZero training examples. Each example lives in a
+// fixed-stride slot holding the legal actions as a bitmask followed by the
+// observation, the dense policy and the value as floats, so the whole buffer
+// is a single allocation regardless of how many states it holds.
+//
+// If a path is given, the slots are backed by a memory-mapped file at that
+// path. A later run with the same shape reopens the file and continues with
+// the buffer exactly as it was left, which lets a crashed or preempted run
+// resume training without refilling the buffer from scratch.
+class ReplayBuffer {
+ public:
+  ReplayBuffer(int observation_size, int num_actions, int max_size,
+               const std::string& path = "");
+  ~ReplayBuffer();
+
+  // ReplayBuffer owns its storage, so it is neither copyable nor movable.
+  ReplayBuffer(const ReplayBuffer&) = delete;
+  ReplayBuffer& operator=(const ReplayBuffer&) = delete;
+
+  // Add one example, replacing the oldest once it's full.
+  void Add(absl::Span<const double> observation,
+           absl::Span<const Action> legal_actions,
+           const ActionsAndProbs& policy, double value);
+
+  // Sample up to `num` examples without replacement and write them as rows of
+  // the given row-major arrays: observations [num, observation_size],
+  // legal_mask [num, num_actions], policy [num, num_actions], value [num].
+  // Returns the number of examples written, which is less than `num` only if
+  // the buffer holds fewer than `num` examples.
+  int Sample(std::mt19937* rng, int num, float* observations, bool* legal_mask,
+             float* policy, float* value) const;
+
+  // Access a single example from the buffer.
+  absl::Span<const float> Observation(int i) const;
+  absl::Span<const float> Policy(int i) const;
+  bool IsLegal(int i, Action action) const;
+  float Value(int i) const;
+
+  // Write the buffer back to its file, if it has one. Returns true on success.
+  bool Flush();
+
+  // How many elements are in the buffer.
+  int Size() const;
+
+  // Is the buffer empty?
+  bool Empty() const { return Size() == 0; }
+
+  // How many elements have ever been added to the buffer.
+  int64_t TotalAdded() const;
+
+  int ObservationSize() const { return observation_size_; }
+  int NumActions() const { return num_actions_; }
+  int MaxSize() const { return max_size_; }
+
+ private:
+  struct Header;
+
+  const Header& header() const {
+    return *reinterpret_cast<const Header*>(data_);
+  }
+  Header& header() { return *reinterpret_cast<Header*>(data_); }
+  const char* Slot(int i) const;
+  char* Slot(int i);
+  const float* SlotFloats(int i) const;
+
+  const int observation_size_;
+  const int num_actions_;
+  const int max_size_;
+  const int mask_words_;   // uint64_t words for the legal action bitmask.
+  const int64_t stride_;   // Bytes per slot.
+  const int64_t length_;   // Total bytes including the header.
+
+  char* data_ = nullptr;
+  int fd_ = -1;                     // Only used for the file backed buffer.
+  std::vector<uint64_t> storage_;   // Only used for the in-memory buffer.
+};
+
+}  // namespace open_spiel::algorithms
+
+#endif  // OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_REPLAY_BUFFER_H_
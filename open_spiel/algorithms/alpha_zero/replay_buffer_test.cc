@@ -0,0 +1,144 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/alpha_zero/replay_buffer.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+
+namespace open_spiel::algorithms {
+namespace {
+
+constexpr int kObservationSize = 3;
+constexpr int kNumActions = 70;  // More than one word of legal mask bits.
+
+// Add an example whose contents are all derived from `i`.
+void AddExample(ReplayBuffer* buffer, int i) {
+  buffer->Add({i * 1.0, i * 2.0, i * 3.0}, {i % kNumActions, 69},
+              {{i % kNumActions, 0.25}, {69, 0.75}}, i % 2 ? 1.0 : -1.0);
+}
+
+// Check that the example in slot `slot` was created by AddExample(i).
+void CheckExample(const ReplayBuffer& buffer, int slot, int i) {
+  SPIEL_CHECK_EQ(buffer.Observation(slot)[0], i * 1.0);
+  SPIEL_CHECK_EQ(buffer.Observation(slot)[2], i * 3.0);
+  SPIEL_CHECK_TRUE(buffer.IsLegal(slot, i % kNumActions));
+  SPIEL_CHECK_TRUE(buffer.IsLegal(slot, 69));
+  SPIEL_CHECK_FALSE(buffer.IsLegal(slot, (i + 1) % 69));
+  SPIEL_CHECK_EQ(buffer.Policy(slot)[i % kNumActions], 0.25);
+  SPIEL_CHECK_EQ(buffer.Policy(slot)[69], 0.75);
+  SPIEL_CHECK_EQ(buffer.Value(slot), i % 2 ? 1.0 : -1.0);
+}
+
+void TestReplayBuffer() {
+  ReplayBuffer buffer(kObservationSize, kNumActions, 4);
+  SPIEL_CHECK_TRUE(buffer.Empty());
+  SPIEL_CHECK_EQ(buffer.Size(), 0);
+
+  AddExample(&buffer, 1);
+  SPIEL_CHECK_FALSE(buffer.Empty());
+  SPIEL_CHECK_EQ(buffer.Size(), 1);
+  SPIEL_CHECK_EQ(buffer.TotalAdded(), 1);
+  CheckExample(buffer, 0, 1);
+
+  for (int i = 2; i <= 6; ++i) {
+    AddExample(&buffer, i);
+  }
+  SPIEL_CHECK_EQ(buffer.Size(), 4);
+  SPIEL_CHECK_EQ(buffer.TotalAdded(), 6);
+  CheckExample(buffer, 0, 5);
+  CheckExample(buffer, 1, 6);
+  CheckExample(buffer, 2, 3);
+  CheckExample(buffer, 3, 4);
+}
+
+void TestReplayBufferSample() {
+  ReplayBuffer buffer(kObservationSize, kNumActions, 8);
+  for (int i = 1; i <= 8; ++i) {
+    AddExample(&buffer, i);
+  }
+
+  std::mt19937 rng;
+  int num = 10;
+  std::vector<float> observations(num * kObservationSize);
+  std::vector<char> legal_mask(num * kNumActions);
+  std::vector<float> policy(num * kNumActions);
+  std::vector<float> value(num);
+  for (int rep = 0; rep < 20; ++rep) {
+    SPIEL_CHECK_EQ(
+        buffer.Sample(&rng, 5, observations.data(),
+                      reinterpret_cast<bool*>(legal_mask.data()),
+                      policy.data(), value.data()), 5);
+    std::vector<bool> seen(9, false);
+    for (int b = 0; b < 5; ++b) {
+      int i = observations[b * kObservationSize];
+      SPIEL_CHECK_GE(i, 1);
+      SPIEL_CHECK_LE(i, 8);
+      SPIEL_CHECK_FALSE(seen[i]);  // Sampled without replacement.
+      seen[i] = true;
+      SPIEL_CHECK_EQ(observations[b * kObservationSize + 1], i * 2.0);
+      SPIEL_CHECK_TRUE(legal_mask[b * kNumActions + i]);
+      SPIEL_CHECK_TRUE(legal_mask[b * kNumActions + 69]);
+      SPIEL_CHECK_FALSE(legal_mask[b * kNumActions + 0]);
+      SPIEL_CHECK_EQ(policy[b * kNumActions + i], 0.25);
+      SPIEL_CHECK_EQ(policy[b * kNumActions + 0], 0);
+      SPIEL_CHECK_EQ(value[b], i % 2 ? 1.0 : -1.0);
+    }
+  }
+
+  // Can't sample more than the buffer holds.
+  SPIEL_CHECK_EQ(
+      buffer.Sample(&rng, num, observations.data(),
+                    reinterpret_cast<bool*>(legal_mask.data()),
+                    policy.data(), value.data()), 8);
+}
+
+void TestReplayBufferPersistence() {
+  std::string path = absl::StrCat(file::GetTmpDir(), "/open_spiel-test-",
+                                  std::rand(), ".replay");
+  {
+    ReplayBuffer buffer(kObservationSize, kNumActions, 4, path);
+    SPIEL_CHECK_TRUE(buffer.Empty());
+    for (int i = 1; i <= 5; ++i) {
+      AddExample(&buffer, i);
+    }
+  }
+  SPIEL_CHECK_TRUE(file::Exists(path));
+  {
+    // Reopening resumes where the previous buffer left off.
+    ReplayBuffer buffer(kObservationSize, kNumActions, 4, path);
+    SPIEL_CHECK_EQ(buffer.Size(), 4);
+    SPIEL_CHECK_EQ(buffer.TotalAdded(), 5);
+    CheckExample(buffer, 0, 5);
+    CheckExample(buffer, 1, 2);
+    AddExample(&buffer, 6);
+    SPIEL_CHECK_TRUE(buffer.Flush());
+    CheckExample(buffer, 1, 6);
+  }
+  SPIEL_CHECK_TRUE(file::Remove(path));
+}
+
+}  // namespace
+}  // namespace open_spiel::algorithms
+
+int main(int argc, char** argv) {
+  open_spiel::algorithms::TestReplayBuffer();
+  open_spiel::algorithms::TestReplayBufferSample();
+  open_spiel::algorithms::TestReplayBufferPersistence();
+}
@@ -0,0 +1,274 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/alpha_zero/shared_memory.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <string>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel::algorithms {
+namespace {
+
+// The atomics live in memory shared between processes, so they must not
+// depend on a lock inside the process.
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(std::atomic<int64_t>::is_always_lock_free);
+
+constexpr uint64_t kRingMagic = 0x474e49525f5a4131;  // "1AZ_RING"
+constexpr uint64_t kBlobMagic = 0x424f4c425f5a4131;  // "1AZ_BLOB"
+constexpr int kVersion = 1;
+
+// Records are prefixed by their length.
+using RecordLength = uint32_t;
+
+// A writer starting with a different capacity, eg for a different model,
+// replaces the file rather than failing. Readers still mapping the old file
+// keep it until they reopen.
+const std::string& RemoveIfWrongSize(const std::string& path, int64_t size) {
+  struct stat st;
+  if (size > 0 && stat(path.c_str(), &st) == 0 && st.st_size != size) {
+    unlink(path.c_str());
+  }
+  return path;
+}
+
+}  // namespace
+
+MappedFile::MappedFile(const std::string& path, int64_t size,
+                       const std::function<void(char*)>& init)
+    : size_(size) {
+  fd_ = open(path.c_str(), O_RDWR);
+  if (fd_ < 0 && size > 0) {
+    // Set up the file under a temporary name and link it into place, so it
+    // only appears fully initialized. If another process won the race, use
+    // theirs instead.
+    std::string tmp_path = absl::StrCat(path, ".tmp.", getpid());
+    int fd = open(tmp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || ftruncate(fd, size) != 0) {
+      SpielFatalError(absl::StrCat("Failed to create ", tmp_path));
+    }
+    if (init) {
+      void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                        0);
+      if (addr == MAP_FAILED) {
+        SpielFatalError(absl::StrCat("Failed to mmap ", tmp_path));
+      }
+      init(static_cast<char*>(addr));
+      munmap(addr, size);
+    }
+    created_ = link(tmp_path.c_str(), path.c_str()) == 0;
+    unlink(tmp_path.c_str());
+    if (created_) {
+      fd_ = fd;
+    } else {
+      close(fd);
+      fd_ = open(path.c_str(), O_RDWR);
+    }
+  }
+  if (fd_ < 0) {
+    SpielFatalError(absl::StrCat("Failed to open ", path));
+  }
+
+  struct stat st;
+  SPIEL_CHECK_EQ(fstat(fd_, &st), 0);
+  if (size == 0) {
+    size_ = st.st_size;
+  } else if (st.st_size != size) {
+    SpielFatalError(absl::StrCat(path, " has size ", st.st_size, ", expected ",
+                                 size, "."));
+  }
+  void* addr =
+      mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if (addr == MAP_FAILED) {
+    SpielFatalError(absl::StrCat("Failed to mmap ", path));
+  }
+  data_ = static_cast<char*>(addr);
+}
+
+MappedFile::~MappedFile() {
+  munmap(data_, size_);
+  close(fd_);
+}
+
+// The reader and writer positions are on separate cache lines, so the two
+// processes don't contend on the same line. Positions count bytes ever
+// written or read, and wrap around the records modulo the capacity.
+struct SharedRing::Header {
+  uint64_t magic;
+  int32_t version;
+  int32_t padding0;
+  int64_t capacity;
+  alignas(64) std::atomic<uint64_t> head;  // Written by the writer.
+  alignas(64) std::atomic<uint64_t> tail;  // Written by the reader.
+  char padding1[56];
+};
+
+SharedRing::SharedRing(const std::string& path, int64_t capacity)
+    : file_(path, sizeof(Header) + capacity,
+            [capacity](char* data) {
+              Header* h = reinterpret_cast<Header*>(data);
+              h->magic = kRingMagic;
+              h->version = kVersion;
+              h->capacity = capacity;
+            }),
+      header_(reinterpret_cast<Header*>(file_.data())),
+      records_(file_.data() + sizeof(Header)),
+      capacity_(capacity) {
+  static_assert(sizeof(Header) == 192, "The header is part of the format.");
+  SPIEL_CHECK_GT(capacity, 0);
+  if (header_->magic != kRingMagic || header_->version != kVersion ||
+      header_->capacity != capacity) {
+    SpielFatalError(absl::StrCat(path, " isn't a ring of this capacity."));
+  }
+  uint64_t head = header_->head.load(std::memory_order_acquire);
+  uint64_t tail = header_->tail.load(std::memory_order_acquire);
+  if (head < tail || head - tail > capacity) {
+    SpielFatalError(absl::StrCat(path, " is corrupt."));
+  }
+}
+
+void SharedRing::CopyIn(uint64_t pos, const char* src, int64_t len) {
+  int64_t offset = pos % capacity_;
+  int64_t first = std::min(len, capacity_ - offset);
+  std::memcpy(records_ + offset, src, first);
+  std::memcpy(records_, src + first, len - first);
+}
+
+void SharedRing::CopyOut(uint64_t pos, char* dst, int64_t len) const {
+  int64_t offset = pos % capacity_;
+  int64_t first = std::min(len, capacity_ - offset);
+  std::memcpy(dst, records_ + offset, first);
+  std::memcpy(dst + first, records_, len - first);
+}
+
+bool SharedRing::Write(absl::string_view record, absl::Time deadline) {
+  int64_t needed = sizeof(RecordLength) + record.size();
+  if (needed > capacity_) {
+    SpielFatalError(absl::StrCat("Record of ", record.size(),
+                                 " bytes doesn't fit in the ring."));
+  }
+  uint64_t head = header_->head.load(std::memory_order_relaxed);
+  while (capacity_ - (head - header_->tail.load(std::memory_order_acquire)) <
+         needed) {
+    if (absl::Now() > deadline) return false;
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  RecordLength length = record.size();
+  CopyIn(head, reinterpret_cast<const char*>(&length), sizeof(length));
+  CopyIn(head + sizeof(length), record.data(), record.size());
+  // Publish the record only after it's completely written.
+  header_->head.store(head + needed, std::memory_order_release);
+  return true;
+}
+
+std::optional<std::string> SharedRing::Read() {
+  uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+  uint64_t head = header_->head.load(std::memory_order_acquire);
+  if (tail == head) return std::nullopt;
+  RecordLength length;
+  CopyOut(tail, reinterpret_cast<char*>(&length), sizeof(length));
+  SPIEL_CHECK_LE(sizeof(length) + length, head - tail);
+  std::string record(length, '\0');
+  CopyOut(tail + sizeof(length), record.data(), length);
+  // Only hand the space back to the writer once it's been copied out.
+  header_->tail.store(tail + sizeof(length) + length,
+                      std::memory_order_release);
+  return record;
+}
+
+// Two slots, written alternately, each guarded by a sequence number that is
+// odd while the slot is being written. A reader retries if the sequence
+// number changed while it was copying, ie a seqlock.
+struct SharedBlob::Header {
+  struct Slot {
+    alignas(64) std::atomic<uint64_t> sequence;
+    std::atomic<int64_t> size;
+  };
+
+  uint64_t magic;
+  int32_t version;
+  int32_t padding0;
+  int64_t capacity;
+  alignas(64) std::atomic<int64_t> published;
+  Slot slots[2];
+};
+
+SharedBlob::SharedBlob(const std::string& path, int64_t capacity)
+    : file_(RemoveIfWrongSize(
+                path, capacity == 0 ? 0 : sizeof(Header) + 2 * capacity),
+            capacity == 0 ? 0 : sizeof(Header) + 2 * capacity,
+            [capacity](char* data) {
+              Header* h = reinterpret_cast<Header*>(data);
+              h->magic = kBlobMagic;
+              h->version = kVersion;
+              h->capacity = capacity;
+            }),
+      header_(reinterpret_cast<Header*>(file_.data())),
+      slots_(file_.data() + sizeof(Header)),
+      capacity_(header_->capacity) {
+  static_assert(sizeof(Header) == 256, "The header is part of the format.");
+  if (header_->magic != kBlobMagic || header_->version != kVersion ||
+      file_.size() != sizeof(Header) + 2 * capacity_) {
+    SpielFatalError(absl::StrCat(path, " isn't a shared blob."));
+  }
+}
+
+int64_t SharedBlob::Publish(absl::string_view data) {
+  SPIEL_CHECK_LE(data.size(), capacity_);
+  int64_t version = header_->published.load(std::memory_order_relaxed) + 1;
+  Header::Slot& slot = header_->slots[version % 2];
+  slot.sequence.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.size.store(data.size(), std::memory_order_relaxed);
+  std::memcpy(slots_ + (version % 2) * capacity_, data.data(), data.size());
+  slot.sequence.fetch_add(1, std::memory_order_release);
+  header_->published.store(version, std::memory_order_release);
+  return version;
+}
+
+int64_t SharedBlob::Version() const {
+  return header_->published.load(std::memory_order_acquire);
+}
+
+std::optional<std::pair<int64_t, std::string>> SharedBlob::Read() const {
+  std::string data;
+  while (true) {
+    int64_t version = header_->published.load(std::memory_order_acquire);
+    if (version == 0) return std::nullopt;
+    const Header::Slot& slot = header_->slots[version % 2];
+    uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence % 2 == 1) continue;  // Being written; a newer one is coming.
+    int64_t size = std::min(slot.size.load(std::memory_order_relaxed),
+                            capacity_);
+    data.resize(size);
+    std::memcpy(data.data(), slots_ + (version % 2) * capacity_, size);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) == sequence) {
+      return std::make_pair(version, std::move(data));
+    }
+  }
+}
+
+}  // namespace open_spiel::algorithms
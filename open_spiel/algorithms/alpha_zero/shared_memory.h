@@ -0,0 +1,125 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_SHARED_MEMORY_H_
+#define OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_SHARED_MEMORY_H_
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+
+// Primitives for passing data between processes on the same host through
+// memory-mapped files. Nothing here takes a lock, so a process that dies at
+// any point can't block the others, and a restarted process picks up where
+// its predecessor left off. Put the files on a tmpfs, eg /dev/shm, to keep
+// them from being written back to disk.
+
+namespace open_spiel::algorithms {
+
+// A memory-mapped file, created with the given size if it doesn't exist.
+class MappedFile {
+ public:
+  // If `size` is 0 the file must already exist, and is mapped at its size.
+  // Otherwise a new file is filled in by `init` before it appears at `path`,
+  // so other processes never see it half initialized.
+  MappedFile(const std::string& path, int64_t size,
+             const std::function<void(char*)>& init = nullptr);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  char* data() const { return data_; }
+  int64_t size() const { return size_; }
+
+  // Whether the file was created, or was already there.
+  bool created() const { return created_; }
+
+ private:
+  char* data_ = nullptr;
+  int64_t size_;
+  bool created_ = false;
+  int fd_ = -1;
+};
+
+// A queue of variable sized records with a single writer and single reader,
+// possibly in different processes. Records are only visible to the reader
+// once they are completely written, so a writer that crashes midway loses at
+// most the record it was writing.
+class SharedRing {
+ public:
+  // Opens the ring at `path`, creating it with room for `capacity` bytes of
+  // records if it doesn't exist.
+  SharedRing(const std::string& path, int64_t capacity);
+
+  // Append a record, waiting until `deadline` for room. Returns false if it
+  // timed out.
+  bool Write(absl::string_view record, absl::Time deadline);
+
+  // Take the oldest record, or nullopt if there is none. Doesn't wait.
+  std::optional<std::string> Read();
+
+  int64_t Capacity() const { return capacity_; }
+
+ private:
+  struct Header;
+
+  void CopyIn(uint64_t pos, const char* src, int64_t len);
+  void CopyOut(uint64_t pos, char* dst, int64_t len) const;
+
+  MappedFile file_;
+  Header* header_;
+  char* records_;
+  int64_t capacity_;
+};
+
+// The latest version of a blob, eg model weights, written by one process and
+// read by any number of others. The writer never waits for readers; a reader
+// that overlaps a write retries.
+class SharedBlob {
+ public:
+  // The writer creates the blob with room for `capacity` bytes. Readers pass
+  // 0 to open an existing one.
+  SharedBlob(const std::string& path, int64_t capacity);
+
+  // Replace the contents, returning the new version. Versions start at 1 and
+  // continue across restarts of the writer.
+  int64_t Publish(absl::string_view data);
+
+  // The latest version, or 0 if nothing was published yet.
+  int64_t Version() const;
+
+  // Copy out the latest contents and their version, or nullopt if nothing was
+  // published yet.
+  std::optional<std::pair<int64_t, std::string>> Read() const;
+
+  int64_t Capacity() const { return capacity_; }
+
+ private:
+  struct Header;
+
+  MappedFile file_;
+  Header* header_;
+  char* slots_;
+  int64_t capacity_;
+};
+
+}  // namespace open_spiel::algorithms
+
+#endif  // OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_SHARED_MEMORY_H_
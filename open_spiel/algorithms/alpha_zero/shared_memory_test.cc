@@ -0,0 +1,154 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/alpha_zero/shared_memory.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <optional>
+#include <string>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+
+namespace open_spiel::algorithms {
+namespace {
+
+std::string TmpPath(const std::string& name) {
+  return absl::StrCat(file::GetTmpDir(), "/open_spiel-shared-memory-test-",
+                      name, "-", getpid());
+}
+
+void TestRing() {
+  std::string path = TmpPath("ring");
+  {
+    SharedRing ring(path, 16);
+    SPIEL_CHECK_FALSE(ring.Read());
+    SPIEL_CHECK_TRUE(ring.Write("hello", absl::Now()));
+    // 4 + 5 bytes used, so another 4 + 5 doesn't fit.
+    SPIEL_CHECK_FALSE(ring.Write("world", absl::Now()));
+    SPIEL_CHECK_EQ(*ring.Read(), "hello");
+    // This one wraps around the end.
+    SPIEL_CHECK_TRUE(ring.Write("world", absl::Now()));
+    SPIEL_CHECK_TRUE(ring.Write("", absl::Now()));
+  }
+  {
+    // Reopening continues where it left off.
+    SharedRing ring(path, 16);
+    SPIEL_CHECK_EQ(*ring.Read(), "world");
+    SPIEL_CHECK_EQ(*ring.Read(), "");
+    SPIEL_CHECK_FALSE(ring.Read());
+  }
+  SPIEL_CHECK_TRUE(file::Remove(path));
+}
+
+void TestRingAcrossProcesses() {
+  std::string path = TmpPath("ring-processes");
+  constexpr int kRecords = 10000;
+  SharedRing ring(path, 1000);
+  pid_t pid = fork();
+  SPIEL_CHECK_GE(pid, 0);
+  if (pid == 0) {
+    SharedRing writer(path, 1000);
+    for (int i = 0; i < kRecords; ++i) {
+      // Vary the sizes so records wrap at different offsets.
+      std::string record = absl::StrCat(i, std::string(i % 37, 'x'));
+      if (!writer.Write(record, absl::Now() + absl::Seconds(60))) _exit(1);
+    }
+    _exit(0);
+  }
+  for (int i = 0; i < kRecords;) {
+    std::optional<std::string> record = ring.Read();
+    if (!record) continue;
+    SPIEL_CHECK_EQ(*record, absl::StrCat(i, std::string(i % 37, 'x')));
+    ++i;
+  }
+  int status;
+  SPIEL_CHECK_EQ(waitpid(pid, &status, 0), pid);
+  SPIEL_CHECK_EQ(status, 0);
+  SPIEL_CHECK_TRUE(file::Remove(path));
+}
+
+void TestBlob() {
+  std::string path = TmpPath("blob");
+  {
+    SharedBlob writer(path, 8);
+    SharedBlob reader(path, 0);
+    SPIEL_CHECK_EQ(reader.Capacity(), 8);
+    SPIEL_CHECK_EQ(reader.Version(), 0);
+    SPIEL_CHECK_FALSE(reader.Read());
+    SPIEL_CHECK_EQ(writer.Publish("one"), 1);
+    SPIEL_CHECK_EQ(writer.Publish("two"), 2);
+    auto latest = reader.Read();
+    SPIEL_CHECK_TRUE(latest);
+    SPIEL_CHECK_EQ(latest->first, 2);
+    SPIEL_CHECK_EQ(latest->second, "two");
+  }
+  {
+    // A restarted writer continues the versions.
+    SharedBlob writer(path, 8);
+    SPIEL_CHECK_EQ(writer.Publish("three"), 3);
+  }
+  {
+    // A writer with a new capacity starts over.
+    SharedBlob writer(path, 16);
+    SPIEL_CHECK_EQ(writer.Version(), 0);
+  }
+  SPIEL_CHECK_TRUE(file::Remove(path));
+}
+
+void TestBlobAcrossProcesses() {
+  // Readers must never see a mix of two versions.
+  std::string path = TmpPath("blob-processes");
+  constexpr int kSize = 1 << 16;
+  SharedBlob writer(path, kSize);
+  writer.Publish(std::string(kSize, 'a'));
+  pid_t pid = fork();
+  SPIEL_CHECK_GE(pid, 0);
+  if (pid == 0) {
+    SharedBlob reader(path, 0);
+    int64_t last = 0;
+    while (last < 1000) {
+      auto [version, data] = *reader.Read();
+      if (version < last) _exit(1);
+      for (char c : data) {
+        if (c != data[0]) _exit(2);
+      }
+      last = version;
+    }
+    _exit(0);
+  }
+  for (int i = 0; i < 2000; ++i) {
+    writer.Publish(std::string(kSize, 'a' + i % 26));
+  }
+  int status;
+  SPIEL_CHECK_EQ(waitpid(pid, &status, 0), pid);
+  SPIEL_CHECK_EQ(status, 0);
+  SPIEL_CHECK_TRUE(file::Remove(path));
+}
+
+}  // namespace
+}  // namespace open_spiel::algorithms
+
+int main(int argc, char** argv) {
+  open_spiel::algorithms::TestRing();
+  open_spiel::algorithms::TestRingAcrossProcesses();
+  open_spiel::algorithms::TestBlob();
+  open_spiel::algorithms::TestBlobAcrossProcesses();
+}
@@ -18,6 +18,7 @@
 #include <memory>
 
 #include "open_spiel/abseil-cpp/absl/hash/hash.h"
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
 #include "open_spiel/abseil-cpp/absl/time/time.h"
 #include "open_spiel/utils/stats.h"
 
@@ -25,14 +26,15 @@ namespace open_spiel {
 namespace algorithms {
 
 VPNetEvaluator::VPNetEvaluator(DeviceManager* device_manager, int batch_size,
-                               int threads, int cache_size, int cache_shards)
+                               int threads, int cache_size, int cache_shards,
+                               absl::Duration max_wait)
     : device_manager_(*device_manager), batch_size_(batch_size),
-      queue_(batch_size * threads * 4), batch_size_hist_(batch_size + 1) {
+      scheduler_(batch_size, max_wait, batch_size * threads * 4) {
   cache_shards = std::max(1, cache_shards);
   cache_.reserve(cache_shards);
   for (int i = 0; i < cache_shards; ++i) {
     cache_.push_back(
-        std::make_unique<LRUCache<uint64_t, VPNetModel::InferenceOutputs>>(
+        std::make_unique<LRUCache<uint64_t, VPNetModelBase::InferenceOutputs>>(
             cache_size / cache_shards));
   }
   if (batch_size_ <= 1) {
@@ -46,8 +48,8 @@ VPNetEvaluator::VPNetEvaluator(DeviceManager* device_manager, int batch_size,
 
 VPNetEvaluator::~VPNetEvaluator() {
   stop_.Stop();
-  queue_.BlockNewValues();
-  queue_.Clear();
+  scheduler_.Close();
+  scheduler_.Clear();
   for (auto& t : inference_threads_) {
     t.join();
   }
@@ -68,37 +70,48 @@ LRUCacheInfo VPNetEvaluator::CacheInfo() {
 }
 
 std::vector<double> VPNetEvaluator::Evaluate(const State& state) {
+  return Evaluate(state, Priority::kNormal);
+}
+
+open_spiel::ActionsAndProbs VPNetEvaluator::Prior(const State& state) {
+  return Prior(state, Priority::kNormal);
+}
+
+std::vector<double> VPNetEvaluator::Evaluate(const State& state,
+                                             Priority priority) {
   // TODO(author5): currently assumes zero-sum.
-  double p0value = Inference(state).value;
+  double p0value = Inference(state, priority).value;
   return {p0value, -p0value};
 }
 
-open_spiel::ActionsAndProbs VPNetEvaluator::Prior(const State& state) {
-  return Inference(state).policy;
+open_spiel::ActionsAndProbs VPNetEvaluator::Prior(const State& state,
+                                                  Priority priority) {
+  return Inference(state, priority).policy;
 }
 
-VPNetModel::InferenceOutputs VPNetEvaluator::Inference(const State& state) {
-  VPNetModel::InferenceInputs inputs = {
+VPNetModelBase::InferenceOutputs VPNetEvaluator::Inference(const State& state,
+                                                           Priority priority) {
+  VPNetModelBase::InferenceInputs inputs = {
     state.LegalActions(), state.ObservationTensor()};
 
   uint64_t key;
   int cache_shard;
   if (!cache_.empty()) {
-    key = absl::Hash<VPNetModel::InferenceInputs>{}(inputs);
+    key = absl::Hash<VPNetModelBase::InferenceInputs>{}(inputs);
     cache_shard = key % cache_.size();
-    std::optional<const VPNetModel::InferenceOutputs> opt_outputs =
+    std::optional<const VPNetModelBase::InferenceOutputs> opt_outputs =
         cache_[cache_shard]->Get(key);
     if (opt_outputs) {
       return *opt_outputs;
     }
   }
-  VPNetModel::InferenceOutputs outputs;
+  VPNetModelBase::InferenceOutputs outputs;
   if (batch_size_ <= 1) {
     outputs = device_manager_.Get(1)->Inference(std::vector{inputs})[0];
   } else {
-    std::promise<VPNetModel::InferenceOutputs> prom;
-    std::future<VPNetModel::InferenceOutputs> fut = prom.get_future();
-    queue_.Push(QueueItem{inputs, &prom});
+    std::promise<VPNetModelBase::InferenceOutputs> prom;
+    std::future<VPNetModelBase::InferenceOutputs> fut = prom.get_future();
+    scheduler_.Push(QueueItem{inputs, &prom}, priority);
     outputs = fut.get();
   }
   if (!cache_.empty()) {
@@ -108,63 +121,47 @@ VPNetModel::InferenceOutputs VPNetEvaluator::Inference(const State& state) {
 }
 
 void VPNetEvaluator::Runner() {
-  std::vector<VPNetModel::InferenceInputs> inputs;
-  std::vector<std::promise<VPNetModel::InferenceOutputs>*> promises;
+  std::vector<VPNetModelBase::InferenceInputs> inputs;
   inputs.reserve(batch_size_);
-  promises.reserve(batch_size_);
   while (!stop_.StopRequested()) {
+    std::vector<QueueItem> batch;
     {
       // Only one thread at a time should be listening to the queue to maximize
       // batch size and minimize latency.
       absl::MutexLock lock(&inference_queue_m_);
-      absl::Time deadline = absl::Now() + absl::InfiniteDuration();
-      for (int i = 0; i < batch_size_; ++i) {
-        std::optional<QueueItem> item = queue_.Pop(deadline);
-        if (!item) {  // Hit the deadline.
-          break;
-        }
-        if (inputs.empty()) {
-          deadline = absl::Now() + absl::Milliseconds(1);
-        }
-        inputs.push_back(item->inputs);
-        promises.push_back(item->prom);
-      }
+      batch = scheduler_.PopBatch();
     }
 
-    if (inputs.empty()) {  // Almost certainly StopRequested.
+    if (batch.empty()) {  // Almost certainly StopRequested.
       continue;
     }
 
-    {
-      absl::MutexLock lock(&stats_m_);
-      batch_size_stats_.Add(inputs.size());
-      batch_size_hist_.Add(inputs.size());
+    for (QueueItem& item : batch) {
+      inputs.push_back(std::move(item.inputs));
     }
-
-    std::vector<VPNetModel::InferenceOutputs> outputs =
+    absl::Time start = absl::Now();
+    std::vector<VPNetModelBase::InferenceOutputs> outputs =
         device_manager_.Get(inputs.size())->Inference(inputs);
-    for (int i = 0; i < promises.size(); ++i) {
-      promises[i]->set_value(outputs[i]);
+    scheduler_.RecordLatency(absl::Now() - start);
+    for (int i = 0; i < batch.size(); ++i) {
+      batch[i].prom->set_value(outputs[i]);
     }
     inputs.clear();
-    promises.clear();
   }
 }
 
-void VPNetEvaluator::ResetBatchSizeStats() {
-  absl::MutexLock lock(&stats_m_);
-  batch_size_stats_.Reset();
-  batch_size_hist_.Reset();
-}
+void VPNetEvaluator::ResetBatchSizeStats() { scheduler_.ResetStats(); }
 
 open_spiel::BasicStats VPNetEvaluator::BatchSizeStats() {
-  absl::MutexLock lock(&stats_m_);
-  return batch_size_stats_;
+  return scheduler_.BatchSizeStats();
 }
 
 open_spiel::HistogramNumbered VPNetEvaluator::BatchSizeHistogram() {
-  absl::MutexLock lock(&stats_m_);
-  return batch_size_hist_;
+  return scheduler_.BatchSizeHistogram();
+}
+
+json::Object VPNetEvaluator::SchedulerStats() {
+  return scheduler_.StatsJson();
 }
 
 }  // namespace algorithms
@@ -16,25 +16,38 @@
 #define OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_VPEVALUATOR_H_
 
 #include <future>  // NOLINT
+#include <memory>
 #include <vector>
 
 #include "open_spiel/abseil-cpp/absl/hash/hash.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/algorithms/alpha_zero/batch_scheduler.h"
 #include "open_spiel/algorithms/alpha_zero/device_manager.h"
-#include "open_spiel/algorithms/alpha_zero/vpnet.h"
+#include "open_spiel/algorithms/alpha_zero/vpnet_base.h"
 #include "open_spiel/algorithms/mcts.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/utils/lru_cache.h"
 #include "open_spiel/utils/stats.h"
+#include "open_spiel/utils/json.h"
 #include "open_spiel/utils/thread.h"
-#include "open_spiel/utils/threaded_queue.h"
 
 namespace open_spiel {
 namespace algorithms {
 
+// Batches inference requests from many threads. A batch waits at most
+// `max_wait` for more requests, see BatchScheduler.
 class VPNetEvaluator : public Evaluator {
  public:
+  struct QueueItem {
+    VPNetModelBase::InferenceInputs inputs;
+    std::promise<VPNetModelBase::InferenceOutputs>* prom;
+  };
+  using Scheduler = BatchScheduler<QueueItem>;
+  using Priority = Scheduler::Priority;
+
   explicit VPNetEvaluator(DeviceManager* device_manager, int batch_size,
-                          int threads, int cache_size, int cache_shards = 1);
+                          int threads, int cache_size, int cache_shards = 1,
+                          absl::Duration max_wait = absl::Milliseconds(1));
   ~VPNetEvaluator() override;
 
   // Return a value of this state for each player.
@@ -43,6 +56,10 @@ class VPNetEvaluator : public Evaluator {
   // Return a policy: the probability of the current player playing each action.
   ActionsAndProbs Prior(const State& state) override;
 
+  // The same, but with the given priority in the batch queue.
+  std::vector<double> Evaluate(const State& state, Priority priority);
+  ActionsAndProbs Prior(const State& state, Priority priority);
+
   void ClearCache();
   LRUCacheInfo CacheInfo();
 
@@ -50,29 +67,43 @@ class VPNetEvaluator : public Evaluator {
   open_spiel::BasicStats BatchSizeStats();
   open_spiel::HistogramNumbered BatchSizeHistogram();
 
+  // Batch sizes and targets, queueing and inference times.
+  json::Object SchedulerStats();
+
  private:
-  VPNetModel::InferenceOutputs Inference(const State& state);
+  VPNetModelBase::InferenceOutputs Inference(const State& state,
+                                             Priority priority);
 
   void Runner();
 
   DeviceManager& device_manager_;
-  std::vector<std::unique_ptr<LRUCache<uint64_t, VPNetModel::InferenceOutputs>>>
+  std::vector<
+      std::unique_ptr<LRUCache<uint64_t, VPNetModelBase::InferenceOutputs>>>
       cache_;
   const int batch_size_;
 
-  struct QueueItem {
-    VPNetModel::InferenceInputs inputs;
-    std::promise<VPNetModel::InferenceOutputs>* prom;
-  };
-
-  ThreadedQueue<QueueItem> queue_;
+  Scheduler scheduler_;
   StopToken stop_;
   std::vector<Thread> inference_threads_;
   absl::Mutex inference_queue_m_;  // Only one thread at a time should pop.
+};
+
+// Forwards to a VPNetEvaluator with high priority, eg for evaluation games
+// where each search waits on its own results rather than being one of many.
+class HighPriorityVPNetEvaluator : public Evaluator {
+ public:
+  explicit HighPriorityVPNetEvaluator(std::shared_ptr<VPNetEvaluator> eval)
+      : eval_(std::move(eval)) {}
+
+  std::vector<double> Evaluate(const State& state) override {
+    return eval_->Evaluate(state, VPNetEvaluator::Priority::kHigh);
+  }
+  ActionsAndProbs Prior(const State& state) override {
+    return eval_->Prior(state, VPNetEvaluator::Priority::kHigh);
+  }
 
-  absl::Mutex stats_m_;
-  open_spiel::BasicStats batch_size_stats_;
-  open_spiel::HistogramNumbered batch_size_hist_;
+ private:
+  std::shared_ptr<VPNetEvaluator> eval_;
 };
 
 }  // namespace algorithms
@@ -22,13 +22,17 @@
 #include <string>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/algorithm/container.h"
+#include "open_spiel/abseil-cpp/absl/strings/match.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_join.h"
 #include "third_party/eigen3/unsupported/Eigen/CXX11/src/Tensor/TensorMap.h"
+#include "open_spiel/algorithms/alpha_zero/native_vpnet.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
 #include "open_spiel/utils/file.h"
 #include "open_spiel/utils/run_python.h"
+#include "tensorflow/core/framework/variable.pb.h"
 #include "tensorflow/core/graph/default_device.h"
 #include "tensorflow/core/protobuf/saver.proto.h"
 
@@ -90,9 +94,36 @@ VPNetModel::VPNetModel(const Game& game, const std::string& path,
 
   // Initialize our variables
   TF_CHECK_OK(tf_session_->Run({}, {}, {"init_all_vars_op"}, nullptr));
+
+  // The trainable variables plus the batch norm statistics are everything
+  // needed for inference. Skip the optimizer's state.
+  const auto& collections = meta_graph_def_.collection_def();
+  for (const std::string& collection : {"variables", "trainable_variables"}) {
+    auto it = collections.find(collection);
+    if (it == collections.end()) continue;
+    for (const std::string& bytes : it->second.bytes_list().value()) {
+      tf::VariableDef def;
+      SPIEL_CHECK_TRUE(def.ParseFromString(bytes));
+      std::string name = def.variable_name();
+      if (absl::EndsWith(name, ":0")) name.resize(name.size() - 2);
+      bool needed = collection == "trainable_variables" ||
+                    absl::EndsWith(name, "/moving_mean") ||
+                    absl::EndsWith(name, "/moving_variance");
+      if (needed && absl::c_none_of(variables_, [&name](const Variable& v) {
+            return v.name == name;
+          })) {
+        variables_.push_back(Variable{name, def.snapshot_name(),
+                                      def.initializer_name(),
+                                      def.initial_value_name()});
+      }
+    }
+  }
 }
 
 std::string VPNetModel::SaveCheckpoint(int step) {
+  // Learning may continue on another thread, but not while saving, so the
+  // checkpoint is a consistent snapshot.
+  absl::ReaderMutexLock lock(&train_m_);
   std::string full_path = absl::StrCat(path_, "/checkpoint-", step);
   tensorflow::Tensor checkpoint_path(tf::DT_STRING, tf::TensorShape());
   checkpoint_path.scalar<tensorflow::tstring>()() = full_path;
@@ -103,12 +134,66 @@ std::string VPNetModel::SaveCheckpoint(int step) {
   // doesn't, so do it manually to make loading checkpoints easier.
   file::File(absl::StrCat(full_path, ".meta"), "w").Write(
       model_meta_graph_contents_);
+  // Also write the weights in a form NativeVPNetModel can load without
+  // TensorFlow.
+  SPIEL_CHECK_TRUE(
+      WriteVPNetWeights(absl::StrCat(full_path, ".weights"), ReadWeights()));
   return full_path;
 }
 
+VPNetWeights VPNetModel::GetWeights() {
+  absl::ReaderMutexLock lock(&train_m_);
+  return ReadWeights();
+}
+
+VPNetWeights VPNetModel::ReadWeights() {
+  std::vector<std::string> snapshots;
+  snapshots.reserve(variables_.size());
+  for (const Variable& variable : variables_) {
+    snapshots.push_back(variable.snapshot);
+  }
+  std::vector<tf::Tensor> tf_outputs;
+  TF_CHECK_OK(tf_session_->Run({}, snapshots, {}, &tf_outputs));
+
+  VPNetWeights weights;
+  for (int i = 0; i < variables_.size(); ++i) {
+    VPNetWeight& weight = weights[variables_[i].name];
+    for (int d = 0; d < tf_outputs[i].dims(); ++d) {
+      weight.shape.push_back(tf_outputs[i].dim_size(d));
+    }
+    auto flat = tf_outputs[i].flat<float>();
+    weight.data.assign(flat.data(), flat.data() + flat.size());
+  }
+  return weights;
+}
+
+void VPNetModel::SetWeights(const VPNetWeights& weights) {
+  // Assign each variable by running its initializer with the initial value
+  // replaced by the new weights.
+  std::vector<std::pair<std::string, tf::Tensor>> feeds;
+  std::vector<std::string> initializers;
+  for (const Variable& variable : variables_) {
+    auto it = weights.find(variable.name);
+    if (it == weights.end()) {
+      SpielFatalError(absl::StrCat("Missing weight: ", variable.name));
+    }
+    tf::TensorShape shape;
+    for (int dim : it->second.shape) shape.AddDim(dim);
+    tf::Tensor tensor(tf::DT_FLOAT, shape);
+    SPIEL_CHECK_EQ(tensor.NumElements(), it->second.data.size());
+    std::copy(it->second.data.begin(), it->second.data.end(),
+              tensor.flat<float>().data());
+    feeds.emplace_back(variable.initial_value, std::move(tensor));
+    initializers.push_back(variable.initializer);
+  }
+  absl::WriterMutexLock lock(&weights_m_);
+  TF_CHECK_OK(tf_session_->Run(feeds, {}, initializers, nullptr));
+}
+
 void VPNetModel::LoadCheckpoint(const std::string& path) {
   tf::Tensor checkpoint_path(tf::DT_STRING, tf::TensorShape());
   checkpoint_path.scalar<tensorflow::tstring>()() = path;
+  absl::WriterMutexLock lock(&weights_m_);
   TF_CHECK_OK(tf_session_->Run(
       {{meta_graph_def_.saver_def().filename_tensor_name(), checkpoint_path}},
       {}, {meta_graph_def_.saver_def().restore_op_name()}, nullptr));
@@ -142,6 +227,7 @@ std::vector<VPNetModel::InferenceOutputs> VPNetModel::Inference(
 
   // Run the inference
   std::vector<tensorflow::Tensor> tf_outputs;
+  absl::ReaderMutexLock lock(&weights_m_);
   TF_CHECK_OK(tf_session_->Run(
       {{"input", tf_inf_inputs}, {"legals_mask", tf_inf_legal_mask},
        {"training", tensorflow::Tensor(false)}},
@@ -207,12 +293,48 @@ VPNetModel::LossInfo VPNetModel::Learn(const std::vector<TrainInputs>& inputs) {
     value_targets_matrix(b, 0) = inputs[b].value;
   }
 
+  return RunTrainStep(tf_train_inputs, tf_train_legal_mask,
+                      tf_policy_targets, tf_value_targets);
+}
+
+VPNetModel::LossInfo VPNetModel::Learn(const ReplayBuffer& replay_buffer,
+                                       int batch_size, std::mt19937* rng) {
+  SPIEL_CHECK_EQ(replay_buffer.ObservationSize(), flat_input_size_);
+  SPIEL_CHECK_EQ(replay_buffer.NumActions(), num_actions_);
+  int training_batch_size = std::min(batch_size, replay_buffer.Size());
+
+  tensorflow::Tensor tf_train_inputs(
+      tf::DT_FLOAT, tf::TensorShape({training_batch_size, flat_input_size_}));
+  tensorflow::Tensor tf_train_legal_mask(
+      tf::DT_BOOL, tf::TensorShape({training_batch_size, num_actions_}));
+  tensorflow::Tensor tf_policy_targets(
+      tf::DT_FLOAT, tf::TensorShape({training_batch_size, num_actions_}));
+  tensorflow::Tensor tf_value_targets(
+      tf::DT_FLOAT, tf::TensorShape({training_batch_size, 1}));
+
+  // The replay buffer slots already hold dense float rows, so gather them
+  // directly into the tensors without any intermediate TrainInputs.
+  replay_buffer.Sample(rng, training_batch_size,
+                       tf_train_inputs.flat<float>().data(),
+                       tf_train_legal_mask.flat<bool>().data(),
+                       tf_policy_targets.flat<float>().data(),
+                       tf_value_targets.flat<float>().data());
+
+  return RunTrainStep(tf_train_inputs, tf_train_legal_mask,
+                      tf_policy_targets, tf_value_targets);
+}
+
+VPNetModel::LossInfo VPNetModel::RunTrainStep(
+    const tensorflow::Tensor& inputs, const tensorflow::Tensor& legal_mask,
+    const tensorflow::Tensor& policy_targets,
+    const tensorflow::Tensor& value_targets) {
   // Run a training step and get the losses.
   std::vector<tensorflow::Tensor> tf_outputs;
-  TF_CHECK_OK(tf_session_->Run({{"input", tf_train_inputs},
-                                {"legals_mask", tf_train_legal_mask},
-                                {"policy_targets", tf_policy_targets},
-                                {"value_targets", tf_value_targets},
+  absl::WriterMutexLock lock(&train_m_);
+  TF_CHECK_OK(tf_session_->Run({{"input", inputs},
+                                {"legals_mask", legal_mask},
+                                {"policy_targets", policy_targets},
+                                {"value_targets", value_targets},
                                 {"training", tensorflow::Tensor(true)}},
                                {"policy_loss", "value_loss", "l2_reg_loss"},
                                {"train"}, &tf_outputs));
@@ -15,6 +15,12 @@
 #ifndef OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_VPNET_H_
 #define OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_VPNET_H_
 
+#include <random>
+
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+#include "open_spiel/algorithms/alpha_zero/native_vpnet.h"
+#include "open_spiel/algorithms/alpha_zero/replay_buffer.h"
+#include "open_spiel/algorithms/alpha_zero/vpnet_base.h"
 #include "open_spiel/spiel.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/protobuf/meta_graph.proto.h"
@@ -33,89 +39,55 @@ bool CreateGraphDef(
     std::string nn_model, int nn_width, int nn_depth, bool verbose = false);
 
 
-class VPNetModel {
+class VPNetModel : public VPNetModelBase {
   // TODO(author7): Save and restore checkpoints:
   // https://stackoverflow.com/questions/37508771/how-to-save-and-restore-a-tensorflow-graph-and-its-state-in-c
   // https://stackoverflow.com/questions/35508866/tensorflow-different-ways-to-export-and-run-graph-in-c/43639305#43639305
   // https://www.tensorflow.org/api_docs/python/tf/compat/v1/train/Saver
 
  public:
-  class LossInfo {
-   public:
-    LossInfo() {}
-    LossInfo(double policy, double value, double l2) :
-      policy_(policy), value_(value), l2_(l2), batches_(1) {}
-
-    // Merge another LossInfo into this one.
-    LossInfo& operator+=(const LossInfo& other) {
-      policy_ += other.policy_;
-      value_ += other.value_;
-      l2_ += other.l2_;
-      batches_ += other.batches_;
-      return *this;
-    }
-
-    // Return the average losses over all merged into this one.
-    double Policy() const { return policy_ / batches_; }
-    double Value() const { return value_ / batches_; }
-    double L2() const { return l2_ / batches_; }
-    double Total() const { return Policy() + Value() + L2(); }
-
-   private:
-    double policy_ = 0;
-    double value_ = 0;
-    double l2_ = 0;
-    int batches_ = 0;
-  };
-
-  struct InferenceInputs {
-    std::vector<Action> legal_actions;
-    std::vector<double> observations;
-
-    bool operator==(const InferenceInputs& o) const {
-      return legal_actions == o.legal_actions && observations == o.observations;
-    }
-
-    template <typename H>
-    friend H AbslHashValue(H h, const InferenceInputs& in) {
-      return H::combine(std::move(h), in.legal_actions, in.observations);
-    }
-  };
-  struct InferenceOutputs {
-    double value;
-    ActionsAndProbs policy;
-  };
-
-  struct TrainInputs {
-    std::vector<Action> legal_actions;
-    std::vector<double> observations;
-    ActionsAndProbs policy;
-    double value;
-  };
-
   VPNetModel(const Game& game, const std::string& path,
              const std::string& file_name,
              const std::string& device = "/cpu:0");
 
-  // Move only, not copyable.
-  VPNetModel(VPNetModel&& other) = default;
-  VPNetModel& operator=(VPNetModel&& other) = default;
+  // Not copyable.
   VPNetModel(const VPNetModel&) = delete;
   VPNetModel& operator=(const VPNetModel&) = delete;
 
-  // Inference: Get both at the same time.
   std::vector<InferenceOutputs> Inference(
-    const std::vector<InferenceInputs>& inputs);
+    const std::vector<InferenceInputs>& inputs) override;
 
-  // Training: do one (batch) step of neural net training
-  LossInfo Learn(const std::vector<TrainInputs>& inputs);
+  LossInfo Learn(const std::vector<TrainInputs>& inputs) override;
+  LossInfo Learn(const ReplayBuffer& replay_buffer, int batch_size,
+                 std::mt19937* rng) override;
 
-  std::string SaveCheckpoint(int step);
-  void LoadCheckpoint(const std::string& path);
+  // Saves a TensorFlow checkpoint, plus the weights alongside it in the format
+  // read by NativeVPNetModel::LoadCheckpoint.
+  std::string SaveCheckpoint(int step) override;
+  void LoadCheckpoint(const std::string& path) override;
 
-  const std::string Device() const { return device_; }
+  VPNetWeights GetWeights() override;
+  void SetWeights(const VPNetWeights& weights) override;
+
+  const std::string Device() const override { return device_; }
 
  private:
+  // A variable needed for inference, and the graph nodes to read and set it.
+  struct Variable {
+    std::string name;
+    std::string snapshot;
+    std::string initializer;
+    std::string initial_value;
+  };
+
+  // GetWeights without the lock.
+  VPNetWeights ReadWeights();
+
+  LossInfo RunTrainStep(const tensorflow::Tensor& inputs,
+                        const tensorflow::Tensor& legal_mask,
+                        const tensorflow::Tensor& policy_targets,
+                        const tensorflow::Tensor& value_targets);
+
   std::string device_;
   std::string path_;
 
@@ -130,6 +102,12 @@ class VPNetModel {
   tensorflow::Session* tf_session_ = nullptr;
   tensorflow::MetaGraphDef meta_graph_def_;
   tensorflow::SessionOptions tf_opts_;
+  std::vector<Variable> variables_;
+
+  // Training must not overlap saving a checkpoint, and replacing the weights
+  // must not overlap inference. Training and inference can overlap though.
+  absl::Mutex train_m_;
+  absl::Mutex weights_m_;
 };
 
 }  // namespace algorithms
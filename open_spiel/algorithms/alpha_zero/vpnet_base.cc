@@ -0,0 +1,119 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/alpha_zero/vpnet_base.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+constexpr char kWeightsMagic[] = "VPNW";
+constexpr uint32_t kWeightsVersion = 1;
+
+template <typename T>
+void AppendRaw(const T& value, std::string* out) {
+  out->append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T ReadRaw(absl::string_view in, int64_t* pos) {
+  SPIEL_CHECK_LE(*pos + sizeof(T), in.size());
+  T value;
+  std::memcpy(&value, in.data() + *pos, sizeof(T));
+  *pos += sizeof(T);
+  return value;
+}
+
+}  // namespace
+
+std::string SerializeVPNetWeights(const VPNetWeights& weights) {
+  std::string out(kWeightsMagic, 4);
+  AppendRaw(kWeightsVersion, &out);
+  AppendRaw<uint32_t>(weights.size(), &out);
+  for (const auto& [name, weight] : weights) {
+    AppendRaw<uint32_t>(name.size(), &out);
+    out.append(name);
+    AppendRaw<uint32_t>(weight.shape.size(), &out);
+    int64_t size = 1;
+    for (int dim : weight.shape) {
+      AppendRaw<int64_t>(dim, &out);
+      size *= dim;
+    }
+    SPIEL_CHECK_EQ(size, weight.data.size());
+    out.append(reinterpret_cast<const char*>(weight.data.data()),
+               size * sizeof(float));
+  }
+  return out;
+}
+
+VPNetWeights DeserializeVPNetWeights(absl::string_view in) {
+  if (in.substr(0, 4) != kWeightsMagic) {
+    SpielFatalError("Not serialized VPNet weights.");
+  }
+  int64_t pos = 4;
+  SPIEL_CHECK_EQ(ReadRaw<uint32_t>(in, &pos), kWeightsVersion);
+  uint32_t count = ReadRaw<uint32_t>(in, &pos);
+  VPNetWeights weights;
+  weights.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    uint32_t name_size = ReadRaw<uint32_t>(in, &pos);
+    SPIEL_CHECK_LE(pos + name_size, in.size());
+    std::string name(in.substr(pos, name_size));
+    pos += name_size;
+    VPNetWeight& weight = weights[name];
+    uint32_t dims = ReadRaw<uint32_t>(in, &pos);
+    int64_t size = 1;
+    for (int d = 0; d < dims; ++d) {
+      weight.shape.push_back(ReadRaw<int64_t>(in, &pos));
+      size *= weight.shape.back();
+    }
+    SPIEL_CHECK_LE(pos + size * sizeof(float), in.size());
+    weight.data.resize(size);
+    std::memcpy(weight.data.data(), in.data() + pos, size * sizeof(float));
+    pos += size * sizeof(float);
+  }
+  return weights;
+}
+
+bool WriteVPNetWeights(const std::string& path, const VPNetWeights& weights) {
+  std::string out = SerializeVPNetWeights(weights);
+  // Write to a temporary file and rename it, so a concurrent reader never sees
+  // a partially written file.
+  std::string tmp_path = absl::StrCat(path, ".tmp");
+  {
+    file::File f(tmp_path, "w");
+    if (!f.Write(out)) return false;
+  }
+  return std::rename(tmp_path.c_str(), path.c_str()) == 0;
+}
+
+VPNetWeights ReadVPNetWeights(const std::string& path) {
+  if (!file::Exists(path)) {
+    SpielFatalError(absl::StrCat("Weights file not found: ", path));
+  }
+  return DeserializeVPNetWeights(file::File(path, "r").ReadContents());
+}
+
+}  // namespace algorithms
+}  // namespace open_spiel
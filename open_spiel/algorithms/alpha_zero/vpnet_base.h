@@ -0,0 +1,134 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_VPNET_BASE_H_
+#define OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_VPNET_BASE_H_
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/algorithms/alpha_zero/replay_buffer.h"
+#include "open_spiel/spiel.h"
+
+namespace open_spiel {
+namespace algorithms {
+
+// The trained variables of a model, keyed by their TensorFlow name without
+// the ":0" suffix, eg "torso_0_dense/kernel".
+struct VPNetWeight {
+  std::vector<int> shape;
+  std::vector<float> data;
+};
+using VPNetWeights = absl::flat_hash_map<std::string, VPNetWeight>;
+
+// Read and write weights in a simple binary format. VPNetModel writes one
+// of these next to each checkpoint, at `checkpoint_path + ".weights"`.
+bool WriteVPNetWeights(const std::string& path, const VPNetWeights& weights);
+VPNetWeights ReadVPNetWeights(const std::string& path);
+
+// The same format in memory, eg to send weights to another process.
+std::string SerializeVPNetWeights(const VPNetWeights& weights);
+VPNetWeights DeserializeVPNetWeights(absl::string_view data);
+
+// The interface to a value and policy network, independent of how it's run.
+// VPNetModel runs it in TensorFlow and can train it, while NativeVPNetModel
+// runs inference only, in process, without depending on TensorFlow.
+class VPNetModelBase {
+ public:
+  class LossInfo {
+   public:
+    LossInfo() {}
+    LossInfo(double policy, double value, double l2) :
+      policy_(policy), value_(value), l2_(l2), batches_(1) {}
+
+    // Merge another LossInfo into this one.
+    LossInfo& operator+=(const LossInfo& other) {
+      policy_ += other.policy_;
+      value_ += other.value_;
+      l2_ += other.l2_;
+      batches_ += other.batches_;
+      return *this;
+    }
+
+    // Return the average losses over all merged into this one.
+    double Policy() const { return policy_ / batches_; }
+    double Value() const { return value_ / batches_; }
+    double L2() const { return l2_ / batches_; }
+    double Total() const { return Policy() + Value() + L2(); }
+
+   private:
+    double policy_ = 0;
+    double value_ = 0;
+    double l2_ = 0;
+    int batches_ = 0;
+  };
+
+  struct InferenceInputs {
+    std::vector<Action> legal_actions;
+    std::vector<double> observations;
+
+    bool operator==(const InferenceInputs& o) const {
+      return legal_actions == o.legal_actions && observations == o.observations;
+    }
+
+    template <typename H>
+    friend H AbslHashValue(H h, const InferenceInputs& in) {
+      return H::combine(std::move(h), in.legal_actions, in.observations);
+    }
+  };
+  struct InferenceOutputs {
+    double value;
+    ActionsAndProbs policy;
+  };
+
+  struct TrainInputs {
+    std::vector<Action> legal_actions;
+    std::vector<double> observations;
+    ActionsAndProbs policy;
+    double value;
+  };
+
+  virtual ~VPNetModelBase() = default;
+
+  // Inference: Get both at the same time.
+  virtual std::vector<InferenceOutputs> Inference(
+      const std::vector<InferenceInputs>& inputs) = 0;
+
+  // Training: do one (batch) step of neural net training
+  virtual LossInfo Learn(const std::vector<TrainInputs>& inputs) = 0;
+
+  // Training: sample a batch from the replay buffer straight into the training
+  // tensors, then do one step of neural net training.
+  virtual LossInfo Learn(const ReplayBuffer& replay_buffer, int batch_size,
+                         std::mt19937* rng) = 0;
+
+  virtual std::string SaveCheckpoint(int step) = 0;
+  virtual void LoadCheckpoint(const std::string& path) = 0;
+
+  // Read or replace the weights in memory, eg to broadcast the learner's
+  // weights to the inference devices. SetWeights is atomic with respect to
+  // Inference: each batch runs entirely with either the old or new weights.
+  virtual VPNetWeights GetWeights() = 0;
+  virtual void SetWeights(const VPNetWeights& weights) = 0;
+
+  virtual const std::string Device() const = 0;
+};
+
+}  // namespace algorithms
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_VPNET_BASE_H_
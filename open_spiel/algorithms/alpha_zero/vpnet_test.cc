@@ -78,8 +78,9 @@ std::vector<VPNetModel::TrainInputs> SolveGame() {
   return train_inputs;
 }
 
-VPNetModel BuildModel(const Game& game, const std::string& nn_model,
-                       bool create_graph) {
+std::unique_ptr<VPNetModel> BuildModel(const Game& game,
+                                       const std::string& nn_model,
+                                       bool create_graph) {
   std::string tmp_dir = open_spiel::file::GetTmpDir();
   std::string filename = absl::StrCat(
       "open_spiel_vpnet_test_", nn_model, ".pb");
@@ -96,15 +97,13 @@ VPNetModel BuildModel(const Game& game, const std::string& nn_model,
   std::string model_path = absl::StrCat(tmp_dir, "/", filename);
   SPIEL_CHECK_TRUE(file::Exists(model_path));
 
-  VPNetModel model(game, tmp_dir, filename, "/cpu:0");
-
-  return model;
+  return std::make_unique<VPNetModel>(game, tmp_dir, filename, "/cpu:0");
 }
 
 void TestModelCreation(const std::string& nn_model) {
   std::cout << "TestModelCreation: " << nn_model << std::endl;
   std::shared_ptr<const Game> game = LoadGame("tic_tac_toe");
-  VPNetModel model = BuildModel(*game, nn_model, true);
+  std::unique_ptr<VPNetModel> model = BuildModel(*game, nn_model, true);
 
   std::unique_ptr<open_spiel::State> state = game->NewInitialState();
   std::vector<Action> legal_actions = state->LegalActions();
@@ -112,21 +111,21 @@ void TestModelCreation(const std::string& nn_model) {
   VPNetModel::InferenceInputs inputs = {legal_actions, obs};
 
   // Check that inference runs at all.
-  model.Inference(std::vector{inputs});
+  model->Inference(std::vector{inputs});
 
   std::vector<VPNetModel::TrainInputs> train_inputs;
   train_inputs.emplace_back(VPNetModel::TrainInputs{
       legal_actions, obs, ActionsAndProbs({{legal_actions[0], 1}}), 0});
 
   // Check that learning runs at all.
-  model.Learn(train_inputs);
+  model->Learn(train_inputs);
 }
 
 // Can learn a single trajectory
 void TestModelLearnsSimple(const std::string& nn_model) {
   std::cout << "TestModelLearnsSimple: " << nn_model << std::endl;
   std::shared_ptr<const Game> game = LoadGame("tic_tac_toe");
-  VPNetModel model = BuildModel(*game, nn_model, false);
+  std::unique_ptr<VPNetModel> model = BuildModel(*game, nn_model, false);
 
   std::vector<VPNetModel::TrainInputs> train_inputs;
   std::unique_ptr<open_spiel::State> state = game->NewInitialState();
@@ -142,7 +141,7 @@ void TestModelLearnsSimple(const std::string& nn_model) {
 
     VPNetModel::InferenceInputs inputs = {legal_actions, obs};
     std::vector<VPNetModel::InferenceOutputs> out =
-        model.Inference(std::vector{inputs});
+        model->Inference(std::vector{inputs});
     SPIEL_CHECK_EQ(out.size(), 1);
     SPIEL_CHECK_EQ(out[0].policy.size(), legal_actions.size());
 
@@ -152,7 +151,7 @@ void TestModelLearnsSimple(const std::string& nn_model) {
   std::cout << "states: " << train_inputs.size() << std::endl;
   std::vector<VPNetModel::LossInfo> losses;
   for (int i = 0; i < 1000; i++) {
-    VPNetModel::LossInfo loss = model.Learn(train_inputs);
+    VPNetModel::LossInfo loss = model->Learn(train_inputs);
     std::cout << absl::StrFormat(
         "%d: Losses(total: %.3f, policy: %.3f, value: %.3f, l2: %.3f)\n",
          i, loss.Total(), loss.Policy(), loss.Value(), loss.L2());
@@ -174,12 +173,12 @@ void TestModelLearnsOptimal(
     const std::vector<VPNetModel::TrainInputs>& train_inputs) {
   std::cout << "TestModelLearnsOptimal: " << nn_model << std::endl;
   std::shared_ptr<const Game> game = LoadGame("tic_tac_toe");
-  VPNetModel model = BuildModel(*game, nn_model, false);
+  std::unique_ptr<VPNetModel> model = BuildModel(*game, nn_model, false);
 
   std::cout << "states: " << train_inputs.size() << std::endl;
   std::vector<VPNetModel::LossInfo> losses;
   for (int i = 0; i < 1000; i++) {
-    VPNetModel::LossInfo loss = model.Learn(train_inputs);
+    VPNetModel::LossInfo loss = model->Learn(train_inputs);
     std::cout << absl::StrFormat(
         "%d: Losses(total: %.3f, policy: %.3f, value: %.3f, l2: %.3f)\n",
          i, loss.Total(), loss.Policy(), loss.Value(), loss.L2());
@@ -79,7 +79,11 @@ double TabularBestResponse::HandleDecisionCase(HistoryNode* node) {
   // expected utility of that node by looking at their policy.
   // We take child probabilities from the policy as that is what we are
   // calculating a best response to.
-  ActionsAndProbs state_policy = policy_->GetStatePolicy(*node->GetState());
+  if (num_policy_buffers_in_use_ == policy_buffers_.size()) {
+    policy_buffers_.emplace_back();
+  }
+  ActionsAndProbs& state_policy = policy_buffers_[num_policy_buffers_in_use_];
+  policy_->FillStatePolicy(*node->GetState(), &state_policy);
   if (state_policy.empty())
     SpielFatalError(absl::StrCat("InfoState ", node->GetInfoState(),
                                  " not found in policy."));
@@ -110,6 +114,7 @@ double TabularBestResponse::HandleDecisionCase(HistoryNode* node) {
     }
   }
   double value = 0;
+  ++num_policy_buffers_in_use_;
   for (const auto& action : node->GetState()->LegalActions()) {
     // We discard the probability here that's returned by GetChild as we
     // immediately load the probability for the given child from the policy.
@@ -122,6 +127,7 @@ double TabularBestResponse::HandleDecisionCase(HistoryNode* node) {
     SPIEL_CHECK_GE(prob, 0);
     value += prob * Value(child->GetHistory());
   }
+  --num_policy_buffers_in_use_;
   return value;
 }
 
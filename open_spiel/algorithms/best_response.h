@@ -15,6 +15,7 @@
 #ifndef OPEN_SPIEL_ALGORITHMS_BEST_RESPONSE_H_
 #define OPEN_SPIEL_ALGORITHMS_BEST_RESPONSE_H_
 
+#include <deque>
 #include <iostream>
 #include <map>
 #include <unordered_map>
@@ -137,6 +138,11 @@ class TabularBestResponse {
 
   // Keep a cache of an empty policy to avoid recomputing it.
   std::unique_ptr<TabularPolicy> dummy_policy_;
+
+  // The policies looked up by HandleDecisionCase, one for each of its calls
+  // in progress, kept so the lookups can reuse them.
+  std::deque<ActionsAndProbs> policy_buffers_;
+  int num_policy_buffers_in_use_ = 0;
 };
 
 }  // namespace algorithms
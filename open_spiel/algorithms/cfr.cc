@@ -15,6 +15,8 @@
 #include "open_spiel/algorithms/cfr.h"
 
 #include <algorithm>
+#include <memory>
+#include <utility>
 
 #include "open_spiel/abseil-cpp/absl/algorithm/container.h"
 #include "open_spiel/spiel_utils.h"
@@ -22,37 +24,70 @@
 namespace open_spiel {
 namespace algorithms {
 
+CFRInfoStateValuesTable::CFRInfoStateValuesTable(
+    std::shared_ptr<InfostateInterner> interner)
+    : interner_(interner ? std::move(interner)
+                         : std::make_shared<InfostateInterner>()) {}
+
+CFRInfoStateValues& CFRInfoStateValuesTable::FindOrAdd(
+    InfostateId id, const std::vector<Action>& legal_actions,
+    double init_value) {
+  SPIEL_CHECK_LT(id, interner_->Size());
+  if (id >= values_.size()) values_.resize(id + 1);
+  if (values_[id].empty()) {
+    SPIEL_CHECK_FALSE(legal_actions.empty());
+    values_[id] = CFRInfoStateValues(legal_actions, init_value);
+    ++num_values_;
+  }
+  return values_[id];
+}
+
 CFRAveragePolicy::CFRAveragePolicy(const CFRInfoStateValuesTable& info_states,
                                    std::shared_ptr<Policy> default_policy)
     : info_states_(info_states), default_policy_(default_policy) {}
 
 ActionsAndProbs CFRAveragePolicy::GetStatePolicy(const State& state) const {
   ActionsAndProbs actions_and_probs;
-  auto entry = info_states_.find(state.InformationStateString());
-  if (entry == info_states_.end()) {
-    if (default_policy_) {
-      return default_policy_->GetStatePolicy(state);
-    } else {
-      return actions_and_probs;
-    }
-  }
-  GetStatePolicyFromInformationStateValues(entry->second, &actions_and_probs);
+  FillStatePolicy(state, &actions_and_probs);
   return actions_and_probs;
 }
 
 ActionsAndProbs CFRAveragePolicy::GetStatePolicy(
     const std::string& info_state) const {
   ActionsAndProbs actions_and_probs;
-  auto entry = info_states_.find(info_state);
-  if (entry == info_states_.end()) {
+  FillStatePolicy(info_state, &actions_and_probs);
+  return actions_and_probs;
+}
+
+void CFRAveragePolicy::FillStatePolicy(const State& state,
+                                       ActionsAndProbs* policy) const {
+  const CFRInfoStateValues* is_vals =
+      info_states_.Find(state.InformationStateString());
+  if (is_vals == nullptr) {
     if (default_policy_) {
-      return default_policy_->GetStatePolicy(info_state);
+      default_policy_->FillStatePolicy(state, policy);
     } else {
-      return actions_and_probs;
+      policy->clear();
     }
+    return;
   }
-  GetStatePolicyFromInformationStateValues(entry->second, &actions_and_probs);
-  return actions_and_probs;
+  policy->clear();
+  GetStatePolicyFromInformationStateValues(*is_vals, policy);
+}
+
+void CFRAveragePolicy::FillStatePolicy(const std::string& info_state,
+                                       ActionsAndProbs* policy) const {
+  const CFRInfoStateValues* is_vals = info_states_.Find(info_state);
+  if (is_vals == nullptr) {
+    if (default_policy_) {
+      default_policy_->FillStatePolicy(info_state, policy);
+    } else {
+      policy->clear();
+    }
+    return;
+  }
+  policy->clear();
+  GetStatePolicyFromInformationStateValues(*is_vals, policy);
 }
 
 void CFRAveragePolicy::GetStatePolicyFromInformationStateValues(
@@ -84,41 +119,55 @@ CFRCurrentPolicy::CFRCurrentPolicy(const CFRInfoStateValuesTable& info_states,
 
 ActionsAndProbs CFRCurrentPolicy::GetStatePolicy(const State& state) const {
   ActionsAndProbs actions_and_probs;
-  auto entry = info_states_.find(state.InformationStateString());
-  if (entry == info_states_.end()) {
+  FillStatePolicy(state, &actions_and_probs);
+  return actions_and_probs;
+}
+
+ActionsAndProbs CFRCurrentPolicy::GetStatePolicy(
+    const std::string& info_state) const {
+  ActionsAndProbs actions_and_probs;
+  FillStatePolicy(info_state, &actions_and_probs);
+  return actions_and_probs;
+}
+
+void CFRCurrentPolicy::FillStatePolicy(const State& state,
+                                       ActionsAndProbs* policy) const {
+  const CFRInfoStateValues* is_vals =
+      info_states_.Find(state.InformationStateString());
+  if (is_vals == nullptr) {
     if (default_policy_) {
-      return default_policy_->GetStatePolicy(state);
+      default_policy_->FillStatePolicy(state, policy);
     } else {
-      return actions_and_probs;
+      policy->clear();
     }
+    return;
   }
-  return GetStatePolicyFromInformationStateValues(entry->second,
-                                                  actions_and_probs);
+  policy->clear();
+  GetStatePolicyFromInformationStateValues(*is_vals, policy);
 }
 
-ActionsAndProbs CFRCurrentPolicy::GetStatePolicy(
-    const std::string& info_state) const {
-  ActionsAndProbs actions_and_probs;
-  auto entry = info_states_.find(info_state);
-  if (entry == info_states_.end()) {
+void CFRCurrentPolicy::FillStatePolicy(const std::string& info_state,
+                                       ActionsAndProbs* policy) const {
+  const CFRInfoStateValues* is_vals = info_states_.Find(info_state);
+  if (is_vals == nullptr) {
     if (default_policy_) {
-      return default_policy_->GetStatePolicy(info_state);
+      default_policy_->FillStatePolicy(info_state, policy);
     } else {
-      return actions_and_probs;
+      policy->clear();
     }
+    return;
   }
-  return GetStatePolicyFromInformationStateValues(entry->second,
-                                                  actions_and_probs);
+  policy->clear();
+  GetStatePolicyFromInformationStateValues(*is_vals, policy);
 }
 
-ActionsAndProbs CFRCurrentPolicy::GetStatePolicyFromInformationStateValues(
+void CFRCurrentPolicy::GetStatePolicyFromInformationStateValues(
     const CFRInfoStateValues& is_vals,
-    ActionsAndProbs& actions_and_probs) const {
+    ActionsAndProbs* actions_and_probs) const {
   for (int aidx = 0; aidx < is_vals.num_actions(); ++aidx) {
-    actions_and_probs.push_back(
+    actions_and_probs->push_back(
         {is_vals.legal_actions[aidx], is_vals.current_policy[aidx]});
   }
-  return actions_and_probs;
 }
 
 CFRSolverBase::CFRSolverBase(const Game& game, bool alternating_updates,
@@ -155,8 +204,7 @@ void CFRSolverBase::InitializeInfostateNodes(const State& state) {
   std::string info_state = state.InformationStateString(current_player);
   std::vector<Action> legal_actions = state.LegalActions();
 
-  CFRInfoStateValues is_vals(legal_actions);
-  info_states_[info_state] = is_vals;
+  info_states_.FindOrAdd(info_states_.Intern(info_state), legal_actions);
 
   for (const Action& action : legal_actions) {
     InitializeInfostateNodes(*state.Child(action));
@@ -234,6 +282,7 @@ std::vector<double> CFRSolverBase::ComputeCounterFactualRegret(
 
   int current_player = state.CurrentPlayer();
   std::string info_state = state.InformationStateString();
+  const InfostateId info_state_id = info_states_.Intern(info_state);
   std::vector<Action> legal_actions = state.LegalActions(current_player);
 
   // Load current policy.
@@ -243,7 +292,7 @@ std::vector<double> CFRSolverBase::ComputeCounterFactualRegret(
                                  policy_overrides->at(current_player),
                                  info_state);
   } else {
-    info_state_policy = GetPolicy(info_state, legal_actions);
+    info_state_policy = GetPolicy(info_state_id, legal_actions);
   }
 
   std::vector<double> child_utilities;
@@ -255,8 +304,8 @@ std::vector<double> CFRSolverBase::ComputeCounterFactualRegret(
 
   // Perform regret and average strategy updates.
   if (!alternating_player || *alternating_player == current_player) {
-    CFRInfoStateValues is_vals = info_states_[info_state];
-    SPIEL_CHECK_FALSE(is_vals.empty());
+    CFRInfoStateValues* is_vals = info_states_.Find(info_state_id);
+    SPIEL_CHECK_TRUE(is_vals != nullptr);
 
     const double self_reach_prob = reach_probabilities[current_player];
     const double cfr_reach_prob =
@@ -267,19 +316,17 @@ std::vector<double> CFRSolverBase::ComputeCounterFactualRegret(
       double cfr_regret = cfr_reach_prob *
                           (child_utilities[aidx] - state_value[current_player]);
 
-      is_vals.cumulative_regrets[aidx] += cfr_regret;
+      is_vals->cumulative_regrets[aidx] += cfr_regret;
 
       // Update average policy.
       if (linear_averaging_) {
-        is_vals.cumulative_policy[aidx] +=
+        is_vals->cumulative_policy[aidx] +=
             iteration_ * self_reach_prob * info_state_policy[aidx];
       } else {
-        is_vals.cumulative_policy[aidx] +=
+        is_vals->cumulative_policy[aidx] +=
             self_reach_prob * info_state_policy[aidx];
       }
     }
-
-    info_states_[info_state] = is_vals;
   }
 
   return state_value;
@@ -357,17 +404,11 @@ bool CFRSolverBase::AllPlayersHaveZeroReachProb(
 }
 
 std::vector<double> CFRSolverBase::GetPolicy(
-    const std::string& info_state, const std::vector<Action>& legal_actions) {
-  auto entry = info_states_.find(info_state);
-  if (entry == info_states_.end()) {
-    info_states_[info_state] = CFRInfoStateValues(legal_actions);
-    entry = info_states_.find(info_state);
-  }
-
-  SPIEL_CHECK_FALSE(entry == info_states_.end());
-  SPIEL_CHECK_FALSE(entry->second.empty());
-  SPIEL_CHECK_FALSE(entry->second.current_policy.empty());
-  return entry->second.current_policy;
+    InfostateId info_state, const std::vector<Action>& legal_actions) {
+  const CFRInfoStateValues& is_vals =
+      info_states_.FindOrAdd(info_state, legal_actions);
+  SPIEL_CHECK_FALSE(is_vals.current_policy.empty());
+  return is_vals.current_policy;
 }
 
 std::string CFRInfoStateValues::ToString() const {
@@ -426,19 +467,19 @@ int CFRInfoStateValues::SampleActionIndex(double epsilon, double z) {
 //  done during the tree traversal (which is done on histories). It is thus
 //  performed as an additional step.
 void CFRSolverBase::ApplyRegretMatchingPlusReset() {
-  for (auto& entry : info_states_) {
-    for (int aidx = 0; aidx < entry.second.num_actions(); ++aidx) {
-      if (entry.second.cumulative_regrets[aidx] < 0) {
-        entry.second.cumulative_regrets[aidx] = 0;
+  info_states_.ForEach([](InfostateId id, CFRInfoStateValues& is_vals) {
+    for (int aidx = 0; aidx < is_vals.num_actions(); ++aidx) {
+      if (is_vals.cumulative_regrets[aidx] < 0) {
+        is_vals.cumulative_regrets[aidx] = 0;
       }
     }
-  }
+  });
 }
 
 void CFRSolverBase::ApplyRegretMatching() {
-  for (auto& entry : info_states_) {
-    entry.second.ApplyRegretMatching();
-  }
+  info_states_.ForEach([](InfostateId id, CFRInfoStateValues& is_vals) {
+    is_vals.ApplyRegretMatching();
+  });
 }
 
 }  // namespace algorithms
@@ -15,6 +15,12 @@
 #ifndef OPEN_SPIEL_ALGORITHMS_CFR_H_
 #define OPEN_SPIEL_ALGORITHMS_CFR_H_
 
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/algorithms/infostate_interner.h"
 #include "open_spiel/policy.h"
 #include "open_spiel/spiel.h"
 
@@ -48,9 +54,59 @@ struct CFRInfoStateValues {
   std::vector<double> current_policy;
 };
 
-// A type for tables holding CFR values.
-using CFRInfoStateValuesTable =
-    std::unordered_map<std::string, CFRInfoStateValues>;
+// A table holding CFR values, by information state. The information states
+// are interned, so once a node has the id of its own the lookups are vector
+// indexing, and the strings are stored once.
+class CFRInfoStateValuesTable {
+ public:
+  // The interner can be shared, e.g. with other tables of the same game, in
+  // which case the ids are the same in all of them.
+  explicit CFRInfoStateValuesTable(
+      std::shared_ptr<InfostateInterner> interner = nullptr);
+
+  InfostateId Intern(absl::string_view info_state) {
+    return interner_->Intern(info_state);
+  }
+  const InfostateInterner& interner() const { return *interner_; }
+
+  // The values of an information state, or nullptr if it has none.
+  CFRInfoStateValues* Find(InfostateId id) {
+    return id < values_.size() && !values_[id].empty() ? &values_[id]
+                                                        : nullptr;
+  }
+  const CFRInfoStateValues* Find(InfostateId id) const {
+    return id < values_.size() && !values_[id].empty() ? &values_[id]
+                                                        : nullptr;
+  }
+  const CFRInfoStateValues* Find(absl::string_view info_state) const {
+    return Find(interner_->Find(info_state));
+  }
+
+  // The values of an information state, which are created for
+  // `legal_actions` if it has none. The references returned are valid until
+  // the next information state is added.
+  CFRInfoStateValues& FindOrAdd(InfostateId id,
+                                const std::vector<Action>& legal_actions,
+                                double init_value = 0);
+
+  // The number of information states with values.
+  int size() const { return num_values_; }
+
+  // Calls fn(id, values) for each information state with values.
+  template <typename Fn>
+  void ForEach(Fn fn) {
+    for (InfostateId id = 0; id < values_.size(); ++id) {
+      if (!values_[id].empty()) fn(id, values_[id]);
+    }
+  }
+
+ private:
+  std::shared_ptr<InfostateInterner> interner_;
+  // By id. Empty for information states without values, which are only
+  // there when the interner is shared.
+  std::vector<CFRInfoStateValues> values_;
+  int num_values_ = 0;
+};
 
 // A policy that extracts the average policy from the CFR table values, which
 // can be passed to tabular exploitability.
@@ -65,6 +121,10 @@ class CFRAveragePolicy : public Policy {
                    std::shared_ptr<Policy> default_policy);
   ActionsAndProbs GetStatePolicy(const State& state) const override;
   ActionsAndProbs GetStatePolicy(const std::string& info_state) const override;
+  void FillStatePolicy(const State& state,
+                       ActionsAndProbs* policy) const override;
+  void FillStatePolicy(const std::string& info_state,
+                       ActionsAndProbs* policy) const override;
 
  private:
   const CFRInfoStateValuesTable& info_states_;
@@ -85,13 +145,17 @@ class CFRCurrentPolicy : public Policy {
                    std::shared_ptr<Policy> default_policy);
   ActionsAndProbs GetStatePolicy(const State& state) const override;
   ActionsAndProbs GetStatePolicy(const std::string& info_state) const override;
+  void FillStatePolicy(const State& state,
+                       ActionsAndProbs* policy) const override;
+  void FillStatePolicy(const std::string& info_state,
+                       ActionsAndProbs* policy) const override;
 
  private:
   const CFRInfoStateValuesTable& info_states_;
   std::shared_ptr<Policy> default_policy_;
-  ActionsAndProbs GetStatePolicyFromInformationStateValues(
+  void GetStatePolicyFromInformationStateValues(
       const CFRInfoStateValues& is_vals,
-      ActionsAndProbs& actions_and_probs) const;
+      ActionsAndProbs* actions_and_probs) const;
 };
 
 // Base class supporting different flavours of the Counterfactual Regret
@@ -176,7 +240,7 @@ class CFRSolverBase {
 
   // Get the policy at this information state. The probabilities are ordered in
   // the same order as legal_actions.
-  std::vector<double> GetPolicy(const std::string& info_state,
+  std::vector<double> GetPolicy(InfostateId info_state,
                                 const std::vector<Action>& legal_actions);
 
   void ApplyRegretMatchingPlusReset();
@@ -61,6 +61,32 @@ void CFRTest_KuhnPoker() {
   CheckExploitabilityKuhnPoker(*game, *average_policy);
 }
 
+// The policies fill a reused list with what GetStatePolicy returns.
+void CFRTest_FillStatePolicy() {
+  std::shared_ptr<const Game> game = LoadGame("kuhn_poker");
+  CFRSolver solver(*game);
+  for (int i = 0; i < 10; i++) {
+    solver.EvaluateAndUpdatePolicy();
+  }
+  ActionsAndProbs filled;
+  for (const std::unique_ptr<Policy>& policy :
+       {solver.AveragePolicy(), solver.CurrentPolicy()}) {
+    std::unique_ptr<State> state = game->NewInitialState();
+    state->ApplyAction(0);
+    state->ApplyAction(1);
+    policy->FillStatePolicy(*state, &filled);
+    SPIEL_CHECK_EQ(filled.size(), 2);
+    SPIEL_CHECK_TRUE(filled == policy->GetStatePolicy(*state));
+    state->ApplyAction(0);
+    policy->FillStatePolicy(state->InformationStateString(), &filled);
+    SPIEL_CHECK_EQ(filled.size(), 2);
+    SPIEL_CHECK_TRUE(filled ==
+                     policy->GetStatePolicy(state->InformationStateString()));
+    policy->FillStatePolicy("not an information state", &filled);
+    SPIEL_CHECK_TRUE(filled.empty());
+  }
+}
+
 void CFRTest_IIGoof4() {
   // Random points order.
   std::shared_ptr<const Game> game = LoadGameAsTurnBased(
@@ -190,6 +216,7 @@ namespace algorithms = open_spiel::algorithms;
 
 int main(int argc, char** argv) {
   algorithms::CFRTest_KuhnPoker();
+  algorithms::CFRTest_FillStatePolicy();
   algorithms::CFRTest_IIGoof4();
   algorithms::CFRPlusTest_KuhnPoker();
   algorithms::CFRTest_KuhnPokerRunsWithThreePlayers(
@@ -14,6 +14,7 @@
 
 #include "open_spiel/algorithms/deterministic_policy.h"
 
+#include <algorithm>
 #include <climits>
 
 #include "open_spiel/algorithms/get_legal_actions_map.h"
@@ -42,28 +43,25 @@ int64_t NumDeterministicPolicies(const Game& game, Player player) {
 DeterministicTabularPolicy::DeterministicTabularPolicy(
     const Game& game, Player player,
     const std::unordered_map<std::string, Action> policy)
-    : table_(), player_(player) {
+    : player_(player) {
   CreateTable(game, player);
   for (const auto& info_state_action : policy) {
-    auto iter = table_.find(info_state_action.first);
-    SPIEL_CHECK_TRUE(iter != table_.end());
-    iter->second.SetAction(info_state_action.second);
+    Entry(info_state_action.first).SetAction(info_state_action.second);
   }
 }
 
 DeterministicTabularPolicy::DeterministicTabularPolicy(const Game& game,
                                                        Player player)
-    : table_(), player_(player) {
+    : player_(player) {
   CreateTable(game, player);
 }
 
 ActionsAndProbs DeterministicTabularPolicy::GetStatePolicy(
     const std::string& info_state) const {
-  auto iter = table_.find(info_state);
-  SPIEL_CHECK_TRUE(iter != table_.end());
+  const LegalsWithIndex& entry = Entry(info_state);
   ActionsAndProbs state_policy;
-  Action policy_action = iter->second.GetAction();
-  for (const auto& action : iter->second.legal_actions_) {
+  Action policy_action = entry.GetAction();
+  for (const auto& action : entry.legal_actions_) {
     state_policy.push_back(
         std::pair<Action, double>(action, action == policy_action ? 1.0 : 0.0));
   }
@@ -72,9 +70,7 @@ ActionsAndProbs DeterministicTabularPolicy::GetStatePolicy(
 
 Action DeterministicTabularPolicy::GetAction(
     const std::string& info_state) const {
-  auto iter = table_.find(info_state);
-  SPIEL_CHECK_TRUE(iter != table_.end());
-  return iter->second.GetAction();
+  return Entry(info_state).GetAction();
 }
 
 bool DeterministicTabularPolicy::NextPolicy() {
@@ -83,11 +79,9 @@ bool DeterministicTabularPolicy::NextPolicy() {
   // end without being able to add 1, then this is the end of the order.
   // Otherwise, increment the digit we land on by 1, and reset all the ones
   // we skipped over earlier in the order.
-  for (auto iter = table_.begin(); iter != table_.end(); ++iter) {
-    if (iter->second.TryIncIndex()) {
-      for (auto iter2 = table_.begin(); iter2 != iter; ++iter2) {
-        iter2->second.index = 0;
-      }
+  for (int i = 0; i < table_.size(); ++i) {
+    if (table_[i].TryIncIndex()) {
+      for (int j = 0; j < i; ++j) table_[j].index = 0;
       return true;
     }
   }
@@ -95,26 +89,46 @@ bool DeterministicTabularPolicy::NextPolicy() {
 }
 
 void DeterministicTabularPolicy::ResetDefaultPolicy() {
-  for (auto& info_state_entry : table_) {
-    info_state_entry.second.index = 0;
-  }
+  for (LegalsWithIndex& entry : table_) entry.index = 0;
 }
 
 void DeterministicTabularPolicy::CreateTable(const Game& game, Player player) {
   std::unordered_map<std::string, std::vector<Action>> legal_actions_map =
       GetLegalActionsMap(game, -1, player);
+  std::vector<std::string> info_states;
+  info_states.reserve(legal_actions_map.size());
   for (const auto& info_state_actions : legal_actions_map) {
-    table_[info_state_actions.first] =
-        LegalsWithIndex(info_state_actions.second);
+    info_states.push_back(info_state_actions.first);
+  }
+  std::sort(info_states.begin(), info_states.end());
+  info_states_ = std::make_shared<InfostateInterner>();
+  table_.reserve(info_states.size());
+  for (const std::string& info_state : info_states) {
+    SPIEL_CHECK_EQ(info_states_->Intern(info_state), table_.size());
+    table_.push_back(LegalsWithIndex(legal_actions_map[info_state]));
   }
 }
 
+LegalsWithIndex& DeterministicTabularPolicy::Entry(
+    const std::string& info_state) {
+  const InfostateId id = info_states_->Find(info_state);
+  SPIEL_CHECK_NE(id, kInvalidInfostateId);
+  return table_[id];
+}
+
+const LegalsWithIndex& DeterministicTabularPolicy::Entry(
+    const std::string& info_state) const {
+  const InfostateId id = info_states_->Find(info_state);
+  SPIEL_CHECK_NE(id, kInvalidInfostateId);
+  return table_[id];
+}
+
 std::string DeterministicTabularPolicy::ToString(
     const std::string& delimiter) const {
   std::string str = "";
-  for (const auto& info_state_entry : table_) {
-    absl::StrAppend(&str, info_state_entry.first, " ", delimiter, " ",
-                    "action = ", info_state_entry.second.GetAction(), "\n");
+  for (InfostateId id = 0; id < table_.size(); ++id) {
+    absl::StrAppend(&str, info_states_->String(id), " ", delimiter, " ",
+                    "action = ", table_[id].GetAction(), "\n");
   }
   return str;
 }
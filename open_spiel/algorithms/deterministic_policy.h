@@ -17,10 +17,11 @@
 
 #include <algorithm>
 #include <iterator>
+#include <memory>
 #include <string>
-#include <map>
 #include <vector>
 
+#include "open_spiel/algorithms/infostate_interner.h"
 #include "open_spiel/policy.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
@@ -103,8 +104,13 @@ class DeterministicTabularPolicy : public Policy {
 
  private:
   void CreateTable(const Game& game, Player player);
+  LegalsWithIndex& Entry(const std::string& info_state);
+  const LegalsWithIndex& Entry(const std::string& info_state) const;
 
-  std::map<std::string, LegalsWithIndex> table_;
+  // The information states are interned in sorted order, so the table, by
+  // id, is in the order NextPolicy counts in. Copies share the interner.
+  std::shared_ptr<InfostateInterner> info_states_;
+  std::vector<LegalsWithIndex> table_;
   Player player_;
 };
 
@@ -14,232 +14,426 @@
 
 #include "open_spiel/algorithms/expected_returns.h"
 
-#include <functional>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
+#include "open_spiel/abseil-cpp/absl/hash/hash.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/simultaneous_move_game.h"
 #include "open_spiel/spiel.h"
+#include "open_spiel/utils/thread.h"
 
 namespace open_spiel {
 namespace algorithms {
 namespace {
 
-// Implements the recursive traversal using a general way to access the
-// player's policies via a function that takes as arguments the player id and
-// information state.
-// We have a special case for the case where we can get a policy just from the
-// InfostateString as that gives us a 2x speedup.
-std::vector<double> ExpectedReturnsImpl(
-    const State& state,
-    const std::function<ActionsAndProbs(Player, const std::string&)>&
-        policy_func,
-    int depth_limit) {
-  if (state.IsTerminal() || depth_limit == 0) {
-    return state.Rewards();
+constexpr int kNumMemoShards = 16;
+
+// Walks the tree below a state for a batch of policy profiles at once. The
+// values computed for a state hold each player's value under each profile,
+// indexed by profile * num_players + player. A profile's policies are only
+// looked up at the states the profile reaches; the values of the profiles
+// that don't reach a state are left at zero.
+class ExpectedReturnsWalker {
+ public:
+  ExpectedReturnsWalker(
+      const std::vector<std::vector<const Policy*>>& profiles,
+      const ExpectedReturnsOptions& options, int num_players)
+      : profiles_(profiles),
+        options_(options),
+        num_profiles_(profiles.size()),
+        num_players_(num_players),
+        ones_(num_profiles_, 1.0) {
+    if (options.memoize) {
+      memo_ = std::make_unique<std::array<MemoShard, kNumMemoShards>>();
+    }
   }
 
-  int num_players = state.NumPlayers();
-  std::vector<double> values(num_players, 0.0);
+  std::vector<double> Run(const State& state);
+
+ private:
+  // A subtree left for the threads, with the probability of reaching it
+  // under each profile.
+  struct Task {
+    std::unique_ptr<State> state;
+    std::vector<double> reach;
+    int depth_limit;
+    std::vector<double> values;
+  };
+
+  // The lists one thread's walk reuses from one node to the next. Deques, so
+  // growing them doesn't move the lists still in use further up the tree.
+  struct Scratch {
+    // By depth, then player, then profile.
+    std::deque<ActionsAndProbs> policies;
+    // By depth, each list the probability of a child under each profile.
+    std::deque<std::vector<double>> child_probs;
+    // By depth, each list the probability of reaching a child from the
+    // starting state under each profile.
+    std::deque<std::vector<double>> child_reach;
+  };
+
+  // The values of a state, for the profiles that reached it.
+  struct MemoEntry {
+    std::vector<double> values;
+    std::vector<bool> evaluated;
+  };
+
+  struct MemoShard {
+    absl::Mutex mutex;
+    absl::flat_hash_map<std::string, MemoEntry> entries ABSL_GUARDED_BY(mutex);
+  };
+
+  ActionsAndProbs& PolicyBuffer(Scratch* scratch, int depth, Player player,
+                                int profile) const {
+    return scratch->policies[(depth * num_players_ + player) * num_profiles_ +
+                             profile];
+  }
+
+  // Looks up the policy of each profile that reaches the state for the player
+  // at the state.
+  void FillPolicies(const State& state, absl::Span<const double> reach,
+                    Player player, int depth, Scratch* scratch) const;
+
+  // Calls fn(child, probs) for each child of a non-terminal state, with the
+  // probability of moving to it under each profile, which is zero for the
+  // profiles that don't reach the state. Skips the children no profile
+  // moves to.
+  template <typename Fn>
+  void ForEachChild(const State& state, absl::Span<const double> reach,
+                    int depth, Scratch* scratch, Fn fn) const;
+
+  // Adds the rewards of the state, weighted by the reach probability of each
+  // profile, to the values.
+  void AddRewards(const State& state, absl::Span<const double> reach,
+                  std::vector<double>* values) const;
+
+  // Walks the nodes above options_.parallel_depth, adding their rewards to
+  // the values and leaving the subtrees below as tasks.
+  void Split(const State& state, const std::vector<double>& reach,
+             int depth_limit, int depth, Scratch* scratch,
+             std::vector<double>* values);
+
+  // Evaluates the tasks on options_.num_threads threads.
+  void RunTasks();
+
+  // Returns the values of the subtree rooted at the state, which each
+  // profile reaches with the given probability.
+  std::vector<double> Evaluate(const State& state,
+                               absl::Span<const double> reach, int depth_limit,
+                               int depth, Scratch* scratch);
+
+  const std::vector<std::vector<const Policy*>>& profiles_;
+  const ExpectedReturnsOptions& options_;
+  const int num_profiles_;
+  const int num_players_;
+  const std::vector<double> ones_;
+  std::vector<Task> tasks_;
+  std::unique_ptr<std::array<MemoShard, kNumMemoShards>> memo_;
+};
+
+void ExpectedReturnsWalker::FillPolicies(const State& state,
+                                         absl::Span<const double> reach,
+                                         Player player, int depth,
+                                         Scratch* scratch) const {
+  // Looking up the policies by information state string is about twice as
+  // fast, when the policies allow it. The string is shared by the profiles.
+  std::string info_state;
+  if (options_.use_infostate_get_policy) {
+    info_state = state.InformationStateString(player);
+  }
+  for (int k = 0; k < num_profiles_; ++k) {
+    if (reach[k] == 0.0) continue;
+    ActionsAndProbs& policy = PolicyBuffer(scratch, depth, player, k);
+    if (options_.use_infostate_get_policy) {
+      profiles_[k][player]->FillStatePolicy(info_state, &policy);
+    } else {
+      profiles_[k][player]->FillStatePolicy(state, &policy);
+    }
+    if (policy.empty()) {
+      SpielFatalError("Error in ExpectedReturns; infostate not found.");
+    }
+  }
+}
+
+template <typename Fn>
+void ExpectedReturnsWalker::ForEachChild(const State& state,
+                                         absl::Span<const double> reach,
+                                         int depth, Scratch* scratch,
+                                         Fn fn) const {
+  while (scratch->child_probs.size() <= depth) {
+    scratch->child_probs.emplace_back(num_profiles_);
+  }
+  while (scratch->policies.size() <
+         (depth + 1) * num_players_ * num_profiles_) {
+    scratch->policies.emplace_back();
+  }
+  std::vector<double>& probs = scratch->child_probs[depth];
+
   if (state.IsChanceNode()) {
-    ActionsAndProbs action_and_probs = state.ChanceOutcomes();
-    for (const auto& action_and_prob : action_and_probs) {
-      std::unique_ptr<State> child = state.Child(action_and_prob.first);
-      std::vector<double> child_values =
-          ExpectedReturnsImpl(*child, policy_func, depth_limit - 1);
-      for (auto p = Player{0}; p < num_players; ++p) {
-        values[p] += action_and_prob.second * child_values[p];
-      }
+    for (const auto& [outcome, prob] : state.ChanceOutcomes()) {
+      std::fill(probs.begin(), probs.end(), prob);
+      fn(*state.Child(outcome), probs);
     }
   } else if (state.IsSimultaneousNode()) {
     // Walk over all the joint actions, and weight by the product of
     // probabilities to choose them.
-    values = state.Rewards();
     auto smstate = dynamic_cast<const SimMoveState*>(&state);
     SPIEL_CHECK_TRUE(smstate != nullptr);
-    std::vector<ActionsAndProbs> state_policies(num_players);
-    for (auto p = Player{0}; p < num_players; ++p) {
-      state_policies[p] = policy_func(p, state.InformationStateString(p));
-      if (state_policies[p].empty()) {
-        SpielFatalError("Error in ExpectedReturnsImpl; infostate not found.");
-      }
+    for (auto p = Player{0}; p < num_players_; ++p) {
+      FillPolicies(state, reach, p, depth, scratch);
     }
     for (const Action flat_action : smstate->LegalActions()) {
       std::vector<Action> actions =
           smstate->FlatJointActionToActions(flat_action);
-      double joint_action_prob = 1.0;
-      for (auto p = Player{0}; p < num_players; ++p) {
-        double player_action_prob = GetProb(state_policies[p], actions[p]);
-        SPIEL_CHECK_GE(player_action_prob, 0.0);
-        SPIEL_CHECK_LE(player_action_prob, 1.0);
-        joint_action_prob *= player_action_prob;
-        if (player_action_prob == 0.0) {
-          break;
+      bool reachable = false;
+      for (int k = 0; k < num_profiles_; ++k) {
+        if (reach[k] == 0.0) {
+          probs[k] = 0.0;
+          continue;
+        }
+        double joint_action_prob = 1.0;
+        for (auto p = Player{0}; p < num_players_; ++p) {
+          double player_action_prob =
+              GetProb(PolicyBuffer(scratch, depth, p, k), actions[p]);
+          SPIEL_CHECK_GE(player_action_prob, 0.0);
+          SPIEL_CHECK_LE(player_action_prob, 1.0);
+          joint_action_prob *= player_action_prob;
+          if (player_action_prob == 0.0) {
+            break;
+          }
         }
+        probs[k] = joint_action_prob;
+        reachable = reachable || joint_action_prob > 0.0;
       }
-
-      if (joint_action_prob > 0.0) {
+      if (reachable) {
         std::unique_ptr<State> child = state.Clone();
         child->ApplyActions(actions);
-        std::vector<double> child_values =
-            ExpectedReturnsImpl(*child, policy_func, depth_limit - 1);
-        for (auto p = Player{0}; p < num_players; ++p) {
-          values[p] += joint_action_prob * child_values[p];
-        }
+        fn(*child, probs);
       }
     }
   } else {
     // Turn-based decision node.
     Player player = state.CurrentPlayer();
-    ActionsAndProbs state_policy =
-        policy_func(player, state.InformationStateString());
-    if (state_policy.empty()) {
-      SpielFatalError("Error in ExpectedReturnsImpl; infostate not found.");
-    }
-    values = state.Rewards();
+    FillPolicies(state, reach, player, depth, scratch);
     for (const Action action : state.LegalActions()) {
-      std::unique_ptr<State> child = state.Child(action);
-      double action_prob = GetProb(state_policy, action);
-      SPIEL_CHECK_GE(action_prob, 0.0);
-      SPIEL_CHECK_LE(action_prob, 1.0);
-      if (action_prob > 0.0) {
-        std::vector<double> child_values =
-            ExpectedReturnsImpl(*child, policy_func, depth_limit - 1);
-        for (auto p = Player{0}; p < num_players; ++p) {
-          values[p] += action_prob * child_values[p];
+      bool reachable = false;
+      for (int k = 0; k < num_profiles_; ++k) {
+        if (reach[k] == 0.0) {
+          probs[k] = 0.0;
+          continue;
         }
+        double action_prob =
+            GetProb(PolicyBuffer(scratch, depth, player, k), action);
+        SPIEL_CHECK_GE(action_prob, 0.0);
+        SPIEL_CHECK_LE(action_prob, 1.0);
+        probs[k] = action_prob;
+        reachable = reachable || action_prob > 0.0;
       }
+      if (reachable) fn(*state.Child(action), probs);
     }
   }
-  SPIEL_CHECK_EQ(values.size(), state.NumPlayers());
-  return values;
 }
 
-// Same as above, but the policy_func now takes a State as input in, rather
-// than a string.
-std::vector<double> ExpectedReturnsImpl(
-    const State& state,
-    const std::function<ActionsAndProbs(Player, const State&)>& policy_func,
-    int depth_limit) {
-  if (state.IsTerminal() || depth_limit == 0) {
-    return state.Rewards();
+void ExpectedReturnsWalker::AddRewards(const State& state,
+                                       absl::Span<const double> reach,
+                                       std::vector<double>* values) const {
+  const std::vector<double> rewards = state.Rewards();
+  SPIEL_CHECK_EQ(rewards.size(), num_players_);
+  for (int k = 0; k < num_profiles_; ++k) {
+    for (auto p = Player{0}; p < num_players_; ++p) {
+      (*values)[k * num_players_ + p] += reach[k] * rewards[p];
+    }
   }
+}
 
-  int num_players = state.NumPlayers();
-  std::vector<double> values(num_players, 0.0);
-  if (state.IsChanceNode()) {
-    ActionsAndProbs action_and_probs = state.ChanceOutcomes();
-    for (const auto& action_and_prob : action_and_probs) {
-      std::unique_ptr<State> child = state.Child(action_and_prob.first);
-      std::vector<double> child_values =
-          ExpectedReturnsImpl(*child, policy_func, depth_limit - 1);
-      for (auto p = Player{0}; p < num_players; ++p) {
-        values[p] += action_and_prob.second * child_values[p];
+std::vector<double> ExpectedReturnsWalker::Evaluate(
+    const State& state, absl::Span<const double> reach, int depth_limit,
+    int depth, Scratch* scratch) {
+  std::vector<double> values(num_profiles_ * num_players_, 0.0);
+  const bool leaf = state.IsTerminal() || depth_limit == 0;
+  if (leaf || !state.IsChanceNode()) AddRewards(state, ones_, &values);
+  if (leaf) return values;
+
+  std::string key;
+  MemoShard* shard = nullptr;
+  if (memo_) {
+    key = state.ToString();
+    // The values of a depth-limited walk depend on the depth left.
+    if (depth_limit > 0) absl::StrAppend(&key, "\n", depth_limit);
+    shard = &(*memo_)[absl::Hash<std::string>()(key) % kNumMemoShards];
+    absl::MutexLock lock(&shard->mutex);
+    auto it = shard->entries.find(key);
+    if (it != shard->entries.end()) {
+      bool covered = true;
+      for (int k = 0; k < num_profiles_; ++k) {
+        covered = covered && (reach[k] == 0.0 || it->second.evaluated[k]);
       }
+      if (covered) return it->second.values;
     }
-  } else if (state.IsSimultaneousNode()) {
-    // Walk over all the joint actions, and weight by the product of
-    // probabilities to choose them.
-    values = state.Rewards();
-    auto smstate = dynamic_cast<const SimMoveState*>(&state);
-    SPIEL_CHECK_TRUE(smstate != nullptr);
-    std::vector<ActionsAndProbs> state_policies(num_players);
-    for (auto p = Player{0}; p < num_players; ++p) {
-      state_policies[p] = policy_func(p, state);
-      if (state_policies[p].empty()) {
-        SpielFatalError("Error in ExpectedReturnsImpl; infostate not found.");
-      }
+  }
+
+  while (scratch->child_reach.size() <= depth) {
+    scratch->child_reach.emplace_back(num_profiles_);
+  }
+  ForEachChild(state, reach, depth, scratch,
+               [&](const State& child, absl::Span<const double> probs) {
+                 std::vector<double>& child_reach = scratch->child_reach[depth];
+                 for (int k = 0; k < num_profiles_; ++k) {
+                   child_reach[k] = reach[k] * probs[k];
+                 }
+                 std::vector<double> child_values = Evaluate(
+                     child, child_reach, depth_limit - 1, depth + 1, scratch);
+                 for (int k = 0; k < num_profiles_; ++k) {
+                   for (auto p = Player{0}; p < num_players_; ++p) {
+                     const int i = k * num_players_ + p;
+                     values[i] += probs[k] * child_values[i];
+                   }
+                 }
+               });
+
+  if (shard != nullptr) {
+    // Another walk may have stored the values of other profiles meanwhile.
+    absl::MutexLock lock(&shard->mutex);
+    MemoEntry& entry = shard->entries[key];
+    if (entry.values.empty()) {
+      entry.values.assign(values.size(), 0.0);
+      entry.evaluated.assign(num_profiles_, false);
     }
-    for (const Action flat_action : smstate->LegalActions()) {
-      std::vector<Action> actions =
-          smstate->FlatJointActionToActions(flat_action);
-      double joint_action_prob = 1.0;
-      for (auto p = Player{0}; p < num_players; ++p) {
-        double player_action_prob = GetProb(state_policies[p], actions[p]);
-        SPIEL_CHECK_GE(player_action_prob, 0.0);
-        SPIEL_CHECK_LE(player_action_prob, 1.0);
-        joint_action_prob *= player_action_prob;
-        if (player_action_prob == 0.0) {
-          break;
-        }
+    for (int k = 0; k < num_profiles_; ++k) {
+      if (reach[k] == 0.0 || entry.evaluated[k]) continue;
+      entry.evaluated[k] = true;
+      for (auto p = Player{0}; p < num_players_; ++p) {
+        const int i = k * num_players_ + p;
+        entry.values[i] = values[i];
       }
+    }
+  }
+  return values;
+}
 
-      if (joint_action_prob > 0.0) {
-        std::unique_ptr<State> child = state.Clone();
-        child->ApplyActions(actions);
-        std::vector<double> child_values =
-            ExpectedReturnsImpl(*child, policy_func, depth_limit - 1);
-        for (auto p = Player{0}; p < num_players; ++p) {
-          values[p] += joint_action_prob * child_values[p];
-        }
+void ExpectedReturnsWalker::Split(const State& state,
+                                  const std::vector<double>& reach,
+                                  int depth_limit, int depth, Scratch* scratch,
+                                  std::vector<double>* values) {
+  const bool leaf = state.IsTerminal() || depth_limit == 0;
+  if (!leaf && depth >= options_.parallel_depth) {
+    tasks_.push_back({state.Clone(), reach, depth_limit, {}});
+    return;
+  }
+  if (leaf || !state.IsChanceNode()) AddRewards(state, reach, values);
+  if (leaf) return;
+
+  ForEachChild(state, reach, depth, scratch,
+               [&](const State& child, absl::Span<const double> probs) {
+                 std::vector<double> child_reach(num_profiles_);
+                 for (int k = 0; k < num_profiles_; ++k) {
+                   child_reach[k] = reach[k] * probs[k];
+                 }
+                 Split(child, child_reach, depth_limit - 1, depth + 1, scratch,
+                       values);
+               });
+}
+
+void ExpectedReturnsWalker::RunTasks() {
+  std::atomic<int> next_task{0};
+  absl::Mutex error_mutex;
+  std::exception_ptr error;
+  auto work = [&]() {
+    Scratch scratch;
+    try {
+      for (int i = next_task++; i < tasks_.size(); i = next_task++) {
+        Task& task = tasks_[i];
+        task.values = Evaluate(*task.state, task.reach, task.depth_limit, 0,
+                               &scratch);
       }
+    } catch (...) {
+      absl::MutexLock lock(&error_mutex);
+      if (!error) error = std::current_exception();
+      // Stop the other threads early.
+      next_task = tasks_.size();
     }
-  } else {
-    // Turn-based decision node.
-    Player player = state.CurrentPlayer();
-    ActionsAndProbs state_policy = policy_func(player, state);
-    if (state_policy.empty()) {
-      SpielFatalError("Error in ExpectedReturnsImpl; infostate not found.");
-    }
-    values = state.Rewards();
-    for (const Action action : state.LegalActions()) {
-      std::unique_ptr<State> child = state.Child(action);
-      double action_prob = GetProb(state_policy, action);
-      SPIEL_CHECK_GE(action_prob, 0.0);
-      SPIEL_CHECK_LE(action_prob, 1.0);
-      if (action_prob > 0.0) {
-        std::vector<double> child_values =
-            ExpectedReturnsImpl(*child, policy_func, depth_limit - 1);
-        for (auto p = Player{0}; p < num_players; ++p) {
-          values[p] += action_prob * child_values[p];
-        }
+  };
+
+  std::vector<Thread> threads;
+  const int num_threads =
+      std::min<int>(options_.num_threads, tasks_.size());
+  for (int t = 1; t < num_threads; ++t) threads.emplace_back(work);
+  work();
+  for (Thread& thread : threads) thread.join();
+  if (error) std::rethrow_exception(error);
+}
+
+std::vector<double> ExpectedReturnsWalker::Run(const State& state) {
+  Scratch scratch;
+  if (options_.num_threads <= 1) {
+    return Evaluate(state, ones_, options_.depth_limit, 0, &scratch);
+  }
+  std::vector<double> values(num_profiles_ * num_players_, 0.0);
+  Split(state, std::vector<double>(num_profiles_, 1.0), options_.depth_limit,
+        0, &scratch, &values);
+  RunTasks();
+  for (const Task& task : tasks_) {
+    for (int k = 0; k < num_profiles_; ++k) {
+      for (auto p = Player{0}; p < num_players_; ++p) {
+        const int i = k * num_players_ + p;
+        values[i] += task.reach[k] * task.values[i];
       }
     }
   }
-  SPIEL_CHECK_EQ(values.size(), state.NumPlayers());
   return values;
 }
+
 }  // namespace
 
 std::vector<double> ExpectedReturns(const State& state,
                                     const std::vector<const Policy*>& policies,
                                     int depth_limit,
                                     bool use_infostate_get_policy) {
-  if (use_infostate_get_policy) {
-    return ExpectedReturnsImpl(
-        state,
-        [&policies](Player player, const std::string& info_state) {
-          return policies[player]->GetStatePolicy(info_state);
-        },
-        depth_limit);
-  } else {
-    return ExpectedReturnsImpl(
-        state,
-        [&policies](Player player, const State& state) {
-          return policies[player]->GetStatePolicy(state);
-        },
-        depth_limit);
-  }
+  ExpectedReturnsOptions options;
+  options.depth_limit = depth_limit;
+  options.use_infostate_get_policy = use_infostate_get_policy;
+  return BatchedExpectedReturns(state, {policies}, options)[0];
 }
 
 std::vector<double> ExpectedReturns(const State& state,
                                     const Policy& joint_policy, int depth_limit,
                                     bool use_infostate_get_policy) {
-  if (use_infostate_get_policy) {
-    return ExpectedReturnsImpl(
-        state,
-        [&joint_policy](Player player, const std::string& info_state) {
-          return joint_policy.GetStatePolicy(info_state);
-        },
-        depth_limit);
-  } else {
-    return ExpectedReturnsImpl(
-        state,
-        [&joint_policy](Player player, const State& state) {
-          return joint_policy.GetStatePolicy(state);
-        },
-        depth_limit);
+  ExpectedReturnsOptions options;
+  options.depth_limit = depth_limit;
+  options.use_infostate_get_policy = use_infostate_get_policy;
+  return BatchedExpectedReturns(
+      state, {std::vector<const Policy*>(state.NumPlayers(), &joint_policy)},
+      options)[0];
+}
+
+std::vector<std::vector<double>> BatchedExpectedReturns(
+    const State& state,
+    const std::vector<std::vector<const Policy*>>& profiles,
+    const ExpectedReturnsOptions& options) {
+  const int num_players = state.NumPlayers();
+  for (const std::vector<const Policy*>& profile : profiles) {
+    SPIEL_CHECK_GE(profile.size(), num_players);
+  }
+  SPIEL_CHECK_GE(options.parallel_depth, 0);
+  ExpectedReturnsWalker walker(profiles, options, num_players);
+  const std::vector<double> values = walker.Run(state);
+
+  std::vector<std::vector<double>> profile_values(profiles.size());
+  for (int k = 0; k < profiles.size(); ++k) {
+    profile_values[k].assign(values.begin() + k * num_players,
+                             values.begin() + (k + 1) * num_players);
   }
+  return profile_values;
 }
 
 }  // namespace algorithms
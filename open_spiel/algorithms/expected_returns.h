@@ -16,6 +16,7 @@
 #define OPEN_SPIEL_ALGORITHMS_EXPECTED_RETURNS_H_
 
 #include <string>
+#include <vector>
 
 #include "open_spiel/policy.h"
 #include "open_spiel/spiel.h"
@@ -42,6 +43,38 @@ std::vector<double> ExpectedReturns(const State& state,
                                     const Policy& joint_policy, int depth_limit,
                                     bool use_infostate_get_policy = true);
 
+struct ExpectedReturnsOptions {
+  // As for ExpectedReturns above.
+  int depth_limit = -1;
+  bool use_infostate_get_policy = true;
+
+  // The number of threads to evaluate subtrees on, the calling one included.
+  int num_threads = 1;
+
+  // The subtrees rooted this many moves (chance ones included) below the
+  // starting state are split between the threads. The calling thread walks
+  // the nodes above them first. Deeper splits give more, smaller subtrees.
+  int parallel_depth = 2;
+
+  // Whether to cache the values of states by State::ToString, so a state
+  // reached by several histories is only evaluated once. This is only correct
+  // when the policies depend on nothing more than ToString, so not for
+  // policies over information states that hold history that ToString lacks.
+  bool memoize = false;
+};
+
+// Computes the expected returns of several policy profiles in one walk of the
+// tree, optionally on several threads. Each profile is one policy per player,
+// as for the first ExpectedReturns, which can be the same joint policy for
+// every player. Returns the values of each profile, indexed by profile then
+// player. A profile's policies are only asked for their policy at the states
+// the profile reaches, so they need not cover the others. The policies must be
+// safe to call from several threads.
+std::vector<std::vector<double>> BatchedExpectedReturns(
+    const State& state,
+    const std::vector<std::vector<const Policy*>>& profiles,
+    const ExpectedReturnsOptions& options);
+
 }  // namespace algorithms
 }  // namespace open_spiel
 
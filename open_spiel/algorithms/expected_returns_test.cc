@@ -0,0 +1,202 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/expected_returns.h"
+
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/match.h"
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+constexpr double kTolerance = 1e-9;
+
+void CheckValuesNear(const std::vector<double>& values,
+                     const std::vector<double>& expected) {
+  SPIEL_CHECK_EQ(values.size(), expected.size());
+  for (int p = 0; p < values.size(); ++p) {
+    SPIEL_CHECK_FLOAT_NEAR(values[p], expected[p], kTolerance);
+  }
+}
+
+// Every way of splitting the walk between threads gives the serial values,
+// for each profile of a batch.
+void BatchedMatchesSerial(const std::string& game_name) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  std::unique_ptr<State> root = game->NewInitialState();
+  const TabularPolicy uniform = GetUniformPolicy(*game);
+  const TabularPolicy random = GetRandomPolicy(*game, /*seed=*/5);
+  const TabularPolicy first_action = GetFirstActionPolicy(*game);
+  const std::vector<std::vector<const Policy*>> profiles = {
+      {&uniform, &uniform}, {&random, &first_action}, {&first_action, &random}};
+
+  for (int depth_limit : {-1, 3}) {
+    std::vector<std::vector<double>> expected;
+    for (const std::vector<const Policy*>& profile : profiles) {
+      expected.push_back(ExpectedReturns(*root, profile, depth_limit));
+    }
+    for (int num_threads : {1, 3}) {
+      for (int parallel_depth : {0, 1, 4}) {
+        ExpectedReturnsOptions options;
+        options.depth_limit = depth_limit;
+        options.num_threads = num_threads;
+        options.parallel_depth = parallel_depth;
+        std::vector<std::vector<double>> values =
+            BatchedExpectedReturns(*root, profiles, options);
+        SPIEL_CHECK_EQ(values.size(), profiles.size());
+        for (int k = 0; k < profiles.size(); ++k) {
+          CheckValuesNear(values[k], expected[k]);
+        }
+      }
+    }
+  }
+}
+
+// Always passes in Kuhn poker, with policies only at the information states
+// without a bet, which are the only ones it reaches.
+TabularPolicy KuhnAlwaysPass(const Game& game) {
+  TabularPolicy always_pass = GetFirstActionPolicy(game);
+  auto& table = always_pass.PolicyTable();
+  for (auto it = table.begin(); it != table.end();) {
+    it = absl::StrContains(it->first, 'b') ? table.erase(it) : std::next(it);
+  }
+  return always_pass;
+}
+
+// The uniform profile reaches the information states after a bet, which
+// mustn't be looked up for the profile that always passes.
+void SkipsUnreachedPolicies() {
+  std::shared_ptr<const Game> game = LoadGame("kuhn_poker");
+  std::unique_ptr<State> root = game->NewInitialState();
+  const TabularPolicy uniform = GetUniformPolicy(*game);
+  const TabularPolicy always_pass = KuhnAlwaysPass(*game);
+  const std::vector<std::vector<const Policy*>> profiles = {
+      {&uniform, &uniform}, {&always_pass, &always_pass}};
+  std::vector<std::vector<double>> expected;
+  for (const std::vector<const Policy*>& profile : profiles) {
+    expected.push_back(ExpectedReturns(*root, profile, -1));
+  }
+  for (int num_threads : {1, 3}) {
+    for (bool memoize : {false, true}) {
+      ExpectedReturnsOptions options;
+      options.num_threads = num_threads;
+      options.memoize = memoize;
+      std::vector<std::vector<double>> values =
+          BatchedExpectedReturns(*root, profiles, options);
+      for (int k = 0; k < profiles.size(); ++k) {
+        CheckValuesNear(values[k], expected[k]);
+      }
+    }
+  }
+}
+
+// A Nash equilibrium of Kuhn poker, the one where the first player never bets
+// first. See https://en.wikipedia.org/wiki/Kuhn_poker
+TabularPolicy KuhnEquilibrium() {
+  auto bet = [](double prob) {
+    return ActionsAndProbs{{0, 1 - prob}, {1, prob}};
+  };
+  return TabularPolicy({{"0", bet(0)},
+                        {"1", bet(0)},
+                        {"2", bet(0)},
+                        {"0pb", bet(0)},
+                        {"1pb", bet(1.0 / 3)},
+                        {"2pb", bet(1)},
+                        {"0p", bet(1.0 / 3)},
+                        {"1p", bet(0)},
+                        {"2p", bet(1)},
+                        {"0b", bet(0)},
+                        {"1b", bet(1.0 / 3)},
+                        {"2b", bet(1)}});
+}
+
+// Values of Kuhn poker known independently of the walker: 1/18 to the second
+// player at an equilibrium, 1/8 to the first when both play uniformly at
+// random, and nothing to either when both always pass.
+void KnownValues() {
+  std::shared_ptr<const Game> game = LoadGame("kuhn_poker");
+  std::unique_ptr<State> root = game->NewInitialState();
+  const TabularPolicy equilibrium = KuhnEquilibrium();
+  const TabularPolicy uniform = GetUniformPolicy(*game);
+  const TabularPolicy always_pass = KuhnAlwaysPass(*game);
+  const std::vector<std::vector<const Policy*>> profiles = {
+      {&equilibrium, &equilibrium},
+      {&uniform, &uniform},
+      {&always_pass, &always_pass}};
+  const std::vector<std::vector<double>> expected = {
+      {-1.0 / 18, 1.0 / 18}, {1.0 / 8, -1.0 / 8}, {0, 0}};
+
+  for (int k = 0; k < profiles.size(); ++k) {
+    CheckValuesNear(ExpectedReturns(*root, profiles[k], -1), expected[k]);
+  }
+  for (int num_threads : {1, 3}) {
+    ExpectedReturnsOptions options;
+    options.num_threads = num_threads;
+    std::vector<std::vector<double>> values =
+        BatchedExpectedReturns(*root, profiles, options);
+    for (int k = 0; k < profiles.size(); ++k) {
+      CheckValuesNear(values[k], expected[k]);
+    }
+  }
+}
+
+// Tic-tac-toe reaches most positions by many move orders, and the uniform
+// policy only depends on the position.
+void MemoizesTranspositions() {
+  std::shared_ptr<const Game> game = LoadGame("tic_tac_toe");
+  std::unique_ptr<State> root = game->NewInitialState();
+  const UniformPolicy uniform;
+  const std::vector<std::vector<const Policy*>> profiles = {
+      {&uniform, &uniform}};
+
+  ExpectedReturnsOptions options;
+  options.use_infostate_get_policy = false;
+  options.depth_limit = 5;
+  const std::vector<double> expected =
+      BatchedExpectedReturns(*root, profiles, options)[0];
+  options.memoize = true;
+  CheckValuesNear(BatchedExpectedReturns(*root, profiles, options)[0],
+                  expected);
+  options.num_threads = 2;
+  CheckValuesNear(BatchedExpectedReturns(*root, profiles, options)[0],
+                  expected);
+
+  // The whole game, which is only practical with memoization.
+  options.depth_limit = -1;
+  const std::vector<double> values =
+      BatchedExpectedReturns(*root, profiles, options)[0];
+  // Random play wins more often as the first player.
+  SPIEL_CHECK_GT(values[0], 0);
+  SPIEL_CHECK_FLOAT_NEAR(values[0], -values[1], kTolerance);
+}
+
+}  // namespace
+}  // namespace algorithms
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::algorithms::BatchedMatchesSerial("kuhn_poker");
+  open_spiel::algorithms::BatchedMatchesSerial("leduc_poker");
+  open_spiel::algorithms::SkipsUnreachedPolicies();
+  open_spiel::algorithms::KnownValues();
+  open_spiel::algorithms::MemoizesTranspositions();
+}
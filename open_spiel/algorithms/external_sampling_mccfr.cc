@@ -76,15 +76,13 @@ double ExternalSamplingMCCFRSolver::UpdateRegrets(const State& state,
   }
 
   Player cur_player = state.CurrentPlayer();
-  std::string is_key = state.InformationStateString(cur_player);
+  const InfostateId is_id =
+      info_states_.Intern(state.InformationStateString(cur_player));
   std::vector<Action> legal_actions = state.LegalActions();
 
-  // The insert here only inserts the default value if the key is not found,
-  // otherwise returns the entry in the map.
-  auto iter_and_result = info_states_.insert(
-      {is_key, CFRInfoStateValues(legal_actions, kInitialTableValues)});
-
-  CFRInfoStateValues info_state_copy = iter_and_result.first->second;
+  // Only adds the initial values if there are none yet.
+  CFRInfoStateValues info_state_copy = info_states_.FindOrAdd(
+      is_id, legal_actions, kInitialTableValues);
   info_state_copy.ApplyRegretMatching();
 
   double value = 0;
@@ -104,7 +102,7 @@ double ExternalSamplingMCCFRSolver::UpdateRegrets(const State& state,
   }
 
   // Now the regret and avg strategy updates.
-  CFRInfoStateValues& info_state = info_states_[is_key];
+  CFRInfoStateValues& info_state = *info_states_.Find(is_id);
 
   if (cur_player == player) {
     // Update regrets
@@ -147,15 +145,13 @@ void ExternalSamplingMCCFRSolver::FullUpdateAverage(
   if (sum == 0.0) return;
 
   Player cur_player = state.CurrentPlayer();
-  std::string is_key = state.InformationStateString(cur_player);
+  const InfostateId is_id =
+      info_states_.Intern(state.InformationStateString(cur_player));
   std::vector<Action> legal_actions = state.LegalActions();
 
-  // The insert here only inserts the default value if the key is not found,
-  // otherwise returns the entry in the map.
-  auto iter_and_result = info_states_.insert(
-      {is_key, CFRInfoStateValues(legal_actions, kInitialTableValues)});
-
-  CFRInfoStateValues info_state_copy = iter_and_result.first->second;
+  // Only adds the initial values if there are none yet.
+  CFRInfoStateValues info_state_copy = info_states_.FindOrAdd(
+      is_id, legal_actions, kInitialTableValues);
   info_state_copy.ApplyRegretMatching();
 
   for (int aidx = 0; aidx < legal_actions.size(); ++aidx) {
@@ -165,7 +161,7 @@ void ExternalSamplingMCCFRSolver::FullUpdateAverage(
   }
 
   // Now update the cumulative policy.
-  CFRInfoStateValues& info_state = info_states_[is_key];
+  CFRInfoStateValues& info_state = *info_states_.Find(is_id);
   for (int aidx = 0; aidx < legal_actions.size(); ++aidx) {
     info_state.cumulative_policy[aidx] +=
         (reach_probs[cur_player] * info_state_copy.current_policy[aidx]);
@@ -0,0 +1,298 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/flat_tabular_policy.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+
+namespace open_spiel::algorithms {
+namespace {
+
+// Identifies flat policy files, to avoid mapping something unrelated.
+constexpr uint64_t kMagic = 0x594c4f505f54414c;
+constexpr int kVersion = 1;
+
+// Marks the free slots of the hash index.
+constexpr uint32_t kEmptySlot = std::numeric_limits<uint32_t>::max();
+
+// The hashes are part of the file format, so they can't use absl::Hash, which
+// changes from one process to the next. This is 64-bit FNV-1a.
+uint64_t Fingerprint(absl::string_view info_state) {
+  uint64_t hash = 0xcbf29ce484222325;
+  for (char c : info_state) {
+    hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3;
+  }
+  return hash;
+}
+
+int64_t RoundUp(int64_t bytes) { return (bytes + 7) / 8 * 8; }
+
+// The byte offsets of the sections of the buffer. Each starts 8-byte aligned.
+struct Layout {
+  int64_t slots;
+  int64_t hashes;
+  int64_t key_offsets;
+  int64_t policy_offsets;
+  int64_t actions;
+  int64_t probs;
+  int64_t keys;
+  int64_t length;
+};
+
+Layout GetLayout(int64_t header_size, int64_t num_info_states,
+                 int64_t num_slots, int64_t num_actions, int64_t key_bytes) {
+  Layout layout;
+  layout.slots = header_size;
+  layout.hashes = layout.slots + RoundUp(num_slots * sizeof(uint32_t));
+  layout.key_offsets = layout.hashes + num_info_states * sizeof(uint64_t);
+  layout.policy_offsets =
+      layout.key_offsets + (num_info_states + 1) * sizeof(uint64_t);
+  layout.actions =
+      layout.policy_offsets + (num_info_states + 1) * sizeof(uint64_t);
+  layout.probs = layout.actions + num_actions * sizeof(Action);
+  layout.keys = layout.probs + RoundUp(num_actions * sizeof(float));
+  layout.length = layout.keys + RoundUp(key_bytes);
+  return layout;
+}
+
+}  // namespace
+
+// Stored at the start of the buffer, and so at the start of the file.
+struct FlatTabularPolicy::Header {
+  uint64_t magic;
+  int32_t version;
+  int32_t padding0;
+  int64_t num_info_states;
+  int64_t num_slots;  // A power of two, at least twice num_info_states.
+  int64_t num_actions;  // Summed over all the information states.
+  int64_t key_bytes;
+  char padding[16];
+};
+
+FlatTabularPolicy::FlatTabularPolicy(
+    const std::unordered_map<std::string, ActionsAndProbs>& table) {
+  static_assert(sizeof(Header) == 64, "The header is part of the file format.");
+  std::vector<const std::pair<const std::string, ActionsAndProbs>*> entries;
+  entries.reserve(table.size());
+  for (const auto& entry : table) entries.push_back(&entry);
+  std::sort(entries.begin(), entries.end(),
+            [](const auto* a, const auto* b) { return a->first < b->first; });
+  SPIEL_CHECK_LT(entries.size(), kEmptySlot);
+
+  Header h{};
+  h.magic = kMagic;
+  h.version = kVersion;
+  h.num_info_states = entries.size();
+  h.num_slots = 1;
+  while (h.num_slots < 2 * h.num_info_states) h.num_slots *= 2;
+  for (const auto* entry : entries) {
+    h.num_actions += entry->second.size();
+    h.key_bytes += entry->first.size();
+  }
+  const Layout layout = GetLayout(sizeof(Header), h.num_info_states,
+                                  h.num_slots, h.num_actions, h.key_bytes);
+
+  storage_.resize(layout.length / sizeof(uint64_t));
+  char* data = reinterpret_cast<char*>(storage_.data());
+  std::memcpy(data, &h, sizeof(Header));
+  uint32_t* slots = reinterpret_cast<uint32_t*>(data + layout.slots);
+  uint64_t* hashes = reinterpret_cast<uint64_t*>(data + layout.hashes);
+  uint64_t* key_offsets =
+      reinterpret_cast<uint64_t*>(data + layout.key_offsets);
+  uint64_t* policy_offsets =
+      reinterpret_cast<uint64_t*>(data + layout.policy_offsets);
+  Action* actions = reinterpret_cast<Action*>(data + layout.actions);
+  float* probs = reinterpret_cast<float*>(data + layout.probs);
+  char* keys = data + layout.keys;
+
+  std::fill(slots, slots + h.num_slots, kEmptySlot);
+  const uint64_t slot_mask = h.num_slots - 1;
+  uint64_t key_offset = 0;
+  uint64_t policy_offset = 0;
+  for (uint32_t i = 0; i < entries.size(); ++i) {
+    const auto& [info_state, state_policy] = *entries[i];
+    hashes[i] = Fingerprint(info_state);
+    uint64_t slot = hashes[i] & slot_mask;
+    while (slots[slot] != kEmptySlot) slot = (slot + 1) & slot_mask;
+    slots[slot] = i;
+
+    key_offsets[i] = key_offset;
+    std::memcpy(keys + key_offset, info_state.data(), info_state.size());
+    key_offset += info_state.size();
+
+    policy_offsets[i] = policy_offset;
+    for (const auto& [action, prob] : state_policy) {
+      actions[policy_offset] = action;
+      probs[policy_offset] = prob;
+      ++policy_offset;
+    }
+  }
+  key_offsets[entries.size()] = key_offset;
+  policy_offsets[entries.size()] = policy_offset;
+
+  data_ = data;
+  length_ = layout.length;
+  SetSections();
+}
+
+FlatTabularPolicy::~FlatTabularPolicy() {
+  if (fd_ >= 0) {
+    munmap(const_cast<char*>(data_), length_);
+    close(fd_);
+  }
+}
+
+std::unique_ptr<FlatTabularPolicy> FlatTabularPolicy::Load(
+    const std::string& path) {
+  std::unique_ptr<FlatTabularPolicy> policy(new FlatTabularPolicy());
+  policy->fd_ = open(path.c_str(), O_RDONLY);
+  if (policy->fd_ < 0) {
+    SpielFatalError(absl::StrCat("Failed to open flat policy: ", path));
+  }
+  struct stat st;
+  SPIEL_CHECK_EQ(fstat(policy->fd_, &st), 0);
+  if (st.st_size < sizeof(Header)) {
+    SpielFatalError(absl::StrCat("Not a flat policy: ", path));
+  }
+  void* addr =
+      mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, policy->fd_, 0);
+  if (addr == MAP_FAILED) {
+    SpielFatalError(absl::StrCat("Failed to mmap flat policy: ", path));
+  }
+  policy->data_ = static_cast<const char*>(addr);
+  policy->length_ = st.st_size;
+
+  const Header& h = *reinterpret_cast<const Header*>(policy->data_);
+  if (h.magic != kMagic) {
+    SpielFatalError(absl::StrCat("Not a flat policy: ", path));
+  }
+  if (h.version != kVersion) {
+    SpielFatalError(absl::StrCat("Flat policy ", path, " has version ",
+                                 h.version, ", expected ", kVersion));
+  }
+  const int64_t length = policy->SetSections();
+  if (length != st.st_size) {
+    SpielFatalError(absl::StrCat("Flat policy ", path, " has size ",
+                                 st.st_size, ", expected ", length,
+                                 ". Is it truncated?"));
+  }
+  return policy;
+}
+
+int64_t FlatTabularPolicy::SetSections() {
+  const Header& h = *reinterpret_cast<const Header*>(data_);
+  const Layout layout = GetLayout(sizeof(Header), h.num_info_states,
+                                  h.num_slots, h.num_actions, h.key_bytes);
+  num_info_states_ = h.num_info_states;
+  slot_mask_ = h.num_slots - 1;
+  slots_ = reinterpret_cast<const uint32_t*>(data_ + layout.slots);
+  hashes_ = reinterpret_cast<const uint64_t*>(data_ + layout.hashes);
+  key_offsets_ = reinterpret_cast<const uint64_t*>(data_ + layout.key_offsets);
+  policy_offsets_ =
+      reinterpret_cast<const uint64_t*>(data_ + layout.policy_offsets);
+  actions_ = reinterpret_cast<const Action*>(data_ + layout.actions);
+  probs_ = reinterpret_cast<const float*>(data_ + layout.probs);
+  keys_ = data_ + layout.keys;
+  return layout.length;
+}
+
+void FlatTabularPolicy::Save(const std::string& path) const {
+  file::File file(path, "w");
+  if (!file.Write(absl::string_view(data_, length_))) {
+    SpielFatalError(absl::StrCat("Failed to write flat policy: ", path));
+  }
+}
+
+TabularPolicy FlatTabularPolicy::ToTabularPolicy() const {
+  std::unordered_map<std::string, ActionsAndProbs> table;
+  table.reserve(num_info_states_);
+  for (int i = 0; i < num_info_states_; ++i) {
+    const StatePolicy state_policy = PolicyAt(i);
+    ActionsAndProbs& actions_and_probs = table[std::string(InfoState(i))];
+    actions_and_probs.reserve(state_policy.size());
+    for (int a = 0; a < state_policy.size(); ++a) {
+      actions_and_probs.push_back(
+          {state_policy.actions[a], state_policy.probs[a]});
+    }
+  }
+  return TabularPolicy(table);
+}
+
+int FlatTabularPolicy::NumInfoStates() const { return num_info_states_; }
+
+absl::string_view FlatTabularPolicy::InfoState(int index) const {
+  return absl::string_view(keys_ + key_offsets_[index],
+                           key_offsets_[index + 1] - key_offsets_[index]);
+}
+
+FlatTabularPolicy::StatePolicy FlatTabularPolicy::PolicyAt(int index) const {
+  const uint64_t begin = policy_offsets_[index];
+  const uint64_t size = policy_offsets_[index + 1] - begin;
+  return {absl::Span<const Action>(actions_ + begin, size),
+          absl::Span<const float>(probs_ + begin, size)};
+}
+
+int FlatTabularPolicy::Find(absl::string_view info_state) const {
+  const uint64_t hash = Fingerprint(info_state);
+  // There's always a free slot, so this ends.
+  for (uint64_t slot = hash & slot_mask_;; slot = (slot + 1) & slot_mask_) {
+    const uint32_t index = slots_[slot];
+    if (index == kEmptySlot) return -1;
+    if (hashes_[index] == hash && InfoState(index) == info_state) {
+      return index;
+    }
+  }
+}
+
+FlatTabularPolicy::StatePolicy FlatTabularPolicy::Lookup(
+    absl::string_view info_state) const {
+  const int index = Find(info_state);
+  if (index < 0) return {};
+  return PolicyAt(index);
+}
+
+ActionsAndProbs FlatTabularPolicy::GetStatePolicy(
+    const std::string& info_state) const {
+  ActionsAndProbs actions_and_probs;
+  FillStatePolicy(info_state, &actions_and_probs);
+  return actions_and_probs;
+}
+
+void FlatTabularPolicy::FillStatePolicy(const State& state,
+                                        ActionsAndProbs* policy) const {
+  FillStatePolicy(state.InformationStateString(), policy);
+}
+
+void FlatTabularPolicy::FillStatePolicy(const std::string& info_state,
+                                        ActionsAndProbs* policy) const {
+  const StatePolicy state_policy = Lookup(info_state);
+  policy->resize(state_policy.size());
+  for (int a = 0; a < state_policy.size(); ++a) {
+    (*policy)[a] = {state_policy.actions[a], state_policy.probs[a]};
+  }
+}
+
+}  // namespace open_spiel::algorithms
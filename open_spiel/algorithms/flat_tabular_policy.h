@@ -0,0 +1,115 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_FLAT_TABULAR_POLICY_H_
+#define OPEN_SPIEL_ALGORITHMS_FLAT_TABULAR_POLICY_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+
+namespace open_spiel::algorithms {
+
+// An immutable tabular policy stored in one contiguous buffer, for policies
+// too large to hold as a TabularPolicy. The buffer holds an open-addressing
+// hash index of the information states, their strings, and the legal actions
+// and probabilities (as floats) of every information state back to back.
+//
+// The buffer is also the file format, so Load just maps the file into memory:
+// it takes constant time however large the policy, and the pages are shared
+// by every process using the same file. Files are in the native byte order.
+class FlatTabularPolicy : public Policy {
+ public:
+  // The policy at one information state, pointing into the buffer.
+  struct StatePolicy {
+    absl::Span<const Action> actions;
+    absl::Span<const float> probs;
+
+    bool empty() const { return actions.empty(); }
+    int size() const { return actions.size(); }
+  };
+
+  explicit FlatTabularPolicy(
+      const std::unordered_map<std::string, ActionsAndProbs>& table);
+  explicit FlatTabularPolicy(const TabularPolicy& policy)
+      : FlatTabularPolicy(policy.PolicyTable()) {}
+  FlatTabularPolicy(const FlatTabularPolicy&) = delete;
+  FlatTabularPolicy& operator=(const FlatTabularPolicy&) = delete;
+  ~FlatTabularPolicy() override;
+
+  // Maps a file written by Save. The file must not change while it's mapped.
+  static std::unique_ptr<FlatTabularPolicy> Load(const std::string& path);
+
+  // Writes the policy so it can be loaded by Load.
+  void Save(const std::string& path) const;
+
+  // Converts back to a TabularPolicy, with the probabilities as doubles.
+  TabularPolicy ToTabularPolicy() const;
+
+  // The information states are numbered 0 .. NumInfoStates() - 1, in sorted
+  // order of their strings. The index isn't checked.
+  int NumInfoStates() const;
+  absl::string_view InfoState(int index) const;
+  StatePolicy PolicyAt(int index) const;
+
+  // The index of an information state, or -1 if it isn't in the policy.
+  int Find(absl::string_view info_state) const;
+
+  // The policy at an information state, or an empty one if it isn't in the
+  // policy. Doesn't copy or allocate.
+  StatePolicy Lookup(absl::string_view info_state) const;
+
+  ActionsAndProbs GetStatePolicy(const std::string& info_state) const override;
+  void FillStatePolicy(const State& state,
+                       ActionsAndProbs* policy) const override;
+  void FillStatePolicy(const std::string& info_state,
+                       ActionsAndProbs* policy) const override;
+
+ private:
+  struct Header;
+
+  FlatTabularPolicy() = default;
+
+  // Points the sections at the buffer starting at data_, and returns its
+  // expected length.
+  int64_t SetSections();
+
+  // Either points into storage_, or at the mapped file.
+  const char* data_ = nullptr;
+  int64_t length_ = 0;
+  std::vector<uint64_t> storage_;
+  int fd_ = -1;
+
+  // The sections of the buffer.
+  int num_info_states_ = 0;
+  uint64_t slot_mask_ = 0;
+  const uint32_t* slots_ = nullptr;
+  const uint64_t* hashes_ = nullptr;
+  const uint64_t* key_offsets_ = nullptr;
+  const uint64_t* policy_offsets_ = nullptr;
+  const Action* actions_ = nullptr;
+  const float* probs_ = nullptr;
+  const char* keys_ = nullptr;
+};
+
+}  // namespace open_spiel::algorithms
+
+#endif  // OPEN_SPIEL_ALGORITHMS_FLAT_TABULAR_POLICY_H_
@@ -0,0 +1,102 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/flat_tabular_policy.h"
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/algorithms/tabular_exploitability.h"
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+
+namespace open_spiel::algorithms {
+namespace {
+
+// Checks the flat policy holds the same policy as the table, up to rounding
+// the probabilities to floats.
+void CheckSamePolicy(const FlatTabularPolicy& flat,
+                     const TabularPolicy& tabular) {
+  SPIEL_CHECK_EQ(flat.NumInfoStates(), tabular.PolicyTable().size());
+  for (const auto& [info_state, actions_and_probs] : tabular.PolicyTable()) {
+    const int index = flat.Find(info_state);
+    SPIEL_CHECK_GE(index, 0);
+    SPIEL_CHECK_EQ(flat.InfoState(index), info_state);
+    const FlatTabularPolicy::StatePolicy state_policy =
+        flat.Lookup(info_state);
+    SPIEL_CHECK_EQ(state_policy.size(), actions_and_probs.size());
+    for (int a = 0; a < actions_and_probs.size(); ++a) {
+      SPIEL_CHECK_EQ(state_policy.actions[a], actions_and_probs[a].first);
+      SPIEL_CHECK_FLOAT_NEAR(state_policy.probs[a],
+                             actions_and_probs[a].second, 1e-7);
+    }
+  }
+}
+
+void ConvertsFromAndToTabularPolicy() {
+  for (const char* game_name : {"kuhn_poker", "leduc_poker"}) {
+    std::shared_ptr<const Game> game = LoadGame(game_name);
+    const TabularPolicy tabular = GetRandomPolicy(*game, /*seed=*/7);
+    const FlatTabularPolicy flat(tabular);
+    CheckSamePolicy(flat, tabular);
+    CheckSamePolicy(flat, flat.ToTabularPolicy());
+    SPIEL_CHECK_FLOAT_NEAR(Exploitability(*game, flat),
+                           Exploitability(*game, tabular), 1e-6);
+
+    // The information states are in sorted order.
+    for (int i = 1; i < flat.NumInfoStates(); ++i) {
+      SPIEL_CHECK_LT(flat.InfoState(i - 1), flat.InfoState(i));
+    }
+  }
+}
+
+void MissingInfoStates() {
+  const FlatTabularPolicy flat(TabularPolicy(
+      {{"a", {{0, 0.25}, {2, 0.75}}}, {"b", {{1, 1.0}}}}));
+  SPIEL_CHECK_EQ(flat.Find("c"), -1);
+  SPIEL_CHECK_TRUE(flat.Lookup("").empty());
+  SPIEL_CHECK_TRUE(flat.GetStatePolicy("ab").empty());
+  SPIEL_CHECK_TRUE(flat.GetStatePolicy("a") ==
+                   ActionsAndProbs({{0, 0.25}, {2, 0.75}}));
+
+  const FlatTabularPolicy empty(TabularPolicy{});
+  SPIEL_CHECK_EQ(empty.NumInfoStates(), 0);
+  SPIEL_CHECK_EQ(empty.Find("a"), -1);
+}
+
+void SavesAndLoads() {
+  std::shared_ptr<const Game> game = LoadGame("leduc_poker");
+  const TabularPolicy tabular = GetRandomPolicy(*game, /*seed=*/3);
+  const std::string path = absl::StrCat(
+      file::GetTmpDir(), "/open_spiel-test-", std::rand(), ".policy");
+  FlatTabularPolicy(tabular).Save(path);
+  {
+    std::unique_ptr<FlatTabularPolicy> loaded = FlatTabularPolicy::Load(path);
+    CheckSamePolicy(*loaded, tabular);
+  }
+  SPIEL_CHECK_TRUE(file::Remove(path));
+}
+
+}  // namespace
+}  // namespace open_spiel::algorithms
+
+int main(int argc, char** argv) {
+  open_spiel::algorithms::ConvertsFromAndToTabularPolicy();
+  open_spiel::algorithms::MissingInfoStates();
+  open_spiel::algorithms::SavesAndLoads();
+}
@@ -0,0 +1,77 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/infostate_interner.h"
+
+#include "open_spiel/abseil-cpp/absl/hash/hash.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace algorithms {
+
+InfostateInterner::Key InfostateInterner::MakeKey(
+    absl::string_view info_state) {
+  return {info_state, absl::Hash<absl::string_view>()(info_state)};
+}
+
+InfostateId InfostateInterner::Intern(absl::string_view info_state) {
+  const Key key = MakeKey(info_state);
+  {
+    absl::ReaderMutexLock lock(&mutex_);
+    auto it = ids_.find(key);
+    if (it != ids_.end()) return it->second;
+  }
+  absl::MutexLock lock(&mutex_);
+  // Another thread may have added it in between.
+  auto it = ids_.find(key);
+  if (it != ids_.end()) return it->second;
+  SPIEL_CHECK_LT(entries_.size(), kInvalidInfostateId);
+  const InfostateId id = entries_.size();
+  entries_.push_back({std::string(info_state), key.hash});
+  ids_.emplace(Key{entries_.back().info_state, key.hash}, id);
+  return id;
+}
+
+InfostateId InfostateInterner::Find(absl::string_view info_state) const {
+  const Key key = MakeKey(info_state);
+  absl::ReaderMutexLock lock(&mutex_);
+  auto it = ids_.find(key);
+  return it == ids_.end() ? kInvalidInfostateId : it->second;
+}
+
+const std::string& InfostateInterner::String(InfostateId id) const {
+  absl::ReaderMutexLock lock(&mutex_);
+  SPIEL_CHECK_LT(id, entries_.size());
+  return entries_[id].info_state;
+}
+
+size_t InfostateInterner::Hash(InfostateId id) const {
+  absl::ReaderMutexLock lock(&mutex_);
+  SPIEL_CHECK_LT(id, entries_.size());
+  return entries_[id].hash;
+}
+
+int InfostateInterner::Size() const {
+  absl::ReaderMutexLock lock(&mutex_);
+  return entries_.size();
+}
+
+void InfostateInterner::Clear() {
+  absl::MutexLock lock(&mutex_);
+  ids_.clear();
+  entries_.clear();
+}
+
+}  // namespace algorithms
+}  // namespace open_spiel
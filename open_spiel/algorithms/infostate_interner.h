@@ -0,0 +1,101 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_INFOSTATE_INTERNER_H_
+#define OPEN_SPIEL_ALGORITHMS_INFOSTATE_INTERNER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <string>
+
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+
+// Maps information state strings to small integer ids, so that the tables of
+// tabular algorithms can be vectors indexed by id rather than maps keyed by
+// long strings. Each string is hashed once, when it's interned, and stored
+// once however many tables use its id.
+
+namespace open_spiel {
+namespace algorithms {
+
+using InfostateId = uint32_t;
+inline constexpr InfostateId kInvalidInfostateId =
+    std::numeric_limits<InfostateId>::max();
+
+// The ids are 0, 1, 2, ... in the order the strings are first interned, and
+// stay valid until Clear. Thread-safe.
+class InfostateInterner {
+ public:
+  InfostateInterner() = default;
+  InfostateInterner(const InfostateInterner&) = delete;
+  InfostateInterner& operator=(const InfostateInterner&) = delete;
+
+  // Returns the id of the information state, adding it if it's new.
+  InfostateId Intern(absl::string_view info_state);
+
+  // Returns the id of the information state, or kInvalidInfostateId if it
+  // was never interned.
+  InfostateId Find(absl::string_view info_state) const;
+
+  // The information state of an id. The reference stays valid until Clear.
+  const std::string& String(InfostateId id) const;
+
+  // The hash of the information state of an id, computed when it was
+  // interned.
+  size_t Hash(InfostateId id) const;
+
+  // The number of information states interned.
+  int Size() const;
+
+  // Forgets all the information states. Not safe to call while the interner
+  // is in use from other threads, and invalidates all the ids.
+  void Clear();
+
+ private:
+  struct Entry {
+    std::string info_state;
+    size_t hash;
+  };
+
+  // A string with its hash, so growing the map doesn't hash it again.
+  struct Key {
+    absl::string_view info_state;
+    size_t hash;
+  };
+  struct KeyHash {
+    size_t operator()(const Key& key) const { return key.hash; }
+  };
+  struct KeyEq {
+    bool operator()(const Key& a, const Key& b) const {
+      return a.hash == b.hash && a.info_state == b.info_state;
+    }
+  };
+
+  static Key MakeKey(absl::string_view info_state);
+
+  mutable absl::Mutex mutex_;
+  // Never moved once added, so the keys can refer to their strings.
+  std::deque<Entry> entries_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<Key, InfostateId, KeyHash, KeyEq> ids_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace algorithms
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_ALGORITHMS_INFOSTATE_INTERNER_H_
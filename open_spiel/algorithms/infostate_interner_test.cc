@@ -0,0 +1,100 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/infostate_interner.h"
+
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/algorithms/cfr.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+void InternsEachStringOnce() {
+  InfostateInterner interner;
+  SPIEL_CHECK_EQ(interner.Find("a"), kInvalidInfostateId);
+  SPIEL_CHECK_EQ(interner.Intern("a"), 0);
+  SPIEL_CHECK_EQ(interner.Intern("bb"), 1);
+  SPIEL_CHECK_EQ(interner.Intern(std::string("a")), 0);
+  SPIEL_CHECK_EQ(interner.Find("bb"), 1);
+  SPIEL_CHECK_EQ(interner.Size(), 2);
+  SPIEL_CHECK_EQ(interner.String(1), "bb");
+  SPIEL_CHECK_NE(interner.Hash(0), interner.Hash(1));
+
+  // The strings keep their place as the interner grows.
+  const std::string& a = interner.String(0);
+  for (int i = 0; i < 10000; ++i) interner.Intern(absl::StrCat("s", i));
+  SPIEL_CHECK_EQ(&a, &interner.String(0));
+  SPIEL_CHECK_EQ(interner.Find("s9999"), 10001);
+
+  interner.Clear();
+  SPIEL_CHECK_EQ(interner.Size(), 0);
+  SPIEL_CHECK_EQ(interner.Find("a"), kInvalidInfostateId);
+  SPIEL_CHECK_EQ(interner.Intern("bb"), 0);
+}
+
+void InternsFromThreads() {
+  InfostateInterner interner;
+  constexpr int kNumThreads = 4;
+  constexpr int kNumStrings = 1000;
+  std::vector<std::vector<InfostateId>> ids(kNumThreads);
+  std::vector<Thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&interner, &ids, t]() {
+      for (int i = 0; i < kNumStrings; ++i) {
+        ids[t].push_back(interner.Intern(absl::StrCat("infostate ", i)));
+      }
+    });
+  }
+  for (Thread& thread : threads) thread.join();
+  SPIEL_CHECK_EQ(interner.Size(), kNumStrings);
+  for (int t = 1; t < kNumThreads; ++t) SPIEL_CHECK_EQ(ids[t], ids[0]);
+  for (int i = 0; i < kNumStrings; ++i) {
+    SPIEL_CHECK_EQ(interner.String(ids[0][i]), absl::StrCat("infostate ", i));
+  }
+}
+
+void CFRTablesShareAnInterner() {
+  std::shared_ptr<InfostateInterner> interner =
+      std::make_shared<InfostateInterner>();
+  CFRInfoStateValuesTable first(interner);
+  CFRInfoStateValuesTable second(interner);
+  first.FindOrAdd(first.Intern("x"), {0, 1});
+  const InfostateId y = second.Intern("y");
+  second.FindOrAdd(y, {2}).cumulative_regrets[0] = 3;
+  SPIEL_CHECK_EQ(interner->Size(), 2);
+  SPIEL_CHECK_EQ(first.size(), 1);
+  SPIEL_CHECK_TRUE(first.Find(y) == nullptr);
+  SPIEL_CHECK_TRUE(first.Find("y") == nullptr);
+  SPIEL_CHECK_EQ(second.Find("y")->cumulative_regrets[0], 3);
+  // Values are only created once.
+  SPIEL_CHECK_EQ(second.FindOrAdd(y, {2}).cumulative_regrets[0], 3);
+  SPIEL_CHECK_EQ(second.size(), 1);
+}
+
+}  // namespace
+}  // namespace algorithms
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::algorithms::InternsEachStringOnce();
+  open_spiel::algorithms::InternsFromThreads();
+  open_spiel::algorithms::CFRTablesShareAnInterner();
+}
@@ -46,6 +46,7 @@ ISMCTSBot::ISMCTSBot(int seed, std::shared_ptr<Evaluator> evaluator,
 double ISMCTSBot::RandomNumber() { return absl::Uniform(rng_, 0.0, 1.0); }
 
 void ISMCTSBot::Reset() {
+  infostates_.Clear();
   nodes_.clear();
   node_pool_.clear();
   root_samples_.clear();
@@ -64,7 +65,7 @@ ActionsAndProbs ISMCTSBot::RunSearch(const State& state) {
   SPIEL_CHECK_EQ(state.GetGame()->GetType().dynamics,
                  GameType::Dynamics::kSequential);
 
-  root_node_ = CreateNewNode(state);
+  root_node_ = CreateNewNode(infostates_.Intern(GetStateKey(state)));
   SPIEL_CHECK_TRUE(root_node_ != nullptr);
 
   std::string root_infostate_key = GetStateKey(state);
@@ -189,30 +190,21 @@ std::unique_ptr<State> ISMCTSBot::ISMCTSBot::SampleRootState(
   }
 }
 
-ISMCTSNode* ISMCTSBot::CreateNewNode(const State& state) {
-  std::string infostate_key = GetStateKey(state);
+ISMCTSNode* ISMCTSBot::CreateNewNode(InfostateId infostate) {
   node_pool_.push_back(std::unique_ptr<ISMCTSNode>(new ISMCTSNode));
   ISMCTSNode* node = node_pool_.back().get();
-  nodes_[infostate_key] = node;
+  if (infostate >= nodes_.size()) nodes_.resize(infostate + 1, nullptr);
+  nodes_[infostate] = node;
   node->total_visits = kUnexpandedVisitCount;
   return node;
 }
 
-ISMCTSNode* ISMCTSBot::LookupNode(const State& state) {
-  auto iter = nodes_.find(GetStateKey(state));
-  if (iter == nodes_.end()) {
-    return nullptr;
-  } else {
-    return iter->second;
-  }
-}
-
 ISMCTSNode* ISMCTSBot::LookupOrCreateNode(const State& state) {
-  ISMCTSNode* node = LookupNode(state);
-  if (node != nullptr) {
-    return node;
+  const InfostateId infostate = infostates_.Intern(GetStateKey(state));
+  if (infostate < nodes_.size() && nodes_[infostate] != nullptr) {
+    return nodes_[infostate];
   } else {
-    return CreateNewNode(state);
+    return CreateNewNode(infostate);
   }
 }
 
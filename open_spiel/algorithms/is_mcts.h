@@ -18,8 +18,10 @@
 #include <memory>
 #include <random>
 #include <string>
+#include <vector>
 
 #include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
+#include "open_spiel/algorithms/infostate_interner.h"
 #include "open_spiel/algorithms/mcts.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_bots.h"
@@ -95,8 +97,7 @@ class ISMCTSBot : public Bot {
 
   std::string GetStateKey(const State& state) const;
   std::unique_ptr<State> SampleRootState(const State& state);
-  ISMCTSNode* CreateNewNode(const State& state);
-  ISMCTSNode* LookupNode(const State& state);
+  ISMCTSNode* CreateNewNode(InfostateId infostate);
   ISMCTSNode* LookupOrCreateNode(const State& state);
   Action SelectActionTreePolicy(ISMCTSNode* node,
                                 const std::vector<Action>& legal_actions);
@@ -120,7 +121,9 @@ class ISMCTSBot : public Bot {
 
   std::mt19937 rng_;
   std::shared_ptr<Evaluator> evaluator_;
-  absl::flat_hash_map<std::string, ISMCTSNode*> nodes_;
+  // The nodes, by the id of their state's key.
+  InfostateInterner infostates_;
+  std::vector<ISMCTSNode*> nodes_;
   std::vector<std::unique_ptr<ISMCTSNode>> node_pool_;
 
   // If the number of sampled world state is restricted, this list is used to
@@ -107,15 +107,13 @@ double OutcomeSamplingMCCFRSolver::SampleEpisode(State* state,
   SPIEL_CHECK_PROB(sample_reach);
 
   int player = state->CurrentPlayer();
-  std::string is_key = state->InformationStateString(player);
+  const InfostateId is_id =
+      info_states_.Intern(state->InformationStateString(player));
   std::vector<Action> legal_actions = state->LegalActions();
 
-  // The insert here only inserts the default value if the key is not found,
-  // otherwise returns the entry in the map.
-  auto iter_and_result = info_states_.insert(
-      {is_key, CFRInfoStateValues(legal_actions, kInitialTableValues)});
-
-  CFRInfoStateValues info_state_copy = iter_and_result.first->second;
+  // Only adds the initial values if there are none yet.
+  CFRInfoStateValues info_state_copy = info_states_.FindOrAdd(
+      is_id, legal_actions, kInitialTableValues);
   info_state_copy.ApplyRegretMatching();
 
   const std::vector<double>& sample_policy =
@@ -156,7 +154,7 @@ double OutcomeSamplingMCCFRSolver::SampleEpisode(State* state,
 
   if (player == update_player_) {
     // Now the regret and avg strategy updates.
-    CFRInfoStateValues& info_state = info_states_[is_key];
+    CFRInfoStateValues& info_state = *info_states_.Find(is_id);
     info_state.ApplyRegretMatching();
 
     // Estimate for the counterfactual value of the policy.
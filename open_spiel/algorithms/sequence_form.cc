@@ -0,0 +1,370 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/sequence_form.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+using Entries = absl::flat_hash_map<std::pair<int, int>, double>;
+
+SparseMatrix FromEntries(int num_rows, int num_cols, const Entries& entries) {
+  std::vector<std::pair<std::pair<int, int>, double>> sorted(entries.begin(),
+                                                             entries.end());
+  std::sort(sorted.begin(), sorted.end());
+  SparseMatrix matrix;
+  matrix.num_rows = num_rows;
+  matrix.num_cols = num_cols;
+  matrix.row_starts.assign(num_rows + 1, 0);
+  for (const auto& [row_col, value] : sorted) {
+    ++matrix.row_starts[row_col.first + 1];
+    matrix.cols.push_back(row_col.second);
+    matrix.values.push_back(value);
+  }
+  for (int row = 0; row < num_rows; ++row) {
+    matrix.row_starts[row + 1] += matrix.row_starts[row];
+  }
+  return matrix;
+}
+
+// The walk building a SequenceForm: each player's current sequence, and
+// chance's probability of reaching the state.
+void Walk(const State& state, double chance_prob, std::array<int, 2>* sequence,
+          std::vector<std::vector<SequenceFormInfostate>>* infostates,
+          std::vector<absl::flat_hash_map<std::string, int>>* ids,
+          std::vector<std::vector<int>>* sequences,
+          std::vector<Entries>* payoffs) {
+  if (!state.IsChanceNode()) {
+    std::vector<double> rewards = state.Rewards();
+    for (Player p = 0; p < 2; ++p) {
+      if (rewards[p] != 0) {
+        (*payoffs)[p][{(*sequence)[0], (*sequence)[1]}] +=
+            chance_prob * rewards[p];
+      }
+    }
+  }
+  if (state.IsTerminal()) return;
+
+  if (state.IsChanceNode()) {
+    for (const auto& [action, prob] : state.ChanceOutcomes()) {
+      Walk(*state.Child(action), chance_prob * prob, sequence, infostates,
+           ids, sequences, payoffs);
+    }
+    return;
+  }
+
+  const Player player = state.CurrentPlayer();
+  const int parent = (*sequence)[player];
+  auto [it, inserted] = (*ids)[player].emplace(
+      state.InformationStateString(player), (*infostates)[player].size());
+  if (inserted) {
+    std::vector<Action> legal_actions = state.LegalActions();
+    const int first = (*sequences)[player].size();
+    for (int i = 0; i < legal_actions.size(); ++i) {
+      (*sequences)[player].push_back(it->second);
+    }
+    (*infostates)[player].push_back(
+        {it->first, std::move(legal_actions), parent, first});
+  }
+  const SequenceFormInfostate& infostate = (*infostates)[player][it->second];
+  // With perfect recall, the player got here by the same sequence each time.
+  SPIEL_CHECK_EQ(infostate.parent_sequence, parent);
+  const int first = infostate.first_sequence;
+  const std::vector<Action> legal_actions = infostate.legal_actions;
+  for (int i = 0; i < legal_actions.size(); ++i) {
+    (*sequence)[player] = first + i;
+    Walk(*state.Child(legal_actions[i]), chance_prob, sequence, infostates,
+         ids, sequences, payoffs);
+  }
+  (*sequence)[player] = parent;
+}
+
+double LogSumExp(const double* begin, const double* end) {
+  const double max = *std::max_element(begin, end);
+  double sum = 0;
+  for (const double* v = begin; v != end; ++v) sum += std::exp(*v - max);
+  return max + std::log(sum);
+}
+
+}  // namespace
+
+void SparseMatrix::Multiply(const std::vector<double>& vector,
+                            std::vector<double>* result) const {
+  SPIEL_CHECK_EQ(vector.size(), num_cols);
+  result->assign(num_rows, 0.);
+  for (int row = 0; row < num_rows; ++row) {
+    double sum = 0;
+    for (int i = row_starts[row]; i < row_starts[row + 1]; ++i) {
+      sum += values[i] * vector[cols[i]];
+    }
+    (*result)[row] = sum;
+  }
+}
+
+SparseMatrix SparseMatrix::Transpose() const {
+  Entries entries;
+  for (int row = 0; row < num_rows; ++row) {
+    for (int i = row_starts[row]; i < row_starts[row + 1]; ++i) {
+      entries[{cols[i], row}] = values[i];
+    }
+  }
+  return FromEntries(num_cols, num_rows, entries);
+}
+
+double SparseMatrix::At(int row, int col) const {
+  auto begin = cols.begin() + row_starts[row];
+  auto end = cols.begin() + row_starts[row + 1];
+  auto it = std::lower_bound(begin, end, col);
+  return it != end && *it == col ? values[it - cols.begin()] : 0.;
+}
+
+SequenceForm::SequenceForm(const Game& game)
+    : infostates_(2), sequences_(2, std::vector<int>{-1}), payoffs_(2) {
+  SPIEL_CHECK_EQ(game.NumPlayers(), 2);
+  SPIEL_CHECK_EQ(game.GetType().dynamics, GameType::Dynamics::kSequential);
+  std::array<int, 2> sequence = {0, 0};
+  std::vector<absl::flat_hash_map<std::string, int>> ids(2);
+  std::vector<Entries> payoffs(2);
+  Walk(*game.NewInitialState(), 1., &sequence, &infostates_, &ids,
+       &sequences_, &payoffs);
+  for (Player p = 0; p < 2; ++p) {
+    payoffs_[p] = FromEntries(NumSequences(0), NumSequences(1), payoffs[p]);
+  }
+}
+
+SparseMatrix SequenceForm::Constraints(Player player) const {
+  Entries entries;
+  entries[{0, 0}] = 1;
+  for (int j = 0; j < infostates_[player].size(); ++j) {
+    const SequenceFormInfostate& infostate = infostates_[player][j];
+    entries[{j + 1, infostate.parent_sequence}] = -1;
+    for (int i = 0; i < infostate.legal_actions.size(); ++i) {
+      entries[{j + 1, infostate.first_sequence + i}] = 1;
+    }
+  }
+  return FromEntries(infostates_[player].size() + 1, NumSequences(player),
+                     entries);
+}
+
+std::vector<double> SequenceForm::RealizationPlan(Player player,
+                                                  const Policy& policy) const {
+  std::vector<double> plan(NumSequences(player), 0.);
+  plan[0] = 1;
+  for (const SequenceFormInfostate& infostate : infostates_[player]) {
+    ActionsAndProbs state_policy = policy.GetStatePolicy(infostate.info_state);
+    for (int i = 0; i < infostate.legal_actions.size(); ++i) {
+      plan[infostate.first_sequence + i] =
+          plan[infostate.parent_sequence] *
+          std::max(0., GetProb(state_policy, infostate.legal_actions[i]));
+    }
+  }
+  return plan;
+}
+
+TabularPolicy SequenceForm::BehavioralPolicy(
+    const std::vector<std::vector<double>>& plans) const {
+  std::unordered_map<std::string, ActionsAndProbs> table;
+  for (Player p = 0; p < 2; ++p) {
+    SPIEL_CHECK_EQ(plans[p].size(), NumSequences(p));
+    for (const SequenceFormInfostate& infostate : infostates_[p]) {
+      const int num_actions = infostate.legal_actions.size();
+      const double reach = plans[p][infostate.parent_sequence];
+      ActionsAndProbs& state_policy = table[infostate.info_state];
+      for (int i = 0; i < num_actions; ++i) {
+        state_policy.emplace_back(
+            infostate.legal_actions[i],
+            reach > 0 ? plans[p][infostate.first_sequence + i] / reach
+                      : 1. / num_actions);
+      }
+    }
+  }
+  return TabularPolicy(table);
+}
+
+double SequenceForm::BestResponse(Player player,
+                                  const std::vector<double>& values,
+                                  std::vector<double>* plan) const {
+  SPIEL_CHECK_EQ(values.size(), NumSequences(player));
+  const std::vector<SequenceFormInfostate>& infostates = infostates_[player];
+  // The best value from each sequence on, working up from the last
+  // information states, whose sequences can't lead to any others.
+  std::vector<double> value = values;
+  std::vector<int> best(infostates.size());
+  for (int j = infostates.size() - 1; j >= 0; --j) {
+    const int first = infostates[j].first_sequence;
+    const int num_actions = infostates[j].legal_actions.size();
+    best[j] = std::max_element(value.begin() + first,
+                               value.begin() + first + num_actions) -
+              (value.begin() + first);
+    value[infostates[j].parent_sequence] += value[first + best[j]];
+  }
+  if (plan != nullptr) {
+    plan->assign(NumSequences(player), 0.);
+    (*plan)[0] = 1;
+    for (int j = 0; j < infostates.size(); ++j) {
+      (*plan)[infostates[j].first_sequence + best[j]] =
+          (*plan)[infostates[j].parent_sequence];
+    }
+  }
+  return value[0];
+}
+
+double SequenceForm::NashConv(
+    const std::vector<std::vector<double>>& plans) const {
+  double nash_conv = 0;
+  std::vector<double> values;
+  payoffs_[0].Multiply(plans[1], &values);
+  for (int s = 0; s < values.size(); ++s) nash_conv -= plans[0][s] * values[s];
+  nash_conv += BestResponse(0, values, nullptr);
+  payoffs_[1].Transpose().Multiply(plans[0], &values);
+  for (int s = 0; s < values.size(); ++s) nash_conv -= plans[1][s] * values[s];
+  nash_conv += BestResponse(1, values, nullptr);
+  return nash_conv;
+}
+
+SequenceFormMirrorProxSolver::SequenceFormMirrorProxSolver(const Game& game,
+                                                           double step_size)
+    : sequence_form_(game),
+      payoffs_transposed_(sequence_form_.Payoffs(0).Transpose()),
+      step_size_(step_size),
+      log_behavior_(2),
+      plans_(2),
+      plan_sums_(2) {
+  const GameType::Utility utility = game.GetType().utility;
+  SPIEL_CHECK_TRUE(utility == GameType::Utility::kZeroSum ||
+                   utility == GameType::Utility::kConstantSum);
+  SPIEL_CHECK_GT(step_size, 0);
+  for (Player p = 0; p < 2; ++p) {
+    // Start from the uniform policy, the center of the dilated entropy.
+    log_behavior_[p].assign(sequence_form_.NumSequences(p), 0.);
+    for (const SequenceFormInfostate& infostate :
+         sequence_form_.Infostates(p)) {
+      const int num_actions = infostate.legal_actions.size();
+      for (int i = 0; i < num_actions; ++i) {
+        log_behavior_[p][infostate.first_sequence + i] =
+            -std::log(num_actions);
+      }
+    }
+    Prox(p, log_behavior_[p],
+         std::vector<double>(sequence_form_.NumSequences(p), 0.),
+         &log_behavior_[p], &plans_[p]);
+    plan_sums_[p].assign(sequence_form_.NumSequences(p), 0.);
+  }
+}
+
+void SequenceFormMirrorProxSolver::Prox(
+    Player player, const std::vector<double>& log_behavior,
+    const std::vector<double>& gradient, std::vector<double>* next_log_behavior,
+    std::vector<double>* next_plan) const {
+  const std::vector<SequenceFormInfostate>& infostates =
+      sequence_form_.Infostates(player);
+  // The linear part of the objective: the step along the gradient, less the
+  // gradient of the dilated entropy (with unit weights) at the previous plan.
+  // That is log b(s) + 1 for a sequence s ending with an action played with
+  // probability b(s), less 1 for each information state s leads to.
+  std::vector<double> linear(gradient.size());
+  for (int s = 0; s < gradient.size(); ++s) {
+    linear[s] = step_size_ * gradient[s] - log_behavior[s] - 1;
+  }
+  for (const SequenceFormInfostate& infostate : infostates) {
+    linear[infostate.parent_sequence] += 1;
+  }
+
+  // Minimizing the linear part plus the dilated entropy, from the last
+  // information states up: each one's behavioral policy is the softmax of
+  // minus its sequences' values, and its own value their log-sum-exp.
+  next_log_behavior->resize(gradient.size());
+  (*next_log_behavior)[0] = 0;
+  std::vector<double>& logits = *next_log_behavior;
+  for (int j = infostates.size() - 1; j >= 0; --j) {
+    const int first = infostates[j].first_sequence;
+    const int num_actions = infostates[j].legal_actions.size();
+    for (int i = 0; i < num_actions; ++i) {
+      logits[first + i] = -linear[first + i];
+    }
+    const double log_sum =
+        LogSumExp(&logits[first], &logits[first] + num_actions);
+    for (int i = 0; i < num_actions; ++i) logits[first + i] -= log_sum;
+    linear[infostates[j].parent_sequence] -= log_sum;
+  }
+
+  next_plan->resize(gradient.size());
+  (*next_plan)[0] = 1;
+  for (const SequenceFormInfostate& infostate : infostates) {
+    for (int i = 0; i < infostate.legal_actions.size(); ++i) {
+      const int s = infostate.first_sequence + i;
+      (*next_plan)[s] =
+          (*next_plan)[infostate.parent_sequence] * std::exp(logits[s]);
+    }
+  }
+}
+
+void SequenceFormMirrorProxSolver::Gradients(
+    const std::vector<std::vector<double>>& plans,
+    std::vector<std::vector<double>>* gradients) const {
+  // Player 0 maximizes x' A y, and player 1 minimizes it.
+  gradients->resize(2);
+  sequence_form_.Payoffs(0).Multiply(plans[1], &(*gradients)[0]);
+  for (double& g : (*gradients)[0]) g = -g;
+  payoffs_transposed_.Multiply(plans[0], &(*gradients)[1]);
+}
+
+void SequenceFormMirrorProxSolver::RunIteration() {
+  // Step from the current plans along their gradients, then again from the
+  // current plans, along the gradients at the midpoint.
+  std::vector<std::vector<double>> gradients;
+  Gradients(plans_, &gradients);
+  std::vector<std::vector<double>> mid_log_behavior(2);
+  std::vector<std::vector<double>> mid_plans(2);
+  for (Player p = 0; p < 2; ++p) {
+    Prox(p, log_behavior_[p], gradients[p], &mid_log_behavior[p],
+         &mid_plans[p]);
+  }
+  Gradients(mid_plans, &gradients);
+  for (Player p = 0; p < 2; ++p) {
+    Prox(p, log_behavior_[p], gradients[p], &log_behavior_[p], &plans_[p]);
+    for (int s = 0; s < plans_[p].size(); ++s) {
+      plan_sums_[p][s] += mid_plans[p][s];
+    }
+  }
+  ++num_iterations_;
+}
+
+std::vector<std::vector<double>> SequenceFormMirrorProxSolver::AveragePlans()
+    const {
+  if (num_iterations_ == 0) return plans_;
+  std::vector<std::vector<double>> plans = plan_sums_;
+  for (std::vector<double>& plan : plans) {
+    for (double& p : plan) p /= num_iterations_;
+  }
+  return plans;
+}
+
+}  // namespace algorithms
+}  // namespace open_spiel
@@ -0,0 +1,169 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_SEQUENCE_FORM_H_
+#define OPEN_SPIEL_ALGORITHMS_SEQUENCE_FORM_H_
+
+#include <string>
+#include <vector>
+
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+
+// The sequence form of two-player games of perfect recall, and a first-order
+// method to solve the zero-sum ones.
+//
+// A player's strategy is represented by its realization plan: the probability
+// that the player plays each of their sequences of actions, given that the
+// other player and chance play to reach them. The plans of player 0 are the
+// vectors x >= 0 with E x = e, those of player 1 the vectors y >= 0 with
+// F y = f, and player 0's expected utility is x' A y. Unlike the normal form,
+// these are all linear in the size of the game tree. See von Stengel,
+// "Efficient computation of behavior strategies", Games and Economic Behavior
+// 14(2), 1996.
+
+namespace open_spiel {
+namespace algorithms {
+
+// A matrix in compressed sparse row format.
+struct SparseMatrix {
+  int num_rows = 0;
+  int num_cols = 0;
+  std::vector<int> row_starts;  // num_rows + 1 entries.
+  std::vector<int> cols;
+  std::vector<double> values;
+
+  // Sets `result` to this times `vector`.
+  void Multiply(const std::vector<double>& vector,
+                std::vector<double>* result) const;
+  SparseMatrix Transpose() const;
+  // The value at (row, col), which may not be stored.
+  double At(int row, int col) const;
+};
+
+// One of a player's information states, and the sequences that end with each
+// of its actions.
+struct SequenceFormInfostate {
+  std::string info_state;
+  std::vector<Action> legal_actions;
+  // The sequence that leads to this information state.
+  int parent_sequence;
+  // The sequence that ends with legal_actions[i] is first_sequence + i.
+  int first_sequence;
+};
+
+class SequenceForm {
+ public:
+  // Walks the whole game tree, so only for games small enough for tabular
+  // methods. The game must be sequential, with two players.
+  explicit SequenceForm(const Game& game);
+
+  // Sequence 0 is the empty one. The information states are ordered so that
+  // each one's parent sequence belongs to an earlier one.
+  int NumSequences(Player player) const {
+    return sequences_[player].size();
+  }
+  const std::vector<SequenceFormInfostate>& Infostates(Player player) const {
+    return infostates_[player];
+  }
+  // The information state a sequence's last action is taken in, or -1 for
+  // the empty sequence.
+  int SequenceInfostate(Player player, int sequence) const {
+    return sequences_[player][sequence];
+  }
+
+  // The expected utility of `player`, as a bilinear form of the players'
+  // realization plans: rows are player 0's sequences, and columns player 1's.
+  const SparseMatrix& Payoffs(Player player) const {
+    return payoffs_[player];
+  }
+
+  // E for player 0 and F for player 1: the first row requires the empty
+  // sequence to be played, and each other row that an information state's
+  // sequences are played as often as its parent sequence.
+  SparseMatrix Constraints(Player player) const;
+
+  // The realization plan of a policy, and the behavioral policy of a plan,
+  // which is uniform where the plan doesn't reach.
+  std::vector<double> RealizationPlan(Player player,
+                                      const Policy& policy) const;
+  TabularPolicy BehavioralPolicy(
+      const std::vector<std::vector<double>>& plans) const;
+
+  // Each player's gain from playing a best response to the other's plan,
+  // summed, as algorithms::NashConv would compute it for the policy.
+  double NashConv(const std::vector<std::vector<double>>& plans) const;
+
+  // The best value `player` can get over their plans x of the sum of
+  // x[s] * values[s], and a plan that achieves it, if `plan` isn't null.
+  double BestResponse(Player player, const std::vector<double>& values,
+                      std::vector<double>* plan) const;
+
+ private:
+  std::vector<std::vector<SequenceFormInfostate>> infostates_;
+  std::vector<std::vector<int>> sequences_;
+  std::vector<SparseMatrix> payoffs_;
+};
+
+// The mirror prox method of Nemirovski (SIAM Journal on Optimization 15(1),
+// 2004), using the dilated entropy over each player's realization plans as in
+// Kroer et al., "Faster first-order methods for extensive-form game solving"
+// (EC 2015). Each iteration multiplies by the payoff matrix four times, and
+// the NashConv of the average plans goes down as O(1 / iterations).
+class SequenceFormMirrorProxSolver {
+ public:
+  // The game must be zero-sum or constant-sum. Larger steps converge faster,
+  // up to the point where the iterates start to oscillate; 20 works well for
+  // kuhn_poker and leduc_poker.
+  SequenceFormMirrorProxSolver(const Game& game, double step_size);
+
+  void RunIteration();
+  int NumIterations() const { return num_iterations_; }
+
+  const SequenceForm& GetSequenceForm() const { return sequence_form_; }
+  std::vector<std::vector<double>> AveragePlans() const;
+  TabularPolicy AveragePolicy() const {
+    return sequence_form_.BehavioralPolicy(AveragePlans());
+  }
+  double NashConv() const {
+    return sequence_form_.NashConv(AveragePlans());
+  }
+
+ private:
+  // The Bregman proximal step from `log_behavior`, with respect to the
+  // dilated entropy, along `gradient`: the log behavioral probabilities and
+  // realization plan minimizing step_size_ * <gradient, x> + D(x, previous).
+  void Prox(Player player, const std::vector<double>& log_behavior,
+            const std::vector<double>& gradient,
+            std::vector<double>* next_log_behavior,
+            std::vector<double>* next_plan) const;
+  // The gradients of each player's loss at the given plans.
+  void Gradients(const std::vector<std::vector<double>>& plans,
+                 std::vector<std::vector<double>>* gradients) const;
+
+  const SequenceForm sequence_form_;
+  const SparseMatrix payoffs_transposed_;
+  const double step_size_;
+  int num_iterations_ = 0;
+  // Per player: the log of the behavioral probability of each sequence's last
+  // action, and the realization plan, at the current iterate.
+  std::vector<std::vector<double>> log_behavior_;
+  std::vector<std::vector<double>> plans_;
+  std::vector<std::vector<double>> plan_sums_;
+};
+
+}  // namespace algorithms
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_ALGORITHMS_SEQUENCE_FORM_H_
@@ -0,0 +1,125 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/sequence_form.h"
+
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "open_spiel/algorithms/expected_returns.h"
+#include "open_spiel/algorithms/tabular_exploitability.h"
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+// A policy with random probabilities at every information state.
+TabularPolicy RandomPolicy(const Game& game, std::mt19937* rng) {
+  TabularPolicy policy(game);
+  std::unordered_map<std::string, ActionsAndProbs> table =
+      policy.PolicyTable();
+  for (auto& [info_state, state_policy] : table) {
+    double total = 0;
+    for (auto& [action, prob] : state_policy) {
+      prob = std::uniform_real_distribution<double>(0.1, 1.)(*rng);
+      total += prob;
+    }
+    for (auto& [action, prob] : state_policy) prob /= total;
+  }
+  return TabularPolicy(table);
+}
+
+double Utility(const SequenceForm& sequence_form, Player player,
+               const std::vector<std::vector<double>>& plans) {
+  std::vector<double> values;
+  sequence_form.Payoffs(player).Multiply(plans[1], &values);
+  double utility = 0;
+  for (int s = 0; s < values.size(); ++s) utility += plans[0][s] * values[s];
+  return utility;
+}
+
+void SequenceFormMatchesGameTest(const std::string& game_name) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  SequenceForm sequence_form(*game);
+  std::mt19937 rng(7);
+  for (int i = 0; i < 5; ++i) {
+    TabularPolicy policy = RandomPolicy(*game, &rng);
+    std::vector<std::vector<double>> plans = {
+        sequence_form.RealizationPlan(0, policy),
+        sequence_form.RealizationPlan(1, policy)};
+
+    // The plans satisfy the constraints.
+    for (Player p = 0; p < 2; ++p) {
+      std::vector<double> constraints;
+      sequence_form.Constraints(p).Multiply(plans[p], &constraints);
+      SPIEL_CHECK_FLOAT_NEAR(constraints[0], 1., 1e-12);
+      for (int j = 1; j < constraints.size(); ++j) {
+        SPIEL_CHECK_FLOAT_NEAR(constraints[j], 0., 1e-12);
+      }
+    }
+
+    // The bilinear forms give the expected returns.
+    std::vector<double> returns = ExpectedReturns(
+        *game->NewInitialState(), policy, /*depth_limit=*/-1);
+    for (Player p = 0; p < 2; ++p) {
+      SPIEL_CHECK_FLOAT_NEAR(Utility(sequence_form, p, plans), returns[p],
+                             1e-12);
+    }
+
+    // The policy can be recovered from the plans, and has the same NashConv.
+    TabularPolicy recovered = sequence_form.BehavioralPolicy(plans);
+    for (const auto& [info_state, state_policy] : policy.PolicyTable()) {
+      ActionsAndProbs recovered_policy = recovered.GetStatePolicy(info_state);
+      for (const auto& [action, prob] : state_policy) {
+        SPIEL_CHECK_FLOAT_NEAR(GetProb(recovered_policy, action), prob,
+                               1e-12);
+      }
+    }
+    SPIEL_CHECK_FLOAT_NEAR(sequence_form.NashConv(plans),
+                           algorithms::NashConv(*game, policy), 1e-10);
+  }
+}
+
+void MirrorProxConvergesTest(const std::string& game_name, double step_size,
+                             int num_iterations, double max_nash_conv) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  SequenceFormMirrorProxSolver solver(*game, step_size);
+  for (int i = 0; i < num_iterations; ++i) solver.RunIteration();
+  const double nash_conv = solver.NashConv();
+  std::cout << game_name << ": NashConv " << nash_conv << " after "
+            << num_iterations << " iterations" << std::endl;
+  SPIEL_CHECK_LT(nash_conv, max_nash_conv);
+  SPIEL_CHECK_FLOAT_NEAR(
+      nash_conv, algorithms::NashConv(*game, solver.AveragePolicy()), 1e-10);
+}
+
+}  // namespace
+}  // namespace algorithms
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::algorithms::SequenceFormMatchesGameTest("kuhn_poker");
+  open_spiel::algorithms::SequenceFormMatchesGameTest("leduc_poker");
+  open_spiel::algorithms::MirrorProxConvergesTest("kuhn_poker", 20., 1000,
+                                                  1e-3);
+  open_spiel::algorithms::MirrorProxConvergesTest("leduc_poker", 20., 1000,
+                                                  2e-2);
+}
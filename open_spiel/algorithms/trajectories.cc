@@ -140,6 +140,7 @@ BatchedTrajectory RecordTrajectory(
   BatchedTrajectory trajectory(/*batch_size=*/1);
   std::unique_ptr<open_spiel::State> state = initial_state.Clone();
   bool find_index = !state_to_index.empty();
+  ActionsAndProbs policy;
   while (!state->IsTerminal()) {
     Action action = kInvalidAction;
     if (state->IsChanceNode()) {
@@ -160,9 +161,8 @@ BatchedTrajectory RecordTrajectory(
       } else {
         trajectory.observations[0].push_back(state->InformationStateTensor());
       }
-      ActionsAndProbs policy =
-          policies.at(state->CurrentPlayer())
-              .GetStatePolicy(state->InformationStateString());
+      policies.at(state->CurrentPlayer())
+          .FillStatePolicy(state->InformationStateString(), &policy);
       if (policy.size() > state->LegalActions().size()) {
         std::string policy_str = "";
         for (const auto& item : policy) {
@@ -0,0 +1,263 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/vector_env.h"
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+// Games with sampled chance may draw their outcomes from randomness owned by
+// the game, e.g. negotiation, or update the game when creating new states,
+// e.g. bridge_uncontested_bidding. This serializes both, across all the
+// VectorEnvs that might share the game.
+absl::Mutex* SampledChanceMutex() {
+  static absl::Mutex* mutex = new absl::Mutex();
+  return mutex;
+}
+
+}  // namespace
+
+VectorEnv::VectorEnv(std::shared_ptr<const Game> game, int num_envs, int seed,
+                     int num_threads)
+    : VectorEnv(game, num_envs, seed,
+                !game->GetType().provides_information_state_tensor,
+                num_threads) {}
+
+VectorEnv::VectorEnv(std::shared_ptr<const Game> game, int num_envs, int seed,
+                     bool use_observation, int num_threads)
+    : game_(std::move(game)),
+      num_envs_(num_envs),
+      use_observation_(use_observation),
+      tensor_size_(use_observation ? game_->ObservationTensorSize()
+                                   : game_->InformationStateTensorSize()),
+      actions_per_env_(game_->GetType().dynamics ==
+                               GameType::Dynamics::kSimultaneous
+                           ? game_->NumPlayers()
+                           : 1),
+      num_threads_(std::min(num_threads, num_envs)),
+      states_(num_envs) {
+  SPIEL_CHECK_GT(num_envs_, 0);
+  SPIEL_CHECK_GT(num_threads, 0);
+  if (use_observation_) {
+    SPIEL_CHECK_TRUE(game_->GetType().provides_observation_tensor);
+  } else {
+    SPIEL_CHECK_TRUE(game_->GetType().provides_information_state_tensor);
+  }
+  std::seed_seq seeds{seed};
+  std::vector<uint32_t> env_seeds(num_envs_);
+  seeds.generate(env_seeds.begin(), env_seeds.end());
+  rngs_.reserve(num_envs_);
+  for (uint32_t env_seed : env_seeds) rngs_.emplace_back(env_seed);
+
+  tensors_.resize(num_threads_);
+  for (int thread = 1; thread < num_threads_; ++thread) {
+    threads_.emplace_back([this, thread]() { RunWorker(thread); });
+  }
+}
+
+VectorEnv::~VectorEnv() {
+  {
+    absl::MutexLock lock(&pool_mutex_);
+    stop_ = true;
+    task_ready_.SignalAll();
+  }
+  for (Thread& thread : threads_) thread.join();
+}
+
+void VectorEnv::Reset(const VectorEnvTimeStep& time_step) {
+  CheckSizes(time_step, /*step=*/false);
+  absl::MutexLock lock(&mutex_);
+  ParallelFor([&](int begin, int end, int thread) {
+    for (int env = begin; env < end; ++env) {
+      states_[env] = NewInitialState();
+      SampleChance(states_[env].get(), &rngs_[env]);
+      WriteObservations(env, time_step, &tensors_[thread]);
+    }
+  });
+}
+
+void VectorEnv::Step(absl::Span<const Action> actions,
+                     const VectorEnvTimeStep& time_step) {
+  SPIEL_CHECK_EQ(actions.size(), num_envs_ * actions_per_env_);
+  CheckSizes(time_step, /*step=*/true);
+  const int num_players = game_->NumPlayers();
+  absl::MutexLock lock(&mutex_);
+  for (const std::unique_ptr<State>& state : states_) {
+    SPIEL_CHECK_TRUE(state != nullptr);
+  }
+  ParallelFor([&](int begin, int end, int thread) {
+    std::vector<Action> joint_action(actions_per_env_);
+    for (int env = begin; env < end; ++env) {
+      std::unique_ptr<State>& state = states_[env];
+      absl::Span<const Action> env_actions =
+          actions.subspan(env * actions_per_env_, actions_per_env_);
+      if (state->IsSimultaneousNode()) {
+        joint_action.assign(env_actions.begin(), env_actions.end());
+        state->ApplyActions(joint_action);
+      } else if (actions_per_env_ == 1) {
+        state->ApplyAction(env_actions[0]);
+      } else {
+        state->ApplyAction(env_actions[state->CurrentPlayer()]);
+      }
+      SampleChance(state.get(), &rngs_[env]);
+      // Like rl_environment.py, these are the rewards at the next decision, as
+      // states don't have to provide them at chance nodes.
+      std::vector<double> rewards = state->Rewards();
+      std::copy(rewards.begin(), rewards.end(),
+                time_step.rewards.begin() + env * num_players);
+      time_step.dones[env] = state->IsTerminal();
+      if (state->IsTerminal()) {
+        state = NewInitialState();
+        SampleChance(state.get(), &rngs_[env]);
+      }
+      WriteObservations(env, time_step, &tensors_[thread]);
+    }
+  });
+}
+
+const State& VectorEnv::GetState(int env) const {
+  SPIEL_CHECK_GE(env, 0);
+  SPIEL_CHECK_LT(env, num_envs_);
+  absl::MutexLock lock(&mutex_);
+  SPIEL_CHECK_TRUE(states_[env] != nullptr);
+  return *states_[env];
+}
+
+std::unique_ptr<State> VectorEnv::NewInitialState() const {
+  if (game_->GetType().chance_mode ==
+      GameType::ChanceMode::kSampledStochastic) {
+    absl::MutexLock lock(SampledChanceMutex());
+    return game_->NewInitialState();
+  }
+  return game_->NewInitialState();
+}
+
+void VectorEnv::SampleChance(State* state, std::mt19937* rng) const {
+  const bool sampled = game_->GetType().chance_mode ==
+                       GameType::ChanceMode::kSampledStochastic;
+  while (state->IsChanceNode()) {
+    const double z = std::uniform_real_distribution<double>(0., 1.)(*rng);
+    const Action outcome = SampleAction(state->ChanceOutcomes(), z).first;
+    absl::MutexLockMaybe lock(sampled ? SampledChanceMutex() : nullptr);
+    state->ApplyAction(outcome);
+  }
+}
+
+void VectorEnv::WriteObservations(int env, const VectorEnvTimeStep& time_step,
+                                  std::vector<double>* tensor) const {
+  const State& state = *states_[env];
+  const int num_players = game_->NumPlayers();
+  const int num_actions = game_->NumDistinctActions();
+  time_step.current_player[env] = state.CurrentPlayer();
+  for (Player player = 0; player < num_players; ++player) {
+    if (use_observation_) {
+      state.ObservationTensor(player, tensor);
+    } else {
+      state.InformationStateTensor(player, tensor);
+    }
+    SPIEL_CHECK_EQ(tensor->size(), tensor_size_);
+    std::copy(tensor->begin(), tensor->end(),
+              time_step.observations.begin() +
+                  (env * num_players + player) * tensor_size_);
+
+    absl::Span<int> mask = time_step.legal_actions_mask.subspan(
+        (env * num_players + player) * num_actions, num_actions);
+    std::fill(mask.begin(), mask.end(), 0);
+    for (Action action : state.LegalActions(player)) mask[action] = 1;
+  }
+}
+
+void VectorEnv::CheckSizes(const VectorEnvTimeStep& time_step,
+                           bool step) const {
+  const int num_players = game_->NumPlayers();
+  SPIEL_CHECK_EQ(time_step.observations.size(),
+                 num_envs_ * num_players * tensor_size_);
+  SPIEL_CHECK_EQ(time_step.legal_actions_mask.size(),
+                 num_envs_ * num_players * game_->NumDistinctActions());
+  SPIEL_CHECK_EQ(time_step.current_player.size(), num_envs_);
+  if (step) {
+    SPIEL_CHECK_EQ(time_step.rewards.size(), num_envs_ * num_players);
+    SPIEL_CHECK_EQ(time_step.dones.size(), num_envs_);
+  }
+}
+
+void VectorEnv::ParallelFor(const std::function<void(int, int, int)>& fn) {
+  if (num_threads_ == 1) {
+    fn(0, num_envs_, 0);
+    return;
+  }
+  {
+    absl::MutexLock lock(&pool_mutex_);
+    task_ = &fn;
+    ++task_id_;
+    num_running_ = threads_.size();
+    error_ = nullptr;
+    task_ready_.SignalAll();
+  }
+  // The calling thread takes the first range.
+  std::exception_ptr error;
+  try {
+    fn(RangeBegin(0), RangeBegin(1), 0);
+  } catch (...) {
+    error = std::current_exception();
+  }
+  absl::MutexLock lock(&pool_mutex_);
+  while (num_running_ > 0) task_done_.Wait(&pool_mutex_);
+  task_ = nullptr;
+  if (!error) error = error_;
+  if (error) std::rethrow_exception(error);
+}
+
+void VectorEnv::RunWorker(int thread) {
+  const int begin = RangeBegin(thread);
+  const int end = RangeBegin(thread + 1);
+  int64_t last_task_id = 0;
+  while (true) {
+    const std::function<void(int, int, int)>* task;
+    {
+      absl::MutexLock lock(&pool_mutex_);
+      while (!stop_ && task_id_ == last_task_id) {
+        task_ready_.Wait(&pool_mutex_);
+      }
+      if (stop_) return;
+      last_task_id = task_id_;
+      task = task_;
+    }
+    std::exception_ptr error;
+    try {
+      (*task)(begin, end, thread);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    absl::MutexLock lock(&pool_mutex_);
+    if (error && !error_) error_ = error;
+    if (--num_running_ == 0) task_done_.Signal();
+  }
+}
+
+}  // namespace algorithms
+}  // namespace open_spiel
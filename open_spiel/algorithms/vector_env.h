@@ -0,0 +1,146 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_VECTOR_ENV_H_
+#define OPEN_SPIEL_ALGORITHMS_VECTOR_ENV_H_
+
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/utils/thread.h"
+
+// A batch of environments of the same game, stepped together, for
+// reinforcement learning. It plays the role of python/rl_environment.py for
+// many episodes at once: chance nodes are sampled internally, episodes are
+// restarted as soon as they end, and each step's results are written to
+// caller-provided buffers rather than returned as new vectors.
+
+namespace open_spiel {
+namespace algorithms {
+
+// The buffers a time step of every environment is written to. They are all
+// row-major, with the environment as their first dimension.
+struct VectorEnvTimeStep {
+  // [num_envs, num_players, TensorSize()]: each player's observation or
+  // information state tensor.
+  absl::Span<double> observations;
+  // [num_envs, num_players, num_distinct_actions]: each player's legal
+  // actions, which are all 0 for the players not to play.
+  absl::Span<int> legal_actions_mask;
+  // [num_envs]: the player to play, which is kSimultaneousPlayerId at the
+  // simultaneous nodes.
+  absl::Span<int> current_player;
+  // [num_envs, num_players]: the rewards received during the step. Not written
+  // by Reset.
+  absl::Span<double> rewards;
+  // [num_envs]: whether the episode ended during the step, in which case the
+  // observations are those of the start of the next one. Not written by Reset.
+  absl::Span<bool> dones;
+};
+
+// Reset and Step lock the environments, so a VectorEnv can be used from
+// several threads, but each call waits for the previous ones to finish.
+class VectorEnv {
+ public:
+  // Uses the information state tensors if the game provides them, and the
+  // observation tensors otherwise, like rl_environment.py. The environments
+  // are split between `num_threads` threads, the calling one included, and
+  // each samples its chance nodes with its own generator, so the episodes
+  // don't depend on the number of threads.
+  VectorEnv(std::shared_ptr<const Game> game, int num_envs, int seed,
+            int num_threads = 1);
+  VectorEnv(std::shared_ptr<const Game> game, int num_envs, int seed,
+            bool use_observation, int num_threads = 1);
+  ~VectorEnv();
+
+  int NumEnvs() const { return num_envs_; }
+  int NumThreads() const { return num_threads_; }
+  const Game& GetGame() const { return *game_; }
+  bool UsesObservation() const { return use_observation_; }
+  // The size of each player's observations.
+  int TensorSize() const { return tensor_size_; }
+  // 1 for sequential games, where only the player to play acts. The number of
+  // players for simultaneous ones, which take an action from each player:
+  // their action in the sequential nodes of the game is that of the player to
+  // play, and the others' are ignored.
+  int ActionsPerEnv() const { return actions_per_env_; }
+
+  // Starts a new episode in every environment, and writes their observations.
+  void Reset(const VectorEnvTimeStep& time_step);
+
+  // Applies actions[i * ActionsPerEnv(), (i + 1) * ActionsPerEnv()) in the
+  // i-th environment, samples chance nodes until the next decision, and
+  // restarts the episodes that ended. Reset must have been called first.
+  void Step(absl::Span<const Action> actions,
+            const VectorEnvTimeStep& time_step);
+
+  // The current state of an environment. Not thread-safe with Reset or Step.
+  const State& GetState(int env) const;
+
+ private:
+  std::unique_ptr<State> NewInitialState() const;
+  // Samples chance outcomes until a decision or terminal node.
+  void SampleChance(State* state, std::mt19937* rng) const;
+  void WriteObservations(int env, const VectorEnvTimeStep& time_step,
+                         std::vector<double>* tensor) const;
+  void CheckSizes(const VectorEnvTimeStep& time_step, bool step) const;
+
+  // Calls fn(begin, end, thread) for a contiguous range of environments on
+  // each thread, and waits for them all to return.
+  void ParallelFor(const std::function<void(int, int, int)>& fn);
+  int RangeBegin(int thread) const {
+    return static_cast<int64_t>(num_envs_) * thread / num_threads_;
+  }
+  void RunWorker(int thread);
+
+  const std::shared_ptr<const Game> game_;
+  const int num_envs_;
+  const bool use_observation_;
+  const int tensor_size_;
+  const int actions_per_env_;
+  const int num_threads_;
+
+  mutable absl::Mutex mutex_;
+  std::vector<std::mt19937> rngs_ ABSL_GUARDED_BY(mutex_);
+  std::vector<std::unique_ptr<State>> states_ ABSL_GUARDED_BY(mutex_);
+  // Scratch space for each thread's tensors, so they aren't allocated on
+  // every step.
+  std::vector<std::vector<double>> tensors_ ABSL_GUARDED_BY(mutex_);
+
+  // The threads other than the calling one, and the task they run next.
+  std::vector<Thread> threads_;
+  absl::Mutex pool_mutex_;
+  absl::CondVar task_ready_;
+  absl::CondVar task_done_;
+  const std::function<void(int, int, int)>* task_ ABSL_GUARDED_BY(pool_mutex_) =
+      nullptr;
+  int64_t task_id_ ABSL_GUARDED_BY(pool_mutex_) = 0;
+  int num_running_ ABSL_GUARDED_BY(pool_mutex_) = 0;
+  // The first error a thread raised, rethrown by the calling one. Only from
+  // Python, as SpielFatalError exits otherwise.
+  std::exception_ptr error_ ABSL_GUARDED_BY(pool_mutex_);
+  bool stop_ ABSL_GUARDED_BY(pool_mutex_) = false;
+};
+
+}  // namespace algorithms
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_ALGORITHMS_VECTOR_ENV_H_
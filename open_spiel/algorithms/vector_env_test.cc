@@ -0,0 +1,217 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/vector_env.h"
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+// The storage behind a VectorEnvTimeStep.
+struct TimeStepBuffers {
+  TimeStepBuffers(const Game& game, const VectorEnv& env)
+      : observations(env.NumEnvs() * game.NumPlayers() * env.TensorSize()),
+        legal_actions_mask(env.NumEnvs() * game.NumPlayers() *
+                           game.NumDistinctActions()),
+        current_player(env.NumEnvs()),
+        rewards(env.NumEnvs() * game.NumPlayers()),
+        dones(new bool[env.NumEnvs()]) {
+    time_step.observations = absl::MakeSpan(observations);
+    time_step.legal_actions_mask = absl::MakeSpan(legal_actions_mask);
+    time_step.current_player = absl::MakeSpan(current_player);
+    time_step.rewards = absl::MakeSpan(rewards);
+    time_step.dones = absl::MakeSpan(dones.get(), env.NumEnvs());
+  }
+
+  // A random legal action for each player to play in each environment, and
+  // 0 for the others.
+  std::vector<Action> RandomActions(const Game& game, const VectorEnv& env,
+                                    std::mt19937* rng) const {
+    const int num_players = game.NumPlayers();
+    const int num_actions = game.NumDistinctActions();
+    std::vector<Action> actions;
+    for (int i = 0; i < env.NumEnvs(); ++i) {
+      for (int j = 0; j < env.ActionsPerEnv(); ++j) {
+        const Player player =
+            env.ActionsPerEnv() == 1 ? current_player[i] : j;
+        const int* mask =
+            &legal_actions_mask[(i * num_players + player) * num_actions];
+        std::vector<Action> legal_actions;
+        for (Action a = 0; a < num_actions; ++a) {
+          if (mask[a]) legal_actions.push_back(a);
+        }
+        actions.push_back(
+            legal_actions.empty()
+                ? 0
+                : legal_actions[(*rng)() % legal_actions.size()]);
+      }
+    }
+    return actions;
+  }
+
+  std::vector<double> observations;
+  std::vector<int> legal_actions_mask;
+  std::vector<int> current_player;
+  std::vector<double> rewards;
+  std::unique_ptr<bool[]> dones;  // Not a vector<bool>, which has no data().
+  VectorEnvTimeStep time_step;
+};
+
+void CheckTimeStepMatchesStates(const Game& game, const VectorEnv& env,
+                                const TimeStepBuffers& buffers) {
+  const int num_players = game.NumPlayers();
+  const int num_actions = game.NumDistinctActions();
+  for (int i = 0; i < env.NumEnvs(); ++i) {
+    const State& state = env.GetState(i);
+    SPIEL_CHECK_FALSE(state.IsChanceNode());
+    SPIEL_CHECK_FALSE(state.IsTerminal());
+    SPIEL_CHECK_EQ(buffers.current_player[i], state.CurrentPlayer());
+    for (Player p = 0; p < num_players; ++p) {
+      std::vector<double> tensor = env.UsesObservation()
+                                       ? state.ObservationTensor(p)
+                                       : state.InformationStateTensor(p);
+      for (int j = 0; j < tensor.size(); ++j) {
+        SPIEL_CHECK_EQ(
+            buffers.observations[(i * num_players + p) * tensor.size() + j],
+            tensor[j]);
+      }
+      std::vector<int> mask = state.LegalActionsMask(p);
+      for (int a = 0; a < num_actions; ++a) {
+        SPIEL_CHECK_EQ(
+            buffers.legal_actions_mask[(i * num_players + p) * num_actions + a],
+            mask[a]);
+      }
+    }
+  }
+}
+
+void TimeStepsMatchStatesTest(const std::string& game_name,
+                              int num_threads) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  VectorEnv env(game, /*num_envs=*/5, /*seed=*/3, num_threads);
+  TimeStepBuffers buffers(*game, env);
+  std::mt19937 rng(1);
+  env.Reset(buffers.time_step);
+  int num_episodes = 0;
+  for (int step = 0; step < 100; ++step) {
+    CheckTimeStepMatchesStates(*game, env, buffers);
+    env.Step(buffers.RandomActions(*game, env, &rng), buffers.time_step);
+    for (int i = 0; i < env.NumEnvs(); ++i) {
+      double total = 0;
+      for (Player p = 0; p < game->NumPlayers(); ++p) {
+        const double reward = buffers.rewards[i * game->NumPlayers() + p];
+        // Every game tested has terminal rewards only.
+        if (!buffers.dones[i]) SPIEL_CHECK_EQ(reward, 0);
+        total += reward;
+      }
+      if (game->GetType().utility == GameType::Utility::kZeroSum) {
+        SPIEL_CHECK_FLOAT_EQ(total, 0);
+      }
+      num_episodes += buffers.dones[i];
+    }
+  }
+  SPIEL_CHECK_GT(num_episodes, 0);
+}
+
+// Each environment samples chance with its own generator, so the threads
+// don't change the episodes.
+void ThreadsDontChangeEpisodesTest(const std::string& game_name) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  VectorEnv serial_env(game, /*num_envs=*/13, /*seed=*/5, /*num_threads=*/1);
+  VectorEnv parallel_env(game, /*num_envs=*/13, /*seed=*/5, /*num_threads=*/4);
+  SPIEL_CHECK_EQ(parallel_env.NumThreads(), 4);
+  TimeStepBuffers serial_buffers(*game, serial_env);
+  TimeStepBuffers parallel_buffers(*game, parallel_env);
+  std::mt19937 rng(2);
+  serial_env.Reset(serial_buffers.time_step);
+  parallel_env.Reset(parallel_buffers.time_step);
+  for (int step = 0; step < 50; ++step) {
+    SPIEL_CHECK_EQ(serial_buffers.observations,
+                   parallel_buffers.observations);
+    SPIEL_CHECK_EQ(serial_buffers.legal_actions_mask,
+                   parallel_buffers.legal_actions_mask);
+    SPIEL_CHECK_EQ(serial_buffers.current_player,
+                   parallel_buffers.current_player);
+    std::vector<Action> actions =
+        serial_buffers.RandomActions(*game, serial_env, &rng);
+    serial_env.Step(actions, serial_buffers.time_step);
+    parallel_env.Step(actions, parallel_buffers.time_step);
+    SPIEL_CHECK_EQ(serial_buffers.rewards, parallel_buffers.rewards);
+    for (int i = 0; i < serial_env.NumEnvs(); ++i) {
+      SPIEL_CHECK_EQ(serial_buffers.dones[i], parallel_buffers.dones[i]);
+      SPIEL_CHECK_EQ(serial_env.GetState(i).HistoryString(),
+                     parallel_env.GetState(i).HistoryString());
+    }
+  }
+}
+
+void ObservationTest() {
+  std::shared_ptr<const Game> game = LoadGame("kuhn_poker");
+  VectorEnv env(game, /*num_envs=*/3, /*seed=*/0, /*use_observation=*/true);
+  SPIEL_CHECK_TRUE(env.UsesObservation());
+  SPIEL_CHECK_EQ(env.TensorSize(), game->ObservationTensorSize());
+  TimeStepBuffers buffers(*game, env);
+  env.Reset(buffers.time_step);
+  CheckTimeStepMatchesStates(*game, env, buffers);
+}
+
+void RestartsEpisodesTest() {
+  // Always playing the first legal action ends tic-tac-toe after 7 moves.
+  std::shared_ptr<const Game> game = LoadGame("tic_tac_toe");
+  VectorEnv env(game, /*num_envs=*/4, /*seed=*/0);
+  TimeStepBuffers buffers(*game, env);
+  env.Reset(buffers.time_step);
+  for (int step = 1; step <= 21; ++step) {
+    std::vector<Action> actions;
+    for (int i = 0; i < env.NumEnvs(); ++i) {
+      actions.push_back(env.GetState(i).LegalActions()[0]);
+    }
+    env.Step(actions, buffers.time_step);
+    for (int i = 0; i < env.NumEnvs(); ++i) {
+      SPIEL_CHECK_EQ(buffers.dones[i], step % 7 == 0);
+      SPIEL_CHECK_EQ(buffers.rewards[2 * i], step % 7 == 0 ? 1 : 0);
+      SPIEL_CHECK_EQ(env.GetState(i).History().size(), step % 7);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace algorithms
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  for (int num_threads : {1, 3}) {
+    open_spiel::algorithms::TimeStepsMatchStatesTest("kuhn_poker", num_threads);
+    open_spiel::algorithms::TimeStepsMatchStatesTest("leduc_poker",
+                                                     num_threads);
+    open_spiel::algorithms::TimeStepsMatchStatesTest("tic_tac_toe",
+                                                     num_threads);
+    // Simultaneous, and with sampled chance.
+    open_spiel::algorithms::TimeStepsMatchStatesTest("goofspiel", num_threads);
+    open_spiel::algorithms::TimeStepsMatchStatesTest("negotiation",
+                                                     num_threads);
+  }
+  open_spiel::algorithms::ThreadsDontChangeEpisodesTest("leduc_poker");
+  open_spiel::algorithms::ThreadsDontChangeEpisodesTest("goofspiel");
+  open_spiel::algorithms::ObservationTest();
+  open_spiel::algorithms::RestartsEpisodesTest();
+}
@@ -45,6 +45,9 @@ ABSL_FLAG(int, replay_buffer_size, 1 << 16,
           "How many states to store in the replay buffer.");
 ABSL_FLAG(double, replay_buffer_reuse, 3,
           "How many times to reuse each state in the replay buffer.");
+ABSL_FLAG(bool, replay_buffer_persist, false,
+          "Keep the replay buffer in a memory-mapped file in --path, so a "
+          "restarted run resumes with its buffer intact.");
 ABSL_FLAG(int, checkpoint_freq, 100, "Save a checkpoint every N steps.");
 ABSL_FLAG(int, max_simulations, 300, "How many simulations to run.");
 ABSL_FLAG(int, train_batch_size, 1 << 10,
@@ -54,7 +57,14 @@ ABSL_FLAG(int, inference_batch_size, 1,
 ABSL_FLAG(int, inference_threads, 0, "How many threads to run inference.");
 ABSL_FLAG(int, inference_cache, 1 << 18,
           "Whether to cache the results from inference.");
-ABSL_FLAG(std::string, devices, "/cpu:0", "Comma separated list of devices.");
+ABSL_FLAG(int, inference_max_wait_us, 1000,
+          "The longest an inference request waits for a batch to fill up. "
+          "Batches are usually sent sooner, based on the observed request "
+          "rate and inference time.");
+ABSL_FLAG(std::string, devices, "/cpu:0",
+          "Comma separated list of devices. The first is used for learning. "
+          "Devices named native, eg native:0, run inference in process "
+          "without TensorFlow.");
 ABSL_FLAG(bool, verbose, false, "Show the MCTS stats of possible moves.");
 ABSL_FLAG(int, actors, 4, "How many actors to run.");
 ABSL_FLAG(int, evaluators, 2, "How many evaluators to run.");
@@ -63,6 +73,12 @@ ABSL_FLAG(int, eval_levels, 7,
            " simulations for n in range(eval_levels). Default of 7 means "
            "running mcts with up to 1000 times more simulations."));
 ABSL_FLAG(int, max_steps, 0, "How many learn steps to run.");
+ABSL_FLAG(int, actor_processes, 0,
+          "How many actor processes, started with --actor_process, feed the "
+          "learner in addition to its own actors.");
+ABSL_FLAG(int, actor_process, -1,
+          "Run as this actor process for the learner running in --path, "
+          "instead of training. Use the same flags as the learner.");
 
 open_spiel::StopToken stop_token;
 
@@ -99,6 +115,7 @@ int main(int argc, char** argv) {
   config.train_batch_size = absl::GetFlag(FLAGS_train_batch_size);
   config.replay_buffer_size = absl::GetFlag(FLAGS_replay_buffer_size);
   config.replay_buffer_reuse = absl::GetFlag(FLAGS_replay_buffer_reuse);
+  config.replay_buffer_persist = absl::GetFlag(FLAGS_replay_buffer_persist);
   config.checkpoint_freq = absl::GetFlag(FLAGS_checkpoint_freq);
   config.evaluation_window = 100;
   config.uct_c = absl::GetFlag(FLAGS_uct_c);
@@ -107,6 +124,7 @@ int main(int argc, char** argv) {
   config.inference_batch_size = absl::GetFlag(FLAGS_inference_batch_size);
   config.inference_threads = absl::GetFlag(FLAGS_inference_threads);
   config.inference_cache = absl::GetFlag(FLAGS_inference_cache);
+  config.inference_max_wait_us = absl::GetFlag(FLAGS_inference_max_wait_us);
   config.policy_alpha = absl::GetFlag(FLAGS_policy_alpha);
   config.policy_epsilon = absl::GetFlag(FLAGS_policy_epsilon);
   config.temperature = absl::GetFlag(FLAGS_temperature);
@@ -117,6 +135,12 @@ int main(int argc, char** argv) {
   config.evaluators = absl::GetFlag(FLAGS_evaluators);
   config.eval_levels = absl::GetFlag(FLAGS_eval_levels);
   config.max_steps = absl::GetFlag(FLAGS_max_steps);
+  config.actor_processes = absl::GetFlag(FLAGS_actor_processes);
 
+  int actor_process = absl::GetFlag(FLAGS_actor_process);
+  if (actor_process >= 0) {
+    return !open_spiel::algorithms::AlphaZeroActorProcess(
+        config, actor_process, &stop_token);
+  }
   return !AlphaZero(config, &stop_token);
 }
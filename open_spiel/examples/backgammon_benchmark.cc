@@ -0,0 +1,98 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the speed of the backgammon move generator: how many times a
+// second it can list the legal moves of positions from random games, and how
+// many random games a second can be played through the State interface.
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_format.h"
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+ABSL_FLAG(int, games, 200,
+          "How many random games to play, and to collect positions from.");
+ABSL_FLAG(int, repeats, 10,
+          "How many times to list the moves of each collected position.");
+ABSL_FLAG(int, seed, 0, "Seed for the random moves.");
+
+namespace open_spiel {
+namespace {
+
+// Plays random games, returning the positions where a player is to move.
+std::vector<std::unique_ptr<State>> RandomGames(const Game& game, int games,
+                                                std::mt19937* rng) {
+  std::vector<std::unique_ptr<State>> positions;
+  int64_t moves = 0;
+  absl::Time start = absl::Now();
+  for (int i = 0; i < games; ++i) {
+    std::unique_ptr<State> state = game.NewInitialState();
+    while (!state->IsTerminal()) {
+      std::vector<Action> actions = state->LegalActions();
+      if (!state->IsChanceNode()) {
+        positions.push_back(state->Clone());
+        ++moves;
+      }
+      state->ApplyAction(actions[(*rng)() % actions.size()]);
+    }
+  }
+  double seconds = absl::ToDoubleSeconds(absl::Now() - start);
+  std::cout << absl::StrFormat(
+                   "%d random games in %.1f ms: %.0f games/s, %.0f moves/s",
+                   games, seconds * 1000, games / seconds, moves / seconds)
+            << std::endl;
+  return positions;
+}
+
+void ListMoves(const std::vector<std::unique_ptr<State>>& positions,
+               int repeats) {
+  int64_t calls = 0;
+  int64_t actions = 0;
+  absl::Time start = absl::Now();
+  for (int r = 0; r < repeats; ++r) {
+    for (const auto& state : positions) {
+      actions += state->LegalActions().size();
+      ++calls;
+    }
+  }
+  double seconds = absl::ToDoubleSeconds(absl::Now() - start);
+  std::cout << absl::StrFormat(
+                   "%d move lists in %.1f ms: %.0f lists/s, %.0f moves/s, "
+                   "%.1f moves/list",
+                   calls, seconds * 1000, calls / seconds, actions / seconds,
+                   static_cast<double>(actions) / calls)
+            << std::endl;
+}
+
+}  // namespace
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  std::mt19937 rng(absl::GetFlag(FLAGS_seed));
+  std::shared_ptr<const open_spiel::Game> game =
+      open_spiel::LoadGame("backgammon");
+  auto positions =
+      open_spiel::RandomGames(*game, absl::GetFlag(FLAGS_games), &rng);
+  open_spiel::ListMoves(positions, absl::GetFlag(FLAGS_repeats));
+}
@@ -0,0 +1,105 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Solves random bridge deals double dummy, in batches, and saves the results
+// to a file that the bridge games can be given as their `double_dummy_cache`
+// parameter. The deals are sampled through the bridge game's chance outcomes
+// from a std::mt19937 seeded with --seed, so that they can be dealt again in
+// the same order to generate data for them.
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_format.h"
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/games/bridge.h"
+#include "open_spiel/games/bridge/double_dummy_cache.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+
+ABSL_FLAG(int, num_deals, 1000, "How many deals to solve.");
+ABSL_FLAG(int, batch_size, 200, "How many deals to solve together.");
+ABSL_FLAG(int, seed, 0, "Seed for dealing the cards.");
+ABSL_FLAG(std::string, cache, "",
+          "File to add the results to. It's created if it doesn't exist. If "
+          "empty, the results aren't saved.");
+
+namespace open_spiel {
+namespace bridge {
+namespace {
+
+// Deals the cards the way a bridge state does: card by card, each chance
+// outcome sampled with the rng.
+ddTableDeal RandomDeal(const Game& game, std::mt19937* rng) {
+  std::unique_ptr<State> state = game.NewInitialState();
+  ddTableDeal deal{};
+  for (int i = 0; i < kNumCards; ++i) {
+    const double z = std::uniform_real_distribution<double>(0., 1.)(*rng);
+    const Action card = SampleAction(state->ChanceOutcomes(), z).first;
+    // Cards are rank * kNumSuits + suit, and dealt to each player in turn.
+    deal.cards[i % kNumPlayers][card % kNumSuits] +=
+        1 << (2 + card / kNumSuits);
+    state->ApplyAction(card);
+  }
+  return deal;
+}
+
+void SolveRandomDeals(int num_deals, int batch_size, int seed,
+                      const std::string& path) {
+  std::shared_ptr<const Game> game =
+      LoadGame("bridge", {{"use_double_dummy_result", GameParameter(false)}});
+  auto cache = path.empty() || !file::Exists(path)
+                   ? std::make_unique<DoubleDummyCache>()
+                   : std::make_unique<DoubleDummyCache>(path);
+  const int initial_size = cache->Size();
+
+  std::mt19937 rng(seed);
+  absl::Time start = absl::Now();
+  for (int begin = 0; begin < num_deals; begin += batch_size) {
+    std::vector<ddTableDeal> deals;
+    for (int i = begin; i < std::min(begin + batch_size, num_deals); ++i) {
+      deals.push_back(RandomDeal(*game, &rng));
+    }
+    cache->Solve(deals);
+    double seconds = absl::ToDoubleSeconds(absl::Now() - start);
+    std::cout << absl::StrFormat("%d deals in %.1f s: %.1f deals/s",
+                                 begin + deals.size(), seconds,
+                                 (begin + deals.size()) / seconds)
+              << std::endl;
+  }
+
+  std::cout << absl::StrFormat("%d new results, %d in total",
+                               cache->Size() - initial_size, cache->Size())
+            << std::endl;
+  if (!path.empty()) cache->Save(path);
+}
+
+}  // namespace
+}  // namespace bridge
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  open_spiel::bridge::SolveRandomDeals(
+      absl::GetFlag(FLAGS_num_deals), absl::GetFlag(FLAGS_batch_size),
+      absl::GetFlag(FLAGS_seed), absl::GetFlag(FLAGS_cache));
+}
@@ -0,0 +1,119 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Counts the leaf nodes of the chess move tree ("perft") from the standard
+// test positions, checks them against the published counts, and reports the
+// speed of the move generator.
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_format.h"
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/games/chess/chess_board.h"
+#include "open_spiel/spiel_utils.h"
+
+ABSL_FLAG(int, depth, 4, "How many moves deep to count.");
+ABSL_FLAG(std::string, fen, "",
+          "Count from this position instead of the standard ones. The count "
+          "isn't checked.");
+
+namespace open_spiel {
+namespace chess {
+namespace {
+
+struct PerftPosition {
+  std::string name;
+  std::string fen;
+  // The counts for depth 1, 2, ...
+  std::vector<uint64_t> nodes;
+};
+
+// From https://www.chessprogramming.org/Perft_Results.
+const std::vector<PerftPosition>& StandardPositions() {
+  static const auto* positions = new std::vector<PerftPosition>{
+      {"initial", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+       {20, 400, 8902, 197281, 4865609, 119060324}},
+      {"kiwipete",
+       "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+       {48, 2039, 97862, 4085603, 193690690, 8031647685}},
+      {"position3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+       {14, 191, 2812, 43238, 674624, 11030083}},
+      {"position4",
+       "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+       {6, 264, 9467, 422333, 15833292, 706045033}},
+      {"position5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+       {44, 1486, 62379, 2103487, 89941194}},
+      {"position6",
+       "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - "
+       "0 10",
+       {46, 2079, 89890, 3894594, 164075551, 6923051137}},
+  };
+  return *positions;
+}
+
+// Returns the number of nodes counted.
+uint64_t RunPerft(const std::string& name, const std::string& fen, int depth,
+                  const std::vector<uint64_t>& expected) {
+  auto board = StandardChessBoard::BoardFromFEN(fen);
+  if (!board) SpielFatalError(absl::StrCat("Invalid FEN: ", fen));
+
+  absl::Time start = absl::Now();
+  uint64_t nodes = Perft(*board, depth);
+  double seconds = absl::ToDoubleSeconds(absl::Now() - start);
+
+  std::cout << absl::StrFormat("%-10s depth %d: %12d nodes in %8.1f ms: "
+                               "%.0f nodes/s",
+                               name, depth, nodes, seconds * 1000,
+                               nodes / seconds)
+            << std::endl;
+  if (depth >= 1 && depth <= expected.size() &&
+      nodes != expected[depth - 1]) {
+    SpielFatalError(absl::StrCat("Perft of ", name, " at depth ", depth,
+                                 " gave ", nodes, " nodes, expected ",
+                                 expected[depth - 1], "."));
+  }
+  return nodes;
+}
+
+void PerftBenchmark(int depth, const std::string& fen) {
+  if (!fen.empty()) {
+    RunPerft("custom", fen, depth, {});
+    return;
+  }
+  absl::Time start = absl::Now();
+  uint64_t total = 0;
+  for (const PerftPosition& position : StandardPositions()) {
+    total += RunPerft(position.name, position.fen, depth, position.nodes);
+  }
+  double seconds = absl::ToDoubleSeconds(absl::Now() - start);
+  std::cout << absl::StrFormat("Total: %d nodes in %.1f ms: %.0f nodes/s",
+                               total, seconds * 1000, total / seconds)
+            << std::endl;
+}
+
+}  // namespace
+}  // namespace chess
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  open_spiel::chess::PerftBenchmark(absl::GetFlag(FLAGS_depth),
+                                    absl::GetFlag(FLAGS_fen));
+}
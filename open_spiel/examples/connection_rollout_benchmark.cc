@@ -0,0 +1,82 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures random rollouts per second of the connection games (hex, y and
+// havannah) on large boards, played through the State interface the way a
+// generic MCTS rollout does it.
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_format.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_split.h"
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+ABSL_FLAG(std::string, games,
+          "hex(board_size=19);y(board_size=19);havannah(board_size=10)",
+          "Semicolon separated games to benchmark.");
+ABSL_FLAG(int, rollouts, 200, "How many rollouts to run per game.");
+ABSL_FLAG(int, seed, 0, "Seed for the random moves.");
+
+namespace open_spiel {
+namespace {
+
+void Rollouts(const std::string& game_string, int rollouts,
+              std::mt19937* rng) {
+  std::shared_ptr<const Game> game = LoadGame(game_string);
+  std::unique_ptr<State> initial_state = game->NewInitialState();
+  int64_t moves = 0;
+  int first_player_wins = 0;
+  absl::Time start = absl::Now();
+  for (int i = 0; i < rollouts; ++i) {
+    std::unique_ptr<State> state = initial_state->Clone();
+    while (!state->IsTerminal()) {
+      std::vector<Action> actions = state->LegalActions();
+      state->ApplyAction(actions[(*rng)() % actions.size()]);
+      ++moves;
+    }
+    first_player_wins += state->Returns()[0] > 0;
+  }
+  double seconds = absl::ToDoubleSeconds(absl::Now() - start);
+  std::cout << absl::StrFormat(
+                   "%-24s %6d rollouts in %8.1f ms: %8.0f rollouts/s, "
+                   "%10.0f moves/s, %.1f moves/rollout, first player wins "
+                   "%.1f%%",
+                   game_string, rollouts, seconds * 1000, rollouts / seconds,
+                   moves / seconds, static_cast<double>(moves) / rollouts,
+                   100.0 * first_player_wins / rollouts)
+            << std::endl;
+}
+
+}  // namespace
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  std::mt19937 rng(absl::GetFlag(FLAGS_seed));
+  for (absl::string_view game :
+       absl::StrSplit(absl::GetFlag(FLAGS_games), ';')) {
+    open_spiel::Rollouts(std::string(game), absl::GetFlag(FLAGS_rollouts),
+                         &rng);
+  }
+}
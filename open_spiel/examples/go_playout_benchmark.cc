@@ -0,0 +1,122 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures random Go playouts per second, played directly on the GoBoard and,
+// for comparison, through the State interface the way a generic random
+// rollout does it.
+
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/abseil-cpp/absl/random/uniform_int_distribution.h"
+#include "open_spiel/abseil-cpp/absl/strings/numbers.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_format.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_split.h"
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/games/go.h"
+#include "open_spiel/games/go/go_board.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+ABSL_FLAG(std::string, board_sizes, "9,19",
+          "Comma separated board sizes to benchmark.");
+ABSL_FLAG(int, playouts, 1000, "How many playouts to run per board size.");
+ABSL_FLAG(int, state_playouts, 100,
+          "How many playouts to run through the State interface.");
+ABSL_FLAG(double, komi, 7.5, "Komi used to score the playouts.");
+ABSL_FLAG(int, seed, 0, "Seed for the random moves.");
+
+namespace open_spiel {
+namespace go {
+namespace {
+
+void Report(const std::string& name, int board_size, int playouts,
+            int64_t moves, int black_wins, absl::Duration time) {
+  double seconds = absl::ToDoubleSeconds(time);
+  std::cout << absl::StrFormat(
+                   "%dx%d %-6s %7d playouts in %8.1f ms: %9.0f playouts/s, "
+                   "%11.0f moves/s, %.1f moves/playout, black wins %.1f%%",
+                   board_size, board_size, name, playouts, seconds * 1000,
+                   playouts / seconds, moves / seconds,
+                   static_cast<double>(moves) / playouts,
+                   100.0 * black_wins / playouts)
+            << std::endl;
+}
+
+void BoardPlayouts(int board_size, int playouts, float komi,
+                   std::mt19937* rng) {
+  const GoBoard empty_board(board_size);
+  int64_t moves = 0;
+  int black_wins = 0;
+  absl::Time start = absl::Now();
+  for (int i = 0; i < playouts; ++i) {
+    GoBoard board = empty_board;
+    moves +=
+        board.RandomPlayout(GoColor::kBlack, MaxGameLength(board_size), rng);
+    black_wins += TrompTaylorScore(board, komi) > 0;
+  }
+  Report("board", board_size, playouts, moves, black_wins,
+         absl::Now() - start);
+}
+
+void StatePlayouts(int board_size, int playouts, float komi,
+                   std::mt19937* rng) {
+  std::shared_ptr<const Game> game =
+      LoadGame("go", {{"board_size", GameParameter(board_size)},
+                      {"komi", GameParameter(static_cast<double>(komi))}});
+  std::unique_ptr<State> initial_state = game->NewInitialState();
+  int64_t moves = 0;
+  int black_wins = 0;
+  absl::Time start = absl::Now();
+  for (int i = 0; i < playouts; ++i) {
+    std::unique_ptr<State> state = initial_state->Clone();
+    while (!state->IsTerminal()) {
+      std::vector<Action> actions = state->LegalActions();
+      int index =
+          absl::uniform_int_distribution<int>(0, actions.size() - 1)(*rng);
+      state->ApplyAction(actions[index]);
+      ++moves;
+    }
+    black_wins += state->Returns()[ColorToPlayer(GoColor::kBlack)] > 0;
+  }
+  Report("state", board_size, playouts, moves, black_wins,
+         absl::Now() - start);
+}
+
+}  // namespace
+}  // namespace go
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  std::mt19937 rng(absl::GetFlag(FLAGS_seed));
+  for (absl::string_view size :
+       absl::StrSplit(absl::GetFlag(FLAGS_board_sizes), ',')) {
+    int board_size;
+    if (!absl::SimpleAtoi(size, &board_size)) {
+      open_spiel::SpielFatalError(absl::StrCat("Invalid board size: ", size));
+    }
+    open_spiel::go::BoardPlayouts(board_size, absl::GetFlag(FLAGS_playouts),
+                                  absl::GetFlag(FLAGS_komi), &rng);
+    open_spiel::go::StatePlayouts(board_size,
+                                  absl::GetFlag(FLAGS_state_playouts),
+                                  absl::GetFlag(FLAGS_komi), &rng);
+  }
+}
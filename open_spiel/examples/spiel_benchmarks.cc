@@ -0,0 +1,500 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmarks the primitives of the State API, separately, for each game:
+// Clone, ApplyAction, UndoAction, LegalActions, InformationStateString,
+// ObservationTensor, Serialize, DeserializeState, and whole random playouts.
+//
+// The primitives run on states sampled from random playouts, on 1, 2, 4, ...
+// up to --threads threads, each with its own copy of the game and states. The
+// results are written as JSON, one record per game, primitive and number of
+// threads, with the operations per second over all threads, the time per
+// operation on each thread, and the allocations per operation. Primitives a
+// game doesn't implement are listed in its "unsupported" field.
+//
+// For example:
+//   spiel_benchmarks --games=tic_tac_toe,leduc_poker --threads=4
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_format.h"
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/game_transforms/instrumented.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+#include "open_spiel/utils/json.h"
+#include "open_spiel/utils/thread.h"
+
+ABSL_FLAG(std::vector<std::string>, games, {},
+          "The games to benchmark, all the default loadable ones if empty.");
+ABSL_FLAG(int, threads, 1,
+          "The most threads to measure on: 1, 2, 4, ... and this many.");
+ABSL_FLAG(double, min_time, 0.2,
+          "How many seconds each primitive runs for on each thread.");
+ABSL_FLAG(int, num_states, 100, "How many states the primitives run on.");
+ABSL_FLAG(int, seed, 0, "Seed for the random playouts.");
+ABSL_FLAG(std::string, output, "",
+          "File to write the results to. They're printed if empty.");
+
+// The allocations made by each thread, counted by replacing the global
+// operator new. Allocations which bypass it, e.g. with malloc, aren't counted.
+// Builds with INSTRUMENT_ALLOCATIONS already replace it, in instrumented.cc.
+#ifdef OPEN_SPIEL_INSTRUMENT_ALLOCATIONS
+namespace {
+int64_t NumAllocations() { return open_spiel::NumThreadAllocations(); }
+}  // namespace
+#else
+namespace {
+thread_local int64_t num_allocations = 0;
+int64_t NumAllocations() { return num_allocations; }
+}  // namespace
+
+// GCC can't see that these new and delete replace the global ones as a pair,
+// so it takes the free of the memory from new for a mismatch.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void* operator new(std::size_t size) {
+  ++num_allocations;
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) return ptr;
+  throw std::bad_alloc();
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t size) noexcept { std::free(ptr); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+namespace open_spiel {
+namespace {
+
+// Thrown by SpielFatalError, so that the primitives a game doesn't implement
+// are skipped rather than end the benchmarks.
+class SpielError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+void ThrowSpielError(const std::string& message) { throw SpielError(message); }
+
+// A state, and random actions to apply to it: the chance outcome, the action
+// of the player to play, or one action per player at simultaneous nodes.
+struct Sample {
+  std::unique_ptr<State> state;
+  std::vector<Action> actions;
+};
+
+std::vector<Action> RandomActions(const State& state, std::mt19937* rng) {
+  if (state.IsChanceNode()) {
+    return {SampleAction(state.ChanceOutcomes(), *rng).first};
+  }
+  std::vector<Action> actions;
+  const int num_players = state.IsSimultaneousNode() ? state.NumPlayers() : 1;
+  for (Player p = 0; p < num_players; ++p) {
+    std::vector<Action> legal_actions =
+        state.LegalActions(state.IsSimultaneousNode() ? p
+                                                      : state.CurrentPlayer());
+    actions.push_back(legal_actions.empty()
+                          ? kInvalidAction
+                          : legal_actions[(*rng)() % legal_actions.size()]);
+  }
+  return actions;
+}
+
+void Apply(const std::vector<Action>& actions, State* state) {
+  if (state->IsSimultaneousNode()) {
+    state->ApplyActions(actions);
+  } else {
+    state->ApplyAction(actions[0]);
+  }
+}
+
+// The player whose view the string and tensor primitives take.
+Player Viewer(const State& state) {
+  return state.CurrentPlayer() >= 0 ? state.CurrentPlayer() : 0;
+}
+
+// Returns the length of a random playout from the initial state.
+int RandomPlayout(const Game& game, std::mt19937* rng) {
+  std::unique_ptr<State> state = game.NewInitialState();
+  int length = 0;
+  while (!state->IsTerminal()) {
+    Apply(RandomActions(*state, rng), state.get());
+    ++length;
+  }
+  return length;
+}
+
+// The non-terminal states of random playouts, shuffled.
+std::vector<Sample> SampleStates(const Game& game, int num_states,
+                                 std::mt19937* rng) {
+  std::vector<Sample> samples;
+  while (samples.size() < num_states) {
+    std::unique_ptr<State> state = game.NewInitialState();
+    while (!state->IsTerminal()) {
+      Sample sample{state->Clone(), RandomActions(*state, rng)};
+      Apply(sample.actions, state.get());
+      samples.push_back(std::move(sample));
+    }
+  }
+  std::shuffle(samples.begin(), samples.end(), *rng);
+  samples.resize(num_states);
+  return samples;
+}
+
+bool IsDecision(const Sample& sample) {
+  return !sample.state->IsChanceNode();
+}
+
+// A batch of operations, returning how many it ran.
+using Batch = std::function<int()>;
+
+// A primitive sets up a batch of operations, which is the part that's timed.
+struct Primitive {
+  std::string name;
+  std::function<Batch(const Game&, const std::vector<Sample>&, std::mt19937*)>
+      setup;
+};
+
+std::vector<Primitive> Primitives() {
+  using States = std::vector<std::unique_ptr<State>>;
+  std::vector<Primitive> primitives;
+  primitives.push_back({"clone", [](const Game& game,
+                                    const std::vector<Sample>& samples,
+                                    std::mt19937* rng) -> Batch {
+    // The clones are destroyed outside of the batch.
+    auto clones = std::make_shared<States>(samples.size());
+    return [&samples, clones]() {
+      for (int i = 0; i < samples.size(); ++i) {
+        (*clones)[i] = samples[i].state->Clone();
+      }
+      return samples.size();
+    };
+  }});
+  primitives.push_back({"apply_action", [](const Game& game,
+                                           const std::vector<Sample>& samples,
+                                           std::mt19937* rng) -> Batch {
+    auto clones = std::make_shared<States>();
+    for (const Sample& sample : samples) {
+      clones->push_back(sample.state->Clone());
+    }
+    return [&samples, clones]() {
+      for (int i = 0; i < samples.size(); ++i) {
+        Apply(samples[i].actions, (*clones)[i].get());
+      }
+      return samples.size();
+    };
+  }});
+  primitives.push_back({"undo_action", [](const Game& game,
+                                          const std::vector<Sample>& samples,
+                                          std::mt19937* rng) -> Batch {
+    auto children = std::make_shared<States>();
+    auto moves = std::make_shared<std::vector<std::pair<Player, Action>>>();
+    for (const Sample& sample : samples) {
+      if (sample.state->IsSimultaneousNode()) continue;
+      moves->push_back({sample.state->CurrentPlayer(), sample.actions[0]});
+      children->push_back(sample.state->Child(sample.actions[0]));
+    }
+    return [children, moves]() {
+      for (int i = 0; i < children->size(); ++i) {
+        (*children)[i]->UndoAction((*moves)[i].first, (*moves)[i].second);
+      }
+      return children->size();
+    };
+  }});
+  primitives.push_back({"legal_actions", [](const Game& game,
+                                            const std::vector<Sample>& samples,
+                                            std::mt19937* rng) -> Batch {
+    return [&samples]() {
+      int num_ops = 0;
+      for (const Sample& sample : samples) {
+        if (!IsDecision(sample)) continue;
+        sample.state->LegalActions(Viewer(*sample.state));
+        ++num_ops;
+      }
+      return num_ops;
+    };
+  }});
+  primitives.push_back(
+      {"information_state_string",
+       [](const Game& game, const std::vector<Sample>& samples,
+          std::mt19937* rng) -> Batch {
+         return [&samples]() {
+           int num_ops = 0;
+           for (const Sample& sample : samples) {
+             if (!IsDecision(sample)) continue;
+             const State& state = *sample.state;
+             state.InformationStateString(Viewer(state));
+             ++num_ops;
+           }
+           return num_ops;
+         };
+       }});
+  primitives.push_back(
+      {"observation_tensor",
+       [](const Game& game, const std::vector<Sample>& samples,
+          std::mt19937* rng) -> Batch {
+         // The tensor is reused, as it would be when filling a batch.
+         auto tensor = std::make_shared<std::vector<double>>();
+         return [&samples, tensor]() {
+           int num_ops = 0;
+           for (const Sample& sample : samples) {
+             if (!IsDecision(sample)) continue;
+             const State& state = *sample.state;
+             state.ObservationTensor(Viewer(state), tensor.get());
+             ++num_ops;
+           }
+           return num_ops;
+         };
+       }});
+  primitives.push_back({"serialize", [](const Game& game,
+                                        const std::vector<Sample>& samples,
+                                        std::mt19937* rng) -> Batch {
+    auto strings = std::make_shared<std::vector<std::string>>(samples.size());
+    return [&samples, strings]() {
+      for (int i = 0; i < samples.size(); ++i) {
+        (*strings)[i] = samples[i].state->Serialize();
+      }
+      return samples.size();
+    };
+  }});
+  primitives.push_back({"deserialize", [](const Game& game,
+                                          const std::vector<Sample>& samples,
+                                          std::mt19937* rng) -> Batch {
+    auto strings = std::make_shared<std::vector<std::string>>();
+    for (const Sample& sample : samples) {
+      strings->push_back(sample.state->Serialize());
+    }
+    auto states = std::make_shared<States>(samples.size());
+    return [&game, strings, states]() {
+      for (int i = 0; i < strings->size(); ++i) {
+        (*states)[i] = game.DeserializeState((*strings)[i]);
+      }
+      return strings->size();
+    };
+  }});
+  primitives.push_back({"random_playout", [](const Game& game,
+                                             const std::vector<Sample>& samples,
+                                             std::mt19937* rng) -> Batch {
+    return [&game, rng]() {
+      RandomPlayout(game, rng);
+      return 1;
+    };
+  }});
+  return primitives;
+}
+
+// What a thread measured of a primitive.
+struct Measurement {
+  int64_t num_ops = 0;
+  int64_t num_allocations = 0;
+  absl::Duration time;
+  std::string error;
+};
+
+Measurement Measure(const Primitive& primitive, const Game& game,
+                    const std::vector<Sample>& samples, std::mt19937* rng,
+                    absl::Duration min_time) {
+  Measurement measurement;
+  try {
+    while (measurement.time < min_time) {
+      Batch batch = primitive.setup(game, samples, rng);
+      const int64_t allocations = NumAllocations();
+      const absl::Time start = absl::Now();
+      const int num_ops = batch();
+      measurement.time += absl::Now() - start;
+      measurement.num_allocations += NumAllocations() - allocations;
+      if (num_ops == 0) {
+        SpielFatalError("No state to run " + primitive.name + " on.");
+      }
+      measurement.num_ops += num_ops;
+    }
+  } catch (const std::exception& error) {
+    measurement.error = error.what();
+  }
+  return measurement;
+}
+
+// Measures a primitive on `num_threads` threads at once, each with its own
+// game, states and generator. Returns its record, or sets `error` if the game
+// doesn't support it.
+json::Value MeasureOnThreads(
+    const Primitive& primitive, int num_threads,
+    const std::vector<std::shared_ptr<const Game>>& games,
+    const std::vector<std::vector<Sample>>& samples,
+    std::vector<std::mt19937>* rngs, absl::Duration min_time,
+    std::string* error) {
+  std::vector<Measurement> measurements(num_threads);
+  {
+    std::vector<Thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+      threads.emplace_back([&, t]() {
+        measurements[t] = Measure(primitive, *games[t], samples[t],
+                                  &(*rngs)[t], min_time);
+      });
+    }
+    for (Thread& thread : threads) thread.join();
+  }
+
+  double ops_per_second = 0;
+  Measurement total;
+  for (const Measurement& measurement : measurements) {
+    if (!measurement.error.empty()) {
+      *error = measurement.error;
+      return json::Null();
+    }
+    ops_per_second +=
+        measurement.num_ops / absl::ToDoubleSeconds(measurement.time);
+    total.num_ops += measurement.num_ops;
+    total.num_allocations += measurement.num_allocations;
+    total.time += measurement.time;
+  }
+  return json::Object({
+      {"primitive", primitive.name},
+      {"threads", num_threads},
+      {"ops", total.num_ops},
+      {"ops_per_second", ops_per_second},
+      {"ns_per_op", absl::ToDoubleNanoseconds(total.time) / total.num_ops},
+      {"allocations_per_op",
+       static_cast<double>(total.num_allocations) / total.num_ops},
+  });
+}
+
+json::Value BenchmarkGame(const std::string& game_name,
+                          const std::vector<Primitive>& primitives,
+                          const std::vector<int>& thread_counts,
+                          absl::Duration min_time, int num_states, int seed) {
+  json::Object result({{"game", game_name}});
+  std::shared_ptr<const Game> game;
+  try {
+    game = LoadGame(game_name);
+  } catch (const std::exception& error) {
+    result["error"] = error.what();
+    return result;
+  }
+
+  // One game per thread, as some games update theirs, e.g. with the
+  // randomness of their sampled chance nodes.
+  const int max_threads = thread_counts.back();
+  std::vector<std::shared_ptr<const Game>> games = {game};
+  std::vector<std::mt19937> rngs;
+  std::vector<std::vector<Sample>> samples;
+  try {
+    for (int t = 0; t < max_threads; ++t) {
+      if (t > 0) games.push_back(game->Clone());
+      rngs.emplace_back(seed + t);
+      samples.push_back(SampleStates(*games[t], num_states, &rngs[t]));
+    }
+  } catch (const std::exception& error) {
+    result["error"] = error.what();
+    return result;
+  }
+
+  json::Array records;
+  json::Object unsupported;
+  for (const Primitive& primitive : primitives) {
+    for (int num_threads : thread_counts) {
+      std::string error;
+      json::Value record = MeasureOnThreads(primitive, num_threads, games,
+                                            samples, &rngs, min_time, &error);
+      if (!error.empty()) {
+        unsupported[primitive.name] = error;
+        break;
+      }
+      const json::Object& fields = record.GetObject();
+      std::cerr << absl::StrFormat(
+                       "%-20s %-24s %2d threads %14.0f ops/s %10.1f ns/op "
+                       "%6.2f allocs/op",
+                       game_name, primitive.name, num_threads,
+                       fields.at("ops_per_second").GetDouble(),
+                       fields.at("ns_per_op").GetDouble(),
+                       fields.at("allocations_per_op").GetDouble())
+                << std::endl;
+      records.push_back(std::move(record));
+    }
+  }
+  result["results"] = std::move(records);
+  result["unsupported"] = std::move(unsupported);
+  return result;
+}
+
+void RunBenchmarks(std::vector<std::string> game_names, int max_threads,
+                   double min_seconds, int num_states, int seed,
+                   const std::string& output) {
+  SPIEL_CHECK_GT(max_threads, 0);
+  SPIEL_CHECK_GT(num_states, 0);
+  if (game_names.empty()) {
+    for (const GameType& type : GameRegisterer::RegisteredGames()) {
+      if (type.default_loadable) game_names.push_back(type.short_name);
+    }
+    std::sort(game_names.begin(), game_names.end());
+  }
+  std::vector<int> thread_counts;
+  for (int num_threads = 1; num_threads < max_threads; num_threads *= 2) {
+    thread_counts.push_back(num_threads);
+  }
+  thread_counts.push_back(max_threads);
+
+  SetErrorHandler(ThrowSpielError);
+  const std::vector<Primitive> primitives = Primitives();
+  json::Array results;
+  for (const std::string& game_name : game_names) {
+    results.push_back(BenchmarkGame(game_name, primitives, thread_counts,
+                                    absl::Seconds(min_seconds), num_states,
+                                    seed));
+  }
+
+  const std::string contents = json::ToString(
+      json::Object({
+          {"min_time", min_seconds},
+          {"num_states", num_states},
+          {"seed", seed},
+          {"games", std::move(results)},
+      }),
+      /*wrap=*/true);
+  if (output.empty()) {
+    std::cout << contents << std::endl;
+  } else {
+    file::File(output, "w").Write(contents);
+  }
+}
+
+}  // namespace
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  open_spiel::RunBenchmarks(
+      absl::GetFlag(FLAGS_games), absl::GetFlag(FLAGS_threads),
+      absl::GetFlag(FLAGS_min_time), absl::GetFlag(FLAGS_num_states),
+      absl::GetFlag(FLAGS_seed), absl::GetFlag(FLAGS_output));
+}
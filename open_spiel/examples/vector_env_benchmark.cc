@@ -0,0 +1,228 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures how many environment steps per second a VectorEnv runs, against
+// the loop over a vector of states that it replaces. Both produce the same
+// outputs: every player's tensors and legal actions, and the rewards, with
+// chance sampled and the episodes restarted as they end. The actions are
+// sampled uniformly from the legal ones, outside of the timed steps.
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_format.h"
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/algorithms/vector_env.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+ABSL_FLAG(std::string, game, "tic_tac_toe", "The name of the game to play.");
+ABSL_FLAG(int, num_envs, 256, "How many environments to step together.");
+ABSL_FLAG(int, steps, 200, "How many steps to run.");
+ABSL_FLAG(int, threads, 4, "How many threads the parallel VectorEnv uses.");
+
+namespace open_spiel {
+namespace {
+
+// The outputs of a step, in the layout of algorithms::VectorEnvTimeStep.
+struct Buffers {
+  Buffers(const Game& game, int num_envs, int tensor_size)
+      : observations(num_envs * game.NumPlayers() * tensor_size),
+        legal_actions_mask(num_envs * game.NumPlayers() *
+                           game.NumDistinctActions()),
+        current_player(num_envs),
+        rewards(num_envs * game.NumPlayers()),
+        dones(new bool[num_envs]) {
+    time_step.observations = absl::MakeSpan(observations);
+    time_step.legal_actions_mask = absl::MakeSpan(legal_actions_mask);
+    time_step.current_player = absl::MakeSpan(current_player);
+    time_step.rewards = absl::MakeSpan(rewards);
+    time_step.dones = absl::MakeSpan(dones.get(), num_envs);
+  }
+
+  std::vector<double> observations;
+  std::vector<int> legal_actions_mask;
+  std::vector<int> current_player;
+  std::vector<double> rewards;
+  std::unique_ptr<bool[]> dones;
+  algorithms::VectorEnvTimeStep time_step;
+};
+
+// A uniformly random legal action per player to play in each environment.
+std::vector<Action> RandomActions(const Game& game, const Buffers& buffers,
+                                  int actions_per_env, std::mt19937* rng) {
+  const int num_players = game.NumPlayers();
+  const int num_actions = game.NumDistinctActions();
+  std::vector<Action> actions;
+  std::vector<Action> legal_actions;
+  for (int env = 0; env < buffers.current_player.size(); ++env) {
+    for (int i = 0; i < actions_per_env; ++i) {
+      const Player player =
+          actions_per_env == 1 ? buffers.current_player[env] : i;
+      const int* mask = &buffers.legal_actions_mask[(env * num_players +
+                                                     player) * num_actions];
+      legal_actions.clear();
+      for (Action a = 0; a < num_actions; ++a) {
+        if (mask[a]) legal_actions.push_back(a);
+      }
+      actions.push_back(legal_actions.empty()
+                            ? 0
+                            : legal_actions[(*rng)() % legal_actions.size()]);
+    }
+  }
+  return actions;
+}
+
+// What a trainer without VectorEnv does: step each state in turn.
+class SerialLoop {
+ public:
+  SerialLoop(std::shared_ptr<const Game> game, int num_envs, int seed,
+             bool use_observation)
+      : game_(game), use_observation_(use_observation), rng_(seed) {
+    for (int env = 0; env < num_envs; ++env) states_.push_back(NewEpisode());
+  }
+
+  void Write(Buffers* buffers) {
+    const int num_players = game_->NumPlayers();
+    const int num_actions = game_->NumDistinctActions();
+    for (int env = 0; env < states_.size(); ++env) {
+      const State& state = *states_[env];
+      buffers->current_player[env] = state.CurrentPlayer();
+      for (Player p = 0; p < num_players; ++p) {
+        std::vector<double> tensor = use_observation_
+                                         ? state.ObservationTensor(p)
+                                         : state.InformationStateTensor(p);
+        std::copy(tensor.begin(), tensor.end(),
+                  buffers->observations.begin() +
+                      (env * num_players + p) * tensor.size());
+        std::vector<int> mask = state.LegalActionsMask(p);
+        std::copy(mask.begin(), mask.end(),
+                  buffers->legal_actions_mask.begin() +
+                      (env * num_players + p) * num_actions);
+      }
+    }
+  }
+
+  void Step(const std::vector<Action>& actions, int actions_per_env,
+            Buffers* buffers) {
+    const int num_players = game_->NumPlayers();
+    for (int env = 0; env < states_.size(); ++env) {
+      std::unique_ptr<State>& state = states_[env];
+      if (state->IsSimultaneousNode()) {
+        state->ApplyActions(std::vector<Action>(
+            actions.begin() + env * actions_per_env,
+            actions.begin() + (env + 1) * actions_per_env));
+      } else if (actions_per_env == 1) {
+        state->ApplyAction(actions[env]);
+      } else {
+        state->ApplyAction(
+            actions[env * actions_per_env + state->CurrentPlayer()]);
+      }
+      SampleChance(state.get());
+      std::vector<double> rewards = state->Rewards();
+      std::copy(rewards.begin(), rewards.end(),
+                buffers->rewards.begin() + env * num_players);
+      buffers->dones[env] = state->IsTerminal();
+      if (state->IsTerminal()) state = NewEpisode();
+    }
+    Write(buffers);
+  }
+
+ private:
+  std::unique_ptr<State> NewEpisode() {
+    std::unique_ptr<State> state = game_->NewInitialState();
+    SampleChance(state.get());
+    return state;
+  }
+
+  void SampleChance(State* state) {
+    while (state->IsChanceNode()) {
+      state->ApplyAction(SampleAction(state->ChanceOutcomes(), rng_).first);
+    }
+  }
+
+  std::shared_ptr<const Game> game_;
+  bool use_observation_;
+  std::mt19937 rng_;
+  std::vector<std::unique_ptr<State>> states_;
+};
+
+void PrintRate(const std::string& name, int num_env_steps,
+               absl::Duration time) {
+  std::cout << absl::StrFormat("%-22s %12.0f steps/s", name,
+                               num_env_steps / absl::ToDoubleSeconds(time))
+            << std::endl;
+}
+
+void RunBenchmark(const std::string& game_name, int num_envs, int steps,
+                  int threads) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  std::cout << absl::StrFormat("%s, %d environments, %d steps", game_name,
+                               num_envs, steps)
+            << std::endl;
+
+  // Uses the same tensors as the VectorEnvs.
+  algorithms::VectorEnv serial_env(game, num_envs, /*seed=*/0);
+  const int actions_per_env = serial_env.ActionsPerEnv();
+  {
+    SerialLoop loop(game, num_envs, /*seed=*/0, serial_env.UsesObservation());
+    Buffers buffers(*game, num_envs, serial_env.TensorSize());
+    std::mt19937 rng(1);
+    absl::Duration time;
+    loop.Write(&buffers);
+    for (int step = 0; step < steps; ++step) {
+      std::vector<Action> actions =
+          RandomActions(*game, buffers, actions_per_env, &rng);
+      absl::Time start = absl::Now();
+      loop.Step(actions, actions_per_env, &buffers);
+      time += absl::Now() - start;
+    }
+    PrintRate("Serial loop", num_envs * steps, time);
+  }
+
+  for (int num_threads : {1, threads}) {
+    algorithms::VectorEnv env(game, num_envs, /*seed=*/0, num_threads);
+    Buffers buffers(*game, num_envs, env.TensorSize());
+    std::mt19937 rng(1);
+    absl::Duration time;
+    env.Reset(buffers.time_step);
+    for (int step = 0; step < steps; ++step) {
+      std::vector<Action> actions =
+          RandomActions(*game, buffers, actions_per_env, &rng);
+      absl::Time start = absl::Now();
+      env.Step(actions, buffers.time_step);
+      time += absl::Now() - start;
+    }
+    PrintRate(absl::StrFormat("VectorEnv, %d threads", env.NumThreads()),
+              num_envs * steps, time);
+  }
+}
+
+}  // namespace
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  open_spiel::RunBenchmark(absl::GetFlag(FLAGS_game),
+                           absl::GetFlag(FLAGS_num_envs),
+                           absl::GetFlag(FLAGS_steps),
+                           absl::GetFlag(FLAGS_threads));
+}
@@ -0,0 +1,345 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/game_transforms/instrumented.h"
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdlib>
+#include <new>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+#include "open_spiel/utils/json.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#ifdef OPEN_SPIEL_INSTRUMENT_ALLOCATIONS
+namespace {
+thread_local int64_t num_thread_allocations = 0;
+}  // namespace
+
+void* operator new(std::size_t size) {
+  ++num_thread_allocations;
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) return ptr;
+  throw std::bad_alloc();
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t size) noexcept { std::free(ptr); }
+#endif
+
+namespace open_spiel {
+namespace {
+
+// These parameters are the most-general case. The actual game may be simpler.
+const GameType kGameType{
+    /*short_name=*/"instrumented",
+    /*long_name=*/"Instrumented Version of a Regular Game",
+    GameType::Dynamics::kSequential,
+    GameType::ChanceMode::kSampledStochastic,
+    GameType::Information::kImperfectInformation,
+    GameType::Utility::kGeneralSum,
+    GameType::RewardModel::kRewards,
+    /*max_num_players=*/100,
+    /*min_num_players=*/1,
+    /*provides_information_state_string=*/true,
+    /*provides_information_state_tensor=*/true,
+    /*provides_observation_string=*/true,
+    /*provides_observation_tensor=*/true,
+    {{"game",
+      GameParameter(GameParameter::Type::kGame, /*is_mandatory=*/true)}},
+    /*default_loadable=*/false};
+
+GameType InstrumentedGameType(GameType game_type) {
+  game_type.short_name = kGameType.short_name;
+  game_type.long_name = absl::StrCat("Instrumented ", game_type.long_name);
+  return game_type;
+}
+
+std::shared_ptr<const Game> Factory(const GameParameters& params) {
+  return InstrumentGame(LoadGame(params.at("game").game_value()));
+}
+
+REGISTER_SPIEL_GAME(kGameType, Factory);
+
+int64_t ReadCycleCounter() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+// The counts of one game on one thread. Only that thread writes them, but any
+// can read them.
+struct ThreadCounts {
+  struct Counts {
+    std::atomic<int64_t> calls{0};
+    std::atomic<int64_t> cycles{0};
+    std::atomic<int64_t> allocations{0};
+  };
+  std::array<Counts, kNumInstrumentedMethods> methods;
+};
+
+// The instrumented games, by id, and the counts of every thread. The counts
+// outlive their thread, so they can be read after it ends.
+struct Registry {
+  absl::Mutex mutex;
+  std::vector<std::string> game_names ABSL_GUARDED_BY(mutex);
+  std::vector<std::pair<int, std::unique_ptr<ThreadCounts>>> counts
+      ABSL_GUARDED_BY(mutex);
+};
+
+Registry& GetRegistry() {
+  static Registry* registry = new Registry();
+  return *registry;
+}
+
+// Instrumented games with the same name share their id, and counts.
+int RegisterGame(const std::string& name) {
+  Registry& registry = GetRegistry();
+  absl::MutexLock lock(&registry.mutex);
+  for (int id = 0; id < registry.game_names.size(); ++id) {
+    if (registry.game_names[id] == name) return id;
+  }
+  registry.game_names.push_back(name);
+  return registry.game_names.size() - 1;
+}
+
+// The current thread's counts of a game, by its id.
+ThreadCounts::Counts& GetCounts(int game_id, InstrumentedMethod method) {
+  thread_local std::vector<ThreadCounts*> thread_counts;
+  if (game_id >= thread_counts.size()) thread_counts.resize(game_id + 1);
+  ThreadCounts*& counts = thread_counts[game_id];
+  if (counts == nullptr) {
+    Registry& registry = GetRegistry();
+    absl::MutexLock lock(&registry.mutex);
+    registry.counts.emplace_back(game_id, new ThreadCounts());
+    counts = registry.counts.back().second.get();
+  }
+  return counts->methods[static_cast<int>(method)];
+}
+
+void Add(std::atomic<int64_t>* counter, int64_t value) {
+  // Only the current thread writes the counter.
+  counter->store(counter->load(std::memory_order_relaxed) + value,
+                 std::memory_order_relaxed);
+}
+
+// Adds the call made in its scope to the counts of a method.
+class Call {
+ public:
+  Call(int game_id, InstrumentedMethod method)
+      : counts_(GetCounts(game_id, method)),
+        start_allocations_(NumThreadAllocations()),
+        start_cycles_(ReadCycleCounter()) {}
+  ~Call() {
+    const int64_t cycles = ReadCycleCounter() - start_cycles_;
+    Add(&counts_.calls, 1);
+    Add(&counts_.cycles, cycles);
+    Add(&counts_.allocations, NumThreadAllocations() - start_allocations_);
+  }
+
+ private:
+  ThreadCounts::Counts& counts_;
+  const int64_t start_allocations_;
+  const int64_t start_cycles_;
+};
+
+}  // namespace
+
+std::string InstrumentedMethodName(InstrumentedMethod method) {
+  switch (method) {
+    case InstrumentedMethod::kApplyAction:
+      return "apply_action";
+    case InstrumentedMethod::kUndoAction:
+      return "undo_action";
+    case InstrumentedMethod::kClone:
+      return "clone";
+    case InstrumentedMethod::kLegalActions:
+      return "legal_actions";
+    case InstrumentedMethod::kChanceOutcomes:
+      return "chance_outcomes";
+    case InstrumentedMethod::kActionToString:
+      return "action_to_string";
+    case InstrumentedMethod::kToString:
+      return "to_string";
+    case InstrumentedMethod::kInformationStateString:
+      return "information_state_string";
+    case InstrumentedMethod::kInformationStateTensor:
+      return "information_state_tensor";
+    case InstrumentedMethod::kObservationString:
+      return "observation_string";
+    case InstrumentedMethod::kObservationTensor:
+      return "observation_tensor";
+  }
+  SpielFatalError("Unknown instrumented method.");
+}
+
+InstrumentedGameCounts GetInstrumentationCounts() {
+  Registry& registry = GetRegistry();
+  absl::MutexLock lock(&registry.mutex);
+  InstrumentedGameCounts game_counts;
+  for (const auto& [game_id, thread_counts] : registry.counts) {
+    auto& methods = game_counts[registry.game_names[game_id]];
+    for (int m = 0; m < kNumInstrumentedMethods; ++m) {
+      const ThreadCounts::Counts& counts = thread_counts->methods[m];
+      methods[m].calls += counts.calls.load(std::memory_order_relaxed);
+      methods[m].cycles += counts.cycles.load(std::memory_order_relaxed);
+      methods[m].allocations +=
+          counts.allocations.load(std::memory_order_relaxed);
+    }
+  }
+  return game_counts;
+}
+
+std::string InstrumentationToJson() {
+  json::Object games;
+  for (const auto& [name, methods] : GetInstrumentationCounts()) {
+    json::Object game;
+    for (int m = 0; m < kNumInstrumentedMethods; ++m) {
+      const InstrumentedCounts& counts = methods[m];
+      if (counts.calls == 0) continue;
+      json::Object method({{"calls", counts.calls}, {"cycles", counts.cycles}});
+      if (InstrumentationTracksAllocations()) {
+        method["allocations"] = counts.allocations;
+      }
+      game[InstrumentedMethodName(static_cast<InstrumentedMethod>(m))] =
+          method;
+    }
+    games[name] = game;
+  }
+  return json::ToString(
+      json::Object({{"allocations_tracked", InstrumentationTracksAllocations()},
+                    {"games", games}}));
+}
+
+void ResetInstrumentation() {
+  Registry& registry = GetRegistry();
+  absl::MutexLock lock(&registry.mutex);
+  for (const auto& [game_id, thread_counts] : registry.counts) {
+    for (ThreadCounts::Counts& counts : thread_counts->methods) {
+      counts.calls.store(0, std::memory_order_relaxed);
+      counts.cycles.store(0, std::memory_order_relaxed);
+      counts.allocations.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+bool InstrumentationTracksAllocations() {
+#ifdef OPEN_SPIEL_INSTRUMENT_ALLOCATIONS
+  return true;
+#else
+  return false;
+#endif
+}
+
+int64_t NumThreadAllocations() {
+#ifdef OPEN_SPIEL_INSTRUMENT_ALLOCATIONS
+  return num_thread_allocations;
+#else
+  return 0;
+#endif
+}
+
+std::vector<Action> InstrumentedState::LegalActions(Player player) const {
+  Call call(game_id_, InstrumentedMethod::kLegalActions);
+  return state_->LegalActions(player);
+}
+
+std::vector<Action> InstrumentedState::LegalActions() const {
+  Call call(game_id_, InstrumentedMethod::kLegalActions);
+  return state_->LegalActions();
+}
+
+std::string InstrumentedState::ActionToString(Player player,
+                                              Action action_id) const {
+  Call call(game_id_, InstrumentedMethod::kActionToString);
+  return state_->ActionToString(player, action_id);
+}
+
+std::string InstrumentedState::ToString() const {
+  Call call(game_id_, InstrumentedMethod::kToString);
+  return state_->ToString();
+}
+
+std::string InstrumentedState::InformationStateString(Player player) const {
+  Call call(game_id_, InstrumentedMethod::kInformationStateString);
+  return state_->InformationStateString(player);
+}
+
+void InstrumentedState::InformationStateTensor(
+    Player player, std::vector<double>* values) const {
+  Call call(game_id_, InstrumentedMethod::kInformationStateTensor);
+  state_->InformationStateTensor(player, values);
+}
+
+std::string InstrumentedState::ObservationString(Player player) const {
+  Call call(game_id_, InstrumentedMethod::kObservationString);
+  return state_->ObservationString(player);
+}
+
+void InstrumentedState::ObservationTensor(Player player,
+                                          std::vector<double>* values) const {
+  Call call(game_id_, InstrumentedMethod::kObservationTensor);
+  state_->ObservationTensor(player, values);
+}
+
+std::unique_ptr<State> InstrumentedState::Clone() const {
+  Call call(game_id_, InstrumentedMethod::kClone);
+  return std::unique_ptr<State>(new InstrumentedState(*this));
+}
+
+void InstrumentedState::UndoAction(Player player, Action action) {
+  Call call(game_id_, InstrumentedMethod::kUndoAction);
+  WrappedState::UndoAction(player, action);
+}
+
+ActionsAndProbs InstrumentedState::ChanceOutcomes() const {
+  Call call(game_id_, InstrumentedMethod::kChanceOutcomes);
+  return state_->ChanceOutcomes();
+}
+
+std::vector<Action> InstrumentedState::LegalChanceOutcomes() const {
+  Call call(game_id_, InstrumentedMethod::kChanceOutcomes);
+  return state_->LegalChanceOutcomes();
+}
+
+void InstrumentedState::DoApplyAction(Action action_id) {
+  Call call(game_id_, InstrumentedMethod::kApplyAction);
+  state_->ApplyAction(action_id);
+}
+
+void InstrumentedState::DoApplyActions(const std::vector<Action>& actions) {
+  Call call(game_id_, InstrumentedMethod::kApplyAction);
+  state_->ApplyActions(actions);
+}
+
+InstrumentedGame::InstrumentedGame(std::shared_ptr<const Game> game,
+                                   GameType game_type,
+                                   GameParameters game_parameters)
+    : WrappedGame(game, game_type, game_parameters),
+      game_id_(RegisterGame(game->ToString())) {}
+
+std::shared_ptr<const Game> InstrumentGame(std::shared_ptr<const Game> game) {
+  GameParameters params = game->GetParameters();
+  params["name"] = GameParameter(game->GetType().short_name);
+  GameType game_type = InstrumentedGameType(game->GetType());
+  return std::shared_ptr<const Game>(new InstrumentedGame(
+      game, game_type, {{"game", GameParameter(params)}}));
+}
+
+}  // namespace open_spiel
@@ -0,0 +1,146 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_GAME_TRANSFORMS_INSTRUMENTED_H_
+#define OPEN_SPIEL_GAME_TRANSFORMS_INSTRUMENTED_H_
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/game_transforms/game_wrapper.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+// Instruments a game, e.g. "instrumented(game=leduc_poker())", to see where
+// its time goes without a profiler. Its states behave like the original ones,
+// but count the calls to their public methods and the cycles spent in them,
+// per game and per method. Counting only happens in instrumented games, so
+// the others pay nothing for it.
+//
+// When built with INSTRUMENT_ALLOCATIONS, which replaces the global operator
+// new, the heap allocations made by each method are counted too.
+//
+// The counters are kept per thread, so instrumented games can be played from
+// several threads, and summed when read.
+
+namespace open_spiel {
+
+enum class InstrumentedMethod {
+  kApplyAction,
+  kUndoAction,
+  kClone,
+  kLegalActions,
+  kChanceOutcomes,
+  kActionToString,
+  kToString,
+  kInformationStateString,
+  kInformationStateTensor,
+  kObservationString,
+  kObservationTensor,
+};
+constexpr int kNumInstrumentedMethods = 11;
+
+// Eg "legal_actions".
+std::string InstrumentedMethodName(InstrumentedMethod method);
+
+struct InstrumentedCounts {
+  int64_t calls = 0;
+  int64_t cycles = 0;
+  // Always 0 unless built with INSTRUMENT_ALLOCATIONS.
+  int64_t allocations = 0;
+};
+
+// The counts of each method of the instrumented games, by the name of the
+// game they instrument, e.g. "leduc_poker()", summed over all threads.
+using InstrumentedGameCounts =
+    std::map<std::string,
+             std::array<InstrumentedCounts, kNumInstrumentedMethods>>;
+InstrumentedGameCounts GetInstrumentationCounts();
+
+// The counts as a JSON object, e.g.
+// {"allocations_tracked": true, "games": {"leduc_poker()": {"clone":
+// {"calls": 10, "cycles": 5240, "allocations": 20}, ...}}}
+// Methods which were never called are left out.
+std::string InstrumentationToJson();
+
+// Zeroes all the counts. Calls made at the same time may still be counted.
+void ResetInstrumentation();
+
+// Whether the allocations are counted.
+bool InstrumentationTracksAllocations();
+
+// How many times the current thread called operator new. Always 0 unless
+// built with INSTRUMENT_ALLOCATIONS.
+int64_t NumThreadAllocations();
+
+class InstrumentedState : public WrappedState {
+ public:
+  InstrumentedState(std::shared_ptr<const Game> game,
+                    std::unique_ptr<State> state, int game_id)
+      : WrappedState(game, std::move(state)), game_id_(game_id) {}
+  InstrumentedState(const InstrumentedState& other) = default;
+
+  std::vector<Action> LegalActions(Player player) const override;
+  std::vector<Action> LegalActions() const override;
+  std::string ActionToString(Player player, Action action_id) const override;
+  std::string ToString() const override;
+  std::string InformationStateString(Player player) const override;
+  void InformationStateTensor(Player player,
+                              std::vector<double>* values) const override;
+  std::string ObservationString(Player player) const override;
+  void ObservationTensor(Player player,
+                         std::vector<double>* values) const override;
+  std::unique_ptr<State> Clone() const override;
+  void UndoAction(Player player, Action action) override;
+  ActionsAndProbs ChanceOutcomes() const override;
+  std::vector<Action> LegalChanceOutcomes() const override;
+
+ protected:
+  void DoApplyAction(Action action_id) override;
+  void DoApplyActions(const std::vector<Action>& actions) override;
+
+ private:
+  // Where the counts of the instrumented game are kept.
+  const int game_id_;
+};
+
+class InstrumentedGame : public WrappedGame {
+ public:
+  InstrumentedGame(std::shared_ptr<const Game> game, GameType game_type,
+                   GameParameters game_parameters);
+  InstrumentedGame(const InstrumentedGame& other) = default;
+
+  std::unique_ptr<State> NewInitialState() const override {
+    return std::unique_ptr<State>(new InstrumentedState(
+        shared_from_this(), game_->NewInitialState(), game_id_));
+  }
+
+  std::shared_ptr<const Game> Clone() const override {
+    return std::shared_ptr<const Game>(new InstrumentedGame(*this));
+  }
+
+ private:
+  const int game_id_;
+};
+
+// Returns the instrumented version of a game.
+std::shared_ptr<const Game> InstrumentGame(std::shared_ptr<const Game> game);
+
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAME_TRANSFORMS_INSTRUMENTED_H_
@@ -0,0 +1,138 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/game_transforms/instrumented.h"
+
+#include <optional>
+#include <vector>
+
+#include "open_spiel/spiel.h"
+#include "open_spiel/tests/basic_tests.h"
+#include "open_spiel/utils/json.h"
+#include "open_spiel/utils/thread.h"
+
+namespace open_spiel {
+namespace instrumented {
+namespace {
+
+namespace testing = open_spiel::testing;
+
+void BasicInstrumentedTests() {
+  testing::LoadGameTest("instrumented(game=kuhn_poker())");
+  testing::RandomSimTest(*LoadGame("instrumented(game=leduc_poker())"), 100);
+  testing::RandomSimTestWithUndo(
+      *LoadGame("instrumented(game=tic_tac_toe())"), 10);
+  testing::RandomSimTest(*LoadGame("instrumented(game=goofspiel())"), 10);
+}
+
+const InstrumentedCounts& Counts(const InstrumentedGameCounts& game_counts,
+                                 const std::string& game,
+                                 InstrumentedMethod method) {
+  return game_counts.at(game)[static_cast<int>(method)];
+}
+
+void CountsCallsTest() {
+  ResetInstrumentation();
+  std::shared_ptr<const Game> game =
+      InstrumentGame(LoadGame("tic_tac_toe"));
+  SPIEL_CHECK_EQ(game->GetType().short_name, "instrumented");
+  std::unique_ptr<State> state = game->NewInitialState();
+  for (int i = 0; i < 5; ++i) {
+    std::unique_ptr<State> clone = state->Clone();
+    clone->ObservationTensor();
+    state->ApplyAction(state->LegalActions()[0]);
+  }
+  state->UndoAction(0, state->History().back());
+  state->InformationStateString(0);
+
+  const InstrumentedGameCounts counts = GetInstrumentationCounts();
+  SPIEL_CHECK_EQ(
+      Counts(counts, "tic_tac_toe()", InstrumentedMethod::kClone).calls, 5);
+  SPIEL_CHECK_EQ(
+      Counts(counts, "tic_tac_toe()", InstrumentedMethod::kApplyAction).calls,
+      5);
+  SPIEL_CHECK_EQ(
+      Counts(counts, "tic_tac_toe()", InstrumentedMethod::kLegalActions).calls,
+      5);
+  SPIEL_CHECK_EQ(Counts(counts, "tic_tac_toe()",
+                        InstrumentedMethod::kObservationTensor).calls,
+                 5);
+  SPIEL_CHECK_EQ(
+      Counts(counts, "tic_tac_toe()", InstrumentedMethod::kUndoAction).calls,
+      1);
+  SPIEL_CHECK_EQ(Counts(counts, "tic_tac_toe()",
+                        InstrumentedMethod::kInformationStateString).calls,
+                 1);
+  SPIEL_CHECK_EQ(
+      Counts(counts, "tic_tac_toe()", InstrumentedMethod::kToString).calls, 0);
+  SPIEL_CHECK_GT(
+      Counts(counts, "tic_tac_toe()", InstrumentedMethod::kClone).cycles, 0);
+  if (InstrumentationTracksAllocations()) {
+    // Each clone allocates at least the new state.
+    SPIEL_CHECK_GE(Counts(counts, "tic_tac_toe()", InstrumentedMethod::kClone)
+                       .allocations,
+                   5);
+  }
+
+  ResetInstrumentation();
+  SPIEL_CHECK_EQ(Counts(GetInstrumentationCounts(), "tic_tac_toe()",
+                        InstrumentedMethod::kClone).calls,
+                 0);
+}
+
+void SumsThreadsTest() {
+  ResetInstrumentation();
+  std::shared_ptr<const Game> game =
+      LoadGame("instrumented(game=kuhn_poker())");
+  std::vector<Thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([game]() {
+      std::unique_ptr<State> state = game->NewInitialState();
+      for (int i = 0; i < 100; ++i) state->Clone();
+    });
+  }
+  for (Thread& thread : threads) thread.join();
+  SPIEL_CHECK_EQ(Counts(GetInstrumentationCounts(), "kuhn_poker()",
+                        InstrumentedMethod::kClone).calls,
+                 400);
+}
+
+void JsonTest() {
+  ResetInstrumentation();
+  std::unique_ptr<State> state =
+      LoadGame("instrumented(game=kuhn_poker())")->NewInitialState();
+  state->ChanceOutcomes();
+  std::optional<json::Value> value = json::FromString(InstrumentationToJson());
+  SPIEL_CHECK_TRUE(value.has_value());
+  const json::Object& object = value->GetObject();
+  SPIEL_CHECK_EQ(object.at("allocations_tracked").GetBool(),
+                 InstrumentationTracksAllocations());
+  const json::Object& methods =
+      object.at("games").GetObject().at("kuhn_poker()").GetObject();
+  // Only the methods called are listed.
+  SPIEL_CHECK_EQ(methods.size(), 1);
+  SPIEL_CHECK_EQ(
+      methods.at("chance_outcomes").GetObject().at("calls").GetInt(), 1);
+}
+
+}  // namespace
+}  // namespace instrumented
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::instrumented::BasicInstrumentedTests();
+  open_spiel::instrumented::CountsCallsTest();
+  open_spiel::instrumented::SumsThreadsTest();
+  open_spiel::instrumented::JsonTest();
+}
@@ -14,9 +14,19 @@
 
 #include "open_spiel/game_transforms/normal_form_extensive_game.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
 #include "open_spiel/algorithms/deterministic_policy.h"
-#include "open_spiel/algorithms/expected_returns.h"
+#include "open_spiel/simultaneous_move_game.h"
 #include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
 
 namespace open_spiel {
 
@@ -51,43 +61,233 @@ std::shared_ptr<const Game> Factory(const GameParameters& params) {
 
 REGISTER_SPIEL_GAME(kGameType, Factory);
 
-std::shared_ptr<const TensorGame> ExtensiveToTensorGame(const Game& game) {
-  std::vector<std::vector<std::string>> action_names(game.NumPlayers());
+namespace {
+
+// A node's contribution to the expected returns: the rewards there, weighted
+// by chance's probability of reaching it. The node is reached in exactly the
+// profiles where each player's policy takes the actions on the way, given as
+// the index of the information state in the player's table and of the action
+// among its legal actions.
+struct Contribution {
+  double chance_prob;
+  std::vector<double> rewards;
+  std::vector<std::vector<std::pair<int, int>>> choices;  // Per player.
+};
+
+// One player's information states and legal actions, in the order of a
+// DeterministicTabularPolicy's table.
+struct InfostateTable {
+  absl::flat_hash_map<std::string, int> ids;
+  std::vector<std::vector<Action>> legal_actions;
+};
+
+int InfostateId(const State& state, Player player, InfostateTable* table) {
+  auto [it, inserted] = table->ids.emplace(
+      state.InformationStateString(player), table->legal_actions.size());
+  if (inserted) table->legal_actions.push_back(state.LegalActions(player));
+  return it->second;
+}
+
+int ActionIndex(const std::vector<Action>& legal_actions, Action action) {
+  auto it = std::find(legal_actions.begin(), legal_actions.end(), action);
+  SPIEL_CHECK_TRUE(it != legal_actions.end());
+  return std::distance(legal_actions.begin(), it);
+}
+
+// Walks the tree once, as algorithms::ExpectedReturns would for every
+// profile, recording where rewards are given.
+void CollectContributions(
+    const State& state, double chance_prob,
+    std::vector<std::vector<std::pair<int, int>>>* choices,
+    std::vector<InfostateTable>* tables,
+    std::vector<Contribution>* contributions) {
+  const int num_players = state.NumPlayers();
+  if (!state.IsChanceNode()) {
+    std::vector<double> rewards = state.Rewards();
+    if (std::any_of(rewards.begin(), rewards.end(),
+                    [](double r) { return r != 0; })) {
+      contributions->push_back({chance_prob, std::move(rewards), *choices});
+    }
+  }
+  if (state.IsTerminal()) return;
+
+  if (state.IsChanceNode()) {
+    for (const auto& [action, prob] : state.ChanceOutcomes()) {
+      CollectContributions(*state.Child(action), chance_prob * prob, choices,
+                           tables, contributions);
+    }
+  } else if (state.IsSimultaneousNode()) {
+    auto smstate = dynamic_cast<const SimMoveState*>(&state);
+    SPIEL_CHECK_TRUE(smstate != nullptr);
+    std::vector<int> ids(num_players);
+    for (Player p = 0; p < num_players; ++p) {
+      ids[p] = InfostateId(state, p, &(*tables)[p]);
+    }
+    for (const Action flat_action : smstate->LegalActions()) {
+      std::vector<Action> actions =
+          smstate->FlatJointActionToActions(flat_action);
+      for (Player p = 0; p < num_players; ++p) {
+        (*choices)[p].emplace_back(
+            ids[p],
+            ActionIndex((*tables)[p].legal_actions[ids[p]], actions[p]));
+      }
+      std::unique_ptr<State> child = state.Clone();
+      child->ApplyActions(actions);
+      CollectContributions(*child, chance_prob, choices, tables,
+                           contributions);
+      for (Player p = 0; p < num_players; ++p) (*choices)[p].pop_back();
+    }
+  } else {
+    const Player player = state.CurrentPlayer();
+    const int id = InfostateId(state, player, &(*tables)[player]);
+    const std::vector<Action> legal_actions = state.LegalActions();
+    for (int i = 0; i < legal_actions.size(); ++i) {
+      (*choices)[player].emplace_back(
+          id, ActionIndex((*tables)[player].legal_actions[id],
+                          legal_actions[i]));
+      CollectContributions(*state.Child(legal_actions[i]), chance_prob,
+                           choices, tables, contributions);
+      (*choices)[player].pop_back();
+    }
+  }
+}
+
+// The indices of a player's deterministic policies that make the given
+// choices, in increasing order. A policy's index is its actions' indices as
+// the digits of a mixed radix number, the first information state being the
+// least significant, as DeterministicTabularPolicy::NextPolicy counts them.
+std::vector<int64_t> ConsistentPolicies(
+    const std::vector<std::pair<int, int>>& choices,
+    const std::vector<int>& num_actions, const std::vector<int64_t>& strides) {
+  std::vector<int> fixed(num_actions.size(), -1);
+  for (const auto& [id, action_index] : choices) {
+    if (fixed[id] >= 0 && fixed[id] != action_index) return {};
+    fixed[id] = action_index;
+  }
+  std::vector<int64_t> policies = {0};
+  for (int id = 0; id < num_actions.size(); ++id) {
+    if (fixed[id] >= 0) {
+      for (int64_t& policy : policies) policy += fixed[id] * strides[id];
+      continue;
+    }
+    const int num_policies = policies.size();
+    for (int a = 1; a < num_actions[id]; ++a) {
+      for (int i = 0; i < num_policies; ++i) {
+        policies.push_back(policies[i] + a * strides[id]);
+      }
+    }
+  }
+  std::sort(policies.begin(), policies.end());
+  return policies;
+}
+
+}  // namespace
+
+std::shared_ptr<const TensorGame> ExtensiveToTensorGame(const Game& game,
+                                                        int num_threads) {
+  SPIEL_CHECK_GE(num_threads, 1);
+  const int num_players = game.NumPlayers();
+  std::vector<std::vector<std::string>> action_names(num_players);
 
   GameType type = game.GetType();
 
-  std::vector<algorithms::DeterministicTabularPolicy> policies;
-  for (Player player = 0; player < game.NumPlayers(); ++player) {
+  for (Player player = 0; player < num_players; ++player) {
     algorithms::DeterministicTabularPolicy policy(game, player);
     do {
       action_names[player].push_back(policy.ToString(/*delimiter=*/" --- "));
     } while (policy.NextPolicy());
-    policy.ResetDefaultPolicy();
-    policies.push_back(policy);
   }
-  std::vector<const Policy*> policy_ptrs(policies.size());
-    for (Player player = 0; player < game.NumPlayers(); ++player) {
-      policy_ptrs[player] = &policies[player];
+
+  std::vector<InfostateTable> tables(num_players);
+  std::vector<std::vector<std::pair<int, int>>> choices(num_players);
+  std::vector<Contribution> contributions;
+  CollectContributions(*game.NewInitialState(), 1., &choices, &tables,
+                       &contributions);
+
+  // Number the information states in the order of the policies' tables.
+  std::vector<std::vector<int>> num_actions(num_players);
+  std::vector<std::vector<int64_t>> strides(num_players);
+  for (Player player = 0; player < num_players; ++player) {
+    std::vector<std::pair<std::string, int>> sorted(tables[player].ids.begin(),
+                                                    tables[player].ids.end());
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<int> new_id(sorted.size());
+    int64_t stride = 1;
+    for (int i = 0; i < sorted.size(); ++i) {
+      new_id[sorted[i].second] = i;
+      const int n = tables[player].legal_actions[sorted[i].second].size();
+      num_actions[player].push_back(n);
+      strides[player].push_back(stride);
+      stride *= n;
     }
-  const std::unique_ptr<State> initial_state = game.NewInitialState();
-  std::vector<std::vector<double>> utils(game.NumPlayers());
-  bool last_entry;
-  do {
-    std::vector<double> returns = algorithms::ExpectedReturns(
-        *initial_state, policy_ptrs, /*depth_limit=*/-1);
-    for (Player player = 0; player < game.NumPlayers(); ++player) {
-      utils[player].push_back(returns[player]);
+    SPIEL_CHECK_EQ(stride, action_names[player].size());
+    for (Contribution& contribution : contributions) {
+      for (auto& choice : contribution.choices[player]) {
+        choice.first = new_id[choice.first];
+      }
     }
-    last_entry = true;
-    for (auto policy = policies.rbegin(); policy != policies.rend(); ++policy) {
-      if (policy->NextPolicy()) {
-        last_entry = false;
-        break;
-      } else {
-        policy->ResetDefaultPolicy();
+  }
+
+  // The tensors are row-major, so the profiles of each of player 0's
+  // policies are a contiguous block of them.
+  std::vector<int64_t> block_sizes(num_players, 1);
+  for (Player player = num_players - 2; player >= 0; --player) {
+    block_sizes[player] =
+        block_sizes[player + 1] * action_names[player + 1].size();
+  }
+  const int64_t num_profiles = block_sizes[0] * action_names[0].size();
+  std::vector<std::vector<double>> utils(num_players,
+                                         std::vector<double>(num_profiles, 0.));
+
+  // Each thread adds the contributions to the profiles of a range of player
+  // 0's policies, so they write to separate parts of the tensors.
+  auto fill = [&](int64_t begin, int64_t end) {
+    std::vector<int64_t> offsets;
+    for (const Contribution& contribution : contributions) {
+      std::vector<int64_t> first_policies = ConsistentPolicies(
+          contribution.choices[0], num_actions[0], strides[0]);
+      auto first = std::lower_bound(first_policies.begin(),
+                                    first_policies.end(), begin);
+      auto last = std::lower_bound(first, first_policies.end(), end);
+      if (first == last) continue;
+      // The consistent profiles of the other players, within a block.
+      offsets.assign(1, 0);
+      for (Player player = 1; player < num_players && !offsets.empty();
+           ++player) {
+        std::vector<int64_t> policies = ConsistentPolicies(
+            contribution.choices[player], num_actions[player],
+            strides[player]);
+        std::vector<int64_t> next;
+        next.reserve(offsets.size() * policies.size());
+        for (int64_t offset : offsets) {
+          for (int64_t policy : policies) {
+            next.push_back(offset + policy * block_sizes[player]);
+          }
+        }
+        offsets.swap(next);
+      }
+      for (auto policy = first; policy != last; ++policy) {
+        for (int64_t offset : offsets) {
+          const int64_t profile = *policy * block_sizes[0] + offset;
+          for (Player player = 0; player < num_players; ++player) {
+            utils[player][profile] +=
+                contribution.chance_prob * contribution.rewards[player];
+          }
+        }
       }
     }
-  } while (!last_entry);
+  };
+  const int64_t num_first_policies = action_names[0].size();
+  num_threads = std::min<int64_t>(num_threads, num_first_policies);
+  std::vector<Thread> threads;
+  for (int t = 1; t < num_threads; ++t) {
+    threads.emplace_back([&fill, t, num_threads, num_first_policies]() {
+      fill(num_first_policies * t / num_threads,
+           num_first_policies * (t + 1) / num_threads);
+    });
+  }
+  fill(0, num_first_policies / num_threads);
+  for (Thread& thread : threads) thread.join();
 
   return tensor_game::CreateTensorGame(kGameType.short_name,
                                        "Normal-form " + type.long_name,
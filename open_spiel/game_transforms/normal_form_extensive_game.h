@@ -35,9 +35,14 @@ namespace open_spiel {
 //
 // Hence, this method should only be used for  small games! For example, Kuhn
 // poker has 64 deterministic policies, resulting in a 64-by-64 matrix.
+//
+// The game tree is walked once, to find the states where rewards are given,
+// chance's probability of reaching them and the actions the players take on
+// the way. Each of those rewards is then added to the entries of the profiles
+// that take those actions, split over `num_threads` threads.
 
 std::shared_ptr<const tensor_game::TensorGame> ExtensiveToTensorGame(
-    const Game& game);
+    const Game& game, int num_threads = 1);
 
 }  // namespace open_spiel
 
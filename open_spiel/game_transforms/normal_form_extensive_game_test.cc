@@ -14,6 +14,17 @@
 
 #include "open_spiel/game_transforms/normal_form_extensive_game.h"
 
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/algorithms/deterministic_policy.h"
+#include "open_spiel/algorithms/expected_returns.h"
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/tensor_game.h"
+
 namespace open_spiel {
 namespace {
 
@@ -28,9 +39,54 @@ void ExtensiveToTensorGameTest() {
   SPIEL_CHECK_EQ(auction_tensor_game->Shape()[2], 24);
 }
 
+// Checks the utilities against the expected returns of every profile, found
+// by walking the tree for each one.
+void ExtensiveToTensorGameMatchesExpectedReturnsTest(
+    const std::string& game_string) {
+  std::shared_ptr<const Game> game = LoadGame(game_string);
+  std::shared_ptr<const tensor_game::TensorGame> tensor_game =
+      ExtensiveToTensorGame(*game);
+  std::shared_ptr<const tensor_game::TensorGame> threaded_tensor_game =
+      ExtensiveToTensorGame(*game, /*num_threads=*/3);
+
+  std::vector<algorithms::DeterministicTabularPolicy> policies;
+  for (Player player = 0; player < game->NumPlayers(); ++player) {
+    policies.emplace_back(*game, player);
+  }
+  std::vector<const Policy*> policy_ptrs;
+  for (const auto& policy : policies) policy_ptrs.push_back(&policy);
+  std::unique_ptr<State> initial_state = game->NewInitialState();
+  std::vector<Action> profile(game->NumPlayers(), 0);
+  bool last_profile;
+  do {
+    std::vector<double> returns = algorithms::ExpectedReturns(
+        *initial_state, policy_ptrs, /*depth_limit=*/-1);
+    for (Player player = 0; player < game->NumPlayers(); ++player) {
+      SPIEL_CHECK_FLOAT_NEAR(tensor_game->PlayerUtility(player, profile),
+                             returns[player], 1e-12);
+      SPIEL_CHECK_EQ(threaded_tensor_game->PlayerUtility(player, profile),
+                     tensor_game->PlayerUtility(player, profile));
+    }
+    last_profile = true;
+    for (Player player = game->NumPlayers() - 1; player >= 0; --player) {
+      if (policies[player].NextPolicy()) {
+        ++profile[player];
+        last_profile = false;
+        break;
+      }
+      policies[player].ResetDefaultPolicy();
+      profile[player] = 0;
+    }
+  } while (!last_profile);
+}
+
 }  // namespace
 }  // namespace open_spiel
 
 int main(int argc, char** argv) {
   open_spiel::ExtensiveToTensorGameTest();
+  open_spiel::ExtensiveToTensorGameMatchesExpectedReturnsTest("kuhn_poker");
+  open_spiel::ExtensiveToTensorGameMatchesExpectedReturnsTest(
+      "first_sealed_auction(players=3,max_value=3)");
+  open_spiel::ExtensiveToTensorGameMatchesExpectedReturnsTest("matrix_rps");
 }
@@ -15,11 +15,13 @@
 #include "open_spiel/games/backgammon.h"
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <cstdlib>
-#include <set>
 #include <utility>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/numeric/bits.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
 #include "open_spiel/game_parameters.h"
 #include "open_spiel/spiel.h"
@@ -308,8 +310,7 @@ BackgammonState::BackgammonState(std::shared_ptr<const Game> game,
       dice_({}),
       bar_({0, 0}),
       scores_({0, 0}),
-      board_(
-          {std::vector<int>(kNumPoints, 0), std::vector<int>(kNumPoints, 0)}),
+      board_(),
       turn_history_info_({}) {
   // Setup the board. First, XPlayer.
   board_[kXPlayerId][0] = 2;
@@ -525,31 +526,33 @@ Action BackgammonState::EncodedPassMove() const { return 25; }
 Action BackgammonState::CheckerMovesToSpielMove(
     const std::vector<CheckerMove>& moves) const {
   SPIEL_CHECK_LE(moves.size(), 2);
+  return CheckerMovesToSpielMove(
+      moves.empty() ? CheckerMove() : moves[0],
+      moves.size() > 1 ? moves[1] : CheckerMove());
+}
+
+Action BackgammonState::CheckerMovesToSpielMove(
+    const CheckerMove& first, const CheckerMove& second) const {
   int dig0 = EncodedPassMove();
   int dig1 = EncodedPassMove();
   bool high_roll_first = false;
   int high_roll = DiceValue(0) >= DiceValue(1) ? DiceValue(0) : DiceValue(1);
 
-  if (!moves.empty()) {
-    int pos1 = moves[0].pos;
-    if (pos1 == kBarPos) {
-      pos1 = EncodedBarMove();
-    }
-    if (pos1 != kPassPos) {
-      int num1 = moves[0].num;
-      dig0 = pos1;
-      high_roll_first = num1 == high_roll;
-    }
+  int pos1 = first.pos;
+  if (pos1 == kBarPos) {
+    pos1 = EncodedBarMove();
+  }
+  if (pos1 != kPassPos) {
+    dig0 = pos1;
+    high_roll_first = first.num == high_roll;
   }
 
-  if (moves.size() > 1) {
-    int pos2 = moves[1].pos;
-    if (pos2 == kBarPos) {
-      pos2 = EncodedBarMove();
-    }
-    if (pos2 != kPassPos) {
-      dig1 = pos2;
-    }
+  int pos2 = second.pos;
+  if (pos2 == kBarPos) {
+    pos2 = EncodedBarMove();
+  }
+  if (pos2 != kPassPos) {
+    dig1 = pos2;
   }
 
   Action move = dig1 * 26 + dig0;
@@ -618,11 +621,8 @@ int BackgammonState::CheckersInHome(int player) const {
   return c;
 }
 
-bool BackgammonState::AllInHome(int player) const {
-  if (bar_[player] > 0) {
-    return false;
-  }
-
+bool BackgammonState::AllInHome(
+    int player, const std::array<int, kNumPoints>& board) const {
   SPIEL_CHECK_GE(player, 0);
   SPIEL_CHECK_LE(player, 1);
 
@@ -633,7 +633,7 @@ bool BackgammonState::AllInHome(int player) const {
   int scan_end = (player == kXPlayerId ? 17 : 23);
 
   for (int i = scan_start; i <= scan_end; ++i) {
-    if (board_[player][i] > 0) {
+    if (board[i] > 0) {
       return false;
     }
   }
@@ -651,7 +651,8 @@ int BackgammonState::HighestUsableDiceOutcome() const {
   }
 }
 
-int BackgammonState::FurthestCheckerInHome(int player) const {
+int BackgammonState::FurthestCheckerInHome(
+    int player, const std::array<int, kNumPoints>& board) const {
   // Looking for any checkers in home.
   // --> XPlayer scans 23 -> 18
   // --> OPlayer scans  0 -> 5
@@ -662,7 +663,7 @@ int BackgammonState::FurthestCheckerInHome(int player) const {
   int furthest = (player == kXPlayerId ? 24 : -1);
 
   for (int i = scan_start; i != scan_end; i += inc) {
-    if (board_[player][i] > 0) {
+    if (board[i] > 0) {
       furthest = i;
     }
   }
@@ -860,28 +861,35 @@ int BackgammonState::IsBackgammoned(int player) const {
   return false;
 }
 
-std::set<CheckerMove> BackgammonState::LegalCheckerMoves(int player) const {
-  std::set<CheckerMove> moves;
+int BackgammonState::LegalCheckerMoves(
+    int player, const std::array<int, kNumPoints>& board, int bar,
+    const std::array<int, 2>& dice, CheckerMove* moves) const {
+  int num_moves = 0;
+  // Doubles give the same moves for both dice, so only look at the first.
+  int num_dice = dice[0] == dice[1] ? 1 : 2;
 
-  if (bar_[player] > 0) {
+  if (bar > 0) {
     // If there are any checkers are the bar, must move them out first.
-    for (int outcome : dice_) {
+    for (int d = 0; d < num_dice; ++d) {
+      int outcome = dice[d];
       if (UsableDiceOutcome(outcome)) {
         int pos = PositionFromBar(player, outcome);
         if (NumOppCheckers(player, pos) <= 1) {
           bool hit = NumOppCheckers(player, pos) == 1;
-          moves.insert(CheckerMove(kBarPos, outcome, hit));
+          moves[num_moves++] = CheckerMove(kBarPos, outcome, hit);
         }
       }
     }
-    return moves;
+    return num_moves;
   }
 
   // Regular board moves.
-  bool all_in_home = AllInHome(player);
+  bool all_in_home = AllInHome(player, board);
+  int furthest = all_in_home ? FurthestCheckerInHome(player, board) : -1;
   for (int i = 0; i < kNumPoints; ++i) {
-    if (board_[player][i] > 0) {
-      for (int outcome : dice_) {
+    if (board[i] > 0) {
+      for (int d = 0; d < num_dice; ++d) {
+        int outcome = dice[d];
         if (UsableDiceOutcome(outcome)) {
           int pos = PositionFrom(player, i, outcome);
           if (pos == kScorePos && all_in_home) {
@@ -892,24 +900,25 @@ std::set<CheckerMove> BackgammonState::LegalCheckerMoves(int player) const {
             // just stepping off the board.
             if ((player == kXPlayerId && i + outcome == 24) ||
                 (player == kOPlayerId && i - outcome == -1)) {
-              moves.insert(CheckerMove(i, outcome, false));
+              moves[num_moves++] = CheckerMove(i, outcome, false);
             } else {
               // Otherwise, a die can only be used to move a checker off if
               // there are no checkers further than it in the player's home.
-              if (i == FurthestCheckerInHome(player)) {
-                moves.insert(CheckerMove(i, outcome, false));
+              if (i == furthest) {
+                moves[num_moves++] = CheckerMove(i, outcome, false);
               }
             }
           } else if (pos != kScorePos && NumOppCheckers(player, pos) <= 1) {
             // Regular move.
             bool hit = NumOppCheckers(player, pos) == 1;
-            moves.insert(CheckerMove(i, outcome, hit));
+            moves[num_moves++] = CheckerMove(i, outcome, hit);
           }
         }
       }
     }
   }
-  return moves;
+  SPIEL_CHECK_LE(num_moves, kMaxCheckerMoves);
+  return num_moves;
 }
 
 bool BackgammonState::ApplyCheckerMove(int player, const CheckerMove& move) {
@@ -1004,45 +1013,25 @@ void BackgammonState::UndoCheckerMove(int player, const CheckerMove& move) {
   }
 }
 
-// Returns the maximum move size (2, 1, or 0)
-int BackgammonState::RecLegalMoves(
-    std::vector<CheckerMove> moveseq,
-    std::set<std::vector<CheckerMove>>* movelist) {
-  if (moveseq.size() == 2) {
-    movelist->insert(moveseq);
-    return moveseq.size();
-  }
-
-  std::set<CheckerMove> moves_here = LegalCheckerMoves(cur_player_);
-
-  if (moves_here.empty()) {
-    movelist->insert(moveseq);
-    return moveseq.size();
-  }
-
-  int max_moves = -1;
-  for (const auto& move : moves_here) {
-    moveseq.push_back(move);
-    ApplyCheckerMove(cur_player_, move);
-    int child_max = RecLegalMoves(moveseq, movelist);
-    UndoCheckerMove(cur_player_, move);
-    max_moves = std::max(child_max, max_moves);
-    moveseq.pop_back();
-  }
-
-  return max_moves;
-}
+std::vector<Action> BackgammonState::LegalActions() const {
+  if (IsChanceNode()) return LegalChanceOutcomes();
+  if (IsTerminal()) return {};
 
-std::vector<Action> BackgammonState::ProcessLegalMoves(
-    int max_moves, const std::set<std::vector<CheckerMove>>& movelist) const {
-  if (max_moves == 0) {
-    SPIEL_CHECK_EQ(movelist.size(), 1);
-    SPIEL_CHECK_TRUE(movelist.begin()->empty());
+  SPIEL_CHECK_EQ(CountTotalCheckers(kXPlayerId), kNumCheckersPerPlayer);
+  SPIEL_CHECK_EQ(CountTotalCheckers(kOPlayerId), kNumCheckersPerPlayer);
 
-    // Passing is always a legal move!
-    return {CheckerMovesToSpielMove(
-        {{kPassPos, -1, false}, {kPassPos, -1, false}})};
-  }
+  // An action moves up to two checkers; the second half of a double is played
+  // as another action. So this looks at every move of a first checker and
+  // then at every move of a second one after it, on a copy of the player's
+  // checkers. Hits don't need to be played out: a point with one opponent
+  // checker is as open with it as without it.
+  //
+  // Different sequences can't give the same action, but the actions are
+  // collected in a bit set indexed by the action all the same, which also
+  // gives them back in order.
+  const int player = cur_player_;
+  const std::array<int, 2> dice = {dice_[0], dice_[1]};
+  std::array<uint64_t, (kNumDistinctActions + 63) / 64> actions{};
 
   // Rule 2 in Movement of Checkers:
   // A player must use both numbers of a roll if this is legally possible (or
@@ -1051,51 +1040,67 @@ std::vector<Action> BackgammonState::ProcessLegalMoves(
   // both, the player must play the larger one. When neither number can be used,
   // the player loses his turn. In the case of doubles, when all four numbers
   // cannot be played, the player must play as many numbers as he can.
-  std::vector<Action> legal_actions;
-  int max_roll = -1;
-  for (const auto& move : movelist) {
-    if (max_moves == 2) {
-      // Only add moves that are size 2.
-      if (move.size() == 2) {
-        legal_actions.push_back(CheckerMovesToSpielMove(move));
+  CheckerMove first_moves[kMaxCheckerMoves];
+  CheckerMove second_moves[kMaxCheckerMoves];
+  int num_first = LegalCheckerMoves(player, board_[player], bar_[player], dice,
+                                    first_moves);
+  if (num_first == 0) {
+    // Passing is always a legal move!
+    return {CheckerMovesToSpielMove(CheckerMove(), CheckerMove())};
+  }
+
+  int max_moves = 1;
+  int max_single_roll = -1;
+  for (int i = 0; i < num_first; ++i) {
+    const CheckerMove& first = first_moves[i];
+    std::array<int, kNumPoints> board = board_[player];
+    int bar = bar_[player];
+    std::array<int, 2> next_dice = dice;
+    if (first.pos == kBarPos) {
+      --bar;
+    } else {
+      --board[first.pos];
+    }
+    int to = PositionFrom(player, first.pos, first.num);
+    if (to != kScorePos) ++board[to];
+    next_dice[next_dice[0] == first.num ? 0 : 1] += 6;
+
+    int num_second =
+        LegalCheckerMoves(player, board, bar, next_dice, second_moves);
+    if (num_second > 0) {
+      max_moves = 2;
+      for (int j = 0; j < num_second; ++j) {
+        Action action = CheckerMovesToSpielMove(first, second_moves[j]);
+        actions[action / 64] |= uint64_t{1} << (action % 64);
       }
-    } else if (max_moves == 1) {
-      // We are just finding the maximum roll.
-      max_roll = std::max(max_roll, move[0].num);
+    } else {
+      max_single_roll = std::max(max_single_roll, first.num);
     }
   }
 
   if (max_moves == 1) {
-    // Another round to add those that have the max die roll.
-    for (const auto& move : movelist) {
-      if (move[0].num == max_roll) {
-        legal_actions.push_back(CheckerMovesToSpielMove(move));
+    // Only one checker can move: it must use the larger die it can.
+    for (int i = 0; i < num_first; ++i) {
+      if (first_moves[i].num == max_single_roll) {
+        Action action = CheckerMovesToSpielMove(first_moves[i], CheckerMove());
+        actions[action / 64] |= uint64_t{1} << (action % 64);
       }
     }
   }
 
+  int num_actions = 0;
+  for (uint64_t word : actions) num_actions += absl::popcount(word);
+  std::vector<Action> legal_actions;
+  legal_actions.reserve(num_actions);
+  for (int w = 0; w < actions.size(); ++w) {
+    for (uint64_t word = actions[w]; word != 0; word &= word - 1) {
+      legal_actions.push_back(w * 64 + absl::countr_zero(word));
+    }
+  }
   SPIEL_CHECK_FALSE(legal_actions.empty());
   return legal_actions;
 }
 
-std::vector<Action> BackgammonState::LegalActions() const {
-  if (IsChanceNode()) return LegalChanceOutcomes();
-  if (IsTerminal()) return {};
-
-  SPIEL_CHECK_EQ(CountTotalCheckers(kXPlayerId), kNumCheckersPerPlayer);
-  SPIEL_CHECK_EQ(CountTotalCheckers(kOPlayerId), kNumCheckersPerPlayer);
-
-  std::unique_ptr<State> cstate = this->Clone();
-  BackgammonState* state = dynamic_cast<BackgammonState*>(cstate.get());
-  std::set<std::vector<CheckerMove>> movelist;
-  int max_moves = state->RecLegalMoves({}, &movelist);
-  SPIEL_CHECK_GE(max_moves, 0);
-  SPIEL_CHECK_LE(max_moves, 2);
-  std::vector<Action> legal_actions = ProcessLegalMoves(max_moves, movelist);
-  std::sort(legal_actions.begin(), legal_actions.end());
-  return legal_actions;
-}
-
 std::vector<std::pair<Action, double>> BackgammonState::ChanceOutcomes() const {
   SPIEL_CHECK_TRUE(IsChanceNode());
   return kChanceOutcomes;
@@ -1219,9 +1224,15 @@ void BackgammonState::SetState(int cur_player, bool double_turn,
   cur_player_ = cur_player;
   double_turn_ = double_turn;
   dice_ = dice;
-  bar_ = bar;
-  scores_ = scores;
-  board_ = board;
+  SPIEL_CHECK_EQ(bar.size(), kNumPlayers);
+  SPIEL_CHECK_EQ(scores.size(), kNumPlayers);
+  SPIEL_CHECK_EQ(board.size(), kNumPlayers);
+  for (int p = 0; p < kNumPlayers; ++p) {
+    SPIEL_CHECK_EQ(board[p].size(), kNumPoints);
+    bar_[p] = bar[p];
+    scores_[p] = scores[p];
+    std::copy(board[p].begin(), board[p].end(), board_[p].begin());
+  }
 
   SPIEL_CHECK_EQ(CountTotalCheckers(kXPlayerId), kNumCheckersPerPlayer);
   SPIEL_CHECK_EQ(CountTotalCheckers(kOPlayerId), kNumCheckersPerPlayer);
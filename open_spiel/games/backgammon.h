@@ -17,7 +17,6 @@
 
 #include <array>
 #include <memory>
-#include <set>
 #include <string>
 #include <vector>
 
@@ -79,6 +78,7 @@ struct CheckerMove {
   int pos;  // 0-24  (0-23 for locations on the board and kBarPos)
   int num;  // 1-6
   bool hit;
+  CheckerMove() : CheckerMove(kPassPos, -1, false) {}
   CheckerMove(int _pos, int _num, bool _hit)
       : pos(_pos), num(_num), hit(_hit) {}
   bool operator<(const CheckerMove& rhs) const {
@@ -178,6 +178,8 @@ class BackgammonState : public State {
 
   // Action encoding / decoding functions.
   Action CheckerMovesToSpielMove(const std::vector<CheckerMove>& moves) const;
+  Action CheckerMovesToSpielMove(const CheckerMove& first,
+                                 const CheckerMove& second) const;
   std::vector<CheckerMove> SpielMoveToCheckerMoves(int player,
                                                    Action spiel_move) const;
   Action TranslateAction(int from1, int from2, bool use_high_die_first) const;
@@ -188,7 +190,7 @@ class BackgammonState : public State {
  private:
   void RollDice(int outcome);
   bool IsPosInHome(int player, int pos) const;
-  bool AllInHome(int player) const;
+  bool AllInHome(int player, const std::array<int, kNumPoints>& board) const;
   int CheckersInHome(int player) const;
   bool UsableDiceOutcome(int outcome) const;
   int PositionFromBar(int player, int spaces) const;
@@ -209,15 +211,24 @@ class BackgammonState : public State {
 
   // Returns the position of the furthest checker in the home of this player.
   // Returns -1 if none found.
-  int FurthestCheckerInHome(int player) const;
+  int FurthestCheckerInHome(int player,
+                            const std::array<int, kNumPoints>& board) const;
 
   bool ApplyCheckerMove(int player, const CheckerMove& move);
   void UndoCheckerMove(int player, const CheckerMove& move);
-  std::set<CheckerMove> LegalCheckerMoves(int player) const;
-  int RecLegalMoves(std::vector<CheckerMove> moveseq,
-                    std::set<std::vector<CheckerMove>>* movelist);
-  std::vector<Action> ProcessLegalMoves(
-      int max_moves, const std::set<std::vector<CheckerMove>>& movelist) const;
+
+  // The most moves of a single checker there can be: one for each distinct
+  // die from each of the at most 15 occupied points.
+  static constexpr int kMaxCheckerMoves = 2 * kNumCheckersPerPlayer;
+
+  // Writes the legal moves of a single checker of `player` to `moves` and
+  // returns how many there are. The player's checkers on the points and the
+  // bar, and the dice, are given rather than taken from the state so the move
+  // generator can look ahead without modifying it. Used dice are marked by
+  // adding 6, as in ApplyCheckerMove.
+  int LegalCheckerMoves(int player, const std::array<int, kNumPoints>& board,
+                        int bar, const std::array<int, 2>& dice,
+                        CheckerMove* moves) const;
 
   ScoringType scoring_type_;  // Which rules apply when scoring the game.
 
@@ -228,9 +239,10 @@ class BackgammonState : public State {
   int o_turns_;
   bool double_turn_;
   std::vector<int> dice_;    // Current dice.
-  std::vector<int> bar_;     // Checkers of each player in the bar.
-  std::vector<int> scores_;  // Checkers returned home by each player.
-  std::vector<std::vector<int>> board_;  // Checkers for each player on points.
+  std::array<int, kNumPlayers> bar_;  // Checkers of each player in the bar.
+  std::array<int, kNumPlayers> scores_;  // Checkers returned home by each.
+  // Checkers for each player on points.
+  std::array<std::array<int, kNumPoints>, kNumPlayers> board_;
   std::vector<TurnHistoryInfo> turn_history_info_;  // Info needed for Undo.
 };
 
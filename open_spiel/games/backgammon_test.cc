@@ -15,6 +15,7 @@
 #include "open_spiel/games/backgammon.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <random>
 
 #include "open_spiel/spiel.h"
@@ -333,6 +334,25 @@ void DoublesBearOffOutsideHome() {
   action = bstate->CheckerMovesToSpielMove({{20, 4, false}, {20, 4, false}});
   SPIEL_CHECK_TRUE(ActionsContains(legal_actions, action));
 }
+
+// Plays random games and folds every list of legal actions into a hash, which
+// must match the one recorded from the original set-based move generator, so
+// that the actions and their order stay exactly the same.
+void LegalActionsMatchReferenceTest() {
+  int num_states = 0;
+  const uint64_t hash = testing::RandomGamesHash(
+      *LoadGame("backgammon"), 200, /*seed=*/42,
+      [&num_states](const State& state, testing::SequenceHash* hash) {
+        if (state.IsChanceNode()) return;
+        ++num_states;
+        for (Action action : state.LegalActions()) hash->Mix(action);
+        hash->Mix(kNumDistinctActions);
+      },
+      /*hash_terminal=*/nullptr);
+  SPIEL_CHECK_EQ(num_states, 20710);
+  SPIEL_CHECK_EQ(hash, 6006508334179382791ull);
+}
+
 void HumanReadableNotation() {
   std::shared_ptr<const Game> game = LoadGame("backgammon");
   std::unique_ptr<State> state = game->NewInitialState();
@@ -536,4 +556,5 @@ int main(int argc, char** argv) {
   open_spiel::backgammon::DoublesBearOffOutsideHome();
   open_spiel::backgammon::BasicBackgammonTestsVaryScoring();
   open_spiel::backgammon::HumanReadableNotation();
+  open_spiel::backgammon::LegalActionsMatchReferenceTest();
 }
@@ -15,10 +15,12 @@
 #include "open_spiel/games/breakthrough.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/numeric/bits.h"
 #include "open_spiel/game_parameters.h"
 #include "open_spiel/utils/tensor_view.h"
 
@@ -32,6 +34,9 @@ constexpr int kNumDirections = 6;
 // Numbers of rows needed to have 2 full rows of pieces.
 constexpr int kNumRowsForFullPieces = 6;
 
+// Boards with more cells than this don't fit in the bitboards.
+constexpr int kMaxBitboardCells = 64;
+
 // Direction offsets for black, then white.
 constexpr std::array<int, kNumDirections> kDirRowOffsets = {
     {1, 1, 1, -1, -1, -1}};
@@ -114,6 +119,14 @@ std::string ColLabel(int col) {
   return label;
 }
 
+uint64_t CellBit(int cell) { return uint64_t{1} << cell; }
+
+uint64_t ColumnMask(int rows, int cols, int col) {
+  uint64_t mask = 0;
+  for (int r = 0; r < rows; r++) mask |= CellBit(r * cols + col);
+  return mask;
+}
+
 }  // namespace
 
 BreakthroughState::BreakthroughState(std::shared_ptr<const Game> game, int rows,
@@ -121,8 +134,10 @@ BreakthroughState::BreakthroughState(std::shared_ptr<const Game> game, int rows,
     : State(game), rows_(rows), cols_(cols) {
   SPIEL_CHECK_GT(rows_, 1);
   SPIEL_CHECK_GT(cols_, 1);
+  if (rows_ * cols_ > kMaxBitboardCells) {
+    board_ = std::vector<CellState>(rows_ * cols_, CellState::kEmpty);
+  }
 
-  board_ = std::vector<CellState>(rows_ * cols_, CellState::kEmpty);
   for (int r = 0; r < rows_; r++) {
     for (int c = 0; c < cols_; c++) {
       // Only use two rows if there are at least 6 rows.
@@ -149,41 +164,68 @@ int BreakthroughState::CurrentPlayer() const {
   }
 }
 
+CellState BreakthroughState::board(int row, int col) const {
+  if (!board_.empty()) return board_[row * cols_ + col];
+  const uint64_t bit = CellBit(row * cols_ + col);
+  if (bitboards_[0] & bit) return CellState::kBlack;
+  if (bitboards_[1] & bit) return CellState::kWhite;
+  return CellState::kEmpty;
+}
+
+void BreakthroughState::SetBoard(int r, int c, CellState cs) {
+  if (!board_.empty()) {
+    board_[r * cols_ + c] = cs;
+    return;
+  }
+  const uint64_t bit = CellBit(r * cols_ + c);
+  bitboards_[0] &= ~bit;
+  bitboards_[1] &= ~bit;
+  if (cs != CellState::kEmpty) bitboards_[StateToPlayer(cs)] |= bit;
+}
+
+BreakthroughState::Move BreakthroughState::DecodeAction(Action action) const {
+  // The action is ranked in the mixed base {rows, cols, kNumDirections, 2}.
+  const int dir = (action / 2) % kNumDirections;
+  const int cell = action / (2 * kNumDirections);
+  Move move;
+  move.r1 = cell / cols_;
+  move.c1 = cell % cols_;
+  move.r2 = move.r1 + kDirRowOffsets[dir];
+  move.c2 = move.c1 + kDirColOffsets[dir];
+  move.capture = action % 2 == 1;
+  return move;
+}
+
 void BreakthroughState::DoApplyAction(Action action) {
-  std::vector<int> values(4, -1);
-  UnrankActionMixedBase(action, {rows_, cols_, kNumDirections, 2}, &values);
-  int r1 = values[0];
-  int c1 = values[1];
-  int dir = values[2];
-  bool capture = values[3] == 1;
-  int r2 = r1 + kDirRowOffsets[dir];
-  int c2 = c1 + kDirColOffsets[dir];
-
-  SPIEL_CHECK_TRUE(InBounds(r1, c1));
-  SPIEL_CHECK_TRUE(InBounds(r2, c2));
+  const Move move = DecodeAction(action);
+  SPIEL_CHECK_TRUE(InBounds(move.r1, move.c1));
+  SPIEL_CHECK_TRUE(InBounds(move.r2, move.c2));
+  SPIEL_CHECK_EQ(board(move.r1, move.c1), PlayerToState(cur_player_));
+  const Player opponent = 1 - cur_player_;
 
   // Remove pieces if captured.
-  if (board(r2, c2) == CellState::kWhite) {
-    pieces_[StateToPlayer(CellState::kWhite)]--;
-    SPIEL_CHECK_EQ(board(r1, c1), CellState::kBlack);
-    SPIEL_CHECK_EQ(cur_player_, StateToPlayer(CellState::kBlack));
-  } else if (board(r2, c2) == CellState::kBlack) {
-    pieces_[StateToPlayer(CellState::kBlack)]--;
-    SPIEL_CHECK_EQ(board(r1, c1), CellState::kWhite);
-    SPIEL_CHECK_EQ(cur_player_, StateToPlayer(CellState::kWhite));
+  if (move.capture) {
+    SPIEL_CHECK_EQ(board(move.r2, move.c2), PlayerToState(opponent));
+  }
+  if (board(move.r2, move.c2) == PlayerToState(opponent)) {
+    pieces_[opponent]--;
   }
 
   // Move the piece.
-  if (capture) {
-    SPIEL_CHECK_EQ(board(r2, c2), OpponentState(board(r1, c1)));
+  if (board_.empty()) {
+    const uint64_t from = CellBit(move.r1 * cols_ + move.c1);
+    const uint64_t to = CellBit(move.r2 * cols_ + move.c2);
+    bitboards_[opponent] &= ~to;
+    bitboards_[cur_player_] ^= from | to;
+  } else {
+    SetBoard(move.r2, move.c2, PlayerToState(cur_player_));
+    SetBoard(move.r1, move.c1, CellState::kEmpty);
   }
-  SetBoard(r2, c2, board(r1, c1));
-  SetBoard(r1, c1, CellState::kEmpty);
 
   // Check for winner.
-  if (cur_player_ == 0 && r2 == (rows_ - 1)) {
+  if (cur_player_ == 0 && move.r2 == (rows_ - 1)) {
     winner_ = 0;
-  } else if (cur_player_ == 1 && r2 == 0) {
+  } else if (cur_player_ == 1 && move.r2 == 0) {
     winner_ = 1;
   }
 
@@ -193,21 +235,14 @@ void BreakthroughState::DoApplyAction(Action action) {
 
 std::string BreakthroughState::ActionToString(Player player,
                                               Action action) const {
-  std::vector<int> values(4, -1);
-  UnrankActionMixedBase(action, {rows_, cols_, kNumDirections, 2}, &values);
-  int r1 = values[0];
-  int c1 = values[1];
-  int dir = values[2];
-  bool capture = values[3] == 1;
-  int r2 = r1 + kDirRowOffsets[dir];
-  int c2 = c1 + kDirColOffsets[dir];
+  const Move move = DecodeAction(action);
 
   std::string action_string = "";
-  absl::StrAppend(&action_string, ColLabel(c1));
-  absl::StrAppend(&action_string, RowLabel(rows_, r1));
-  absl::StrAppend(&action_string, ColLabel(c2));
-  absl::StrAppend(&action_string, RowLabel(rows_, r2));
-  if (capture) {
+  absl::StrAppend(&action_string, ColLabel(move.c1));
+  absl::StrAppend(&action_string, RowLabel(rows_, move.r1));
+  absl::StrAppend(&action_string, ColLabel(move.c2));
+  absl::StrAppend(&action_string, RowLabel(rows_, move.r2));
+  if (move.capture) {
     absl::StrAppend(&action_string, "*");
   }
 
@@ -217,6 +252,56 @@ std::string BreakthroughState::ActionToString(Player player,
 std::vector<Action> BreakthroughState::LegalActions() const {
   std::vector<Action> movelist;
   if (IsTerminal()) return movelist;
+  if (!board_.empty()) return CellByCellLegalActions();
+  const Player player = CurrentPlayer();
+  const int num_cells = rows_ * cols_;
+  const uint64_t on_board =
+      num_cells == kMaxBitboardCells ? ~uint64_t{0} : CellBit(num_cells) - 1;
+  const uint64_t own = bitboards_[player];
+  const uint64_t opponent = bitboards_[1 - player];
+  const uint64_t empty = on_board & ~(own | opponent);
+
+  // The pieces that can move in each of the player's directions, found for
+  // all pieces at once by shifting the target cells back by the direction.
+  // Only the diagonal moves can capture.
+  std::array<uint64_t, kNumDirections / 2> moves;
+  std::array<uint64_t, kNumDirections / 2> captures;
+  for (int o = 0; o < kNumDirections / 2; o++) {
+    const int dc = kDirColOffsets[o];
+    uint64_t sources = own;
+    if (dc < 0) sources &= ~ColumnMask(rows_, cols_, 0);
+    if (dc > 0) sources &= ~ColumnMask(rows_, cols_, cols_ - 1);
+    auto back = [&](uint64_t targets) {
+      return player == 0 ? targets >> (cols_ + dc) : targets << (cols_ - dc);
+    };
+    moves[o] = sources & back(empty);
+    captures[o] = dc == 0 ? 0 : sources & back(opponent);
+  }
+
+  // Visit the pieces in order of their cells, so the actions come out sorted.
+  uint64_t movable = 0;
+  for (int o = 0; o < kNumDirections / 2; o++) {
+    movable |= moves[o] | captures[o];
+  }
+  for (; movable != 0; movable &= movable - 1) {
+    const int cell = absl::countr_zero(movable);
+    const uint64_t bit = CellBit(cell);
+    for (int o = 0; o < kNumDirections / 2; o++) {
+      const int dir = player * kNumDirections / 2 + o;
+      if (moves[o] & bit) {
+        // Regular move.
+        movelist.push_back((cell * kNumDirections + dir) * 2);
+      } else if (captures[o] & bit) {
+        movelist.push_back((cell * kNumDirections + dir) * 2 + 1);
+      }
+    }
+  }
+
+  return movelist;
+}
+
+std::vector<Action> BreakthroughState::CellByCellLegalActions() const {
+  std::vector<Action> movelist;
   const Player player = CurrentPlayer();
   CellState mystate = PlayerToState(player);
   std::vector<int> action_bases = {rows_, cols_, kNumDirections, 2};
@@ -340,14 +425,9 @@ void BreakthroughState::ObservationTensor(Player player,
 }
 
 void BreakthroughState::UndoAction(Player player, Action action) {
-  std::vector<int> values(4, -1);
-  UnrankActionMixedBase(action, {rows_, cols_, kNumDirections, 2}, &values);
-  int r1 = values[0];
-  int c1 = values[1];
-  int dir = values[2];
-  bool capture = values[3] == 1;
-  int r2 = r1 + kDirRowOffsets[dir];
-  int c2 = c1 + kDirColOffsets[dir];
+  const Move move = DecodeAction(action);
+  const uint64_t from = CellBit(move.r1 * cols_ + move.c1);
+  const uint64_t to = CellBit(move.r2 * cols_ + move.c2);
 
   cur_player_ = PreviousPlayerRoundRobin(cur_player_, 2);
   total_moves_--;
@@ -357,18 +437,16 @@ void BreakthroughState::UndoAction(Player player, Action action) {
 
   // Move back the piece, and put back the opponent's piece if necessary.
   // The move is (r1, c1) -> (r2, c2) where r is row and c is column.
-  SetBoard(r1, c1, board(r2, c2));
-  SetBoard(r2, c2, CellState::kEmpty);
-  if (capture) {
-    if (board(r1, c1) == CellState::kWhite) {
-      SetBoard(r2, c2, CellState::kBlack);
-      // If the piece being captured is white, decrement the white piece count.
-      pieces_[1]++;
-    } else if (board(r1, c1) == CellState::kBlack) {
-      SetBoard(r2, c2, CellState::kWhite);
-      // Otherwise, decrement the black piece count.
-      pieces_[0]++;
-    }
+  const CellState mover = board(move.r2, move.c2);
+  if (board_.empty()) {
+    bitboards_[StateToPlayer(mover)] ^= from | to;
+  } else {
+    SetBoard(move.r1, move.c1, mover);
+    SetBoard(move.r2, move.c2, CellState::kEmpty);
+  }
+  if (move.capture) {
+    SetBoard(move.r2, move.c2, OpponentState(mover));
+    pieces_[1 - StateToPlayer(mover)]++;
   }
   history_.pop_back();
 }
@@ -16,6 +16,7 @@
 #define OPEN_SPIEL_GAMES_BREAKTHROUGH_H_
 
 #include <array>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -29,6 +30,9 @@
 // Parameters:
 //       "columns"    int     number of columns on the board   (default = 8)
 //       "rows"       int     number of rows on the board      (default = 8)
+//
+// Boards of at most 64 cells are kept as a 64-bit bitboard per player, with
+// bit row * cols + col for each cell. Larger boards are kept cell by cell.
 
 namespace open_spiel {
 namespace breakthrough {
@@ -64,9 +68,9 @@ class BreakthroughState : public State {
   void UndoAction(Player player, Action action) override;
 
   bool InBounds(int r, int c) const;
-  void SetBoard(int r, int c, CellState cs) { board_[r * cols_ + c] = cs; }
+  void SetBoard(int r, int c, CellState cs);
   void SetPieces(int idx, int value) { pieces_[idx] = value; }
-  CellState board(int row, int col) const { return board_[row * cols_ + col]; }
+  CellState board(int row, int col) const;
   int pieces(int idx) const { return pieces_[idx]; }
   int rows() const { return rows_; }
   int cols() const { return cols_; }
@@ -79,6 +83,16 @@ class BreakthroughState : public State {
  private:
   int observation_plane(int r, int c) const;
 
+  struct Move {
+    int r1, c1;  // From.
+    int r2, c2;  // To, which may be off the board.
+    bool capture;
+  };
+  Move DecodeAction(Action action) const;
+
+  // LegalActions for boards too large for the bitboards.
+  std::vector<Action> CellByCellLegalActions() const;
+
   // Fields sets to bad/invalid values. Use Game::NewInitialState().
   Player cur_player_ = kInvalidPlayer;
   int winner_ = kInvalidPlayer;
@@ -86,7 +100,11 @@ class BreakthroughState : public State {
   std::array<int, 2> pieces_;
   int rows_ = -1;
   int cols_ = -1;
-  std::vector<CellState> board_;  // for (row,col) we use row*cols_ + col.
+  // Each player's pieces. For (row,col) we use bit row*cols_ + col.
+  std::array<uint64_t, kNumPlayers> bitboards_ = {};
+  // The cells of boards with more than 64 cells, which don't use bitboards_,
+  // and empty otherwise. For (row,col) we use row*cols_ + col.
+  std::vector<CellState> board_;
 };
 
 class BreakthroughGame : public Game {
@@ -14,6 +14,11 @@
 
 #include "open_spiel/games/breakthrough.h"
 
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "open_spiel/spiel.h"
 #include "open_spiel/tests/basic_tests.h"
 
@@ -34,6 +39,28 @@ void BasicBreakthroughTests() {
   testing::LoadGameTest("breakthrough");
   testing::NoChanceOutcomesTest(*LoadGame("breakthrough"));
   testing::RandomSimTest(*LoadGame("breakthrough"), 100);
+  // Too large for the bitboards.
+  testing::RandomSimTestWithUndo(*LoadGame("breakthrough(rows=9,columns=8)"),
+                                 2);
+}
+
+// The hashes were recorded before the board was a bitboard, so this checks the
+// legal actions, observations and results are still the same.
+void MatchesReferenceTest() {
+  SPIEL_CHECK_EQ(testing::RandomGamesHash(*LoadGame("breakthrough"), 50),
+                 2582588951160083459ull);
+  SPIEL_CHECK_EQ(
+      testing::RandomGamesHash(*LoadGame("breakthrough(rows=6,columns=6)"), 50),
+      14124917800625572692ull);
+  SPIEL_CHECK_EQ(
+      testing::RandomGamesHash(*LoadGame("breakthrough(rows=5,columns=7)"), 50),
+      550315136342326756ull);
+  SPIEL_CHECK_EQ(
+      testing::RandomGamesHash(*LoadGame("breakthrough(rows=9,columns=8)"), 20),
+      9807092384691901164ull);
+  SPIEL_CHECK_EQ(testing::RandomGamesHash(
+                     *LoadGame("breakthrough(rows=10,columns=10)"), 20),
+                 8774464448720977521ull);
 }
 
 }  // namespace
@@ -43,4 +70,5 @@ void BasicBreakthroughTests() {
 int main(int argc, char** argv) {
   open_spiel::breakthrough::BasicSerializationTest();
   open_spiel::breakthrough::BasicBreakthroughTests();
+  open_spiel::breakthrough::MatchesReferenceTest();
 }
@@ -25,14 +25,6 @@
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
 
-// Our preferred version of the double_dummy_solver defines a DDS_EXTERNAL
-// macro to add a prefix to the exported symbols to avoid name clashes.
-// In order to compile with versions of the double_dummy_solver which do not
-// do this, we define DDS_EXTERNAL as an identity if it isn't already defined.
-#ifndef DDS_EXTERNAL
-#define DDS_EXTERNAL(x) x
-#endif
-
 namespace open_spiel {
 namespace bridge {
 namespace {
@@ -61,6 +53,11 @@ const GameType kGameType{/*short_name=*/"bridge",
                              {"dealer_vul", GameParameter(false)},
                              // If true, the non-dealer's side is vulnerable.
                              {"non_dealer_vul", GameParameter(false)},
+                             // A file of double dummy results saved by a
+                             // DoubleDummyCache, to use instead of solving
+                             // the deals again.
+                             {"double_dummy_cache",
+                              GameParameter(std::string())},
                          }};
 
 std::shared_ptr<const Game> Factory(const GameParameters& params) {
@@ -117,7 +114,17 @@ int Partnership(Player player) { return player & 1; }
 }  // namespace
 
 BridgeGame::BridgeGame(const GameParameters& params)
-    : Game(kGameType, params) {}
+    : Game(kGameType, params) {
+  const std::string path = ParameterValue<std::string>("double_dummy_cache");
+  if (!path.empty()) {
+    double_dummy_cache_ = std::make_shared<DoubleDummyCache>(path);
+  }
+}
+
+ddTableResults BridgeGame::DoubleDummyResults(const ddTableDeal& deal) const {
+  if (double_dummy_cache_) return double_dummy_cache_->Solve({deal})[0];
+  return SolveDeals({deal})[0];
+}
 
 BridgeState::BridgeState(std::shared_ptr<const Game> game,
                          bool use_double_dummy_result,
@@ -465,14 +472,8 @@ void BridgeState::ComputeDoubleDummyTricks() {
       dd_table_deal.cards[player][suit] += 1 << (2 + rank);
     }
   }
-  DDS_EXTERNAL(SetMaxThreads)(0);
-  const int return_code =
-      DDS_EXTERNAL(CalcDDtable)(dd_table_deal, &double_dummy_results_);
-  if (return_code != RETURN_NO_FAULT) {
-    char error_message[80];
-    DDS_EXTERNAL(ErrorMessage)(return_code, error_message);
-    SpielFatalError(absl::StrCat("double_dummy_solver:", error_message));
-  }
+  double_dummy_results_ = static_cast<const BridgeGame&>(*game_)
+                              .DoubleDummyResults(dd_table_deal);
 }
 
 std::vector<Action> BridgeState::LegalActions() const {
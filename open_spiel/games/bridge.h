@@ -43,10 +43,12 @@
 // partner). There will thus be 26 turns for declarer, and 13 turns for each
 // of the defenders during the play.
 
+#include <memory>
 #include <optional>
 
 #include "open_spiel/games/bridge/double_dummy_solver/include/dll.h"
 #include "open_spiel/games/bridge/bridge_scoring.h"
+#include "open_spiel/games/bridge/double_dummy_cache.h"
 #include "open_spiel/spiel.h"
 
 namespace open_spiel {
@@ -203,6 +205,9 @@ class BridgeGame : public Game {
     return UseDoubleDummyResult() ? kMaxAuctionLength
                                   : kMaxAuctionLength + kNumCards;
   }
+  // The solver's results for the deal, from the `double_dummy_cache` if
+  // there is one.
+  ddTableResults DoubleDummyResults(const ddTableDeal& deal) const;
 
  private:
   bool UseDoubleDummyResult() const {
@@ -214,6 +219,9 @@ class BridgeGame : public Game {
   bool IsNonDealerVulnerable() const {
     return ParameterValue<bool>("non_dealer_vul", false);
   }
+
+  // Shared by the clones of the game.
+  std::shared_ptr<DoubleDummyCache> double_dummy_cache_;
 };
 
 }  // namespace bridge
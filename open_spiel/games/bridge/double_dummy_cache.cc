@@ -0,0 +1,185 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/bridge/double_dummy_cache.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/games/bridge/double_dummy_solver/include/dll.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+
+// Our preferred version of the double_dummy_solver defines a DDS_EXTERNAL
+// macro to add a prefix to the exported symbols to avoid name clashes.
+// In order to compile with versions of the double_dummy_solver which do not
+// do this, we define DDS_EXTERNAL as an identity if it isn't already defined.
+#ifndef DDS_EXTERNAL
+#define DDS_EXTERNAL(x) x
+#endif
+
+namespace open_spiel {
+namespace bridge {
+namespace {
+
+constexpr int kNumSuits = 4;
+constexpr int kNumCardsPerSuit = 13;
+constexpr int kNumCards = kNumSuits * kNumCardsPerSuit;
+
+// A saved result is the deal's key followed by its tricks.
+constexpr int kRecordSize = sizeof(DealKey) + DDS_STRAINS * DDS_HANDS;
+
+void CheckReturnCode(int return_code) {
+  if (return_code != RETURN_NO_FAULT) {
+    char error_message[80];
+    DDS_EXTERNAL(ErrorMessage)(return_code, error_message);
+    SpielFatalError(absl::StrCat("double_dummy_solver:", error_message));
+  }
+}
+
+void InitSolver() {
+  // Sets up the solver's threads and memory, once.
+  static const bool initialized = [] {
+    DDS_EXTERNAL(SetMaxThreads)(0);
+    return true;
+  }();
+  (void)initialized;
+}
+
+}  // namespace
+
+DealKey KeyOfDeal(const ddTableDeal& deal) {
+  DealKey key{};
+  int num_cards = 0;
+  for (int hand = 0; hand < DDS_HANDS; ++hand) {
+    for (int suit = 0; suit < kNumSuits; ++suit) {
+      for (int rank = 0; rank < kNumCardsPerSuit; ++rank) {
+        if (deal.cards[hand][suit] & (1 << (2 + rank))) {
+          const int card = suit * kNumCardsPerSuit + rank;
+          key[card / 4] |= hand << (2 * (card % 4));
+          ++num_cards;
+        }
+      }
+    }
+  }
+  SPIEL_CHECK_EQ(num_cards, kNumCards);
+  return key;
+}
+
+std::vector<ddTableResults> SolveDeals(const std::vector<ddTableDeal>& deals) {
+  InitSolver();
+  std::vector<ddTableResults> results(deals.size());
+  // These are sized for the largest batch, too big for the stack.
+  auto batch = std::make_unique<ddTableDeals>();
+  auto batch_results = std::make_unique<ddTablesRes>();
+  auto par_results = std::make_unique<allParResults>();
+  int trump_filter[DDS_STRAINS] = {0, 0, 0, 0, 0};  // Solve every strain.
+  for (int begin = 0; begin < deals.size(); begin += MAXNOOFTABLES) {
+    const int end = std::min<int>(begin + MAXNOOFTABLES, deals.size());
+    batch->noOfTables = end - begin;
+    std::copy(deals.begin() + begin, deals.begin() + end, batch->deals);
+    CheckReturnCode(DDS_EXTERNAL(CalcAllTables)(
+        batch.get(), /*mode=*/-1, trump_filter, batch_results.get(),
+        par_results.get()));
+    std::copy(batch_results->results, batch_results->results + (end - begin),
+              results.begin() + begin);
+  }
+  return results;
+}
+
+DoubleDummyCache::DoubleDummyCache(const std::string& path) {
+  const std::string contents = file::File(path, "rb").ReadContents();
+  if (contents.size() % kRecordSize != 0) {
+    SpielFatalError(absl::StrCat("Not a double dummy cache: ", path));
+  }
+  absl::MutexLock lock(&mutex_);
+  tricks_.reserve(contents.size() / kRecordSize);
+  for (int i = 0; i < contents.size(); i += kRecordSize) {
+    DealKey key;
+    Tricks tricks;
+    std::copy_n(contents.begin() + i, key.size(), key.begin());
+    std::copy_n(contents.begin() + i + key.size(), tricks.size(),
+                tricks.begin());
+    tricks_[key] = tricks;
+  }
+}
+
+std::vector<ddTableResults> DoubleDummyCache::Solve(
+    const std::vector<ddTableDeal>& deals) {
+  std::vector<ddTableResults> results(deals.size());
+  std::vector<DealKey> keys;
+  keys.reserve(deals.size());
+  for (const ddTableDeal& deal : deals) keys.push_back(KeyOfDeal(deal));
+
+  std::vector<int> missing;
+  {
+    absl::MutexLock lock(&mutex_);
+    for (int i = 0; i < deals.size(); ++i) {
+      auto it = tricks_.find(keys[i]);
+      if (it == tricks_.end()) {
+        missing.push_back(i);
+        continue;
+      }
+      for (int strain = 0; strain < DDS_STRAINS; ++strain) {
+        for (int hand = 0; hand < DDS_HANDS; ++hand) {
+          results[i].resTable[strain][hand] =
+              it->second[strain * DDS_HANDS + hand];
+        }
+      }
+    }
+  }
+  if (missing.empty()) return results;
+
+  // Solve without holding the lock, so other threads can still look up.
+  std::vector<ddTableDeal> missing_deals;
+  missing_deals.reserve(missing.size());
+  for (int i : missing) missing_deals.push_back(deals[i]);
+  std::vector<ddTableResults> solved = SolveDeals(missing_deals);
+
+  absl::MutexLock lock(&mutex_);
+  for (int m = 0; m < missing.size(); ++m) {
+    results[missing[m]] = solved[m];
+    Tricks& tricks = tricks_[keys[missing[m]]];
+    for (int strain = 0; strain < DDS_STRAINS; ++strain) {
+      for (int hand = 0; hand < DDS_HANDS; ++hand) {
+        tricks[strain * DDS_HANDS + hand] = solved[m].resTable[strain][hand];
+      }
+    }
+  }
+  return results;
+}
+
+void DoubleDummyCache::Save(const std::string& path) const {
+  std::string contents;
+  {
+    absl::MutexLock lock(&mutex_);
+    contents.reserve(tricks_.size() * kRecordSize);
+    for (const auto& [key, tricks] : tricks_) {
+      contents.append(key.begin(), key.end());
+      contents.append(tricks.begin(), tricks.end());
+    }
+  }
+  file::File(path, "wb").Write(contents);
+}
+
+int DoubleDummyCache::Size() const {
+  absl::MutexLock lock(&mutex_);
+  return tricks_.size();
+}
+
+}  // namespace bridge
+}  // namespace open_spiel
@@ -0,0 +1,76 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_GAMES_BRIDGE_DOUBLE_DUMMY_CACHE_H_
+#define OPEN_SPIEL_GAMES_BRIDGE_DOUBLE_DUMMY_CACHE_H_
+
+// Double dummy results for whole deals, solved in batches and cached.
+//
+// Solving a deal for every strain and declarer takes a good fraction of a
+// second, which dominates generating bidding data. SolveDeals passes the deals
+// to the solver's CalcAllTables in batches, which it spreads over its threads,
+// rather than one at a time. A DoubleDummyCache keeps the results by deal, and
+// can be saved to and loaded from a file, so that the bridge games can be
+// pointed at results computed ahead of time with their `double_dummy_cache`
+// parameter.
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/base/thread_annotations.h"
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+#include "open_spiel/games/bridge/double_dummy_solver/include/dll.h"
+
+namespace open_spiel {
+namespace bridge {
+
+// A deal of all 52 cards, as the hand (0-3) holding each card, packed four
+// cards to a byte in the order of suit then rank.
+using DealKey = std::array<uint8_t, 13>;
+DealKey KeyOfDeal(const ddTableDeal& deal);
+
+// The results for each deal, as CalcDDtable would give them.
+std::vector<ddTableResults> SolveDeals(const std::vector<ddTableDeal>& deals);
+
+// Thread-safe, so one cache can be shared by all the states of a game.
+class DoubleDummyCache {
+ public:
+  DoubleDummyCache() = default;
+  // Loads the results saved in the file at `path`.
+  explicit DoubleDummyCache(const std::string& path);
+
+  // As SolveDeals, but only solving the deals that aren't in the cache, and
+  // adding those.
+  std::vector<ddTableResults> Solve(const std::vector<ddTableDeal>& deals);
+
+  // Overwrites the file at `path` with all the results in the cache.
+  void Save(const std::string& path) const;
+
+  int Size() const;
+
+ private:
+  // The number of tricks for each strain, then each declarer.
+  using Tricks = std::array<uint8_t, DDS_STRAINS * DDS_HANDS>;
+
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<DealKey, Tricks> tricks_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace bridge
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_BRIDGE_DOUBLE_DUMMY_CACHE_H_
@@ -12,10 +12,21 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/games/bridge.h"
 #include "open_spiel/games/bridge/bridge_scoring.h"
+#include "open_spiel/games/bridge/double_dummy_cache.h"
 #include "open_spiel/games/bridge_uncontested_bidding.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/tests/basic_tests.h"
+#include "open_spiel/utils/file.h"
 
 namespace open_spiel {
 namespace bridge {
@@ -41,6 +52,89 @@ void DeserializeStateTest() {
   SPIEL_CHECK_EQ(state->ToString(), "AKQJ.543.QJ8.T92 97532.A2.9.QJ853 ");
 }
 
+// The cards in the order they're dealt, one to each player in turn.
+std::vector<Action> RandomDealActions(std::mt19937* rng) {
+  std::vector<Action> cards(kNumCards);
+  std::iota(cards.begin(), cards.end(), 0);
+  std::shuffle(cards.begin(), cards.end(), *rng);
+  return cards;
+}
+
+ddTableDeal TableDeal(const std::vector<Action>& cards) {
+  ddTableDeal deal{};
+  for (int i = 0; i < kNumCards; ++i) {
+    deal.cards[i % kNumPlayers][cards[i] % kNumSuits] +=
+        1 << (2 + cards[i] / kNumSuits);
+  }
+  return deal;
+}
+
+void CheckSameResults(const std::vector<ddTableResults>& results,
+                      const std::vector<ddTableResults>& expected) {
+  SPIEL_CHECK_EQ(results.size(), expected.size());
+  for (int i = 0; i < results.size(); ++i) {
+    for (int strain = 0; strain < DDS_STRAINS; ++strain) {
+      for (int hand = 0; hand < DDS_HANDS; ++hand) {
+        SPIEL_CHECK_EQ(results[i].resTable[strain][hand],
+                       expected[i].resTable[strain][hand]);
+      }
+    }
+  }
+}
+
+void DoubleDummyCacheTest() {
+  std::mt19937 rng(7);
+  std::vector<std::vector<Action>> deal_actions;
+  std::vector<ddTableDeal> deals;
+  for (int i = 0; i < 3; ++i) {
+    deal_actions.push_back(RandomDealActions(&rng));
+    deals.push_back(TableDeal(deal_actions.back()));
+  }
+  SPIEL_CHECK_TRUE(KeyOfDeal(deals[0]) != KeyOfDeal(deals[1]));
+  const std::vector<ddTableResults> expected = SolveDeals(deals);
+
+  std::string path = absl::StrCat(file::GetTmpDir(), "/open_spiel-test-",
+                                  std::rand(), ".dd");
+  {
+    DoubleDummyCache cache;
+    CheckSameResults(cache.Solve(deals), expected);
+    SPIEL_CHECK_EQ(cache.Size(), 3);
+    CheckSameResults(cache.Solve({deals[1]}), {expected[1]});
+    SPIEL_CHECK_EQ(cache.Size(), 3);
+    cache.Save(path);
+  }
+  {
+    DoubleDummyCache cache(path);
+    SPIEL_CHECK_EQ(cache.Size(), 3);
+    CheckSameResults(cache.Solve({deals[2], deals[0]}),
+                     {expected[2], expected[0]});
+  }
+
+  // The games give the same results with the cache as without.
+  std::shared_ptr<const Game> game = LoadGame("bridge");
+  std::shared_ptr<const Game> cached_game =
+      LoadGame("bridge", {{"double_dummy_cache", GameParameter(path)}});
+  for (const std::vector<Action>& cards : deal_actions) {
+    std::unique_ptr<State> state = game->NewInitialState();
+    std::unique_ptr<State> cached_state = cached_game->NewInitialState();
+    for (Action action : cards) {
+      state->ApplyAction(action);
+      cached_state->ApplyAction(action);
+    }
+    for (const char* call : {"3N", "Pass", "Pass", "Pass"}) {
+      state->ApplyAction(state->StringToAction(call));
+      cached_state->ApplyAction(cached_state->StringToAction(call));
+    }
+    SPIEL_CHECK_TRUE(cached_state->IsTerminal());
+    SPIEL_CHECK_EQ(cached_state->Returns(), state->Returns());
+  }
+  testing::RandomSimTest(
+      *LoadGame("bridge_uncontested_bidding",
+                {{"double_dummy_cache", GameParameter(path)}}),
+      2);
+  file::Remove(path);
+}
+
 }  // namespace
 }  // namespace bridge
 }  // namespace open_spiel
@@ -49,4 +143,5 @@ int main(int argc, char** argv) {
   open_spiel::bridge::DeserializeStateTest();
   open_spiel::bridge::ScoringTests();
   open_spiel::bridge::BasicGameTests();
+  open_spiel::bridge::DoubleDummyCacheTest();
 }
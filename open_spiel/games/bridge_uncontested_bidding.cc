@@ -20,15 +20,10 @@
 #include "open_spiel/games/bridge/double_dummy_solver/include/dll.h"
 #include "open_spiel/game_parameters.h"
 #include "open_spiel/games/bridge/bridge_scoring.h"
+#include "open_spiel/games/bridge/double_dummy_cache.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
 
-// For compatibility with versions of the double dummy solver code which
-// don't amend exported names.
-#ifndef DDS_EXTERNAL
-#define DDS_EXTERNAL(x) x
-#endif
-
 namespace open_spiel {
 namespace bridge_uncontested_bidding {
 namespace {
@@ -62,6 +57,7 @@ const GameType kGameType{
         {"subgame", GameParameter(static_cast<std::string>(""))},
         {"rng_seed", GameParameter(0)},
         {"relative_scoring", GameParameter(false)},
+        {"double_dummy_cache", GameParameter(static_cast<std::string>(""))},
     }};
 
 std::shared_ptr<const Game> Factory(const GameParameters& params) {
@@ -261,38 +257,30 @@ void UncontestedBiddingState::ScoreDeal() {
     }
   }
 
-  // Initialize scores to zero
-  score_ = 0;
-  reference_scores_.resize(reference_contracts_.size());
-  std::fill(reference_scores_.begin(), reference_scores_.end(), 0);
-
-  // For each redeal
+  // Lay out the North-South cards for each redeal.
+  std::vector<ddTableDeal> dd_table_deals(kNumRedeals, dd_table_deal);
   for (int ideal = 0; ideal < kNumRedeals; ++ideal) {
     if (ideal > 0) deal_.Shuffle(&rng_, kNumCardsPerHand * 2, kNumCards);
-
-    // Populate (reshuffled) North-South cards
     for (int opponent = 0; opponent < kNumPlayers; ++opponent) {
-      std::fill(dd_table_deal.cards[1 + opponent * 2],
-                dd_table_deal.cards[1 + opponent * 2] + 4, 0);
       for (int i = kNumCardsPerHand * (2 + opponent);
            i < kNumCardsPerHand * (3 + opponent); ++i) {
-        dd_table_deal.cards[1 + opponent * 2][deal_.Suit(i)] +=
+        dd_table_deals[ideal].cards[1 + opponent * 2][deal_.Suit(i)] +=
             1 << (2 + deal_.Rank(i));
       }
     }
+  }
 
-    // Analyze the deal.
-    DDS_EXTERNAL(SetMaxThreads)(0);
-    struct ddTableResults results;
-    const int return_code = DDS_EXTERNAL(CalcDDtable)(dd_table_deal, &results);
+  // Analyze the deals together.
+  const std::vector<ddTableResults> all_results =
+      static_cast<const UncontestedBiddingGame&>(*game_).DoubleDummyResults(
+          dd_table_deals);
 
-    // Check for errors.
-    if (return_code != RETURN_NO_FAULT) {
-      char error_message[80];
-      DDS_EXTERNAL(ErrorMessage)(return_code, error_message);
-      SpielFatalError(absl::StrCat("double_dummy_solver:", error_message));
-    }
+  // Initialize scores to zero
+  score_ = 0;
+  reference_scores_.resize(reference_contracts_.size());
+  std::fill(reference_scores_.begin(), reference_scores_.end(), 0);
 
+  for (const ddTableResults& results : all_results) {
     // Compute the score and update the total.
     if (!passed_out) {
       const int declarer_tricks =
@@ -336,6 +324,10 @@ UncontestedBiddingGame::UncontestedBiddingGame(const GameParameters& params)
       forced_actions_{},
       deal_filter_{NoFilter},
       rng_seed_(ParameterValue<int>("rng_seed")) {
+  const std::string path = ParameterValue<std::string>("double_dummy_cache");
+  if (!path.empty()) {
+    double_dummy_cache_ = std::make_shared<bridge::DoubleDummyCache>(path);
+  }
   std::string subgame = ParameterValue<std::string>("subgame");
   if (subgame == "2NT") {
     deal_filter_ = Is2NTDeal;
@@ -390,6 +382,12 @@ UncontestedBiddingGame::UncontestedBiddingGame(const GameParameters& params)
   }
 }
 
+std::vector<ddTableResults> UncontestedBiddingGame::DoubleDummyResults(
+    const std::vector<ddTableDeal>& deals) const {
+  if (double_dummy_cache_) return double_dummy_cache_->Solve(deals);
+  return bridge::SolveDeals(deals);
+}
+
 // Deserialize the deal and auction
 // e.g. "AKQJ.543.QJ8.T92 97532.A2.9.QJ853 2N-3C"
 std::unique_ptr<State> UncontestedBiddingGame::DeserializeState(
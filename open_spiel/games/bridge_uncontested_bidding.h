@@ -91,8 +91,15 @@
 // for player 1 will be the score relative to the best-scoring of the possible
 // contracts (so 0 if the contract reached is the best-scoring contract,
 // otherwise negative).
+//
+// The parameter `double_dummy_cache` may name a file of double dummy results
+// saved by a bridge::DoubleDummyCache, which are used instead of solving those
+// layouts again.
+
+#include <memory>
 
 #include "open_spiel/games/bridge/bridge_scoring.h"
+#include "open_spiel/games/bridge/double_dummy_cache.h"
 #include "open_spiel/spiel.h"
 
 namespace open_spiel {
@@ -225,12 +232,18 @@ class UncontestedBiddingGame : public Game {
   int MaxGameLength() const override { return kNumActions; }
   std::unique_ptr<State> DeserializeState(
       const std::string& str) const override;
+  // The solver's results for the deals, from the `double_dummy_cache` if
+  // there is one.
+  std::vector<ddTableResults> DoubleDummyResults(
+      const std::vector<ddTableDeal>& deals) const;
 
  private:
   std::vector<Contract> reference_contracts_;
   std::vector<Action> forced_actions_;
   std::function<bool(const Deal&)> deal_filter_;
   mutable int rng_seed_;
+  // Shared by the clones of the game.
+  std::shared_ptr<bridge::DoubleDummyCache> double_dummy_cache_;
 };
 
 }  // namespace bridge_uncontested_bidding
@@ -0,0 +1,215 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/chess/bitboard.h"
+
+#include <array>
+#include <vector>
+
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace chess {
+namespace bitboard_internal {
+namespace {
+
+using Step = std::array<int, 2>;
+
+constexpr std::array<Step, 4> kRookSteps = {
+    {{1, 0}, {-1, 0}, {0, 1}, {0, -1}}};
+constexpr std::array<Step, 4> kBishopSteps = {
+    {{1, 1}, {-1, 1}, {1, -1}, {-1, -1}}};
+constexpr std::array<Step, 8> kKingSteps = {
+    {{1, 0}, {1, 1}, {1, -1}, {0, 1}, {0, -1}, {-1, 1}, {-1, 0}, {-1, -1}}};
+constexpr std::array<Step, 8> kKnightSteps = {
+    {{-2, -1}, {-2, 1}, {-1, -2}, {-1, 2}, {2, -1}, {2, 1}, {1, -2}, {1, 2}}};
+
+// A xorshift generator, seeded per rank with seeds known to find magics for
+// every square within a few thousand tries.
+class MagicGenerator {
+ public:
+  explicit MagicGenerator(int rank) : state_(kSeeds[rank]) {}
+
+  // Magics with few bits set work best.
+  Bitboard Next() { return NextRandom() & NextRandom() & NextRandom(); }
+
+ private:
+  static constexpr std::array<uint64_t, 8> kSeeds = {
+      {728, 10316, 55013, 32803, 12281, 15100, 16645, 255}};
+
+  uint64_t NextRandom() {
+    state_ ^= state_ >> 12;
+    state_ ^= state_ << 25;
+    state_ ^= state_ >> 27;
+    return state_ * 2685821657736338717ull;
+  }
+
+  uint64_t state_;
+};
+
+bool OnBoard(int x, int y) { return x >= 0 && x < 8 && y >= 0 && y < 8; }
+
+template <std::size_t N>
+Bitboard StepAttacks(int index, const std::array<Step, N>& steps) {
+  Bitboard attacks = 0;
+  for (const Step& step : steps) {
+    int x = index % 8 + step[0];
+    int y = index / 8 + step[1];
+    if (OnBoard(x, y)) attacks |= SquareBit(y * 8 + x);
+  }
+  return attacks;
+}
+
+// Squares reached along the rays, up to and including the first occupied
+// square. This is the slow reference the lookup tables are filled from.
+template <std::size_t N>
+Bitboard RayAttacks(int index, const std::array<Step, N>& steps,
+                    Bitboard occupied) {
+  Bitboard attacks = 0;
+  for (const Step& step : steps) {
+    int x = index % 8 + step[0];
+    int y = index / 8 + step[1];
+    for (; OnBoard(x, y); x += step[0], y += step[1]) {
+      attacks |= SquareBit(y * 8 + x);
+      if (occupied & SquareBit(y * 8 + x)) break;
+    }
+  }
+  return attacks;
+}
+
+// The squares along the rays that can block, ie all but the last one.
+Bitboard BlockerMask(int index, const std::array<Step, 4>& steps) {
+  Bitboard mask = 0;
+  for (const Step& step : steps) {
+    int x = index % 8 + step[0];
+    int y = index / 8 + step[1];
+    for (; OnBoard(x + step[0], y + step[1]); x += step[0], y += step[1]) {
+      mask |= SquareBit(y * 8 + x);
+    }
+  }
+  return mask;
+}
+
+// Fills in the tables for one kind of slider, appending their attack sets to
+// `attacks`. The magics are searched for from fixed seeds, so the tables are
+// the same on every run.
+void InitSliders(const std::array<Step, 4>& steps, SliderTable* tables,
+                 std::vector<Bitboard>* attacks) {
+  std::vector<int> offsets(64);
+  for (int index = 0; index < 64; ++index) {
+    tables[index].mask = BlockerMask(index, steps);
+    offsets[index] = attacks->size();
+    attacks->resize(attacks->size() + (1 << CountSquares(tables[index].mask)));
+  }
+
+  std::vector<Bitboard> occupancies;
+  std::vector<Bitboard> reference;
+  std::vector<int> filled_in;
+  for (int index = 0; index < 64; ++index) {
+    SliderTable& table = tables[index];
+    int bits = CountSquares(table.mask);
+    table.shift = 64 - bits;
+    table.magic = 0;
+    Bitboard* out = attacks->data() + offsets[index];
+
+    // Enumerate all subsets of the mask.
+    occupancies.clear();
+    reference.clear();
+    Bitboard subset = 0;
+    do {
+      occupancies.push_back(subset);
+      reference.push_back(RayAttacks(index, steps, subset));
+      subset = (subset - table.mask) & table.mask;
+    } while (subset != 0);
+
+#if defined(__BMI2__)
+    for (int i = 0; i < occupancies.size(); ++i) {
+      out[SliderIndex(table, occupancies[i])] = reference[i];
+    }
+#else
+    // Try sparse random multipliers until one maps every subset to a slot
+    // that is either its own or shared with a subset with the same attacks.
+    MagicGenerator generator(index / 8);
+    filled_in.assign(occupancies.size(), 0);
+    for (int attempt = 1;; ++attempt) {
+      do {
+        table.magic = generator.Next();
+      } while (CountSquares((table.mask * table.magic) >> 56) < 6);
+      bool ok = true;
+      for (int i = 0; i < occupancies.size() && ok; ++i) {
+        int slot = SliderIndex(table, occupancies[i]);
+        if (filled_in[slot] < attempt) {
+          filled_in[slot] = attempt;
+          out[slot] = reference[i];
+        } else {
+          ok = out[slot] == reference[i];
+        }
+      }
+      if (ok) break;
+    }
+#endif
+  }
+
+  for (int index = 0; index < 64; ++index) {
+    tables[index].attacks = attacks->data() + offsets[index];
+  }
+}
+
+const AttackTables* BuildTables() {
+  auto* tables = new AttackTables();
+  for (int index = 0; index < 64; ++index) {
+    tables->knight[index] = StepAttacks(index, kKnightSteps);
+    tables->king[index] = StepAttacks(index, kKingSteps);
+    tables->pawn[0][index] =
+        StepAttacks(index, std::array<Step, 2>{{{-1, -1}, {1, -1}}});
+    tables->pawn[1][index] =
+        StepAttacks(index, std::array<Step, 2>{{{-1, 1}, {1, 1}}});
+  }
+
+  for (int from = 0; from < 64; ++from) {
+    for (const Step& step : kKingSteps) {
+      Step back = {-step[0], -step[1]};
+      Bitboard line =
+          SquareBit(from) | RayAttacks(from, std::array<Step, 1>{step}, 0) |
+          RayAttacks(from, std::array<Step, 1>{back}, 0);
+      Bitboard between = 0;
+      int x = from % 8 + step[0];
+      int y = from / 8 + step[1];
+      for (; OnBoard(x, y); x += step[0], y += step[1]) {
+        int to = y * 8 + x;
+        tables->between[from][to] = between;
+        tables->line[from][to] = line;
+        between |= SquareBit(to);
+      }
+    }
+  }
+
+  // Reserve up front, so the pointers into it stay valid.
+  tables->slider_attacks.reserve(102400 + 5248);
+  InitSliders(kRookSteps, tables->rook, &tables->slider_attacks);
+  InitSliders(kBishopSteps, tables->bishop, &tables->slider_attacks);
+  SPIEL_CHECK_EQ(tables->slider_attacks.size(), 102400 + 5248);
+  return tables;
+}
+
+}  // namespace
+
+const AttackTables& Tables() {
+  static const AttackTables* tables = BuildTables();
+  return *tables;
+}
+
+}  // namespace bitboard_internal
+}  // namespace chess
+}  // namespace open_spiel
@@ -0,0 +1,131 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_GAMES_IMPL_CHESS_BITBOARD_H_
+#define OPEN_SPIEL_GAMES_IMPL_CHESS_BITBOARD_H_
+
+#include <cstdint>
+#include <vector>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+#include "open_spiel/abseil-cpp/absl/numeric/bits.h"
+
+// Attack tables for move generation on an 8x8 board represented as 64-bit
+// sets of squares. Bit y * 8 + x stands for the square at file x and rank y,
+// the same index ChessBoard uses for its mailbox, so visiting the set bits
+// from lowest to highest visits squares in the mailbox order.
+//
+// Sliding piece attacks are looked up by the occupancy of the squares that
+// can block them, which is hashed with "magic" multipliers, or extracted with
+// PEXT when compiled for BMI2.
+
+namespace open_spiel {
+namespace chess {
+
+using Bitboard = uint64_t;
+
+inline constexpr Bitboard SquareBit(int index) { return Bitboard{1} << index; }
+
+inline int LowestSquare(Bitboard b) { return absl::countr_zero(b); }
+
+// Removes and returns the lowest square. `b` must not be empty.
+inline int PopLowestSquare(Bitboard* b) {
+  int index = absl::countr_zero(*b);
+  *b &= *b - 1;
+  return index;
+}
+
+inline int CountSquares(Bitboard b) { return absl::popcount(b); }
+
+inline bool MoreThanOne(Bitboard b) { return (b & (b - 1)) != 0; }
+
+namespace bitboard_internal {
+
+struct SliderTable {
+  Bitboard mask;  // Squares that can block, excluding the board edge.
+  Bitboard magic;
+  int shift;
+  const Bitboard* attacks;  // Indexed by SliderIndex.
+};
+
+struct AttackTables {
+  Bitboard knight[64];
+  Bitboard king[64];
+  Bitboard pawn[2][64];  // Indexed by ToInt(Color), so black first.
+  Bitboard between[64][64];
+  Bitboard line[64][64];
+  SliderTable rook[64];
+  SliderTable bishop[64];
+  std::vector<Bitboard> slider_attacks;
+};
+
+// Built on first use.
+const AttackTables& Tables();
+
+inline int SliderIndex(const SliderTable& table, Bitboard occupied) {
+#if defined(__BMI2__)
+  return _pext_u64(occupied, table.mask);
+#else
+  return ((occupied & table.mask) * table.magic) >> table.shift;
+#endif
+}
+
+}  // namespace bitboard_internal
+
+inline Bitboard KnightAttacks(int index) {
+  return bitboard_internal::Tables().knight[index];
+}
+
+inline Bitboard KingAttacks(int index) {
+  return bitboard_internal::Tables().king[index];
+}
+
+// Squares a pawn of the given color (ToInt(Color)) attacks from `index`.
+inline Bitboard PawnAttacks(int color, int index) {
+  return bitboard_internal::Tables().pawn[color][index];
+}
+
+inline Bitboard RookAttacks(int index, Bitboard occupied) {
+  const auto& table = bitboard_internal::Tables().rook[index];
+  return table.attacks[bitboard_internal::SliderIndex(table, occupied)];
+}
+
+inline Bitboard BishopAttacks(int index, Bitboard occupied) {
+  const auto& table = bitboard_internal::Tables().bishop[index];
+  return table.attacks[bitboard_internal::SliderIndex(table, occupied)];
+}
+
+inline Bitboard QueenAttacks(int index, Bitboard occupied) {
+  return RookAttacks(index, occupied) | BishopAttacks(index, occupied);
+}
+
+// Squares strictly between two squares on a rank, file or diagonal, or none
+// if they aren't aligned.
+inline Bitboard Between(int from, int to) {
+  return bitboard_internal::Tables().between[from][to];
+}
+
+// The whole rank, file or diagonal through both squares, or none if they
+// aren't aligned.
+inline Bitboard Line(int from, int to) {
+  return bitboard_internal::Tables().line[from][to];
+}
+
+}  // namespace chess
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_IMPL_CHESS_BITBOARD_H_
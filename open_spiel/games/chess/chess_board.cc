@@ -20,10 +20,18 @@
 #include <utility>
 #include <vector>
 
+#include "open_spiel/games/chess/bitboard.h"
 #include "open_spiel/spiel_utils.h"
 
 namespace open_spiel {
 namespace chess {
+namespace {
+
+Square BitboardSquare(int index) {
+  return Square{static_cast<int8_t>(index % 8), static_cast<int8_t>(index / 8)};
+}
+
+}  // namespace
 
 bool IsMoveCharacter(char c) {
   return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
@@ -314,7 +322,9 @@ std::string Move::ToSAN(const StandardChessBoard &board) const {
 
 template <uint32_t kBoardSize>
 ChessBoard<kBoardSize>::ChessBoard()
-    : to_play_(Color::kWhite),
+    : color_bitboards_{},
+      type_bitboards_{},
+      to_play_(Color::kWhite),
       ep_square_(InvalidSquare()),
       irreversible_move_counter_(0),
       move_number_(1),
@@ -439,6 +449,15 @@ ChessBoard<kBoardSize>::BoardFromFEN(const std::string &fen) {
 
 template <uint32_t kBoardSize>
 Square ChessBoard<kBoardSize>::find(const Piece &piece) const {
+#ifndef OPEN_SPIEL_CHESS_MAILBOX_MOVEGEN
+  if constexpr (kBoardSize == 8) {
+    if (piece.type != PieceType::kEmpty && piece.color != Color::kEmpty) {
+      Bitboard pieces = PiecesBitboard_(piece.color, piece.type);
+      if (pieces == 0) return InvalidSquare();
+      return BitboardSquare(LowestSquare(pieces));
+    }
+  }
+#endif
   for (int8_t y = 0; y < kBoardSize; ++y) {
     for (int8_t x = 0; x < kBoardSize; ++x) {
       Square sq{x, y};
@@ -454,6 +473,10 @@ Square ChessBoard<kBoardSize>::find(const Piece &piece) const {
 template <uint32_t kBoardSize>
 void ChessBoard<kBoardSize>::GenerateLegalMoves(
     const MoveYieldFn &yield) const {
+#ifndef OPEN_SPIEL_CHESS_MAILBOX_MOVEGEN
+  if (GenerateLegalMovesBitboard_(yield)) return;
+#endif
+
   auto king_square = find(Piece{to_play_, PieceType::kKing});
 
   GeneratePseudoLegalMoves([this, &king_square, &yield](const Move &move) {
@@ -473,6 +496,163 @@ void ChessBoard<kBoardSize>::GenerateLegalMoves(
   });
 }
 
+template <uint32_t kBoardSize>
+bool ChessBoard<kBoardSize>::GenerateLegalMovesBitboard_(
+    const MoveYieldFn &yield) const {
+  if constexpr (kBoardSize != 8) return false;
+
+  const auto type_bitboard = [this](PieceType type) {
+    return type_bitboards_[static_cast<int>(type)];
+  };
+  const int us = ToInt(to_play_);
+  const Color opponent = OppColor(to_play_);
+  const Bitboard ours = color_bitboards_[us];
+  const Bitboard theirs = color_bitboards_[ToInt(opponent)];
+  const Bitboard occupied = ours | theirs;
+  const Bitboard kings = PiecesBitboard_(to_play_, PieceType::kKing);
+  if (kings == 0 || MoreThanOne(kings)) return false;
+  const int king = LowestSquare(kings);
+  const Bitboard checkers = AttackersBitboard_(king, occupied, opponent);
+
+  // A piece is pinned if it's the only one between our king and an opponent
+  // slider. It can still move along the line between them.
+  const Bitboard queens = type_bitboard(PieceType::kQueen);
+  const Bitboard rooks = type_bitboard(PieceType::kRook) | queens;
+  const Bitboard bishops = type_bitboard(PieceType::kBishop) | queens;
+  Bitboard snipers =
+      ((RookAttacks(king, 0) & rooks) | (BishopAttacks(king, 0) & bishops)) &
+      theirs;
+  Bitboard pinned = 0;
+  while (snipers != 0) {
+    Bitboard blockers = Between(king, PopLowestSquare(&snipers)) & occupied;
+    if (blockers != 0 && !MoreThanOne(blockers)) pinned |= blockers & ours;
+  }
+
+  // In check, other pieces must capture the checking piece or block it. In
+  // double check only the king can move.
+  Bitboard evasions = ~Bitboard{0};
+  if (checkers != 0) {
+    evasions = MoreThanOne(checkers)
+                   ? 0
+                   : Between(king, LowestSquare(checkers)) | checkers;
+  }
+
+  bool generating = true;
+  const int forward = to_play_ == Color::kWhite ? 8 : -8;
+  Bitboard movers = ours;
+  while (movers != 0 && generating) {
+    const int from = PopLowestSquare(&movers);
+    const Square from_sq = BitboardSquare(from);
+    const Piece &piece = board_[from];
+    Bitboard targets = 0;
+    switch (piece.type) {
+      case PieceType::kKing: {
+        // The king itself mustn't block attacks on the squares it moves to.
+        const Bitboard without_king = occupied ^ SquareBit(from);
+        targets = KingAttacks(from) & ~ours;
+        while (targets != 0 && generating) {
+          const int to = PopLowestSquare(&targets);
+          if (AttackersBitboard_(to, without_king, opponent) == 0) {
+            generating = yield(Move(from_sq, BitboardSquare(to), piece));
+          }
+        }
+        // Castling is rare enough to check the way the mailbox does.
+        if (checkers == 0 && generating) {
+          GenerateCastlingDestinations_(
+              from_sq, to_play_, [&](const Square &to) {
+                Move move(from_sq, to, piece, PieceType::kEmpty, true);
+                auto board_copy = *this;
+                board_copy.ApplyMove(move);
+                if (generating && !board_copy.UnderAttack(to, to_play_)) {
+                  generating = yield(move);
+                }
+              });
+        }
+        continue;
+      }
+      case PieceType::kQueen:
+        targets = QueenAttacks(from, occupied);
+        break;
+      case PieceType::kRook:
+        targets = RookAttacks(from, occupied);
+        break;
+      case PieceType::kBishop:
+        targets = BishopAttacks(from, occupied);
+        break;
+      case PieceType::kKnight:
+        targets = KnightAttacks(from);
+        break;
+      case PieceType::kPawn: {
+        targets = PawnAttacks(us, from) & theirs;
+        const int one = from + forward;
+        if (one >= 0 && one < 64 && (occupied & SquareBit(one)) == 0) {
+          targets |= SquareBit(one);
+          if (IsPawnStartingRank(from_sq, to_play_) &&
+              (occupied & SquareBit(one + forward)) == 0) {
+            targets |= SquareBit(one + forward);
+          }
+        }
+
+        // En passant removes two pieces from the capturing pawn's line, so
+        // rather than reasoning about pins, look for attacks on the king in
+        // the resulting position.
+        if (ep_square_ != InvalidSquare()) {
+          const int ep = SquareToIndex_(ep_square_);
+          const int captured = ep - forward;
+          if ((PawnAttacks(us, from) & ~occupied & SquareBit(ep)) != 0) {
+            const Bitboard after =
+                (occupied ^ SquareBit(from) ^ SquareBit(captured)) |
+                SquareBit(ep);
+            if ((AttackersBitboard_(king, after, opponent) &
+                 ~SquareBit(captured)) == 0) {
+              generating = yield(Move(from_sq, ep_square_, piece));
+            }
+          }
+        }
+        break;
+      }
+      default:
+        std::cerr << "Unknown piece type: " << static_cast<int>(piece.type)
+                  << std::endl;
+    }
+
+    targets &= ~ours & evasions;
+    if ((pinned & SquareBit(from)) != 0) targets &= Line(king, from);
+    while (targets != 0 && generating) {
+      const Square to = BitboardSquare(PopLowestSquare(&targets));
+      if (piece.type == PieceType::kPawn && IsPawnPromotionRank(to)) {
+        generating = yield(Move(from_sq, to, piece, PieceType::kQueen)) &&
+                     yield(Move(from_sq, to, piece, PieceType::kRook)) &&
+                     yield(Move(from_sq, to, piece, PieceType::kBishop)) &&
+                     yield(Move(from_sq, to, piece, PieceType::kKnight));
+      } else {
+        generating = yield(Move(from_sq, to, piece));
+      }
+    }
+  }
+  return true;
+}
+
+template <uint32_t kBoardSize>
+uint64_t ChessBoard<kBoardSize>::AttackersBitboard_(
+    int index, uint64_t occupied, Color attacker_color) const {
+  const auto type_bitboard = [this](PieceType type) {
+    return type_bitboards_[static_cast<int>(type)];
+  };
+  const Bitboard queens = type_bitboard(PieceType::kQueen);
+  // A pawn of ours on the square would attack the opponent pawns that attack
+  // the square.
+  return ((PawnAttacks(ToInt(OppColor(attacker_color)), index) &
+           type_bitboard(PieceType::kPawn)) |
+          (KnightAttacks(index) & type_bitboard(PieceType::kKnight)) |
+          (KingAttacks(index) & type_bitboard(PieceType::kKing)) |
+          (RookAttacks(index, occupied) &
+           (type_bitboard(PieceType::kRook) | queens)) |
+          (BishopAttacks(index, occupied) &
+           (type_bitboard(PieceType::kBishop) | queens))) &
+         color_bitboards_[ToInt(attacker_color)];
+}
+
 template <uint32_t kBoardSize>
 void ChessBoard<kBoardSize>::GeneratePseudoLegalMoves(
     const MoveYieldFn &yield) const {
@@ -1008,6 +1188,14 @@ bool ChessBoard<kBoardSize>::UnderAttack(const Square &sq,
                                          Color our_color) const {
   SPIEL_CHECK_NE(sq, InvalidSquare());
 
+#ifndef OPEN_SPIEL_CHESS_MAILBOX_MOVEGEN
+  if constexpr (kBoardSize == 8) {
+    return AttackersBitboard_(SquareToIndex_(sq),
+                              color_bitboards_[0] | color_bitboards_[1],
+                              OppColor(our_color)) != 0;
+  }
+#endif
+
   bool under_attack = false;
   Color opponent_color = OppColor(our_color);
 
@@ -1456,6 +1644,18 @@ void ChessBoard<kBoardSize>::set_square(Square sq, Piece piece) {
   zobrist_hash_ ^= kZobristValues[position][static_cast<int>(piece.color)]
                                  [static_cast<int>(piece.type)];
 
+  static_assert(kBoardSize * kBoardSize <= 64,
+                "The bitboards need a bit per square.");
+  const uint64_t bit = uint64_t{1} << position;
+  if (current_piece.type != PieceType::kEmpty) {
+    color_bitboards_[ToInt(current_piece.color)] &= ~bit;
+    type_bitboards_[static_cast<int>(current_piece.type)] &= ~bit;
+  }
+  if (piece.type != PieceType::kEmpty) {
+    color_bitboards_[ToInt(piece.color)] |= bit;
+    type_bitboards_[static_cast<int>(piece.type)] |= bit;
+  }
+
   board_[position] = piece;
 }
 
@@ -1553,5 +1753,22 @@ StandardChessBoard MakeDefaultBoard() {
   return *maybe_board;
 }
 
+uint64_t Perft(const StandardChessBoard &board, int depth) {
+  if (depth == 0) return 1;
+  uint64_t nodes = 0;
+  board.GenerateLegalMoves([&board, &nodes, depth](const Move &move) {
+    // The last move's children needn't be generated, just counted.
+    if (depth == 1) {
+      ++nodes;
+    } else {
+      StandardChessBoard child = board;
+      child.ApplyMove(move);
+      nodes += Perft(child, depth - 1);
+    }
+    return true;
+  });
+  return nodes;
+}
+
 }  // namespace chess
 }  // namespace open_spiel
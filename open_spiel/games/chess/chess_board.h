@@ -256,6 +256,11 @@ class ChessBoard {
 
   // Pseudo-legal moves are moves that may leave the king in check, but are
   // otherwise legal.
+  // Legal moves on the standard board are generated from bitboards, with
+  // pinned pieces and checks masked out up front, unless compiled with
+  // OPEN_SPIEL_CHESS_MAILBOX_MOVEGEN, which filters the pseudo-legal moves by
+  // applying each one instead. Both generate the same set of moves, though
+  // not necessarily in the same order.
   // The generation functions call yield(move) for each move generated.
   // The yield function should return whether generation should continue.
   // For performance reasons, we do not guarantee that no more moves will be
@@ -426,10 +431,26 @@ class ChessBoard {
   void GenerateRayDestinations_(Square sq, Color color, Offset offset_step,
                                 const YieldFn& yield) const;
 
+  // Bitboard versions of the functions above, for the standard board size.
+  // GenerateLegalMovesBitboard_ returns false if the position isn't one it
+  // handles, ie doesn't have exactly one king to move.
+  bool GenerateLegalMovesBitboard_(const MoveYieldFn& yield) const;
+  uint64_t AttackersBitboard_(int index, uint64_t occupied,
+                              Color attacker_color) const;
+  uint64_t PiecesBitboard_(Color color, PieceType type) const {
+    return color_bitboards_[ToInt(color)] &
+           type_bitboards_[static_cast<int>(type)];
+  }
+
   void SetIrreversibleMoveCounter(int c);
   void SetMovenumber(int move_number);
 
   std::array<Piece, kBoardSize * kBoardSize> board_;
+
+  // The squares occupied by each color (indexed by ToInt(color)) and by each
+  // piece type, kept in sync with board_ by set_square.
+  std::array<uint64_t, 2> color_bitboards_;
+  std::array<uint64_t, 7> type_bitboards_;
   Color to_play_;
   Square ep_square_;
   int32_t irreversible_move_counter_;
@@ -458,6 +479,10 @@ inline std::ostream& operator<<(std::ostream& stream, const PieceType& pt) {
 
 StandardChessBoard MakeDefaultBoard();
 
+// Counts the positions reachable in exactly `depth` legal moves, the standard
+// way to check (and time) a move generator against published counts.
+uint64_t Perft(const StandardChessBoard& board, int depth);
+
 }  // namespace chess
 }  // namespace open_spiel
 
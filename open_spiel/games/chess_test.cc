@@ -16,6 +16,8 @@
 
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "open_spiel/games/chess/chess_board.h"
 #include "open_spiel/spiel.h"
@@ -68,6 +70,28 @@ void MoveGenerationTests() {
   SPIEL_CHECK_EQ(CountNumLegalMoves(start_pos), 20);
 }
 
+void PerftTests() {
+  // Node counts from https://www.chessprogramming.org/Perft_Results, for
+  // positions with castling, en passant, promotions and discovered checks.
+  const std::vector<std::pair<std::string, uint64_t>> positions = {
+      {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 8902},
+      {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+       97862},
+      {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 2812},
+      {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+       9467},
+      {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 62379},
+      {"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - "
+       "0 10",
+       89890},
+  };
+  for (const auto& [fen, nodes] : positions) {
+    auto board = StandardChessBoard::BoardFromFEN(fen);
+    SPIEL_CHECK_TRUE(board);
+    SPIEL_CHECK_EQ(Perft(*board, 3), nodes);
+  }
+}
+
 void TerminalReturnTests() {
   std::shared_ptr<const Game> game = LoadGame("chess");
   ChessState checkmate_state(
@@ -248,6 +272,7 @@ void MoveConversionTests() {
 int main(int argc, char** argv) {
   open_spiel::chess::BasicChessTests();
   open_spiel::chess::MoveGenerationTests();
+  open_spiel::chess::PerftTests();
   open_spiel::chess::UndoTests();
   open_spiel::chess::TerminalReturnTests();
   open_spiel::chess::ObservationTensorTests();
@@ -15,9 +15,11 @@
 #include "open_spiel/games/connect_four.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <utility>
 
+#include "open_spiel/abseil-cpp/absl/numeric/bits.h"
 #include "open_spiel/utils/tensor_view.h"
 
 namespace open_spiel {
@@ -48,6 +50,31 @@ std::shared_ptr<const Game> Factory(const GameParameters& params) {
 
 REGISTER_SPIEL_GAME(kGameType, Factory);
 
+// Cell (row, col) is bit col * kBitsPerColumn + row of the bitboards.
+constexpr int kBitsPerColumn = kRows + 1;
+constexpr uint64_t kColumnMask = (uint64_t{1} << kRows) - 1;
+
+constexpr uint64_t CellBit(int row, int col) {
+  return uint64_t{1} << (col * kBitsPerColumn + row);
+}
+
+// The cells of the top row.
+constexpr uint64_t TopRow() {
+  uint64_t top = 0;
+  for (int col = 0; col < kCols; ++col) top |= CellBit(kRows - 1, col);
+  return top;
+}
+
+// Whether there are four in a row vertically, horizontally, or along either
+// diagonal, ie four bits set at the same step apart.
+bool HasFourInARow(uint64_t stones) {
+  for (int step : {1, kBitsPerColumn, kBitsPerColumn - 1, kBitsPerColumn + 1}) {
+    uint64_t pairs = stones & (stones >> step);
+    if (pairs & (pairs >> (2 * step))) return true;
+  }
+  return false;
+}
+
 CellState PlayerToState(Player player) {
   switch (player) {
     case 0:
@@ -74,12 +101,20 @@ std::string StateToString(CellState state) {
 }
 }  // namespace
 
-CellState& ConnectFourState::CellAt(int row, int col) {
-  return board_[row * kCols + col];
+CellState ConnectFourState::CellAt(int row, int col) const {
+  if (stones_[0] & CellBit(row, col)) return PlayerToState(0);
+  if (stones_[1] & CellBit(row, col)) return PlayerToState(1);
+  return CellState::kEmpty;
 }
 
-CellState ConnectFourState::CellAt(int row, int col) const {
-  return board_[row * kCols + col];
+void ConnectFourState::SetCell(int row, int col, CellState state) {
+  for (Player player : {0, 1}) {
+    if (state == PlayerToState(player)) {
+      stones_[player] |= CellBit(row, col);
+    } else {
+      stones_[player] &= ~CellBit(row, col);
+    }
+  }
 }
 
 int ConnectFourState::CurrentPlayer() const {
@@ -92,9 +127,11 @@ int ConnectFourState::CurrentPlayer() const {
 
 void ConnectFourState::DoApplyAction(Action move) {
   SPIEL_CHECK_EQ(CellAt(kRows - 1, move), CellState::kEmpty);
-  int row = 0;
-  while (CellAt(row, move) != CellState::kEmpty) ++row;
-  CellAt(row, move) = PlayerToState(CurrentPlayer());
+  // The stone drops to the lowest empty cell of the column.
+  uint64_t column =
+      ((stones_[0] | stones_[1]) >> (move * kBitsPerColumn)) & kColumnMask;
+  int row = absl::countr_one(column);
+  stones_[current_player_] |= CellBit(row, move);
 
   if (HasLine(current_player_)) {
     outcome_ = static_cast<Outcome>(current_player_);
@@ -109,8 +146,9 @@ std::vector<Action> ConnectFourState::LegalActions() const {
   // Can move in any non-full column.
   std::vector<Action> moves;
   if (IsTerminal()) return moves;
+  uint64_t occupied = stones_[0] | stones_[1];
   for (int col = 0; col < kCols; ++col) {
-    if (CellAt(kRows - 1, col) == CellState::kEmpty) moves.push_back(col);
+    if (!(occupied & CellBit(kRows - 1, col))) moves.push_back(col);
   }
   return moves;
 }
@@ -120,48 +158,16 @@ std::string ConnectFourState::ActionToString(Player player,
   return absl::StrCat(StateToString(PlayerToState(player)), action_id);
 }
 
-bool ConnectFourState::HasLineFrom(Player player, int row, int col) const {
-  return HasLineFromInDirection(player, row, col, 0, 1) ||
-         HasLineFromInDirection(player, row, col, -1, -1) ||
-         HasLineFromInDirection(player, row, col, -1, 0) ||
-         HasLineFromInDirection(player, row, col, -1, 1);
-}
-
-bool ConnectFourState::HasLineFromInDirection(Player player, int row, int col,
-                                              int drow, int dcol) const {
-  if (row + 3 * drow >= kRows || col + 3 * dcol >= kCols ||
-      row + 3 * drow < 0 || col + 3 * dcol < 0)
-    return false;
-  CellState c = PlayerToState(player);
-  for (int i = 0; i < 4; ++i) {
-    if (CellAt(row, col) != c) return false;
-    row += drow;
-    col += dcol;
-  }
-  return true;
-}
-
 bool ConnectFourState::HasLine(Player player) const {
-  CellState c = PlayerToState(player);
-  for (int col = 0; col < kCols; ++col) {
-    for (int row = 0; row < kRows; ++row) {
-      if (CellAt(row, col) == c && HasLineFrom(player, row, col)) return true;
-    }
-  }
-  return false;
+  return HasFourInARow(stones_[player]);
 }
 
 bool ConnectFourState::IsFull() const {
-  for (int col = 0; col < kCols; ++col) {
-    if (CellAt(kRows - 1, col) == CellState::kEmpty) return false;
-  }
-  return true;
+  return ((stones_[0] | stones_[1]) & TopRow()) == TopRow();
 }
 
 ConnectFourState::ConnectFourState(std::shared_ptr<const Game> game)
-    : State(game) {
-  std::fill(begin(board_), end(board_), CellState::kEmpty);
-}
+    : State(game) {}
 
 std::string ConnectFourState::ToString() const {
   std::string str;
@@ -216,7 +222,8 @@ void ConnectFourState::ObservationTensor(Player player,
   TensorView<2> view(values, {kCellStates, kNumCells}, true);
 
   for (int cell = 0; cell < kNumCells; ++cell) {
-    view[{PlayerRelative(board_[cell], player), cell}] = 1.0;
+    view[{PlayerRelative(CellAt(cell / kCols, cell % kCols), player), cell}] =
+        1.0;
   }
 }
 
@@ -244,15 +251,15 @@ ConnectFourState::ConnectFourState(std::shared_ptr<const Game> game,
   for (const char ch : str) {
     switch (ch) {
       case '.':
-        CellAt(r, c) = CellState::kEmpty;
+        SetCell(r, c, CellState::kEmpty);
         break;
       case 'x':
         ++xs;
-        CellAt(r, c) = CellState::kCross;
+        SetCell(r, c, CellState::kCross);
         break;
       case 'o':
         ++os;
-        CellAt(r, c) = CellState::kNought;
+        SetCell(r, c, CellState::kNought);
         break;
     }
     if (ch == '.' || ch == 'x' || ch == 'o') {
@@ -16,6 +16,7 @@
 #define OPEN_SPIEL_GAMES_CONNECT_FOUR_H_
 
 #include <array>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
@@ -26,6 +27,10 @@
 // Simple game of Connect Four
 // https://en.wikipedia.org/wiki/Connect_Four
 //
+// The board is kept as a bitboard per player, with 7 bits per column: one per
+// row from the bottom up, then a spare bit that is always clear, so lines are
+// found with shifts without wrapping from one column into the next.
+//
 // Minimax values (win/loss/draw) available for first 8 moves, here:
 // https://archive.ics.uci.edu/ml/datasets/Connect-4
 //
@@ -82,16 +87,13 @@ class ConnectFourState : public State {
   void DoApplyAction(Action move) override;
 
  private:
-  CellState& CellAt(int row, int col);
   CellState CellAt(int row, int col) const;
+  void SetCell(int row, int col, CellState state);
   bool HasLine(Player player) const;  // Does this player have a line?
-  bool HasLineFrom(Player player, int row, int col) const;
-  bool HasLineFromInDirection(Player player, int row, int col, int drow,
-                              int dcol) const;
   bool IsFull() const;         // Is the board full?
   Player current_player_ = 0;  // Player zero goes first
   Outcome outcome_ = Outcome::kUnknown;
-  std::array<CellState, kNumCells> board_;
+  std::array<uint64_t, kNumPlayers> stones_ = {};  // A bitboard per player.
 };
 
 // Game object.
@@ -14,6 +14,11 @@
 
 #include "open_spiel/games/connect_four.h"
 
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
 #include "open_spiel/tests/basic_tests.h"
@@ -79,6 +84,13 @@ void DeserializeDraw() {
   SPIEL_CHECK_EQ(state->Returns(), (std::vector<double>{0, 0}));
 }
 
+// The hashes were recorded before the board was a bitboard, so this checks the
+// legal actions, observations and results are still the same.
+void MatchesReferenceTest() {
+  SPIEL_CHECK_EQ(testing::RandomGamesHash(*LoadGame("connect_four"), 200),
+                 1050029224357822199ull);
+}
+
 }  // namespace
 }  // namespace connect_four
 }  // namespace open_spiel
@@ -88,4 +100,5 @@ int main(int argc, char **argv) {
   open_spiel::connect_four::FastLoss();
   open_spiel::connect_four::BasicSerializationTest();
   open_spiel::connect_four::DeserializeDraw();
+  open_spiel::connect_four::MatchesReferenceTest();
 }
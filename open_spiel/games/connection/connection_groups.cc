@@ -0,0 +1,31 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/connection/connection_groups.h"
+
+#include <limits>
+
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace connection {
+
+ConnectionGroups::ConnectionGroups(int num_cells) : nodes_(num_cells) {
+  // Cells and group sizes are stored in 16 bits.
+  SPIEL_CHECK_LE(num_cells, std::numeric_limits<uint16_t>::max());
+  for (int cell = 0; cell < num_cells; ++cell) Reset(cell, 0);
+}
+
+}  // namespace connection
+}  // namespace open_spiel
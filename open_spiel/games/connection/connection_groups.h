@@ -0,0 +1,103 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_GAMES_CONNECTION_CONNECTION_GROUPS_H_
+#define OPEN_SPIEL_GAMES_CONNECTION_CONNECTION_GROUPS_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Groups of connected stones for the connection games (hex, y, havannah),
+// where stones are never removed and a player wins by connecting parts of the
+// board: edges or corners.
+//
+// It is a union-find over the cells of the board, with union by size and path
+// halving. The leader of each group holds a bitmask of the board features the
+// group touches, so telling whether a move won is a few Find calls rather
+// than a search of the board. It is one flat array, so copying it with the
+// State is one allocation and a contiguous copy.
+
+namespace open_spiel {
+namespace connection {
+
+class ConnectionGroups {
+ public:
+  // A bitmask of board features, eg edges, whose meaning is up to the game.
+  using Features = uint16_t;
+
+  // Every cell starts out as a group of its own, touching no features.
+  explicit ConnectionGroups(int num_cells);
+
+  // Makes `cell` a group of its own touching `features`. Only valid for a
+  // cell that isn't joined to any other yet.
+  void Reset(int cell, Features features) {
+    nodes_[cell] = Node{static_cast<uint16_t>(cell), 1, features};
+  }
+
+  // Returns the leader of the group of `cell`, shortening the path to it.
+  int Find(int cell) {
+    while (nodes_[cell].parent != cell) {
+      nodes_[cell].parent = nodes_[nodes_[cell].parent].parent;
+      cell = nodes_[cell].parent;
+    }
+    return cell;
+  }
+
+  // Same, without shortening the path, for const callers.
+  int Find(int cell) const {
+    while (nodes_[cell].parent != cell) cell = nodes_[cell].parent;
+    return cell;
+  }
+
+  // Merges the groups of the two cells. Returns true if they were already the
+  // same group.
+  bool Join(int cell_a, int cell_b) {
+    int leader_a = Find(cell_a);
+    int leader_b = Find(cell_b);
+    if (leader_a == leader_b) return true;
+    // The smaller group joins the bigger one, to keep the trees shallow.
+    if (nodes_[leader_a].size < nodes_[leader_b].size) {
+      std::swap(leader_a, leader_b);
+    }
+    nodes_[leader_b].parent = leader_a;
+    nodes_[leader_a].size += nodes_[leader_b].size;
+    nodes_[leader_a].features |= nodes_[leader_b].features;
+    return false;
+  }
+
+  // The features touched by the group of `cell`.
+  Features GroupFeatures(int cell) { return nodes_[Find(cell)].features; }
+  Features GroupFeatures(int cell) const {
+    return nodes_[Find(cell)].features;
+  }
+
+  int GroupSize(int cell) const { return nodes_[Find(cell)].size; }
+
+  int NumCells() const { return nodes_.size(); }
+
+ private:
+  struct Node {
+    uint16_t parent;  // The leader of the group if it points to itself.
+    uint16_t size;    // These two are only up to date for the leader.
+    Features features;
+  };
+
+  std::vector<Node> nodes_;
+};
+
+}  // namespace connection
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_CONNECTION_CONNECTION_GROUPS_H_
@@ -15,10 +15,14 @@
 #include "open_spiel/games/gin_rummy/gin_rummy_utils.h"
 
 #include <algorithm>
+#include <array>
+#include <numeric>
 #include <set>
 #include <utility>
 
 #include "open_spiel/abseil-cpp/absl/algorithm/container.h"
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
+#include "open_spiel/abseil-cpp/absl/numeric/bits.h"
 #include "open_spiel/spiel.h"
 
 namespace open_spiel {
@@ -223,6 +227,208 @@ VecVecInt SuitMelds(VecInt cards) {
   return melds;
 }
 
+CardMask CardsToMask(const VecInt &cards) {
+  CardMask mask = 0;
+  for (int card : cards) mask |= CardMask{1} << card;
+  return mask;
+}
+
+VecInt MaskToCards(CardMask mask) {
+  VecInt cards;
+  cards.reserve(absl::popcount(mask));
+  for (; mask != 0; mask &= mask - 1) cards.push_back(absl::countr_zero(mask));
+  return cards;
+}
+
+namespace {
+
+// Every meld, indexed by meld id.
+struct MeldTable {
+  std::array<VecInt, kNumMelds> cards;
+  std::array<CardMask, kNumMelds> masks;
+  std::array<int, kNumMelds> values;
+  // The ids of the melds whose lowest card is the given card.
+  std::array<VecInt, kNumCards> by_lowest_card;
+};
+
+const MeldTable &Melds() {
+  static const MeldTable *table = [] {
+    auto *table = new MeldTable();
+    VecInt full_deck(kNumCards);
+    std::iota(full_deck.begin(), full_deck.end(), 0);
+    VecVecInt melds = RankMelds(full_deck);
+    VecVecInt suit_melds = SuitMelds(full_deck);
+    melds.insert(melds.end(), suit_melds.begin(), suit_melds.end());
+    SPIEL_CHECK_EQ(melds.size(), kNumMelds);
+    for (VecInt &meld : melds) {
+      int meld_id = MeldToInt(meld);
+      table->masks[meld_id] = CardsToMask(meld);
+      table->values[meld_id] = TotalCardValue(meld);
+      table->by_lowest_card[*absl::c_min_element(meld)].push_back(meld_id);
+      table->cards[meld_id] = std::move(meld);
+    }
+    return table;
+  }();
+  return *table;
+}
+
+int TotalCardValue(CardMask cards) {
+  int total_value = 0;
+  for (; cards != 0; cards &= cards - 1) {
+    total_value += CardValue(absl::countr_zero(cards));
+  }
+  return total_value;
+}
+
+bool IsSubset(CardMask subset, CardMask cards) {
+  return (subset & ~cards) == 0;
+}
+
+// The cards of one suit, with bit i set for rank i.
+constexpr CardMask kSuitMask = (CardMask{1} << kNumRanks) - 1;
+
+// The cards that are in at least one meld within the given cards.
+CardMask MeldableCards(CardMask cards) {
+  // Runs of three, by their lowest card. Each suit is its own run of bits,
+  // so runs wrapping into the next suit are masked out.
+  CardMask no_wrap = 0;
+  for (int suit = 0; suit < kNumSuits; ++suit) {
+    no_wrap |= (kSuitMask >> 2) << (suit * kNumRanks);
+  }
+  CardMask runs = cards & (cards >> 1) & (cards >> 2) & no_wrap;
+  CardMask meldable = runs | (runs << 1) | (runs << 2);
+  // Ranks held in at least three suits.
+  CardMask s = cards & kSuitMask;
+  CardMask c = (cards >> kNumRanks) & kSuitMask;
+  CardMask d = (cards >> (2 * kNumRanks)) & kSuitMask;
+  CardMask h = (cards >> (3 * kNumRanks)) & kSuitMask;
+  CardMask sets = (s & c & d) | (s & c & h) | (s & d & h) | (c & d & h);
+  for (int suit = 0; suit < kNumSuits; ++suit) {
+    meldable |= (sets << (suit * kNumRanks)) & cards;
+  }
+  return meldable;
+}
+
+// Finds the highest total value of disjoint melds within a set of cards. The
+// lowest card that can be in a meld is either left out or in one of the melds
+// it is the lowest card of, and either way the rest is a smaller search of the
+// same kind. The searches for the subsets overlap, so their results are
+// memoized.
+class MeldSearch {
+ public:
+  int MaxMeldValue(CardMask cards) {
+    // Cards in no meld can't add to the value.
+    cards = MeldableCards(cards);
+    if (cards == 0) return 0;
+    auto it = memo_.find(cards);
+    if (it != memo_.end()) return it->second;
+    const MeldTable &melds = Melds();
+    int best = MaxMeldValue(cards & (cards - 1));
+    for (int meld_id : melds.by_lowest_card[absl::countr_zero(cards)]) {
+      if (IsSubset(melds.masks[meld_id], cards)) {
+        best = std::max(best, melds.values[meld_id] +
+                                  MaxMeldValue(cards & ~melds.masks[meld_id]));
+      }
+    }
+    memo_[cards] = best;
+    return best;
+  }
+
+  // The ids of a set of disjoint melds with the highest total value.
+  VecInt BestMelds(CardMask cards) {
+    const MeldTable &melds = Melds();
+    VecInt meld_ids;
+    while (MaxMeldValue(cards) > 0) {
+      int target = MaxMeldValue(cards);
+      CardMask rest = cards & (cards - 1);
+      if (MaxMeldValue(rest) != target) {
+        for (int meld_id : melds.by_lowest_card[absl::countr_zero(cards)]) {
+          if (IsSubset(melds.masks[meld_id], cards) &&
+              melds.values[meld_id] +
+                      MaxMeldValue(cards & ~melds.masks[meld_id]) ==
+                  target) {
+            meld_ids.push_back(meld_id);
+            rest = cards & ~melds.masks[meld_id];
+            break;
+          }
+        }
+      }
+      cards = rest;
+    }
+    return meld_ids;
+  }
+
+  // The deadwood count after the best melds. With 11 cards, the highest card
+  // left over by the best meld group gets discarded.
+  int MinDeadwood(CardMask hand) {
+    int best = MaxMeldValue(hand);
+    int deadwood_total = TotalCardValue(hand) - best;
+    if (absl::popcount(hand) == kMaxHandSize && deadwood_total > 0) {
+      deadwood_total -= DiscardValue(hand, best);
+    }
+    return deadwood_total;
+  }
+
+ private:
+  // Whether the card is in a meld of some best meld group.
+  bool InBestMeld(CardMask hand, int card, int best) {
+    const MeldTable &melds = Melds();
+    for (int meld_id = 0; meld_id < kNumMelds; ++meld_id) {
+      CardMask meld = melds.masks[meld_id];
+      if ((meld & (CardMask{1} << card)) && IsSubset(meld, hand) &&
+          melds.values[meld_id] + MaxMeldValue(hand & ~meld) == best) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // The value of the highest card left over by the best meld group. When
+  // there are several, the one used is the first AllMeldGroups lists. Usually
+  // the highest card any of them leaves over is left over by all of them, so
+  // the meld groups needn't be listed.
+  int DiscardValue(CardMask hand, int best) {
+    int highest = 0;
+    int highest_in_all = 0;
+    for (CardMask cards = hand; cards != 0; cards &= cards - 1) {
+      int card = absl::countr_zero(cards);
+      if (MaxMeldValue(hand & ~(CardMask{1} << card)) != best) continue;
+      highest = std::max(highest, CardValue(card));
+      if (CardValue(card) > highest_in_all && !InBestMeld(hand, card, best)) {
+        highest_in_all = CardValue(card);
+      }
+    }
+    if (highest == highest_in_all) return highest;
+
+    int best_meld_group_total_value = 0;
+    CardMask deadwood = hand;
+    for (const auto &meld_group : AllMeldGroups(MaskToCards(hand))) {
+      int meld_group_total_value = gin_rummy::TotalCardValue(meld_group);
+      if (meld_group_total_value > best_meld_group_total_value) {
+        best_meld_group_total_value = meld_group_total_value;
+        deadwood = hand;
+        for (const auto &meld : meld_group) deadwood &= ~CardsToMask(meld);
+      }
+    }
+    int discard_value = 0;
+    for (; deadwood != 0; deadwood &= deadwood - 1) {
+      discard_value =
+          std::max(discard_value, CardValue(absl::countr_zero(deadwood)));
+    }
+    return discard_value;
+  }
+
+  absl::flat_hash_map<CardMask, int> memo_;
+};
+
+}  // namespace
+
+CardMask MeldMask(int meld_id) {
+  SPIEL_CHECK_GE(meld_id, 0);
+  SPIEL_CHECK_LT(meld_id, kNumMelds);
+  return Melds().masks[meld_id];
+}
+
 // Returns all melds of length 5 or less. Any meld of length 6 or more can
 // be expressed as two or more melds of shorter length.
 VecVecInt AllMelds(const VecInt &cards) {
@@ -293,15 +499,9 @@ VecVecVecInt AllMeldGroups(const VecInt &cards) {
 // "Best" means any meld group that achieves the lowest possible deadwood
 // count for the given cards. In general this is non-unique.
 VecVecInt BestMeldGroup(const VecInt &cards) {
-  int best_meld_group_total_value = 0;
   VecVecInt best_meld_group;
-  VecVecVecInt all_meld_groups = AllMeldGroups(cards);
-  for (const auto &meld_group : all_meld_groups) {
-    int meld_group_total_value = TotalCardValue(meld_group);
-    if (meld_group_total_value > best_meld_group_total_value) {
-      best_meld_group_total_value = meld_group_total_value;
-      best_meld_group = meld_group;
-    }
+  for (int meld_id : MeldSearch().BestMelds(CardsToMask(cards))) {
+    best_meld_group.push_back(Melds().cards[meld_id]);
   }
   return best_meld_group;
 }
@@ -314,25 +514,12 @@ int MinDeadwood(VecInt hand, std::optional<int> card) {
 
 // Minimum deadwood count over all meld groups.
 int MinDeadwood(const VecInt &hand) {
-  VecInt deadwood = hand;
-  VecVecInt best_melds = BestMeldGroup(hand);
-
-  for (const auto &meld : best_melds) {
-    for (auto card : meld) {
-      deadwood.erase(std::remove(deadwood.begin(), deadwood.end(), card),
-                     deadwood.end());
-    }
-  }
-  // If we have 11 cards we can discard one.
-  if (hand.size() == kMaxHandSize && !deadwood.empty()) {
-    absl::c_sort(deadwood, CompareRanks);
-    deadwood.pop_back();
-  }
-  int deadwood_total = 0;
-  for (int card : deadwood) deadwood_total += CardValue(card);
-  return deadwood_total;
+  return MinDeadwood(CardsToMask(hand));
 }
 
+// Minimum deadwood count over all meld groups.
+int MinDeadwood(CardMask hand) { return MeldSearch().MinDeadwood(hand); }
+
 // Returns the one card that can be layed off on a three card rank meld.
 int RankMeldLayoff(const VecInt &meld) {
   SPIEL_CHECK_EQ(meld.size(), 3);
@@ -364,20 +551,23 @@ VecInt SuitMeldLayoffs(const VecInt &meld) {
 // the 6's and 7's in melds, leaving us with 26 points. Laying the two suit
 // melds leaves only the 8d for 8 points.
 // Returns vector of meld_ids (see MeldToInt).
+// A meld is legal if the best meld group that includes it is good enough.
 VecInt LegalMelds(const VecInt &hand, int knock_card) {
-  int total_hand_value = TotalCardValue(hand);
-  std::set<int> meld_set;
-  VecInt hand_(hand);
-  VecVecVecInt all_meld_groups = AllMeldGroups(hand_);
-  for (const auto &meld_group : all_meld_groups) {
-    int meld_group_total_value = TotalCardValue(meld_group);
-    if (total_hand_value - meld_group_total_value <= knock_card) {
-      for (const auto &meld : meld_group) {
-        meld_set.insert(meld_to_int.at(meld));
-      }
+  const MeldTable &melds = Melds();
+  CardMask cards = CardsToMask(hand);
+  int total_hand_value = TotalCardValue(cards);
+  MeldSearch search;
+  VecInt legal_melds;
+  for (int meld_id = 0; meld_id < kNumMelds; ++meld_id) {
+    CardMask meld = melds.masks[meld_id];
+    if (IsSubset(meld, cards) &&
+        total_hand_value - melds.values[meld_id] -
+                search.MaxMeldValue(cards & ~meld) <=
+            knock_card) {
+      legal_melds.push_back(meld_id);
     }
   }
-  return VecInt(meld_set.begin(), meld_set.end());
+  return legal_melds;
 }
 
 // Returns the legal discards when a player has knocked. Normally a player can
@@ -385,16 +575,17 @@ VecInt LegalMelds(const VecInt &hand, int knock_card) {
 // discard a card that preseves the ability to arrange the hand so that the
 // total deadwood is less than the knock card.
 VecInt LegalDiscards(const VecInt &hand, int knock_card) {
-  std::set<int> legal_discards;
-  for (int i = 0; i < hand.size(); ++i) {
-    VecInt hand_(hand);
-    hand_.erase(hand_.begin() + i);
-    int deadwood = MinDeadwood(hand_);
-    if (deadwood <= knock_card) {
-      legal_discards.insert(hand[i]);
+  CardMask cards = CardsToMask(hand);
+  // The searches after each discard share most of their subsets.
+  MeldSearch search;
+  CardMask legal_discards = 0;
+  for (int card : hand) {
+    CardMask discard = CardMask{1} << card;
+    if (search.MinDeadwood(cards & ~discard) <= knock_card) {
+      legal_discards |= discard;
     }
   }
-  return VecInt(legal_discards.begin(), legal_discards.end());
+  return MaskToCards(legal_discards);
 }
 
 VecInt AllLayoffs(const VecInt &layed_melds, const VecInt &previous_layoffs) {
@@ -15,6 +15,7 @@
 #ifndef OPEN_SPIEL_GAMES_GIN_RUMMY_UTILS_H_
 #define OPEN_SPIEL_GAMES_GIN_RUMMY_UTILS_H_
 
+#include <cstdint>
 #include <map>
 #include <string>
 #include <vector>
@@ -26,11 +27,21 @@ inline constexpr int kNumSuits = 4;
 inline constexpr int kNumRanks = 13;
 inline constexpr int kNumCards = kNumSuits * kNumRanks;
 inline constexpr int kMaxHandSize = 11;
+inline constexpr int kNumMelds = 185;
 
 using VecInt = std::vector<int>;
 using VecVecInt = std::vector<std::vector<int>>;
 using VecVecVecInt = std::vector<std::vector<std::vector<int>>>;
 
+// A set of cards, with bit i set for card i.
+using CardMask = uint64_t;
+
+CardMask CardsToMask(const VecInt &cards);
+VecInt MaskToCards(CardMask mask);  // In ascending order.
+
+// The cards of the meld with the given id (see MeldToInt).
+CardMask MeldMask(int meld_id);
+
 std::string CardString(std::optional<int> card);
 std::string HandToString(const VecInt &cards);
 
@@ -68,6 +79,7 @@ VecVecInt BestMeldGroup(const VecInt &cards);
 
 int MinDeadwood(VecInt hand, std::optional<int> card);
 int MinDeadwood(const VecInt &hand);
+int MinDeadwood(CardMask hand);
 
 int RankMeldLayoff(const VecInt &meld);
 VecInt SuitMeldLayoffs(const VecInt &meld);
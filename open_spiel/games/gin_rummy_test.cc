@@ -14,6 +14,11 @@
 
 #include "open_spiel/games/gin_rummy.h"
 
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
 #include "open_spiel/abseil-cpp/absl/algorithm/container.h"
 #include "open_spiel/games/gin_rummy/gin_rummy_utils.h"
 #include "open_spiel/spiel.h"
@@ -532,6 +537,135 @@ void OklahomaTest() {
   SPIEL_CHECK_EQ(returns[0], -88);
 }
 
+// The meld group with the highest value, found by listing every meld group.
+int ReferenceMaxMeldValue(const std::vector<int>& hand) {
+  int best = 0;
+  for (const auto& meld_group : AllMeldGroups(hand)) {
+    best = std::max(best, TotalCardValue(meld_group));
+  }
+  return best;
+}
+
+// MinDeadwood as it was written over AllMeldGroups: with 11 cards, the highest
+// card left over by the first best meld group listed is discarded.
+int ReferenceMinDeadwood(const std::vector<int>& hand) {
+  int best_meld_group_total_value = 0;
+  std::vector<std::vector<int>> best_melds;
+  for (const auto& meld_group : AllMeldGroups(hand)) {
+    int meld_group_total_value = TotalCardValue(meld_group);
+    if (meld_group_total_value > best_meld_group_total_value) {
+      best_meld_group_total_value = meld_group_total_value;
+      best_melds = meld_group;
+    }
+  }
+  std::vector<int> deadwood = hand;
+  for (const auto& meld : best_melds) {
+    for (auto card : meld) {
+      deadwood.erase(std::remove(deadwood.begin(), deadwood.end(), card),
+                     deadwood.end());
+    }
+  }
+  if (hand.size() == kMaxHandSize && !deadwood.empty()) {
+    absl::c_sort(deadwood, CompareRanks);
+    deadwood.pop_back();
+  }
+  int deadwood_total = 0;
+  for (int card : deadwood) deadwood_total += CardValue(card);
+  return deadwood_total;
+}
+
+std::vector<int> ReferenceLegalMelds(const std::vector<int>& hand,
+                                     int knock_card) {
+  std::set<int> meld_set;
+  for (const auto& meld_group : AllMeldGroups(hand)) {
+    if (TotalCardValue(hand) - TotalCardValue(meld_group) <= knock_card) {
+      for (const auto& meld : meld_group) meld_set.insert(MeldToInt(meld));
+    }
+  }
+  return std::vector<int>(meld_set.begin(), meld_set.end());
+}
+
+std::vector<int> ReferenceLegalDiscards(const std::vector<int>& hand,
+                                        int knock_card) {
+  std::set<int> legal_discards;
+  for (int i = 0; i < hand.size(); ++i) {
+    std::vector<int> rest(hand);
+    rest.erase(rest.begin() + i);
+    if (ReferenceMinDeadwood(rest) <= knock_card) {
+      legal_discards.insert(hand[i]);
+    }
+  }
+  return std::vector<int>(legal_discards.begin(), legal_discards.end());
+}
+
+// Checks the meld searches over card masks against listing every meld group,
+// on random hands. Hands drawn from a few neighbouring ranks have many
+// overlapping melds, so half of them are.
+void MatchesMeldGroupsTest() {
+  std::mt19937 rng(0);
+  for (int i = 0; i < 2000; ++i) {
+    int low_rank = rng() % (kNumRanks - 5);
+    std::vector<int> deck;
+    for (int card = 0; card < kNumCards; ++card) {
+      if (i % 2 == 0 || (CardRank(card) >= low_rank &&
+                         CardRank(card) < low_rank + 6)) {
+        deck.push_back(card);
+      }
+    }
+    std::shuffle(deck.begin(), deck.end(), rng);
+    int hand_size = i % 4 == 0 ? 3 + rng() % 7 : 10 + rng() % 2;
+    std::vector<int> hand(deck.begin(), deck.begin() + hand_size);
+
+    std::vector<std::vector<int>> melds = RankMelds(hand);
+    for (const auto& meld : SuitMelds(hand)) melds.push_back(meld);
+    std::vector<std::vector<int>> all_melds = AllMelds(hand);
+    absl::c_sort(melds);
+    absl::c_sort(all_melds);
+    SPIEL_CHECK_EQ(all_melds, melds);
+
+    std::vector<std::vector<int>> meld_group = BestMeldGroup(hand);
+    SPIEL_CHECK_EQ(TotalCardValue(meld_group), ReferenceMaxMeldValue(hand));
+    CardMask melded = 0;
+    for (const auto& meld : meld_group) {
+      SPIEL_CHECK_EQ(melded & CardsToMask(meld), 0);
+      melded |= CardsToMask(meld);
+    }
+    SPIEL_CHECK_EQ(melded & ~CardsToMask(hand), 0);
+
+    SPIEL_CHECK_EQ(MinDeadwood(hand), ReferenceMinDeadwood(hand));
+    for (int knock_card : {0, 5, 10, kMaxPossibleDeadwood}) {
+      SPIEL_CHECK_EQ(LegalMelds(hand, knock_card),
+                     ReferenceLegalMelds(hand, knock_card));
+      SPIEL_CHECK_EQ(LegalDiscards(hand, knock_card),
+                     ReferenceLegalDiscards(hand, knock_card));
+    }
+  }
+}
+
+// Checks MinDeadwood against listing every meld group on every 11-card hand
+// of the cards of five neighbouring ranks, which have the most ties between
+// best meld groups leaving different cards over.
+void MinDeadwoodExhaustiveTest() {
+  for (int low_rank : {3, 8}) {
+    std::vector<int> deck;
+    for (int card = 0; card < kNumCards; ++card) {
+      if (CardRank(card) >= low_rank && CardRank(card) < low_rank + 5) {
+        deck.push_back(card);
+      }
+    }
+    // Each hand leaves out nine cards of the 20.
+    std::vector<bool> in_hand(deck.size(), true);
+    std::fill(in_hand.begin(), in_hand.begin() + 9, false);
+    do {
+      std::vector<int> hand;
+      for (int i = 0; i < deck.size(); ++i) {
+        if (in_hand[i]) hand.push_back(deck[i]);
+      }
+      SPIEL_CHECK_EQ(MinDeadwood(hand), ReferenceMinDeadwood(hand));
+    } while (std::next_permutation(in_hand.begin(), in_hand.end()));
+  }
+}
+
 }  // namespace
 }  // namespace gin_rummy
 }  // namespace open_spiel
@@ -539,6 +673,8 @@ void OklahomaTest() {
 int main(int argc, char** argv) {
   open_spiel::gin_rummy::BasicGameTests();
   open_spiel::gin_rummy::MeldTests();
+  open_spiel::gin_rummy::MatchesMeldGroupsTest();
+  open_spiel::gin_rummy::MinDeadwoodExhaustiveTest();
   open_spiel::gin_rummy::GameplayTest1();
   open_spiel::gin_rummy::GameplayTest2();
   open_spiel::gin_rummy::GameplayTest3();
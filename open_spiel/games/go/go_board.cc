@@ -37,6 +37,15 @@ void Neighbours(VirtualPoint p, const F& f) {
   f(p - kVirtualBoardSize);
 }
 
+// Calls f for all 4 diagonal neighbours of p.
+template <typename F>
+void Diagonals(VirtualPoint p, const F& f) {
+  f(p + kVirtualBoardSize + 1);
+  f(p + kVirtualBoardSize - 1);
+  f(p - kVirtualBoardSize + 1);
+  f(p - kVirtualBoardSize - 1);
+}
+
 std::vector<VirtualPoint> MakeBoardPoints(int board_size) {
   std::vector<VirtualPoint> points;
   points.reserve(board_size * board_size);
@@ -236,9 +245,12 @@ void GoBoard::Clear() {
     chains_[i].reset_border();
   }
 
+  num_empty_ = 0;
   for (VirtualPoint p : BoardPoints(board_size_)) {
     board_[p].color = GoColor::kEmpty;
     chains_[p].reset();
+    empty_index_[p] = num_empty_;
+    empty_points_[num_empty_++] = p;
   }
 
   for (VirtualPoint p : BoardPoints(board_size_)) {
@@ -295,6 +307,16 @@ void GoBoard::SetStone(VirtualPoint p, GoColor c) {
   zobrist_hash_ ^= zobrist_values[p][static_cast<int>(
       c == GoColor::kEmpty ? PointColor(p) : c)];
 
+  if (c == GoColor::kEmpty) {
+    empty_index_[p] = num_empty_;
+    empty_points_[num_empty_++] = p;
+  } else {
+    // Move the last empty point into this one's place.
+    VirtualPoint last = empty_points_[--num_empty_];
+    empty_points_[empty_index_[p]] = last;
+    empty_index_[last] = empty_index_[p];
+  }
+
   board_[p].color = c;
 }
 
@@ -440,6 +462,55 @@ bool GoBoard::IsLegalMove(VirtualPoint p, GoColor c) const {
   return false;
 }
 
+bool GoBoard::IsEye(VirtualPoint p, GoColor c) const {
+  if (!IsEmpty(p)) return false;
+
+  bool surrounded = true;
+  Neighbours(p, [this, c, &surrounded](VirtualPoint n) {
+    GoColor s = PointColor(n);
+    surrounded &= (s == c || s == GoColor::kGuard);
+  });
+  if (!surrounded) return false;
+
+  int opponent_diagonals = 0;
+  bool on_edge = false;
+  Diagonals(p, [this, c, &opponent_diagonals, &on_edge](VirtualPoint n) {
+    GoColor s = PointColor(n);
+    opponent_diagonals += s == OppColor(c);
+    on_edge |= s == GoColor::kGuard;
+  });
+  return opponent_diagonals + on_edge < 2;
+}
+
+VirtualPoint GoBoard::RandomPlayoutMove(GoColor c, std::mt19937* rng) {
+  // Sample from the empty points, moving rejected ones past the end of the
+  // range still to sample from, so each one is tried at most once.
+  for (int n = num_empty_; n > 0; --n) {
+    int i = absl::uniform_int_distribution<int>(0, n - 1)(*rng);
+    VirtualPoint p = empty_points_[i];
+    if (!IsEye(p, c) && IsLegalMove(p, c)) return p;
+
+    VirtualPoint last = empty_points_[n - 1];
+    std::swap(empty_points_[i], empty_points_[n - 1]);
+    empty_index_[p] = n - 1;
+    empty_index_[last] = i;
+  }
+  return kVirtualPass;
+}
+
+int GoBoard::RandomPlayout(GoColor to_play, int max_moves, std::mt19937* rng) {
+  int num_moves = 0;
+  int consecutive_passes = 0;
+  while (num_moves < max_moves && consecutive_passes < 2) {
+    VirtualPoint p = RandomPlayoutMove(to_play, rng);
+    PlayMove(p, to_play);
+    consecutive_passes = p == kVirtualPass ? consecutive_passes + 1 : 0;
+    to_play = OppColor(to_play);
+    ++num_moves;
+  }
+  return num_moves;
+}
+
 void GoBoard::Chain::reset_border() {
   num_stones = 0;
   // Need to have values big enough that they can never go below 0 even if
@@ -18,6 +18,7 @@
 #include <array>
 #include <cstdint>
 #include <ostream>
+#include <random>
 #include <vector>
 #include "open_spiel/spiel_utils.h"
 
@@ -123,6 +124,27 @@ class GoBoard {
 
   inline bool InAtari(VirtualPoint p) const { return chain(p).in_atari(); }
 
+  // The empty points, in no particular order. The list is kept up to date as
+  // stones are placed and captured, so playouts can sample moves from it.
+  inline int NumEmptyPoints() const { return num_empty_; }
+  inline VirtualPoint EmptyPoint(int i) const { return empty_points_[i]; }
+
+  // Whether p is an empty point that c would rarely want to fill: all its
+  // neighbours are c's stones or the edge, and the opponent holds at most one
+  // of its diagonals, or none if it's on the edge.
+  bool IsEye(VirtualPoint p, GoColor c) const;
+
+  // Returns a uniformly random legal move for c that doesn't fill one of its
+  // own eyes, or kVirtualPass if there is none. This may reorder the empty
+  // points.
+  VirtualPoint RandomPlayoutMove(GoColor c, std::mt19937* rng);
+
+  // Plays moves from RandomPlayoutMove, starting with to_play, until both
+  // players pass in a row or max_moves moves have been played. Positional
+  // superko isn't checked, only simple ko. Returns the number of moves played;
+  // the result can then be scored with TrompTaylorScore.
+  int RandomPlayout(GoColor to_play, int max_moves, std::mt19937* rng);
+
   inline uint64_t HashValue() const { return zobrist_hash_; }
 
   // Actual liberty count, i.e. each liberty is counted exactly once.
@@ -221,6 +243,12 @@ class GoBoard {
   std::array<Vertex, kVirtualBoardPoints> board_;
   std::array<Chain, kVirtualBoardPoints> chains_;
 
+  // The empty points and where each one is in that list, maintained by
+  // SetStone.
+  std::array<VirtualPoint, kMaxBoardSize * kMaxBoardSize> empty_points_;
+  std::array<uint16_t, kVirtualBoardPoints> empty_index_;
+  int num_empty_;
+
   uint64_t zobrist_hash_;
 
   // Chains captured in the last move, kInvalidPoint otherwise.
@@ -14,6 +14,8 @@
 
 #include "open_spiel/games/go.h"
 
+#include <random>
+
 #include "open_spiel/games/go/go_board.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
@@ -63,6 +65,58 @@ void ConcreteActionsAreUsedInTheAPI() {
   }
 }
 
+void EyeTest() {
+  GoBoard board(9);
+  for (const char* p : {"b1", "a2", "e4", "e6", "d5", "f5"}) {
+    board.PlayMove(MakePoint(p), GoColor::kBlack);
+  }
+  SPIEL_CHECK_TRUE(board.IsEye(MakePoint("a1"), GoColor::kBlack));
+  SPIEL_CHECK_FALSE(board.IsEye(MakePoint("a1"), GoColor::kWhite));
+  SPIEL_CHECK_TRUE(board.IsEye(MakePoint("e5"), GoColor::kBlack));
+  SPIEL_CHECK_FALSE(board.IsEye(MakePoint("c1"), GoColor::kBlack));
+
+  // Away from the edge it takes two opponent diagonals to spoil an eye, on
+  // the edge one.
+  board.PlayMove(MakePoint("d4"), GoColor::kWhite);
+  SPIEL_CHECK_TRUE(board.IsEye(MakePoint("e5"), GoColor::kBlack));
+  board.PlayMove(MakePoint("f6"), GoColor::kWhite);
+  SPIEL_CHECK_FALSE(board.IsEye(MakePoint("e5"), GoColor::kBlack));
+  board.PlayMove(MakePoint("b2"), GoColor::kWhite);
+  SPIEL_CHECK_FALSE(board.IsEye(MakePoint("a1"), GoColor::kBlack));
+}
+
+void RandomPlayoutTest() {
+  std::mt19937 rng;
+  for (int board_size : {5, 9, 19}) {
+    for (int i = 0; i < 10; ++i) {
+      GoBoard board(board_size);
+      int num_moves = board.RandomPlayout(GoColor::kBlack,
+                                          MaxGameLength(board_size), &rng);
+      SPIEL_CHECK_GT(num_moves, 0);
+      SPIEL_CHECK_LE(num_moves, MaxGameLength(board_size));
+
+      // The list of empty points matches the board.
+      int num_empty = 0;
+      for (VirtualPoint p : BoardPoints(board_size)) {
+        num_empty += board.IsEmpty(p);
+      }
+      SPIEL_CHECK_EQ(board.NumEmptyPoints(), num_empty);
+      for (int j = 0; j < board.NumEmptyPoints(); ++j) {
+        SPIEL_CHECK_TRUE(board.IsEmpty(board.EmptyPoint(j)));
+      }
+
+      // A playout that ended with two passes left the last player to pass
+      // nothing to play but its own eyes.
+      if (num_moves < MaxGameLength(board_size)) {
+        GoColor last = num_moves % 2 == 1 ? GoColor::kBlack : GoColor::kWhite;
+        for (VirtualPoint p : BoardPoints(board_size)) {
+          SPIEL_CHECK_TRUE(!board.IsLegalMove(p, last) || board.IsEye(p, last));
+        }
+      }
+    }
+  }
+}
+
 }  // namespace
 }  // namespace go
 }  // namespace open_spiel
@@ -71,4 +125,6 @@ int main(int argc, char** argv) {
   open_spiel::go::BasicGoTests();
   open_spiel::go::HandicapTest();
   open_spiel::go::ConcreteActionsAreUsedInTheAPI();
+  open_spiel::go::EyeTest();
+  open_spiel::go::RandomPlayoutTest();
 }
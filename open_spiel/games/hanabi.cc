@@ -14,6 +14,10 @@
 
 #include "open_spiel/games/hanabi.h"
 
+#include <algorithm>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/game_parameters.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
@@ -56,6 +60,200 @@ std::shared_ptr<const Game> Factory(const GameParameters& params) {
 
 REGISTER_SPIEL_GAME(kGameType, Factory);
 
+using hanabi_learning_env::HanabiCard;
+using hanabi_learning_env::HanabiGame;
+using hanabi_learning_env::HanabiHand;
+using hanabi_learning_env::HanabiHistoryItem;
+using hanabi_learning_env::HanabiMove;
+using hanabi_learning_env::HanabiState;
+
+// The sections of the canonical encoding, in order, as the environment's
+// canonical_encoders.cc lays them out.
+
+int HandsSectionLength(const HanabiGame& game, bool own_hand) {
+  return (game.NumPlayers() - !own_hand) * game.HandSize() * game.NumColors() *
+             game.NumRanks() +
+         game.NumPlayers();
+}
+
+int BoardSectionLength(const HanabiGame& game) {
+  return game.MaxDeckSize() - game.NumPlayers() * game.HandSize() +
+         game.NumColors() * game.NumRanks() + game.MaxInformationTokens() +
+         game.MaxLifeTokens();
+}
+
+int DiscardSectionLength(const HanabiGame& game) { return game.MaxDeckSize(); }
+
+int LastActionSectionLength(const HanabiGame& game) {
+  return game.NumPlayers() + 4 + game.NumPlayers() + game.NumColors() +
+         game.NumRanks() + 2 * game.HandSize() +
+         game.NumColors() * game.NumRanks() + 2;
+}
+
+int CardKnowledgeSectionLength(const HanabiGame& game) {
+  if (game.ObservationType() == HanabiGame::kMinimal) return 0;
+  return game.NumPlayers() * game.HandSize() *
+         (game.NumColors() * game.NumRanks() + game.NumColors() +
+          game.NumRanks());
+}
+
+int EncodingLength(const HanabiGame& game, bool own_hand) {
+  return HandsSectionLength(game, own_hand) + BoardSectionLength(game) +
+         DiscardSectionLength(game) + LastActionSectionLength(game) +
+         CardKnowledgeSectionLength(game);
+}
+
+// Encodes the state as CanonicalObservationEncoder::Encode encodes the
+// observer's HanabiObservation, reading the hands, knowledge and history
+// straight from the state, relative to the observer, instead of copying them
+// into the observation. `values` must be zeroed.
+template <typename T>
+void EncodeObservation(const HanabiGame& game, const HanabiState& state,
+                       int observer, bool own_hand, T* values) {
+  const int num_players = game.NumPlayers();
+  const int num_colors = game.NumColors();
+  const int num_ranks = game.NumRanks();
+  const int hand_size = game.HandSize();
+  const int bits_per_card = num_colors * num_ranks;
+  const std::vector<HanabiHand>& hands = state.Hands();
+  auto hand = [&](int relative_player) -> const HanabiHand& {
+    return hands[(observer + relative_player) % num_players];
+  };
+  int offset = 0;
+
+  // The cards in the other players' hands, and which hands are short.
+  const bool seer = game.ObservationType() == HanabiGame::kSeer;
+  for (int p = own_hand ? 0 : 1; p < num_players; ++p) {
+    if (p > 0 || seer) {
+      const std::vector<HanabiCard>& cards = hand(p).Cards();
+      for (int i = 0; i < cards.size(); ++i) {
+        values[offset + i * bits_per_card + cards[i].Color() * num_ranks +
+               cards[i].Rank()] = 1;
+      }
+    }
+    offset += hand_size * bits_per_card;
+  }
+  for (int p = 0; p < num_players; ++p) {
+    if (hand(p).Cards().size() < hand_size) values[offset + p] = 1;
+  }
+  offset += num_players;
+
+  // The deck size, fireworks and tokens.
+  std::fill(values + offset, values + offset + state.Deck().Size(), 1);
+  offset += game.MaxDeckSize() - num_players * hand_size;
+  for (int c = 0; c < num_colors; ++c) {
+    if (state.Fireworks()[c] > 0) values[offset + state.Fireworks()[c] - 1] = 1;
+    offset += num_ranks;
+  }
+  std::fill(values + offset, values + offset + state.InformationTokens(), 1);
+  offset += game.MaxInformationTokens();
+  std::fill(values + offset, values + offset + state.LifeTokens(), 1);
+  offset += game.MaxLifeTokens();
+
+  // How many of each card have been discarded.
+  std::vector<int> num_discarded(bits_per_card, 0);
+  for (const HanabiCard& card : state.DiscardPile()) {
+    ++num_discarded[card.Color() * num_ranks + card.Rank()];
+  }
+  for (int c = 0; c < num_colors; ++c) {
+    for (int r = 0; r < num_ranks; ++r) {
+      std::fill(values + offset,
+                values + offset + num_discarded[c * num_ranks + r], 1);
+      offset += game.NumberCardInstances(c, r);
+    }
+  }
+
+  // The last move that wasn't a deal.
+  const std::vector<HanabiHistoryItem>& history = state.MoveHistory();
+  auto last_move = std::find_if(
+      history.rbegin(), history.rend(), [](const HanabiHistoryItem& item) {
+        return item.move.MoveType() != HanabiMove::Type::kDeal;
+      });
+  if (last_move != history.rend()) {
+    const HanabiMove::Type type = last_move->move.MoveType();
+    const bool reveal = type == HanabiMove::Type::kRevealColor ||
+                        type == HanabiMove::Type::kRevealRank;
+    const bool play_or_discard =
+        type == HanabiMove::Type::kPlay || type == HanabiMove::Type::kDiscard;
+    const int player =
+        (last_move->player - observer + num_players) % num_players;
+    values[offset + player] = 1;
+    offset += num_players;
+    switch (type) {
+      case HanabiMove::Type::kPlay:
+        values[offset] = 1;
+        break;
+      case HanabiMove::Type::kDiscard:
+        values[offset + 1] = 1;
+        break;
+      case HanabiMove::Type::kRevealColor:
+        values[offset + 2] = 1;
+        break;
+      case HanabiMove::Type::kRevealRank:
+        values[offset + 3] = 1;
+        break;
+      default:
+        SpielFatalError(absl::StrCat("Unexpected move ",
+                                     last_move->move.ToString()));
+    }
+    offset += 4;
+    if (reveal) {
+      values[offset + (player + last_move->move.TargetOffset()) % num_players] =
+          1;
+    }
+    offset += num_players;
+    if (type == HanabiMove::Type::kRevealColor) {
+      values[offset + last_move->move.Color()] = 1;
+    }
+    offset += num_colors;
+    if (type == HanabiMove::Type::kRevealRank) {
+      values[offset + last_move->move.Rank()] = 1;
+    }
+    offset += num_ranks;
+    if (reveal) {
+      for (int i = 0; i < hand_size; ++i) {
+        if (last_move->reveal_bitmask & (1 << i)) values[offset + i] = 1;
+      }
+    }
+    offset += hand_size;
+    if (play_or_discard) values[offset + last_move->move.CardIndex()] = 1;
+    offset += hand_size;
+    if (play_or_discard) {
+      values[offset + last_move->color * num_ranks + last_move->rank] = 1;
+    }
+    offset += bits_per_card;
+    if (type == HanabiMove::Type::kPlay) {
+      if (last_move->scored) values[offset] = 1;
+      if (last_move->information_token) values[offset + 1] = 1;
+    }
+    offset += 2;
+  } else {
+    offset += LastActionSectionLength(game);
+  }
+
+  // What everyone knows about the cards in each hand.
+  if (game.ObservationType() == HanabiGame::kMinimal) return;
+  for (int p = 0; p < num_players; ++p) {
+    for (const HanabiHand::CardKnowledge& knowledge : hand(p).Knowledge()) {
+      for (int c = 0; c < num_colors; ++c) {
+        if (!knowledge.ColorPlausible(c)) continue;
+        for (int r = 0; r < num_ranks; ++r) {
+          if (knowledge.RankPlausible(r)) {
+            values[offset + c * num_ranks + r] = 1;
+          }
+        }
+      }
+      offset += bits_per_card;
+      if (knowledge.ColorHinted()) values[offset + knowledge.Color()] = 1;
+      offset += num_colors;
+      if (knowledge.RankHinted()) values[offset + knowledge.Rank()] = 1;
+      offset += num_ranks;
+    }
+    offset += (hand_size - hand(p).Knowledge().size()) *
+              (bits_per_card + num_colors + num_ranks);
+  }
+}
+
 }  // namespace
 
 std::unordered_map<std::string, std::string> OpenSpielHanabiGame::MapParams()
@@ -108,7 +306,14 @@ std::unordered_map<std::string, std::string> OpenSpielHanabiGame::MapParams()
 }
 
 OpenSpielHanabiGame::OpenSpielHanabiGame(const GameParameters& params)
-    : Game(kGameType, params), game_(MapParams()), encoder_(&game_) {}
+    : Game(kGameType, params), game_(MapParams()), encoder_(&game_) {
+  encodes_own_hand_ =
+      encoder_.Shape()[0] == EncodingLength(game_, /*own_hand=*/true);
+  if (!encodes_own_hand_) {
+    SPIEL_CHECK_EQ(encoder_.Shape()[0],
+                   EncodingLength(game_, /*own_hand=*/false));
+  }
+}
 
 int OpenSpielHanabiGame::NumDistinctActions() const { return game_.MaxMoves(); }
 
@@ -208,10 +413,20 @@ void OpenSpielHanabiState::ObservationTensor(
   SPIEL_CHECK_GE(player, 0);
   SPIEL_CHECK_LT(player, num_players_);
 
-  auto obs = game_->Encoder().Encode(
-      hanabi_learning_env::HanabiObservation(state_, player));
-  values->resize(obs.size());
-  for (int i = 0; i < obs.size(); ++i) values->at(i) = obs[i];
+  values->assign(game_->ObservationTensorSize(), 0.);
+  EncodeObservation(game_->HanabiGame(), state_, player,
+                    game_->EncodesOwnHand(), values->data());
+}
+
+void OpenSpielHanabiState::ObservationTensor(Player player,
+                                             absl::Span<float> values) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+  SPIEL_CHECK_EQ(values.size(), game_->ObservationTensorSize());
+
+  std::fill(values.begin(), values.end(), 0.f);
+  EncodeObservation(game_->HanabiGame(), state_, player,
+                    game_->EncodesOwnHand(), values.data());
 }
 
 std::unique_ptr<State> OpenSpielHanabiState::Clone() const {
@@ -241,5 +456,18 @@ OpenSpielHanabiState::OpenSpielHanabiState(std::shared_ptr<const Game> game)
       game_(static_cast<const OpenSpielHanabiGame*>(game.get())),
       prev_state_score_(0.) {}
 
+void ObservationTensors(const std::vector<const State*>& states,
+                        const std::vector<Player>& players,
+                        absl::Span<float> values) {
+  SPIEL_CHECK_EQ(states.size(), players.size());
+  if (states.empty()) return;
+  const int size = states[0]->GetGame()->ObservationTensorSize();
+  SPIEL_CHECK_EQ(values.size(), states.size() * size);
+  for (int i = 0; i < states.size(); ++i) {
+    static_cast<const OpenSpielHanabiState*>(states[i])->ObservationTensor(
+        players[i], values.subspan(i * size, size));
+  }
+}
+
 }  // namespace hanabi
 }  // namespace open_spiel
@@ -30,7 +30,9 @@
 // (TLDR: Set the environment variable BUILD_WITH_HANABI to ON).
 
 #include <memory>
+#include <vector>
 
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/spiel.h"
 #include "hanabi_lib/canonical_encoders.h"
 #include "hanabi_lib/hanabi_game.h"
@@ -58,10 +60,15 @@ class OpenSpielHanabiGame : public Game {
 
   const hanabi_learning_env::HanabiGame& HanabiGame() const { return game_; }
 
+  // Whether the encoder leaves room for the observer's own cards, as some
+  // versions of the environment do (they're only shown to seers).
+  bool EncodesOwnHand() const { return encodes_own_hand_; }
+
  private:
   std::unordered_map<std::string, std::string> MapParams() const;
   hanabi_learning_env::HanabiGame game_;
   hanabi_learning_env::CanonicalObservationEncoder encoder_;
+  bool encodes_own_hand_;
 };
 
 class OpenSpielHanabiState : public State {
@@ -81,11 +88,21 @@ class OpenSpielHanabiState : public State {
   void ObservationTensor(Player player,
                          std::vector<double>* values) const override;
 
+  // The same as ObservationTensor, written to `values`, which must have
+  // ObservationTensorSize() entries. Like ObservationTensor, this encodes the
+  // state directly as the environment's CanonicalObservationEncoder would
+  // encode the player's HanabiObservation, without building one.
+  void ObservationTensor(Player player, absl::Span<float> values) const;
+
   std::unique_ptr<State> Clone() const override;
   ActionsAndProbs ChanceOutcomes() const override;
   std::string ToString() const override;
   bool IsTerminal() const override;
 
+  const hanabi_learning_env::HanabiState& HanabiState() const {
+    return state_;
+  }
+
  protected:
   void DoApplyAction(Action action) override;
 
@@ -95,6 +112,13 @@ class OpenSpielHanabiState : public State {
   double prev_state_score_;
 };
 
+// Writes the observation tensors of many states, for training on batches of
+// them: the tensor of states[i] for players[i] goes in the i-th row of
+// ObservationTensorSize() entries of `values`.
+void ObservationTensors(const std::vector<const State*>& states,
+                        const std::vector<Player>& players,
+                        absl::Span<float> values);
+
 }  // namespace hanabi
 }  // namespace open_spiel
 
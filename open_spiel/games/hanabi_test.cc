@@ -14,6 +14,12 @@
 
 #include "open_spiel/games/hanabi.h"
 
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/game_parameters.h"
 #include "open_spiel/spiel_utils.h"
 #include "open_spiel/tests/basic_tests.h"
@@ -34,8 +40,75 @@ void BasicHanabiTests() {
   }
 }
 
+// The tensors should be exactly the canonical encoder's, for every player.
+void ObservationTensorMatchesEncoderTest(int players,
+                                         const std::string& observation_type) {
+  std::shared_ptr<const Game> game = LoadGame(
+      "hanabi", {{"players", GameParameter(players)},
+                 {"observation_type", GameParameter(observation_type)}});
+  const auto& hanabi_game = static_cast<const OpenSpielHanabiGame&>(*game);
+  std::mt19937 rng(7);
+  for (int i = 0; i < 10; ++i) {
+    std::unique_ptr<State> state = game->NewInitialState();
+    while (true) {
+      const auto& hanabi_state =
+          static_cast<const OpenSpielHanabiState&>(*state);
+      std::vector<float> values(game->ObservationTensorSize());
+      for (Player p = 0; p < players; ++p) {
+        std::vector<int> expected = hanabi_game.Encoder().Encode(
+            hanabi_learning_env::HanabiObservation(hanabi_state.HanabiState(),
+                                                   p));
+        hanabi_state.ObservationTensor(p, absl::MakeSpan(values));
+        SPIEL_CHECK_EQ(std::vector<float>(expected.begin(), expected.end()),
+                       values);
+        SPIEL_CHECK_EQ(std::vector<double>(expected.begin(), expected.end()),
+                       state->ObservationTensor(p));
+      }
+      if (state->IsTerminal()) break;
+      std::vector<Action> actions = state->LegalActions();
+      state->ApplyAction(actions[rng() % actions.size()]);
+    }
+  }
+}
+
+void ObservationTensorsTest() {
+  std::shared_ptr<const Game> game =
+      LoadGame("hanabi", {{"players", GameParameter(5)}});
+  std::mt19937 rng(7);
+  std::vector<std::unique_ptr<State>> states;
+  std::vector<const State*> batch;
+  std::vector<Player> players;
+  for (int i = 0; i < 8; ++i) {
+    states.push_back(game->NewInitialState());
+    for (int j = 0; j < 10 * i && !states.back()->IsTerminal(); ++j) {
+      std::vector<Action> actions = states.back()->LegalActions();
+      states.back()->ApplyAction(actions[rng() % actions.size()]);
+    }
+    batch.push_back(states.back().get());
+    players.push_back(i % 5);
+  }
+  const int size = game->ObservationTensorSize();
+  std::vector<float> values(batch.size() * size);
+  ObservationTensors(batch, players, absl::MakeSpan(values));
+  for (int i = 0; i < batch.size(); ++i) {
+    std::vector<double> expected = batch[i]->ObservationTensor(players[i]);
+    SPIEL_CHECK_EQ(std::vector<float>(expected.begin(), expected.end()),
+                   std::vector<float>(values.begin() + i * size,
+                                      values.begin() + (i + 1) * size));
+  }
+}
+
 }  // namespace
 }  // namespace hanabi
 }  // namespace open_spiel
 
-int main(int argc, char **argv) { open_spiel::hanabi::BasicHanabiTests(); }
+int main(int argc, char **argv) {
+  open_spiel::hanabi::BasicHanabiTests();
+  for (int players = 2; players <= 5; ++players) {
+    for (const char* observation_type : {"minimal", "card_knowledge", "seer"}) {
+      open_spiel::hanabi::ObservationTensorMatchesEncoderTest(players,
+                                                              observation_type);
+    }
+  }
+  open_spiel::hanabi::ObservationTensorsTest();
+}
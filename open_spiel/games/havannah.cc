@@ -107,6 +107,14 @@ constexpr int kBitsSetTable64[] = {
     3, 4, 4, 5, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
 };
 
+// How many edges and corners a group with these features is connected to.
+int NumEdges(connection::ConnectionGroups::Features features) {
+  return kBitsSetTable64[features & 0x3f];
+}
+int NumCorners(connection::ConnectionGroups::Features features) {
+  return kBitsSetTable64[features >> 6];
+}
+
 }  // namespace
 
 int Move::Corner(int board_size) const {
@@ -147,12 +155,10 @@ std::string Move::ToString() const {
   return absl::StrCat(std::string(1, static_cast<char>('a' + x)), y + 1);
 }
 
-int HavannahState::Cell::NumCorners() const { return kBitsSetTable64[corner]; }
-int HavannahState::Cell::NumEdges() const { return kBitsSetTable64[edge]; }
-
 HavannahState::HavannahState(std::shared_ptr<const Game> game, int board_size,
                              bool ansi_color_output)
     : State(game),
+      groups_((board_size * 2 - 1) * (board_size * 2 - 1)),
       board_size_(board_size),
       board_diameter_(board_size * 2 - 1),
       valid_cells_((board_size * 2 - 1) * (board_size * 2 - 1) -
@@ -162,8 +168,8 @@ HavannahState::HavannahState(std::shared_ptr<const Game> game, int board_size,
   board_.resize(board_diameter_ * board_diameter_);
   for (int i = 0; i < board_.size(); i++) {
     Move m = ActionToMove(i);
-    board_[i] = Cell((m.OnBoard() ? kPlayerNone : kPlayerInvalid), i,
-                     m.Corner(board_size), m.Edge(board_size));
+    board_[i] = Cell(m.OnBoard() ? kPlayerNone : kPlayerInvalid);
+    groups_.Reset(i, m.Edge(board_size) | m.Corner(board_size) << 6);
   }
 }
 
@@ -329,7 +335,7 @@ void HavannahState::DoApplyAction(Action action) {
       skip = false;
     } else if (m.OnBoard()) {
       if (current_player_ == board_[m.xy].player) {
-        alreadyjoined |= JoinGroups(move.xy, m.xy);
+        alreadyjoined |= groups_.Join(move.xy, m.xy);
 
         // Skip the next one. If it is the same group, it is already connected
         // and forms a sharp corner, which we can ignore.
@@ -338,8 +344,9 @@ void HavannahState::DoApplyAction(Action action) {
     }
   }
 
-  const Cell& group = board_[FindGroupLeader(move.xy)];
-  if (group.NumEdges() >= 3 || group.NumCorners() >= 2 ||
+  connection::ConnectionGroups::Features group =
+      groups_.GroupFeatures(move.xy);
+  if (NumEdges(group) >= 3 || NumCorners(group) >= 2 ||
       (alreadyjoined && CheckRingDFS(move, 0, 3))) {
     outcome_ = current_player_;
   } else if (moves_made_ == valid_cells_) {
@@ -349,39 +356,6 @@ void HavannahState::DoApplyAction(Action action) {
   current_player_ = (current_player_ == kPlayer1 ? kPlayer2 : kPlayer1);
 }
 
-int HavannahState::FindGroupLeader(int cell) {
-  int parent = board_[cell].parent;
-  if (parent != cell) {
-    do {  // Follow the parent chain up to the group leader.
-      parent = board_[parent].parent;
-    } while (parent != board_[parent].parent);
-    // Do path compression, but only the current one to avoid recursion.
-    board_[cell].parent = parent;
-  }
-  return parent;
-}
-
-bool HavannahState::JoinGroups(int cell_a, int cell_b) {
-  int leader_a = FindGroupLeader(cell_a);
-  int leader_b = FindGroupLeader(cell_b);
-
-  if (leader_a == leader_b)  // Already the same group.
-    return true;
-
-  if (board_[leader_a].size < board_[leader_b].size) {
-    // Force group a's subtree to be bigger.
-    std::swap(leader_a, leader_b);
-  }
-
-  // Group b joins group a.
-  board_[leader_b].parent = leader_a;
-  board_[leader_a].size += board_[leader_b].size;
-  board_[leader_a].corner |= board_[leader_b].corner;
-  board_[leader_a].edge |= board_[leader_b].edge;
-
-  return false;
-}
-
 bool HavannahState::CheckRingDFS(const Move& move, int left, int right) {
   if (!move.OnBoard()) return false;
 
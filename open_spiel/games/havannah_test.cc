@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdint>
+
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
 #include "open_spiel/tests/basic_tests.h"
@@ -42,8 +44,23 @@ void BasicHavannahTests() {
       *LoadGame("havannah(board_size=5,ansi_color_output=True)"), 3);
 }
 
+// Plays random games and hashes their lengths and results, to check they
+// stay the same as before the groups were kept in ConnectionGroups.
+void RandomGamesOutcomeTest() {
+  const uint64_t hash = testing::RandomGamesHash(
+      *LoadGame("havannah(board_size=8)"), 100, /*seed=*/7, /*hash_state=*/nullptr,
+      [](const State& state, testing::SequenceHash* hash) {
+        hash->Mix(state.History().size());
+        hash->Mix(state.Returns()[0] + 1);
+      });
+  SPIEL_CHECK_EQ(hash, 9716139736604843970ull);
+}
+
 }  // namespace
 }  // namespace havannah
 }  // namespace open_spiel
 
-int main(int argc, char** argv) { open_spiel::havannah::BasicHavannahTests(); }
+int main(int argc, char** argv) {
+  open_spiel::havannah::BasicHavannahTests();
+  open_spiel::havannah::RandomGamesOutcomeTest();
+}
@@ -50,8 +50,52 @@ std::shared_ptr<const Game> Factory(const GameParameters& params) {
 
 REGISTER_SPIEL_GAME(kGameType, Factory);
 
+constexpr connection::ConnectionGroups::Features kBothEdges = 3;
+
+// The state of a stone of the player connected to the given edges.
+CellState ConnectedState(Player player,
+                         connection::ConnectionGroups::Features edges) {
+  switch (player) {
+    case 0:
+      return edges == kBothEdges ? CellState::kBlackWin
+             : edges == 1        ? CellState::kBlackNorth
+             : edges == 2        ? CellState::kBlackSouth
+                                 : CellState::kBlack;
+    case 1:
+      return edges == kBothEdges ? CellState::kWhiteWin
+             : edges == 1        ? CellState::kWhiteWest
+             : edges == 2        ? CellState::kWhiteEast
+                                 : CellState::kWhite;
+    default:
+      SpielFatalError(absl::StrCat("Invalid player id ", player));
+      return CellState::kEmpty;
+  }
+}
+
+CellState PlayerStone(Player player) {
+  return player == 0 ? CellState::kBlack : CellState::kWhite;
+}
+
 }  // namespace
 
+connection::ConnectionGroups::Features HexState::EdgesAt(Player player,
+                                                         int cell) const {
+  if (player == 0) {
+    if (cell < board_size_) {  // First row
+      return 1;
+    } else if (cell >= board_size_ * (board_size_ - 1)) {  // Last row
+      return 2;
+    }
+  } else {
+    if (cell % board_size_ == 0) {  // First column
+      return 1;
+    } else if (cell % board_size_ == board_size_ - 1) {  // Last column
+      return 2;
+    }
+  }
+  return 0;
+}
+
 CellState HexState::PlayerAndActionToState(Player player, Action move) const {
   // This function returns the CellState resulting from the given move.
   // The cell state tells us:
@@ -63,61 +107,25 @@ CellState HexState::PlayerAndActionToState(Player player, Action move) const {
   // We know the colour from the argument player
   // For connectedness to the edges, we check if the move is in first/last
   // row/column, or if any of the neighbours are the same colour and connected.
-  switch (player) {
-    case 0: {
-      bool north_connected = false;
-      bool south_connected = false;
-      if (move < board_size_) {  // First row
-        north_connected = true;
-      } else if (move >= board_size_ * (board_size_ - 1)) {  // Last row
-        south_connected = true;
-      }
-      for (int neighbour : AdjacentCells(move)) {
-        if (board_[neighbour] == CellState::kBlackNorth) {
-          north_connected = true;
-        } else if (board_[neighbour] == CellState::kBlackSouth) {
-          south_connected = true;
-        }
-      }
-      if (north_connected && south_connected) {
-        return CellState::kBlackWin;
-      } else if (north_connected) {
-        return CellState::kBlackNorth;
-      } else if (south_connected) {
-        return CellState::kBlackSouth;
-      } else {
-        return CellState::kBlack;
-      }
-    }
-    case 1: {
-      bool west_connected = false;
-      bool east_connected = false;
-      if (move % board_size_ == 0) {  // First column
-        west_connected = true;
-      } else if (move % board_size_ == board_size_ - 1) {  // Last column
-        east_connected = true;
-      }
-      for (int neighbour : AdjacentCells(move)) {
-        if (board_[neighbour] == CellState::kWhiteWest) {
-          west_connected = true;
-        } else if (board_[neighbour] == CellState::kWhiteEast) {
-          east_connected = true;
-        }
-      }
-      if (west_connected && east_connected) {
-        return CellState::kWhiteWin;
-      } else if (west_connected) {
-        return CellState::kWhiteWest;
-      } else if (east_connected) {
-        return CellState::kWhiteEast;
-      } else {
-        return CellState::kWhite;
-      }
+  connection::ConnectionGroups::Features edges = EdgesAt(player, move);
+  std::array<int, kMaxNeighbours> neighbours;
+  int num_neighbours = AdjacentCells(move, &neighbours);
+  for (int i = 0; i < num_neighbours; ++i) {
+    if (board_[neighbours[i]] == PlayerStone(player)) {
+      edges |= groups_.GroupFeatures(neighbours[i]);
     }
-    default:
-      SpielFatalError(absl::StrCat("Invalid player id ", player));
-      return CellState::kEmpty;
   }
+  return ConnectedState(player, edges);
+}
+
+CellState HexState::BoardAt(int cell) const {
+  CellState state = board_[cell];
+  if (state == CellState::kBlack) {
+    return ConnectedState(0, groups_.GroupFeatures(cell));
+  } else if (state == CellState::kWhite) {
+    return ConnectedState(1, groups_.GroupFeatures(cell));
+  }
+  return state;
 }
 
 std::string StateToString(CellState state) {
@@ -149,35 +157,25 @@ std::string StateToString(CellState state) {
 void HexState::DoApplyAction(Action move) {
   SPIEL_CHECK_EQ(board_[move], CellState::kEmpty);
   CellState move_cell_state = PlayerAndActionToState(CurrentPlayer(), move);
-  board_[move] = move_cell_state;
 
   if (move_cell_state == CellState::kBlackWin) {
+    board_[move] = move_cell_state;
     result_black_perspective_ = 1;
   } else if (move_cell_state == CellState::kWhiteWin) {
+    board_[move] = move_cell_state;
     result_black_perspective_ = -1;
-  } else if (move_cell_state != CellState::kBlack &&
-             move_cell_state != CellState::kWhite) {
-    // Move is connected to an edge but not winning.
-    // Update edge-connected groups with a flood-fill, to maintain that all edge
-    // connected nodes are known about.
-    // We don't do flood fill if a player has won, so it's impossible for a cell
-    // connected to an edge to be changed by the flood-fill.
-    CellState cell_state_to_change =
-        (current_player_ == 0 ? CellState::kBlack : CellState::kWhite);
-    // We assume that move can safely be cast to int
-    std::vector<int> flood_stack = {static_cast<int>(move)};
-    int latest_cell;
-    while (!flood_stack.empty()) {
-      latest_cell = flood_stack.back();
-      flood_stack.pop_back();
-      for (int neighbour : AdjacentCells(latest_cell)) {
-        if (board_[neighbour] == cell_state_to_change) {
-          // We make the change before putting the cell on the queue to avoid
-          // putting the same cell on the queue multiple times
-          board_[neighbour] = move_cell_state;
-          flood_stack.push_back(neighbour);
-        }
-      }
+  } else {
+    // Join the stone to the groups of its neighbours of the same colour,
+    // which connects all of them to the edges any of them were connected to.
+    // This isn't done for the winning stone, so the stones around it keep
+    // showing the edge they were connected to before.
+    CellState stone = PlayerStone(current_player_);
+    board_[move] = stone;
+    groups_.Reset(move, EdgesAt(current_player_, move));
+    std::array<int, kMaxNeighbours> neighbours;
+    int num_neighbours = AdjacentCells(move, &neighbours);
+    for (int i = 0; i < num_neighbours; ++i) {
+      if (board_[neighbours[i]] == stone) groups_.Join(move, neighbours[i]);
     }
   }
   current_player_ = 1 - current_player_;
@@ -187,6 +185,8 @@ std::vector<Action> HexState::LegalActions() const {
   // Can move in any empty cell.
   std::vector<Action> moves;
   if (IsTerminal()) return moves;
+  // Every move fills a cell.
+  moves.reserve(board_.size() - history_.size());
   for (int cell = 0; cell < board_.size(); ++cell) {
     if (board_[cell] == CellState::kEmpty) {
       moves.push_back(cell);
@@ -203,28 +203,30 @@ std::string HexState::ActionToString(Player player, Action action_id) const {
                       action_id / board_size_, ")");
 }
 
-std::vector<int> HexState::AdjacentCells(int cell) const {
-  std::vector<int> neighbours = {
-      cell - board_size_, cell - board_size_ + 1, cell - 1,
-      cell + 1,           cell + board_size_ - 1, cell + board_size_};
-  for (int i = kMaxNeighbours - 1; i >= 0; i--) {
-    // Check for invalid neighbours and remove
-    // Iterating in reverse to avoid changing the index of a candidate neighbour
-    if (neighbours[i] < 0 || (neighbours[i] >= board_size_ * board_size_) ||
-        (neighbours[i] % board_size_ == 0 &&
+int HexState::AdjacentCells(
+    int cell, std::array<int, kMaxNeighbours>* neighbours) const {
+  int num_neighbours = 0;
+  for (int neighbour :
+       {cell - board_size_, cell - board_size_ + 1, cell - 1, cell + 1,
+        cell + board_size_ - 1, cell + board_size_}) {
+    // Skip neighbours off the board, or wrapped around to the other side.
+    if (neighbour < 0 || (neighbour >= board_size_ * board_size_) ||
+        (neighbour % board_size_ == 0 &&
          cell % board_size_ == board_size_ - 1) ||
-        (neighbours[i] % board_size_ == board_size_ - 1 &&
+        (neighbour % board_size_ == board_size_ - 1 &&
          cell % board_size_ == 0)) {
-      neighbours.erase(neighbours.begin() + i);
+      continue;
     }
+    (*neighbours)[num_neighbours++] = neighbour;
   }
-  return neighbours;
+  return num_neighbours;
 }
 
 HexState::HexState(std::shared_ptr<const Game> game, int board_size)
-    : State(game), board_size_(board_size) {
-  board_.resize(board_size * board_size, CellState::kEmpty);
-}
+    : State(game),
+      board_(board_size * board_size, CellState::kEmpty),
+      board_size_(board_size),
+      groups_(board_size * board_size) {}
 
 std::string HexState::ToString() const {
   std::string str;
@@ -239,7 +241,7 @@ std::string HexState::ToString() const {
       line_num++;
       absl::StrAppend(&str, std::string(line_num, ' '));
     }
-    absl::StrAppend(&str, StateToString(board_[cell]));
+    absl::StrAppend(&str, StateToString(BoardAt(cell)));
     absl::StrAppend(&str, " ");
   }
   return str;
@@ -272,7 +274,7 @@ void HexState::ObservationTensor(Player player,
   TensorView<2> view(values, {kCellStates, static_cast<int>(board_.size())},
                      true);
   for (int cell = 0; cell < board_.size(); ++cell) {
-    view[{static_cast<int>(board_[cell]) - kMinValueCellState, cell}] = 1.0;
+    view[{static_cast<int>(BoardAt(cell)) - kMinValueCellState, cell}] = 1.0;
   }
 }
 
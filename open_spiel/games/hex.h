@@ -21,6 +21,7 @@
 #include <string>
 #include <vector>
 
+#include "open_spiel/games/connection/connection_groups.h"
 #include "open_spiel/spiel.h"
 
 // The classic game of Hex: https://en.wikipedia.org/wiki/Hex_(board_game)
@@ -80,18 +81,30 @@ class HexState : public State {
                          std::vector<double>* values) const override;
   std::unique_ptr<State> Clone() const override;
   std::vector<Action> LegalActions() const override;
-  CellState BoardAt(int cell) const { return board_[cell]; }
+  CellState BoardAt(int cell) const;
 
  protected:
+  // The colour of the stone in each cell, kBlack or kWhite, or kBlackWin or
+  // kWhiteWin for the winning stone. Which edges the others are connected to
+  // is kept in groups_.
   std::vector<CellState> board_;
   void DoApplyAction(Action move) override;
 
  private:
   CellState PlayerAndActionToState(Player player, Action move) const;
-  Player current_player_ = 0;                      // Player zero goes first
-  double result_black_perspective_ = 0;            // 1 if Black (player 0) wins
-  std::vector<int> AdjacentCells(int cell) const;  // Cells adjacent to cell
+  // The edges a stone of the player in this cell is on, as a bitmask of the
+  // player's two edges: north or west is 1, south or east is 2.
+  connection::ConnectionGroups::Features EdgesAt(Player player,
+                                                 int cell) const;
+  // Writes the cells adjacent to cell to `neighbours`, returning how many.
+  int AdjacentCells(int cell,
+                    std::array<int, kMaxNeighbours>* neighbours) const;
+  Player current_player_ = 0;            // Player zero goes first
+  double result_black_perspective_ = 0;  // 1 if Black (player 0) wins
   const int board_size_;
+  // The groups of connected stones, each with the edges it is connected to.
+  // The winning stone isn't joined to its neighbours.
+  connection::ConnectionGroups groups_;
 };
 
 // Game object.
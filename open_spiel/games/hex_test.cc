@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdint>
+
 #include "open_spiel/spiel.h"
 #include "open_spiel/tests/basic_tests.h"
 
@@ -28,8 +30,30 @@ void BasicHexTests() {
   testing::RandomSimTest(*LoadGame("hex"), 5);
 }
 
+// Plays random games and hashes the observations, which show the edges each
+// stone is connected to, and the results, to check they stay the same as when
+// the connections were found with a flood fill.
+void MatchesFloodFillTest() {
+  const uint64_t hash = testing::RandomGamesHash(
+      *LoadGame("hex(board_size=5)"), 100, /*seed=*/7,
+      [](const State& state, testing::SequenceHash* hash) {
+        // Each observation is hashed after the move that led to it.
+        if (state.History().empty()) return;
+        for (float value : state.ObservationTensor(0)) hash->Mix(value);
+      },
+      [](const State& state, testing::SequenceHash* hash) {
+        for (float value : state.ObservationTensor(0)) hash->Mix(value);
+        hash->Mix(state.History().size());
+        hash->Mix(state.Returns()[0] + 1);
+      });
+  SPIEL_CHECK_EQ(hash, 2714926975721443937ull);
+}
+
 }  // namespace
 }  // namespace hex
 }  // namespace open_spiel
 
-int main(int argc, char** argv) { open_spiel::hex::BasicHexTests(); }
+int main(int argc, char** argv) {
+  open_spiel::hex::BasicHexTests();
+  open_spiel::hex::MatchesFloodFillTest();
+}
@@ -179,6 +179,26 @@ std::string KuhnState::InformationStateString(Player player) const {
   return str;
 }
 
+// The same information as the string: 0 before our card is dealt, otherwise
+// 1 + our card * number of betting sequences + the index of the sequence. The
+// sequences of each length follow all the shorter ones, and among themselves
+// are ordered by their bets read as a binary number.
+int64_t KuhnState::InformationStateIndex(Player player) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+
+  if (history_.size() <= player) return 0;
+  int64_t bets = 0;
+  int length = 0;
+  for (int i = num_players_; i < history_.size(); ++i, ++length) {
+    bets |= history_[i] << length;
+  }
+  const int max_length = game_->MaxGameLength();
+  const int64_t num_sequences = (int64_t{1} << (max_length + 1)) - 1;
+  const int64_t sequence = (int64_t{1} << length) - 1 + bets;
+  return 1 + history_[player] * num_sequences + sequence;
+}
+
 // Observation is card then contributions to the pot, e.g. 111
 std::string KuhnState::ObservationString(Player player) const {
   SPIEL_CHECK_GE(player, 0);
@@ -342,6 +362,11 @@ double KuhnGame::MaxUtility() const {
   return (num_players_ - 1) * 2;
 }
 
+int64_t KuhnGame::NumInformationStateIndices() const {
+  const int64_t num_sequences = (int64_t{1} << (MaxGameLength() + 1)) - 1;
+  return 1 + (num_players_ + 1) * num_sequences;
+}
+
 double KuhnGame::MinUtility() const {
   // In poker, the utility is defined as the money a player has at the end
   // of the game minus then money the player had before starting the game.
@@ -56,6 +56,7 @@ class KuhnState : public State {
   bool IsTerminal() const override;
   std::vector<double> Returns() const override;
   std::string InformationStateString(Player player) const override;
+  int64_t InformationStateIndex(Player player) const override;
   std::string ObservationString(Player player) const override;
   void InformationStateTensor(Player player,
                               std::vector<double>* values) const override;
@@ -106,6 +107,7 @@ class KuhnGame : public Game {
   std::vector<int> InformationStateTensorShape() const override;
   std::vector<int> ObservationTensorShape() const override;
   int MaxGameLength() const override { return num_players_ * 2 - 1; }
+  int64_t NumInformationStateIndices() const override;
 
  private:
   // Number of players.
@@ -32,6 +32,9 @@ void BasicKuhnTests() {
     testing::RandomSimTest(
         *LoadGame("kuhn_poker", {{"players", GameParameter(players)}}), 100);
   }
+  testing::CheckInformationStateIndices(*LoadGame("kuhn_poker"));
+  testing::CheckInformationStateIndices(
+      *LoadGame("kuhn_poker", {{"players", GameParameter(3)}}));
 }
 
 void CountStates() {
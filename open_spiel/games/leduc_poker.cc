@@ -16,6 +16,8 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
+#include <limits>
 #include <numeric>
 #include <utility>
 
@@ -52,6 +54,21 @@ std::shared_ptr<const Game> Factory(const GameParameters& params) {
 
 REGISTER_SPIEL_GAME(kGameType, Factory);
 
+// The position of a round's betting sequence among all sequences of folds,
+// calls and raises: the sequences of each length follow all the shorter ones,
+// and among themselves are ordered by their actions read as a base 3 number.
+int64_t SequenceIndex(const std::vector<int>& sequence) {
+  int64_t num_shorter = 0;
+  int64_t num_of_length = 1;
+  int64_t value = 0;
+  for (int action : sequence) {
+    num_shorter += num_of_length;
+    num_of_length *= 3;
+    value = value * 3 + action;
+  }
+  return num_shorter + value;
+}
+
 }  // namespace
 LeducState::LeducState(std::shared_ptr<const Game> game)
     : State(game),
@@ -277,6 +294,32 @@ std::string LeducState::InformationStateString(Player player) const {
       public_card_, absl::StrJoin(round2_sequence_, " "));
 }
 
+// The same information as the string, as the digits of a mixed radix number:
+// our card, if dealt, and whether all the private cards have been dealt, the
+// first round's betting, the public card, if dealt, the second round's
+// betting and, once the game is over, the set of winners. The rest of the
+// string follows from those.
+int64_t LeducState::InformationStateIndex(Player player) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+  const auto& game = static_cast<const LeducGame&>(*game_);
+  SPIEL_CHECK_GT(game.NumInformationStateIndices(), 0);
+
+  int64_t index = private_cards_[player] == kInvalidCard
+                      ? 0
+                      : 1 + 2 * private_cards_[player] +
+                            (private_cards_dealt_ == num_players_);
+  index = index * game.NumRoundSequences() + SequenceIndex(round1_sequence_);
+  index = index * (game.MaxChanceOutcomes() + 1) +
+          (public_card_ == kInvalidCard ? 0 : 1 + public_card_);
+  index = index * game.NumRoundSequences() + SequenceIndex(round2_sequence_);
+  int winners = 0;
+  if (IsTerminal()) {
+    for (Player p = 0; p < num_players_; ++p) winners |= winner_[p] << p;
+  }
+  return (index << num_players_) | winners;
+}
+
 // Observation is card then contribution of each players to the pot.
 std::string LeducState::ObservationString(Player player) const {
   SPIEL_CHECK_GE(player, 0);
@@ -591,6 +634,21 @@ LeducGame::LeducGame(const GameParameters& params)
       total_cards_((num_players_ + 1) * kNumSuits) {
   SPIEL_CHECK_GE(num_players_, kGameType.min_num_players);
   SPIEL_CHECK_LE(num_players_, kGameType.max_num_players);
+
+  num_round_sequences_ = 0;
+  for (int length = 0, num_of_length = 1; length <= MaxGameLength() / 2;
+       ++length) {
+    num_round_sequences_ += num_of_length;
+    num_of_length *= 3;
+  }
+  // The radixes of LeducState::InformationStateIndex.
+  const double num_indices = (1. + 2 * total_cards_) * num_round_sequences_ *
+                             (total_cards_ + 1) * num_round_sequences_ *
+                             (1 << num_players_);
+  num_information_state_indices_ =
+      num_indices < std::numeric_limits<int64_t>::max()
+          ? static_cast<int64_t>(num_indices)
+          : 0;
 }
 
 std::unique_ptr<State> LeducGame::NewInitialState() const {
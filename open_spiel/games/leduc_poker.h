@@ -69,6 +69,7 @@ class LeducState : public State {
   bool IsTerminal() const override;
   std::vector<double> Returns() const override;
   std::string InformationStateString(Player player) const override;
+  int64_t InformationStateIndex(Player player) const override;
   std::string ObservationString(Player player) const override;
   void InformationStateTensor(Player player,
                               std::vector<double>* values) const override;
@@ -175,10 +176,18 @@ class LeducGame : public Game {
     // = 2 raises + (num_players_-1)*2 calls + (num_players_-2) calls
     return 2 * (2 + (num_players_ - 1) * 2 + (num_players_ - 2));
   }
+  // Zero from 6 players, for which the indices don't fit in 64 bits.
+  int64_t NumInformationStateIndices() const override {
+    return num_information_state_indices_;
+  }
+  // The number of betting sequences a round could have, for indexing them.
+  int64_t NumRoundSequences() const { return num_round_sequences_; }
 
  private:
   int num_players_;  // Number of players.
   int total_cards_;  // Number of cards total cards in the game.
+  int64_t num_round_sequences_;
+  int64_t num_information_state_indices_;
 };
 
 }  // namespace leduc_poker
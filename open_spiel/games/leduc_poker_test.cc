@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
 #include "open_spiel/tests/basic_tests.h"
 
 namespace open_spiel {
@@ -30,6 +31,12 @@ void BasicLeducTests() {
         *LoadGame("leduc_poker", {{"players", GameParameter(players)}}), 100);
   }
   testing::ResampleInfostateTest(*LoadGame("leduc_poker"), /*num_sims=*/100);
+  testing::CheckInformationStateIndices(*LoadGame("leduc_poker"));
+  // Too many indices for 64 bits.
+  SPIEL_CHECK_EQ(
+      LoadGame("leduc_poker", {{"players", GameParameter(10)}})
+          ->NumInformationStateIndices(),
+      0);
 }
 
 }  // namespace
@@ -16,6 +16,8 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
+#include <limits>
 #include <utility>
 
 #include "open_spiel/game_parameters.h"
@@ -234,6 +236,24 @@ std::string LiarsDiceState::InformationStateString(Player player) const {
   return result;
 }
 
+// The same information as the string: our dice, as base 7 digits with 0 for
+// a die not yet rolled, followed by the set of bids made, as a bit for each.
+int64_t LiarsDiceState::InformationStateIndex(Player player) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+  SPIEL_CHECK_GT(game_->NumInformationStateIndices(), 0);
+
+  int64_t index = 0;
+  for (int outcome : dice_outcomes_[player]) {
+    index = index * (kDiceSides + 1) +
+            (outcome == kInvalidOutcome ? 0 : outcome);
+  }
+  // The bids only ever go up, so the set determines their order.
+  int64_t bids = 0;
+  for (int bid : bidseq_) bids |= int64_t{1} << bid;
+  return (index << game_->NumDistinctActions()) | bids;
+}
+
 std::string LiarsDiceState::ToString() const {
   std::string result = "";
 
@@ -412,6 +432,21 @@ std::unique_ptr<State> LiarsDiceGame::NewInitialState() const {
 
 int LiarsDiceGame::MaxChanceOutcomes() const { return kDiceSides; }
 
+int64_t LiarsDiceGame::NumInformationStateIndices() const {
+  const int num_bid_bits = NumDistinctActions();
+  if (num_bid_bits >= 63) return 0;
+  // What's left for the dice, as LiarsDiceState::InformationStateIndex
+  // shifts them past the bids.
+  const int64_t max_dice_indices =
+      std::numeric_limits<int64_t>::max() >> num_bid_bits;
+  int64_t num_dice_indices = 1;
+  for (int d = 0; d < max_dice_per_player_; ++d) {
+    if (num_dice_indices > max_dice_indices / (kDiceSides + 1)) return 0;
+    num_dice_indices *= kDiceSides + 1;
+  }
+  return num_dice_indices << num_bid_bits;
+}
+
 int LiarsDiceGame::MaxGameLength() const {
   // A bet for each side and number of total dice, plus "liar" action.
   return total_num_dice_ * kDiceSides + 1;
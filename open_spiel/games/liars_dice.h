@@ -51,6 +51,7 @@ class LiarsDiceState : public State {
   bool IsTerminal() const override;
   std::vector<double> Returns() const override;
   std::string InformationStateString(Player player) const override;
+  int64_t InformationStateIndex(Player player) const override;
   void InformationStateTensor(
       Player player, std::vector<double>* values) const override;
   void ObservationTensor(
@@ -103,6 +104,8 @@ class LiarsDiceGame : public Game {
   std::vector<int> InformationStateTensorShape() const override;
   std::vector<int> ObservationTensorShape() const override;
   int MaxGameLength() const override;
+  // Zero when the bids are too many to index in 64 bits.
+  int64_t NumInformationStateIndices() const override;
 
   // Returns the maximum among how many dice each player has. For example,
   // if player 1 has 3 dice and player 2 has 2 dice, returns 3.
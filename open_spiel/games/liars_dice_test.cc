@@ -25,6 +25,7 @@ void BasicLiarsDiceTests() {
   testing::LoadGameTest("liars_dice");
   testing::ChanceOutcomesTest(*LoadGame("liars_dice"));
   testing::RandomSimTest(*LoadGame("liars_dice"), 100);
+  testing::CheckInformationStateIndices(*LoadGame("liars_dice"));
 }
 
 }  // namespace
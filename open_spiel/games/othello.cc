@@ -15,11 +15,13 @@
 #include "open_spiel/games/othello.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <tuple>
 #include <utility>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/numeric/bits.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
 #include "open_spiel/utils/tensor_view.h"
@@ -96,92 +98,78 @@ inline std::string ColumnString(int col) {
 
 }  // namespace
 
-std::pair<int, int> GetNext(int row, int col, Direction dir) {
+// All cells but those of the first and the last column.
+constexpr uint64_t kNotFirstColumn = ~uint64_t{0x0101010101010101};
+constexpr uint64_t kNotLastColumn = ~uint64_t{0x8080808080808080};
+
+// Moves every disk one cell in the given direction, dropping those that would
+// leave the board.
+uint64_t Shift(uint64_t disks, Direction dir) {
   switch (dir) {
     case Direction::kUp:
-      return std::make_pair(row - 1, col);
+      return disks >> kNumCols;
     case Direction::kDown:
-      return std::make_pair(row + 1, col);
+      return disks << kNumCols;
     case Direction::kLeft:
-      return std::make_pair(row, col - 1);
+      return (disks >> 1) & kNotLastColumn;
     case Direction::kRight:
-      return std::make_pair(row, col + 1);
+      return (disks << 1) & kNotFirstColumn;
     case Direction::kUpRight:
-      return std::make_pair(row - 1, col + 1);
+      return (disks >> (kNumCols - 1)) & kNotFirstColumn;
     case Direction::kUpLeft:
-      return std::make_pair(row - 1, col - 1);
+      return (disks >> (kNumCols + 1)) & kNotLastColumn;
     case Direction::kDownRight:
-      return std::make_pair(row + 1, col + 1);
+      return (disks << (kNumCols + 1)) & kNotFirstColumn;
     case Direction::kDownLeft:
-      return std::make_pair(row + 1, col - 1);
+      return (disks << (kNumCols - 1)) & kNotLastColumn;
     default:
-      SpielFatalError(absl::StrCat("Found unmatched case in GetNext."));
+      SpielFatalError(absl::StrCat("Found unmatched case in Shift."));
   }
 }
 
-inline bool OthelloState::OnBoard(int row, int col) const {
-  return (row >= 0) && (row < kNumRows) && (col >= 0) && (col < kNumCols);
+CellState OthelloState::BoardAt(int cell) const {
+  if (disks_[0] & (uint64_t{1} << cell)) return CellState::kBlack;
+  if (disks_[1] & (uint64_t{1} << cell)) return CellState::kWhite;
+  return CellState::kEmpty;
 }
 
-int OthelloState::CountSteps(Player player, int move, Direction dir) const {
-  int row, col;
-  std::tie(row, col) = RowColFromMove(move);
-  std::tie(row, col) = GetNext(row, col, dir);
-
-  int count = 0;
-  CellState cell = PlayerToState(player);
-  while (OnBoard(row, col)) {
-    if (BoardAt(row, col) == cell) {
-      return count;
-    } else if (BoardAt(row, col) == CellState::kEmpty) {
-      return 0;
-    }
-
-    count++;
-    std::tie(row, col) = GetNext(row, col, dir);
-  }
-
-  return 0;
-}
-
-bool OthelloState::CanCapture(Player player, int move) const {
-  if (board_[move] != CellState::kEmpty) return false;
-
+uint64_t OthelloState::LegalMoves(Player player) const {
+  const uint64_t own = disks_[player];
+  const uint64_t opponent = disks_[1 - player];
+  const uint64_t empty = ~(own | opponent);
+  uint64_t moves = 0;
   for (auto direction : kDirections) {
-    if (CountSteps(player, move, direction) != 0) {
-      return true;
-    }
+    // Opponent disks in a line from one of ours, then an empty cell beyond.
+    // A line can be at most 6 disks long.
+    uint64_t line = Shift(own, direction) & opponent;
+    for (int i = 0; i < 5; ++i) line |= Shift(line, direction) & opponent;
+    moves |= Shift(line, direction) & empty;
   }
-
-  return false;
+  return moves;
 }
 
-void OthelloState::Capture(Player player, int move, Direction dir, int steps) {
-  int row, col;
-
-  std::tie(row, col) = RowColFromMove(move);
-  std::tie(row, col) = GetNext(row, col, dir);
-
-  CellState cell = PlayerToState(player);
-  for (int step = 0; step < steps; step++) {
-    if (BoardAt(row, col) == CellState::kEmpty || BoardAt(row, col) == cell) {
-      SpielFatalError(
-          absl::StrCat("Cannot capture cell (", row, ", ", col, ")"));
+uint64_t OthelloState::Flips(Player player, int move) const {
+  const uint64_t own = disks_[player];
+  const uint64_t opponent = disks_[1 - player];
+  uint64_t flips = 0;
+  for (auto direction : kDirections) {
+    uint64_t line = 0;
+    uint64_t cell = Shift(uint64_t{1} << move, direction);
+    while (cell & opponent) {
+      line |= cell;
+      cell = Shift(cell, direction);
     }
-
-    board_[RowColToMove(row, col)] = cell;
-
-    std::tie(row, col) = GetNext(row, col, dir);
+    if (cell & own) flips |= line;
   }
+  return flips;
 }
 
 int OthelloState::DiskCount(Player player) const {
-  return absl::c_count(board_, PlayerToState(player));
+  return absl::popcount(disks_[player]);
 }
 
 bool OthelloState::NoValidActions() const {
-  return (LegalRegularActions(Player(0)).empty() &&
-          LegalRegularActions(Player(1)).empty());
+  return LegalMoves(Player(0)) == 0 && LegalMoves(Player(1)) == 0;
 }
 
 std::pair<int, int> OthelloState::RowColFromMove(int move) const {
@@ -199,7 +187,7 @@ int OthelloState::RowColToMove(int row, int col) const {
 }
 
 bool OthelloState::ValidAction(Player player, int move) const {
-  return (board_[move] == CellState::kEmpty && CanCapture(player, move));
+  return LegalMoves(player) & (uint64_t{1} << move);
 }
 
 void OthelloState::DoApplyAction(Action move) {
@@ -210,15 +198,9 @@ void OthelloState::DoApplyAction(Action move) {
 
   SPIEL_CHECK_TRUE(ValidAction(current_player_, move));
 
-  CellState cell = PlayerToState(current_player_);
-  board_[move] = cell;
-
-  for (auto direction : kDirections) {
-    int steps = CountSteps(current_player_, move, direction);
-    if (steps > 0) {
-      Capture(current_player_, move, direction, steps);
-    }
-  }
+  uint64_t flips = Flips(current_player_, move);
+  disks_[current_player_] |= flips | (uint64_t{1} << move);
+  disks_[1 - current_player_] &= ~flips;
 
   if (NoValidActions()) {  // check for end game state
     int count_zero = DiskCount(Player(0));
@@ -238,10 +220,8 @@ void OthelloState::DoApplyAction(Action move) {
 
 std::vector<Action> OthelloState::LegalRegularActions(Player p) const {
   std::vector<Action> moves;
-  for (int cell = 0; cell < kNumCells; ++cell) {
-    if (ValidAction(p, cell)) {
-      moves.push_back(cell);
-    }
+  for (uint64_t legal = LegalMoves(p); legal != 0; legal &= legal - 1) {
+    moves.push_back(absl::countr_zero(legal));
   }
   return moves;
 }
@@ -264,11 +244,10 @@ std::string OthelloState::ActionToString(Player player,
 }
 
 OthelloState::OthelloState(std::shared_ptr<const Game> game) : State(game) {
-  absl::c_fill(board_, CellState::kEmpty);
-  board_[RowColToMove(3, 3)] = CellState::kWhite;
-  board_[RowColToMove(3, 4)] = CellState::kBlack;
-  board_[RowColToMove(4, 3)] = CellState::kBlack;
-  board_[RowColToMove(4, 4)] = CellState::kWhite;
+  disks_[1] |= uint64_t{1} << RowColToMove(3, 3);
+  disks_[0] |= uint64_t{1} << RowColToMove(3, 4);
+  disks_[0] |= uint64_t{1} << RowColToMove(4, 3);
+  disks_[1] |= uint64_t{1} << RowColToMove(4, 4);
 }
 
 std::string OthelloState::ToString() const {
@@ -321,9 +300,9 @@ void OthelloState::ObservationTensor(Player player,
   TensorView<2> view(values, {kCellStates, kNumCells}, true);
 
   for (int cell = 0; cell < kNumCells; ++cell) {
-    if (board_[cell] == CellState::kEmpty) {
+    if (BoardAt(cell) == CellState::kEmpty) {
       view[{0, cell}] = 1;
-    } else if (board_[cell] == PlayerToState(player)) {
+    } else if (BoardAt(cell) == PlayerToState(player)) {
       view[{1, cell}] = 1;
     } else {  // Opponent's piece
       view[{2, cell}] = 1;
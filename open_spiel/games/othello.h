@@ -16,18 +16,22 @@
 #define OPEN_SPIEL_GAMES_OTHELLO_H_
 
 #include <array>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
 #include <tuple>
 #include <vector>
 
-#include "open_spiel/abseil-cpp/absl/algorithm/container.h"  // for c_fill
 #include "open_spiel/spiel.h"
 
 // Simple game of Othello:
 // https://en.wikipedia.org/wiki/Reversi
 //
+// The board is kept as a 64-bit bitboard per player, with bit row * 8 + col
+// for each cell, so legal moves and flips are found a direction at a time for
+// all disks at once by shifting.
+//
 // Parameters: none
 
 namespace open_spiel {
@@ -83,11 +87,12 @@ class OthelloState : public State {
   std::vector<Action> LegalActions() const override;
 
  private:
-  std::array<CellState, kNumCells> board_;
+  std::array<uint64_t, kNumPlayers> disks_ = {};  // A bitboard per player.
   void DoApplyAction(Action move) override;
 
+  CellState BoardAt(int cell) const;
   CellState BoardAt(int row, int col) const {
-    return board_[RowColToMove(row, col)];
+    return BoardAt(RowColToMove(row, col));
   }
   std::string ToStringForPlayer(
       Player player) const;  // to string for a specific player
@@ -104,18 +109,11 @@ class OthelloState : public State {
   // Returns the number of pieces on the board for the given player.
   int DiskCount(Player player) const;
 
-  // Returns true if the specified move would result in a capture.
-  bool CanCapture(Player player, int move) const;
-
-  // Returns the number of capturable disks of the opponent in the given
-  // direction from the given starting location.
-  int CountSteps(Player player, int move, Direction dir) const;
-
-  // Updates the board to reflect a capture move.
-  void Capture(Player player, int move, Direction dir, int steps);
+  // Returns the cells where the player could move, as a bitboard.
+  uint64_t LegalMoves(Player player) const;
 
-  // Returns true if (row, col) is a valid location on the board.
-  inline bool OnBoard(int row, int col) const;
+  // Returns the opponent's disks that the move would flip, as a bitboard.
+  uint64_t Flips(Player player, int move) const;
 
   // Returns the (row, col) pair corresponding to the given move code.
   std::pair<int, int> RowColFromMove(int move) const;
@@ -12,6 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "open_spiel/spiel.h"
 #include "open_spiel/tests/basic_tests.h"
 
@@ -27,10 +32,18 @@ void BasicOthelloTests() {
   testing::RandomSimTest(*LoadGame("othello"), 100);
 }
 
+// The hashes were recorded before the board was a bitboard, so this checks the
+// legal actions, observations and results are still the same.
+void MatchesReferenceTest() {
+  SPIEL_CHECK_EQ(testing::RandomGamesHash(*LoadGame("othello"), 50),
+                 4755856078453889680ull);
+}
+
 }  // namespace
 }  // namespace othello
 }  // namespace open_spiel
 
 int main(int argc, char** argv) {
   open_spiel::othello::BasicOthelloTests();
+  open_spiel::othello::MatchesReferenceTest();
 }
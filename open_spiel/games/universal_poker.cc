@@ -25,6 +25,7 @@
 #include "open_spiel/abseil-cpp/absl/strings/str_join.h"
 #include "open_spiel/game_parameters.h"
 #include "open_spiel/games/universal_poker/logic/card_set.h"
+#include "open_spiel/games/universal_poker/logic/hand_ranks.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
 
@@ -117,6 +118,18 @@ inline uint32_t GetMaxBettingActions(const acpc_cpp::ACPCGame &acpc_game) {
   return acpc_game.IsLimitGame() ? 3 : 4;
 }
 
+// The table of the hands a player can show down with in each round: their
+// hole cards together with the board dealt so far.
+logic::HandRankTable MakeHandRankTable(const acpc_cpp::ACPCGame &acpc_game) {
+  std::vector<int> cards_per_round;
+  for (int round = 0; round < acpc_game.NumRounds(); ++round) {
+    cards_per_round.push_back(acpc_game.GetNbHoleCardsRequired() +
+                              acpc_game.GetNbBoardCardsRequired(round));
+  }
+  return logic::HandRankTable(acpc_game.NumSuitsDeck(),
+                              acpc_game.NumRanksDeck(), cards_per_round);
+}
+
 // namespace universal_poker
 UniversalPokerState::UniversalPokerState(std::shared_ptr<const Game> game,
                                          int big_blind,
@@ -213,6 +226,23 @@ std::vector<double> UniversalPokerState::Returns() const {
     return std::vector<double>(NumPlayers(), 0.0);
   }
 
+  // Two player showdowns are ranked with the game's table rather than ACPC.
+  if (NumPlayers() == 2 && IsShowdown()) {
+    const logic::HandRankTable &table =
+        static_cast<const UniversalPokerGame &>(*game_).HandRanks();
+    std::array<int, 2> ranks;
+    for (Player player = 0; player < 2; ++player) {
+      logic::CardSet cards = board_cards_;
+      cards.cs.cards |= hole_cards_[player].cs.cards;
+      ranks[player] = table.RankCards(cards);
+    }
+    double value = 0;
+    if (ranks[0] != ranks[1]) {
+      value = ranks[0] > ranks[1] ? ShowdownStake() : -ShowdownStake();
+    }
+    return {value, -value};
+  }
+
   std::vector<double> returns(NumPlayers());
   for (Player player = 0; player < NumPlayers(); ++player) {
     // Money vs money at start.
@@ -388,6 +418,26 @@ std::string UniversalPokerState::ObservationString(Player player) const {
   return result;
 }
 
+bool UniversalPokerState::IsShowdown() const {
+  return IsTerminal() &&
+         acpc_state_.NumFolded() < acpc_game_->GetNbPlayers() - 1;
+}
+
+double UniversalPokerState::ShowdownStake() const {
+  // ACPC gives back the part of the larger bet that wasn't called.
+  return std::min(acpc_state_.CurrentSpent(0), acpc_state_.CurrentSpent(1));
+}
+
+std::vector<double> UniversalPokerState::ShowdownValues(
+    const std::vector<logic::CardSet> &hands,
+    const std::vector<double> &opponent_reach) const {
+  SPIEL_CHECK_EQ(NumPlayers(), 2);
+  SPIEL_CHECK_TRUE(IsShowdown());
+  return logic::ShowdownValues(
+      static_cast<const UniversalPokerGame &>(*game_).HandRanks(),
+      board_cards_, hands, opponent_reach, ShowdownStake());
+}
+
 std::unique_ptr<State> UniversalPokerState::Clone() const {
   return std::unique_ptr<State>(new UniversalPokerState(*this));
 }
@@ -573,7 +623,8 @@ UniversalPokerState::GetHistoriesConsistentWithInfostate(int player_id) const {
 UniversalPokerGame::UniversalPokerGame(const GameParameters &params)
     : Game(kGameType, params),
       gameDesc_(parseParameters(params)),
-      acpc_game_(gameDesc_) {
+      acpc_game_(gameDesc_),
+      hand_ranks_(std::make_shared<LazyHandRanks>()) {
   max_game_length_ = MaxGameLength();
   SPIEL_CHECK_TRUE(max_game_length_.has_value());
   std::string betting_abstraction =
@@ -649,6 +700,14 @@ int UniversalPokerGame::NumDistinctActions() const {
   }
 }
 
+const logic::HandRankTable &UniversalPokerGame::HandRanks() const {
+  absl::call_once(hand_ranks_->once, [this] {
+    hand_ranks_->table = std::make_unique<const logic::HandRankTable>(
+        MakeHandRankTable(acpc_game_));
+  });
+  return *hand_ranks_->table;
+}
+
 std::shared_ptr<const Game> UniversalPokerGame::Clone() const {
   return std::shared_ptr<const Game>(new UniversalPokerGame(*this));
 }
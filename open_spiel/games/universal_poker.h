@@ -22,8 +22,10 @@
 #include <vector>
 
 #include "open_spiel/abseil-cpp/absl/algorithm/container.h"
+#include "open_spiel/abseil-cpp/absl/base/call_once.h"
 #include "open_spiel/games/universal_poker/acpc_cpp/acpc_game.h"
 #include "open_spiel/games/universal_poker/logic/card_set.h"
+#include "open_spiel/games/universal_poker/logic/hand_ranks.h"
 #include "open_spiel/policy.h"
 #include "open_spiel/spiel.h"
 
@@ -70,6 +72,16 @@ class UniversalPokerState : public State {
   std::vector<std::pair<Action, double>> ChanceOutcomes() const override;
   std::vector<Action> LegalActions() const override;
 
+  // Whether the hand ended with more than one player in it, who show down.
+  bool IsShowdown() const;
+
+  // At a two player showdown, the value for the player holding each of
+  // `hands`, with this state's board and bets, against an opponent holding
+  // each of them with weight `opponent_reach`. See logic::ShowdownValues.
+  std::vector<double> ShowdownValues(
+      const std::vector<logic::CardSet> &hands,
+      const std::vector<double> &opponent_reach) const;
+
   // Used to make UpdateIncrementalStateDistribution much faster.
   std::unique_ptr<HistoryDistribution> GetHistoriesConsistentWithInfostate(
       int player_id) const override;
@@ -113,6 +125,8 @@ class UniversalPokerState : public State {
   void _CalculateActionsAndNodeType();
 
   double GetTotalReward(Player player) const;
+  // What the winner of a two player showdown wins: the smaller of the bets.
+  double ShowdownStake() const;
 
   const uint32_t &GetPossibleActionsMask() const { return possibleActions_; }
   const int GetPossibleActionCount() const;
@@ -143,11 +157,21 @@ class UniversalPokerGame : public Game {
  private:
   std::string gameDesc_;
   const acpc_cpp::ACPCGame acpc_game_;
+  // Built the first time HandRanks is called, and shared with clones.
+  struct LazyHandRanks {
+    absl::once_flag once;
+    std::unique_ptr<const logic::HandRankTable> table;
+  };
+  std::shared_ptr<LazyHandRanks> hand_ranks_;
   std::optional<int> max_game_length_;
   BettingAbstraction betting_abstraction_ = BettingAbstraction::kFULLGAME;
 
  public:
   const acpc_cpp::ACPCGame *GetACPCGame() const { return &acpc_game_; }
+  // Ranks the hands players can hold at a showdown in any round, for two
+  // player showdowns and logic::ShowdownValues. The table is built on the
+  // first call.
+  const logic::HandRankTable &HandRanks() const;
 
   std::string parseParameters(const GameParameters &map);
   int big_blind_;
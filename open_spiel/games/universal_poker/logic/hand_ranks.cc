@@ -0,0 +1,167 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/universal_poker/logic/hand_ranks.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
+#include "open_spiel/abseil-cpp/absl/numeric/bits.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel::universal_poker::logic {
+namespace {
+
+// The next larger number with as many bits set.
+// See https://graphics.stanford.edu/~seander/bithacks.html#NextBitPermutation
+uint64_t NextCombination(uint64_t v) {
+  uint64_t t = v | (v - 1);
+  return (t + 1) | (((~t & -~t) - 1) >> (absl::countr_zero(v) + 1));
+}
+
+}  // namespace
+
+HandRankTable::HandRankTable(int num_suits, int num_ranks,
+                             const std::vector<int>& cards_per_round)
+    : num_suits_(num_suits), num_ranks_(num_ranks) {
+  SPIEL_CHECK_LE(num_suits, kMaxSuits);
+  const int deck_size = num_suits * num_ranks;
+  binomial_.assign(deck_size + 1, std::vector<uint64_t>(deck_size + 1, 0));
+  for (int n = 0; n <= deck_size; ++n) {
+    binomial_[n][0] = 1;
+    for (int k = 1; k <= n; ++k) {
+      binomial_[n][k] = binomial_[n - 1][k - 1] + binomial_[n - 1][k];
+    }
+  }
+
+  for (int num_cards : cards_per_round) {
+    if (num_cards < 1 || num_cards > deck_size || IsTabled(num_cards) ||
+        binomial_[deck_size][num_cards] > kMaxTableSize) {
+      continue;
+    }
+    if (ranks_.size() <= num_cards) ranks_.resize(num_cards + 1);
+    std::vector<int>& ranks = ranks_[num_cards];
+    ranks.reserve(binomial_[deck_size][num_cards]);
+    // Counting up through the sets of deck indices visits them in
+    // colexicographic order, so each set's rank goes at the next Index.
+    const uint64_t first = (uint64_t{1} << num_cards) - 1;
+    const uint64_t last = first << (deck_size - num_cards);
+    for (uint64_t set = first;; set = NextCombination(set)) {
+      CardSet cards;
+      for (uint64_t rest = set; rest != 0; rest &= rest - 1) {
+        int index = absl::countr_zero(rest);
+        cards.cs.bySuit[index % num_suits] |= 1 << (index / num_suits);
+      }
+      ranks.push_back(cards.RankCards());
+      if (set == last) break;
+    }
+  }
+}
+
+uint64_t HandRankTable::Index(const CardSet& cards) const {
+  // The cards as a set of indices into the deck, ordered by rank then suit.
+  uint64_t set = 0;
+  for (int suit = 0; suit < num_suits_; ++suit) {
+    for (uint32_t ranks = cards.cs.bySuit[suit]; ranks != 0;
+         ranks &= ranks - 1) {
+      set |= uint64_t{1} << (absl::countr_zero(ranks) * num_suits_ + suit);
+    }
+  }
+  SPIEL_CHECK_EQ(set >> (num_suits_ * num_ranks_), 0);
+
+  uint64_t index = 0;
+  for (int k = 1; set != 0; set &= set - 1, ++k) {
+    index += binomial_[absl::countr_zero(set)][k];
+  }
+  return index;
+}
+
+int HandRankTable::RankCards(const CardSet& cards) const {
+  int num_cards = cards.NumCards();
+  if (!IsTabled(num_cards)) return cards.RankCards();
+  return ranks_[num_cards][Index(cards)];
+}
+
+std::vector<double> ShowdownValues(const HandRankTable& table,
+                                   const CardSet& board,
+                                   const std::vector<CardSet>& hands,
+                                   const std::vector<double>& opponent_reach,
+                                   double stake) {
+  SPIEL_CHECK_EQ(hands.size(), opponent_reach.size());
+  const int num_hands = hands.size();
+  std::vector<int> ranks(num_hands);
+  std::vector<int> order;
+  order.reserve(num_hands);
+  for (int i = 0; i < num_hands; ++i) {
+    if (hands[i].cs.cards & board.cs.cards) continue;
+    CardSet cards = board;
+    cards.cs.cards |= hands[i].cs.cards;
+    ranks[i] = table.RankCards(cards);
+    order.push_back(i);
+  }
+  std::sort(order.begin(), order.end(),
+            [&ranks](int a, int b) { return ranks[a] < ranks[b]; });
+
+  // The total weight of the hands added so far that hold each set of cards,
+  // for every subset of their cards, so the empty set has the total weight.
+  absl::flat_hash_map<uint64_t, double> weight_holding;
+  auto add = [&weight_holding](uint64_t cards, double weight) {
+    for (uint64_t subset = cards;; subset = (subset - 1) & cards) {
+      weight_holding[subset] += weight;
+      if (subset == 0) break;
+    }
+  };
+  // The weight of the hands added so far that share no cards with `cards`,
+  // by inclusion-exclusion over the subsets of `cards`.
+  auto disjoint_weight = [&weight_holding](uint64_t cards) {
+    double weight = 0;
+    for (uint64_t subset = cards;; subset = (subset - 1) & cards) {
+      auto it = weight_holding.find(subset);
+      if (it != weight_holding.end()) {
+        weight += absl::popcount(subset) % 2 ? -it->second : it->second;
+      }
+      if (subset == 0) break;
+    }
+    return weight;
+  };
+
+  // Going through the hands from the weakest, hands of equal rank together.
+  std::vector<double> weaker(num_hands);
+  std::vector<double> not_stronger(num_hands);
+  for (int begin = 0, end = 0; begin < order.size(); begin = end) {
+    while (end < order.size() && ranks[order[end]] == ranks[order[begin]]) {
+      ++end;
+    }
+    for (int k = begin; k < end; ++k) {
+      weaker[order[k]] = disjoint_weight(hands[order[k]].cs.cards);
+    }
+    for (int k = begin; k < end; ++k) {
+      add(hands[order[k]].cs.cards, opponent_reach[order[k]]);
+    }
+    for (int k = begin; k < end; ++k) {
+      not_stronger[order[k]] = disjoint_weight(hands[order[k]].cs.cards);
+    }
+  }
+
+  std::vector<double> values(num_hands, 0.);
+  for (int i : order) {
+    double stronger = disjoint_weight(hands[i].cs.cards) - not_stronger[i];
+    values[i] = stake * (weaker[i] - stronger);
+  }
+  return values;
+}
+
+}  // namespace open_spiel::universal_poker::logic
@@ -0,0 +1,84 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_HAND_RANKS_H
+#define OPEN_SPIEL_HAND_RANKS_H
+
+#include <cstdint>
+#include <vector>
+
+#include "open_spiel/games/universal_poker/logic/card_set.h"
+
+namespace open_spiel {
+namespace universal_poker {
+namespace logic {
+
+// The ranks, as CardSet::RankCards evaluates them, of every set of cards a
+// player can hold in a game: their private cards together with the board, for
+// each round. It's built once for the deck, so ranking a hand is a lookup.
+// Sizes with more than kMaxTableSize sets aren't tabled and are ranked by ACPC
+// each time. That covers every size of Kuhn and Leduc style games, and of
+// hold'em with a short deck, up to 24 cards for a 7 card river. For hold'em
+// with the full deck only the 2 hole cards are tabled, and as the board is
+// dealt before any showdown, every showdown is still ranked by ACPC.
+class HandRankTable {
+ public:
+  static constexpr uint64_t kMaxTableSize = 1 << 20;
+
+  // `cards_per_round` is the number of private plus board cards a player
+  // holds in each round.
+  HandRankTable(int num_suits, int num_ranks,
+                const std::vector<int>& cards_per_round);
+
+  // The cards must be from the deck.
+  int RankCards(const CardSet& cards) const;
+
+  bool IsTabled(int num_cards) const {
+    return num_cards < ranks_.size() && !ranks_[num_cards].empty();
+  }
+
+ private:
+  // The position of the cards among all sets of as many cards from the deck,
+  // in colexicographic order of their indices in the deck.
+  uint64_t Index(const CardSet& cards) const;
+
+  int num_suits_;
+  int num_ranks_;
+  // binomial_[n][k] is n choose k.
+  std::vector<std::vector<uint64_t>> binomial_;
+  // By number of cards, then by Index. Empty for sizes that aren't tabled.
+  std::vector<std::vector<int>> ranks_;
+};
+
+// The value of a two player showdown for each of `hands`, against an opponent
+// who holds each of them with weight `opponent_reach`. That is the sum of the
+// weights of the opponent's hands that share no card with ours, times `stake`
+// for those ours beats, minus `stake` for those that beat ours. Hands that
+// share cards with the board have no weight and no value.
+//
+// Rather than comparing every pair of hands, this sorts the hands by rank and
+// keeps running sums of the weight of the weaker hands, separately also for
+// the hands holding each subset of cards so that the ones sharing a card with
+// ours can be taken out. So it takes O(n log n) for n hands.
+std::vector<double> ShowdownValues(const HandRankTable& table,
+                                   const CardSet& board,
+                                   const std::vector<CardSet>& hands,
+                                   const std::vector<double>& opponent_reach,
+                                   double stake);
+
+}  // namespace logic
+}  // namespace universal_poker
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_HAND_RANKS_H
@@ -0,0 +1,134 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/universal_poker/logic/hand_ranks.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "open_spiel/games/universal_poker/logic/card_set.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace universal_poker {
+namespace logic {
+namespace {
+
+// `num_cards` distinct random cards from the deck.
+CardSet RandomCards(int num_suits, int num_ranks, int num_cards,
+                    std::mt19937* rng) {
+  std::vector<int> deck;
+  for (int rank = 0; rank < num_ranks; ++rank) {
+    for (int suit = 0; suit < num_suits; ++suit) {
+      deck.push_back(rank * kMaxSuits + suit);
+    }
+  }
+  std::shuffle(deck.begin(), deck.end(), *rng);
+  deck.resize(num_cards);
+  return CardSet(deck);
+}
+
+void TableMatchesRankCardsTest(int num_suits, int num_ranks,
+                               const std::vector<int>& cards_per_round) {
+  HandRankTable table(num_suits, num_ranks, cards_per_round);
+  std::mt19937 rng(7);
+  for (int num_cards : cards_per_round) {
+    for (int i = 0; i < 1000; ++i) {
+      CardSet cards = RandomCards(num_suits, num_ranks, num_cards, &rng);
+      SPIEL_CHECK_EQ(table.RankCards(cards), cards.RankCards());
+    }
+  }
+}
+
+void TableSizesTest() {
+  HandRankTable small(3, 8, {2, 5, 6});
+  SPIEL_CHECK_TRUE(small.IsTabled(2));
+  SPIEL_CHECK_TRUE(small.IsTabled(5));
+  SPIEL_CHECK_TRUE(small.IsTabled(6));
+  SPIEL_CHECK_FALSE(small.IsTabled(3));
+
+  // A hold'em deck of 24 cards has few enough river hands to table.
+  HandRankTable short_deck(4, 6, {2, 5, 6, 7});
+  SPIEL_CHECK_TRUE(short_deck.IsTabled(5));
+  SPIEL_CHECK_TRUE(short_deck.IsTabled(7));
+
+  // With the full deck, every size with a board has too many hands.
+  HandRankTable holdem(4, 13, {2, 5, 6, 7});
+  SPIEL_CHECK_TRUE(holdem.IsTabled(2));
+  SPIEL_CHECK_FALSE(holdem.IsTabled(5));
+  SPIEL_CHECK_FALSE(holdem.IsTabled(6));
+  SPIEL_CHECK_FALSE(holdem.IsTabled(7));
+}
+
+// Compares every pair of hands.
+std::vector<double> PairwiseShowdownValues(
+    const HandRankTable& table, const CardSet& board,
+    const std::vector<CardSet>& hands,
+    const std::vector<double>& opponent_reach, double stake) {
+  std::vector<double> values(hands.size(), 0.);
+  for (int i = 0; i < hands.size(); ++i) {
+    if (hands[i].cs.cards & board.cs.cards) continue;
+    CardSet ours = board;
+    ours.cs.cards |= hands[i].cs.cards;
+    for (int j = 0; j < hands.size(); ++j) {
+      if (hands[j].cs.cards & (board.cs.cards | hands[i].cs.cards)) continue;
+      CardSet theirs = board;
+      theirs.cs.cards |= hands[j].cs.cards;
+      int our_rank = table.RankCards(ours);
+      int their_rank = table.RankCards(theirs);
+      if (our_rank > their_rank) values[i] += stake * opponent_reach[j];
+      if (our_rank < their_rank) values[i] -= stake * opponent_reach[j];
+    }
+  }
+  return values;
+}
+
+void ShowdownValuesTest(int num_suits, int num_ranks, int num_hole_cards,
+                        int num_board_cards) {
+  HandRankTable table(num_suits, num_ranks,
+                      {num_hole_cards + num_board_cards});
+  CardSet deck(num_suits, num_ranks);
+  std::vector<CardSet> hands = deck.SampleCards(num_hole_cards);
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<double> reach(0., 1.);
+  for (int i = 0; i < 20; ++i) {
+    CardSet board = RandomCards(num_suits, num_ranks, num_board_cards, &rng);
+    std::vector<double> opponent_reach(hands.size());
+    for (double& weight : opponent_reach) weight = reach(rng);
+    std::vector<double> values =
+        ShowdownValues(table, board, hands, opponent_reach, 2.5);
+    std::vector<double> expected =
+        PairwiseShowdownValues(table, board, hands, opponent_reach, 2.5);
+    for (int h = 0; h < hands.size(); ++h) {
+      SPIEL_CHECK_FLOAT_NEAR(values[h], expected[h], 1e-9);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace logic
+}  // namespace universal_poker
+}  // namespace open_spiel
+
+int main(int argc, char **argv) {
+  open_spiel::universal_poker::logic::TableSizesTest();
+  open_spiel::universal_poker::logic::TableMatchesRankCardsTest(3, 8,
+                                                                {2, 5, 6});
+  open_spiel::universal_poker::logic::TableMatchesRankCardsTest(4, 13,
+                                                                {2, 5, 7});
+  open_spiel::universal_poker::logic::ShowdownValuesTest(4, 13, 2, 5);
+  open_spiel::universal_poker::logic::ShowdownValuesTest(3, 8, 2, 3);
+  open_spiel::universal_poker::logic::ShowdownValuesTest(4, 6, 1, 1);
+}
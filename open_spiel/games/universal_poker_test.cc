@@ -15,12 +15,16 @@
 #include "open_spiel/games/universal_poker.h"
 
 #include <memory>
+#include <random>
+#include <string>
+#include <vector>
 
 #include "open_spiel/abseil-cpp/absl/algorithm/container.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_join.h"
 #include "open_spiel/canonical_game_strings.h"
 #include "open_spiel/algorithms/evaluate_bots.h"
 #include "open_spiel/game_parameters.h"
+#include "open_spiel/games/universal_poker/logic/card_set.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
 #include "open_spiel/tests/basic_tests.h"
@@ -413,6 +417,58 @@ void FullNLBettingTest3() {
       ":2c2d|2h2s|3c3d/3h3s4c/4d/4h"));
 }
 
+// Plays random games, and checks the returns, and the showdown values against
+// a random range, which rank hands with the game's table, against ACPC.
+void ShowdownMatchesACPCTest(const std::string &game_string) {
+  std::shared_ptr<const Game> game = LoadGame(game_string);
+  const acpc_cpp::ACPCGame *acpc_game =
+      static_cast<const UniversalPokerGame &>(*game).GetACPCGame();
+  logic::CardSet deck(acpc_game->NumSuitsDeck(), acpc_game->NumRanksDeck());
+  const std::vector<logic::CardSet> hands =
+      deck.SampleCards(acpc_game->GetNbHoleCardsRequired());
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<double> dist(0., 1.);
+
+  for (int num_showdowns = 0; num_showdowns < 10;) {
+    std::unique_ptr<State> state = game->NewInitialState();
+    while (!state->IsTerminal()) {
+      if (state->IsChanceNode()) {
+        state->ApplyAction(SampleAction(state->ChanceOutcomes(), dist(rng))
+                               .first);
+      } else {
+        std::vector<Action> actions = state->LegalActions();
+        state->ApplyAction(actions[rng() % actions.size()]);
+      }
+    }
+    const auto &poker = static_cast<const UniversalPokerState &>(*state);
+    std::vector<double> returns = poker.Returns();
+    for (Player player = 0; player < 2; ++player) {
+      SPIEL_CHECK_EQ(returns[player], poker.GetTotalReward(player));
+    }
+    if (!poker.IsShowdown()) continue;
+    ++num_showdowns;
+
+    std::vector<double> opponent_reach(hands.size());
+    for (double &weight : opponent_reach) weight = dist(rng);
+    std::vector<double> values = poker.ShowdownValues(hands, opponent_reach);
+    std::unique_ptr<State> clone = poker.Clone();
+    auto &swapped = static_cast<UniversalPokerState &>(*clone);
+    const uint64_t board = poker.board_cards_.cs.cards;
+    for (int i = 0; i < hands.size(); ++i) {
+      double expected = 0;
+      for (int j = 0; j < hands.size(); ++j) {
+        if ((hands[i].cs.cards | board) & (hands[j].cs.cards | board)) {
+          continue;
+        }
+        swapped.hole_cards_[0] = hands[i];
+        swapped.hole_cards_[1] = hands[j];
+        expected += opponent_reach[j] * swapped.GetTotalReward(0);
+      }
+      SPIEL_CHECK_FLOAT_NEAR(values[i], expected, 1e-6);
+    }
+  }
+}
+
 }  // namespace
 }  // namespace universal_poker
 }  // namespace open_spiel
@@ -430,4 +486,17 @@ int main(int argc, char **argv) {
   open_spiel::universal_poker::FullNLBettingTest1();
   open_spiel::universal_poker::FullNLBettingTest2();
   open_spiel::universal_poker::FullNLBettingTest3();
+  // Leduc-style, and small hold'em with limit and with unequal stacks.
+  open_spiel::universal_poker::ShowdownMatchesACPCTest(
+      "universal_poker(betting=limit,numPlayers=2,numRounds=2,blind=1 1,"
+      "raiseSize=2 4,firstPlayer=1 1,maxRaises=2 2,numSuits=2,numRanks=3,"
+      "numHoleCards=1,numBoardCards=0 1)");
+  open_spiel::universal_poker::ShowdownMatchesACPCTest(
+      "universal_poker(betting=limit,numPlayers=2,numRounds=4,blind=2 1,"
+      "raiseSize=2 2 4 4,firstPlayer=2 1 1 1,maxRaises=3 3 3 3,numSuits=4,"
+      "numRanks=6,numHoleCards=2,numBoardCards=0 3 1 1)");
+  open_spiel::universal_poker::ShowdownMatchesACPCTest(
+      "universal_poker(betting=nolimit,numPlayers=2,numRounds=4,blind=2 1,"
+      "firstPlayer=2 1 1 1,numSuits=4,numRanks=6,numHoleCards=2,"
+      "numBoardCards=0 3 1 1,stack=40 25)");
 }
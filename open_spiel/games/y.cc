@@ -116,14 +116,15 @@ std::string Move::ToString() const {
 YState::YState(std::shared_ptr<const Game> game, int board_size,
                bool ansi_color_output)
     : State(game),
+      groups_(board_size * board_size),
       board_size_(board_size),
       neighbors(get_neighbors(board_size)),
       ansi_color_output_(ansi_color_output) {
   board_.resize(board_size * board_size);
   for (int i = 0; i < board_.size(); i++) {
     Move m = ActionToMove(i);
-    board_[i] = Cell((m.OnBoard() ? kPlayerNone : kPlayerInvalid), i,
-                     m.Edge(board_size));
+    board_[i] = m.OnBoard() ? kPlayerNone : kPlayerInvalid;
+    groups_.Reset(i, m.Edge(board_size));
   }
 }
 
@@ -137,7 +138,7 @@ std::vector<Action> YState::LegalActions() const {
   if (IsTerminal()) return moves;
   moves.reserve(board_.size() - moves_made_);
   for (int cell = 0; cell < board_.size(); ++cell) {
-    if (board_[cell].player == kPlayerNone) {
+    if (board_[cell] == kPlayerNone) {
       moves.push_back(cell);
     }
   }
@@ -206,7 +207,7 @@ std::string YState::ToString() const {
       }
 
       // Actual piece.
-      Player p = board_[pos.xy].player;
+      Player p = board_[pos.xy];
       if (p == kPlayerNone) out << empty;
       if (p == kPlayer1) out << white;
       if (p == kPlayer2) out << black;
@@ -259,68 +260,36 @@ void YState::ObservationTensor(Player player,
   TensorView<2> view(values, {kCellStates, static_cast<int>(board_.size())},
                      true);
   for (int i = 0; i < board_.size(); ++i) {
-    if (board_[i].player != kPlayerInvalid) {
-      view[{PlayerRelative(board_[i].player, player), i}] = 1.0;
+    if (board_[i] != kPlayerInvalid) {
+      view[{PlayerRelative(board_[i], player), i}] = 1.0;
     }
   }
 }
 
 void YState::DoApplyAction(Action action) {
-  SPIEL_CHECK_EQ(board_[action].player, kPlayerNone);
+  SPIEL_CHECK_EQ(board_[action], kPlayerNone);
   SPIEL_CHECK_EQ(outcome_, kPlayerNone);
 
   Move move = ActionToMove(action);
   SPIEL_CHECK_TRUE(move.OnBoard());
 
   last_move_ = move;
-  board_[move.xy].player = current_player_;
+  board_[move.xy] = current_player_;
   moves_made_++;
 
   for (const Move& m : neighbors[move.xy]) {
-    if (m.OnBoard() && current_player_ == board_[m.xy].player) {
-      JoinGroups(move.xy, m.xy);
+    if (m.OnBoard() && current_player_ == board_[m.xy]) {
+      groups_.Join(move.xy, m.xy);
     }
   }
 
-  if (board_[FindGroupLeader(move.xy)].edge == 0x7) {  // ie all 3 edges.
+  if (groups_.GroupFeatures(move.xy) == 0x7) {  // ie all 3 edges.
     outcome_ = current_player_;
   }
 
   current_player_ = (current_player_ == kPlayer1 ? kPlayer2 : kPlayer1);
 }
 
-int YState::FindGroupLeader(int cell) {
-  int parent = board_[cell].parent;
-  if (parent != cell) {
-    do {  // Follow the parent chain up to the group leader.
-      parent = board_[parent].parent;
-    } while (parent != board_[parent].parent);
-    // Do path compression, but only the current one to avoid recursion.
-    board_[cell].parent = parent;
-  }
-  return parent;
-}
-
-bool YState::JoinGroups(int cell_a, int cell_b) {
-  int leader_a = FindGroupLeader(cell_a);
-  int leader_b = FindGroupLeader(cell_b);
-
-  if (leader_a == leader_b)  // Already the same group.
-    return true;
-
-  if (board_[leader_a].size < board_[leader_b].size) {
-    // Force group a's subtree to be bigger.
-    std::swap(leader_a, leader_b);
-  }
-
-  // Group b joins group a.
-  board_[leader_b].parent = leader_a;
-  board_[leader_a].size += board_[leader_b].size;
-  board_[leader_a].edge |= board_[leader_b].edge;
-
-  return false;
-}
-
 std::unique_ptr<State> YState::Clone() const {
   return std::unique_ptr<State>(new YState(*this));
 }
@@ -22,6 +22,7 @@
 #include <string>
 #include <vector>
 
+#include "open_spiel/games/connection/connection_groups.h"
 #include "open_spiel/spiel.h"
 
 // https://en.wikipedia.org/wiki/Y_(game)
@@ -91,30 +92,6 @@ typedef std::vector<std::array<Move, kMaxNeighbors>> NeighborList;
 
 // State of an in-play game.
 class YState : public State {
-  // Represents a single cell on the board, as well as the structures needed for
-  // groups of cells. Groups of cells are defined by a union-find structure
-  // embedded in the array of cells. Following the `parent` indices will lead to
-  // the group leader which has the up to date size and edge
-  // connectivity of that group. Size and edge are not valid for any
-  // cell that is not a group leader.
-  struct Cell {
-    // Who controls this cell.
-    YPlayer player;
-
-    // A parent index to allow finding the group leader. It is the leader of the
-    // group if it points to itself. Allows path compression to shorten the path
-    // from a direct parent to the leader.
-    uint16_t parent;
-
-    // These three are only defined for the group leader's cell.
-    uint16_t size;  // Size of this group of cells.
-    uint8_t edge;   // A bitset of which edges this group is connected to.
-
-    Cell() {}
-    Cell(YPlayer player_, int parent_, int edge_)
-        : player(player_), parent(parent_), size(1), edge(edge_) {}
-  };
-
  public:
   YState(std::shared_ptr<const Game> game, int board_size,
          bool ansi_color_output = false);
@@ -141,18 +118,14 @@ class YState : public State {
  protected:
   void DoApplyAction(Action action) override;
 
-  // Find the leader of the group. Not const due to union-find path compression.
-  int FindGroupLeader(int cell);
-
-  // Join the groups of two positions, propagating group size, and edge
-  // connections. Returns true if they were already the same group.
-  bool JoinGroups(int cell_a, int cell_b);
-
   // Turn an action id into a `Move` with an x,y.
   Move ActionToMove(Action action_id) const;
 
  private:
-  std::vector<Cell> board_;
+  // Who controls each cell.
+  std::vector<YPlayer> board_;
+  // The groups of connected cells, with the edges each is connected to.
+  connection::ConnectionGroups groups_;
   YPlayer current_player_ = kPlayer1;
   YPlayer outcome_ = kPlayerNone;
   const int board_size_;
@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdint>
+
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
 #include "open_spiel/tests/basic_tests.h"
@@ -43,8 +45,23 @@ void BasicYTests() {
                          3);
 }
 
+// Plays random games and hashes their lengths and results, to check they
+// stay the same as before the groups were kept in ConnectionGroups.
+void RandomGamesOutcomeTest() {
+  const uint64_t hash = testing::RandomGamesHash(
+      *LoadGame("y(board_size=9)"), 100, /*seed=*/7, /*hash_state=*/nullptr,
+      [](const State& state, testing::SequenceHash* hash) {
+        hash->Mix(state.History().size());
+        hash->Mix(state.Returns()[0] + 1);
+      });
+  SPIEL_CHECK_EQ(hash, 5249623787934239550ull);
+}
+
 }  // namespace
 }  // namespace y_game
 }  // namespace open_spiel
 
-int main(int argc, char** argv) { open_spiel::y_game::BasicYTests(); }
+int main(int argc, char** argv) {
+  open_spiel::y_game::BasicYTests();
+  open_spiel::y_game::RandomGamesOutcomeTest();
+}
@@ -86,6 +86,19 @@ class Policy {
   virtual ActionsAndProbs GetStatePolicy(const std::string& info_state) const {
     SpielFatalError("GetStatePolicy(const std::string&) unimplemented.");
   }
+
+  // Same as GetStatePolicy, but replaces the contents of *policy instead of
+  // returning a new list. Callers looking up many states can reuse one list,
+  // and then the policies overriding these don't allocate once it's grown
+  // large enough. By default, these copy the result of GetStatePolicy.
+  virtual void FillStatePolicy(const State& state,
+                               ActionsAndProbs* policy) const {
+    *policy = GetStatePolicy(state);
+  }
+  virtual void FillStatePolicy(const std::string& info_state,
+                               ActionsAndProbs* policy) const {
+    *policy = GetStatePolicy(info_state);
+  }
 };
 
 // A tabular policy represented internally as a map. Note that this
@@ -134,6 +147,21 @@ class TabularPolicy : public Policy {
     }
   }
 
+  void FillStatePolicy(const State& state,
+                       ActionsAndProbs* policy) const override {
+    FillStatePolicy(state.InformationStateString(), policy);
+  }
+
+  void FillStatePolicy(const std::string& info_state,
+                       ActionsAndProbs* policy) const override {
+    auto iter = policy_table_.find(info_state);
+    if (iter == policy_table_.end()) {
+      policy->clear();
+    } else {
+      policy->assign(iter->second.begin(), iter->second.end());
+    }
+  }
+
   std::unordered_map<std::string, ActionsAndProbs>& PolicyTable() {
     return policy_table_;
   }
@@ -171,6 +199,15 @@ class UniformPolicy : public Policy {
     });
     return probs;
   }
+
+  void FillStatePolicy(const State& state,
+                       ActionsAndProbs* policy) const override {
+    std::vector<Action> actions = state.LegalActions();
+    policy->clear();
+    for (Action action : actions) {
+      policy->push_back({action, 1. / static_cast<double>(actions.size())});
+    }
+  }
 };
 
 // Returns the probability for the specified action, or -1 if not found.
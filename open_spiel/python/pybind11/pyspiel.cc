@@ -12,7 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <map>
 #include <memory>
+#include <optional>
 #include <unordered_map>
 
 #include "open_spiel/algorithms/best_response.h"
@@ -21,13 +23,16 @@
 #include "open_spiel/algorithms/deterministic_policy.h"
 #include "open_spiel/algorithms/evaluate_bots.h"
 #include "open_spiel/algorithms/expected_returns.h"
+#include "open_spiel/algorithms/flat_tabular_policy.h"
 #include "open_spiel/algorithms/is_mcts.h"
 #include "open_spiel/algorithms/matrix_game_utils.h"
 #include "open_spiel/algorithms/mcts.h"
 #include "open_spiel/algorithms/tabular_exploitability.h"
 #include "open_spiel/algorithms/tensor_game_utils.h"
 #include "open_spiel/algorithms/trajectories.h"
+#include "open_spiel/algorithms/vector_env.h"
 #include "open_spiel/canonical_game_strings.h"
+#include "open_spiel/game_transforms/instrumented.h"
 #include "open_spiel/game_transforms/normal_form_extensive_game.h"
 #include "open_spiel/game_transforms/turn_based_simultaneous_game.h"
 #include "open_spiel/games/efg_game.h"
@@ -59,6 +64,8 @@ using ::open_spiel::algorithms::Evaluator;
 using ::open_spiel::algorithms::Exploitability;
 using ::open_spiel::algorithms::NashConv;
 using ::open_spiel::algorithms::TabularBestResponse;
+using ::open_spiel::algorithms::VectorEnv;
+using ::open_spiel::algorithms::VectorEnvTimeStep;
 using ::open_spiel::matrix_game::MatrixGame;
 using ::open_spiel::tensor_game::TensorGame;
 
@@ -177,6 +184,16 @@ class PyBot : public Bot {
   }
 };
 
+// The data of a numpy array a VectorEnv writes to. The arrays are taken
+// without conversion, so that they can't be silently replaced by a copy.
+template <typename T>
+absl::Span<T> MutableBuffer(py::array_t<T> array) {
+  if (!(array.flags() & py::array::c_style)) {
+    SpielFatalError("VectorEnv buffers must be C-contiguous arrays.");
+  }
+  return absl::Span<T>(array.mutable_data(), array.size());
+}
+
 // Definintion of our Python module.
 PYBIND11_MODULE(pyspiel, m) {
   m.doc() = "Open Spiel";
@@ -330,6 +347,10 @@ PYBIND11_MODULE(pyspiel, m) {
                State::InformationStateTensor)
       .def("information_state_tensor", (std::vector<double>(State::*)() const) &
                                            State::InformationStateTensor)
+      .def("information_state_index",
+           (int64_t(State::*)(int) const) & State::InformationStateIndex)
+      .def("information_state_index",
+           (int64_t(State::*)() const) & State::InformationStateIndex)
       .def("observation_string",
            (std::string(State::*)(int) const) & State::ObservationString)
       .def("observation_string",
@@ -373,6 +394,7 @@ PYBIND11_MODULE(pyspiel, m) {
       .def("information_state_tensor_layout",
            &Game::InformationStateTensorLayout)
       .def("information_state_tensor_size", &Game::InformationStateTensorSize)
+      .def("num_information_state_indices", &Game::NumInformationStateIndices)
       .def("observation_tensor_shape", &Game::ObservationTensorShape)
       .def("observation_tensor_layout", &Game::ObservationTensorLayout)
       .def("observation_tensor_size", &Game::ObservationTensorSize)
@@ -586,6 +608,20 @@ PYBIND11_MODULE(pyspiel, m) {
            py::overload_cast<>(&open_spiel::TabularPolicy::PolicyTable));
   m.def("UniformRandomPolicy", &open_spiel::GetUniformPolicy);
 
+  // An immutable tabular policy in one flat buffer, which can be saved and
+  // memory-mapped back in constant time.
+  py::class_<open_spiel::algorithms::FlatTabularPolicy, open_spiel::Policy>(
+      m, "FlatTabularPolicy")
+      .def(py::init<const open_spiel::TabularPolicy&>())
+      .def_static("load", &open_spiel::algorithms::FlatTabularPolicy::Load)
+      .def("save", &open_spiel::algorithms::FlatTabularPolicy::Save)
+      .def("to_tabular_policy",
+           &open_spiel::algorithms::FlatTabularPolicy::ToTabularPolicy)
+      .def("num_info_states",
+           &open_spiel::algorithms::FlatTabularPolicy::NumInfoStates)
+      .def("get_state_policy",
+           &open_spiel::algorithms::FlatTabularPolicy::GetStatePolicy);
+
   py::class_<open_spiel::algorithms::CFRSolver>(m, "CFRSolver")
       .def(py::init<const Game&>())
       .def("evaluate_and_update_policy",
@@ -711,7 +747,8 @@ PYBIND11_MODULE(pyspiel, m) {
         "which is exponentially larger. Use only with small games.");
 
   m.def("extensive_to_tensor_game",
-        open_spiel::ExtensiveToTensorGame,
+        open_spiel::ExtensiveToTensorGame, py::arg("game"),
+        py::arg("num_threads") = 1,
         "Converts an extensive-game to its equivalent tensor game, "
         "which is exponentially larger. Use only with small games.");
 
@@ -739,6 +776,42 @@ PYBIND11_MODULE(pyspiel, m) {
         "A general implementation of deserialization of a game and state "
         "string serialized by serialize_game_and_state.");
 
+  m.def("instrument_game", open_spiel::InstrumentGame,
+        "Returns a version of the game which counts the calls to its states' "
+        "methods, like loading instrumented(game=...).");
+
+  m.def(
+      "instrumentation_counts",
+      []() {
+        std::map<std::string,
+                 std::map<std::string, std::map<std::string, int64_t>>>
+            result;
+        for (const auto& [game, methods] : GetInstrumentationCounts()) {
+          for (int m = 0; m < kNumInstrumentedMethods; ++m) {
+            if (methods[m].calls == 0) continue;
+            result[game][InstrumentedMethodName(
+                static_cast<InstrumentedMethod>(m))] = {
+                {"calls", methods[m].calls},
+                {"cycles", methods[m].cycles},
+                {"allocations", methods[m].allocations}};
+          }
+        }
+        return result;
+      },
+      "The counts of the instrumented games, as {game: {method: {'calls': "
+      "..., 'cycles': ..., 'allocations': ...}}}.");
+
+  m.def("instrumentation_json", open_spiel::InstrumentationToJson,
+        "The counts of the instrumented games, as a JSON string.");
+
+  m.def("reset_instrumentation", open_spiel::ResetInstrumentation,
+        "Zeroes the counts of the instrumented games.");
+
+  m.def("instrumentation_tracks_allocations",
+        open_spiel::InstrumentationTracksAllocations,
+        "Whether OpenSpiel was built to count the allocations of the "
+        "instrumented games.");
+
   m.def("exploitability",
         py::overload_cast<const Game&, const Policy&>(&Exploitability),
         "Returns the sum of the utility that a best responder wins when when "
@@ -792,6 +865,27 @@ PYBIND11_MODULE(pyspiel, m) {
                           bool>(&open_spiel::algorithms::ExpectedReturns),
         "Computes the undiscounted expected returns from a depth-limited "
         "search.");
+  m.def(
+      "batched_expected_returns",
+      [](const State& state,
+         const std::vector<std::vector<const Policy*>>& profiles,
+         int depth_limit, bool use_infostate_get_policy, int num_threads,
+         int parallel_depth, bool memoize) {
+        open_spiel::algorithms::ExpectedReturnsOptions options;
+        options.depth_limit = depth_limit;
+        options.use_infostate_get_policy = use_infostate_get_policy;
+        options.num_threads = num_threads;
+        options.parallel_depth = parallel_depth;
+        options.memoize = memoize;
+        py::gil_scoped_release release;
+        return open_spiel::algorithms::BatchedExpectedReturns(state, profiles,
+                                                              options);
+      },
+      py::arg("state"), py::arg("profiles"), py::arg("depth_limit") = -1,
+      py::arg("use_infostate_get_policy") = true, py::arg("num_threads") = 1,
+      py::arg("parallel_depth") = 2, py::arg("memoize") = false,
+      "Computes the expected returns of several policy profiles in one "
+      "walk of the tree, optionally on several threads.");
 
   py::class_<open_spiel::algorithms::BatchedTrajectory>(m, "BatchedTrajectory")
       .def(py::init<int>())
@@ -829,6 +923,79 @@ PYBIND11_MODULE(pyspiel, m) {
             &open_spiel::algorithms::RecordBatchedTrajectory),
         "Records a batch of trajectories.");
 
+  // Reset and step release the GIL while the environments are stepped, so
+  // VectorEnvs can be stepped from several Python threads at once.
+  py::class_<VectorEnv>(m, "VectorEnv")
+      .def(py::init([](std::shared_ptr<const Game> game, int num_envs,
+                       int seed, std::optional<bool> use_observation,
+                       int num_threads) {
+             return use_observation.has_value()
+                        ? std::make_unique<VectorEnv>(game, num_envs, seed,
+                                                      *use_observation,
+                                                      num_threads)
+                        : std::make_unique<VectorEnv>(game, num_envs, seed,
+                                                      num_threads);
+           }),
+           py::arg("game"), py::arg("num_envs"), py::arg("seed"),
+           py::arg("use_observation") = py::none(),
+           py::arg("num_threads") = 1)
+      .def("num_envs", &VectorEnv::NumEnvs)
+      .def("num_threads", &VectorEnv::NumThreads)
+      .def("actions_per_env", &VectorEnv::ActionsPerEnv)
+      .def("uses_observation", &VectorEnv::UsesObservation)
+      .def("tensor_size", &VectorEnv::TensorSize)
+      .def("get_state",
+           [](const VectorEnv& env, int index) {
+             return env.GetState(index).Clone();
+           },
+           "Returns a copy of an environment's current state.")
+      .def(
+          "reset",
+          [](VectorEnv& env, py::array_t<double> observations,
+             py::array_t<int> legal_actions_mask,
+             py::array_t<int> current_player) {
+            VectorEnvTimeStep time_step;
+            time_step.observations = MutableBuffer(observations);
+            time_step.legal_actions_mask = MutableBuffer(legal_actions_mask);
+            time_step.current_player = MutableBuffer(current_player);
+            py::gil_scoped_release release;
+            env.Reset(time_step);
+          },
+          py::arg("observations").noconvert(),
+          py::arg("legal_actions_mask").noconvert(),
+          py::arg("current_player").noconvert(),
+          "Starts new episodes, writing their observations to float64 "
+          "[num_envs, num_players, tensor_size], legal_actions_mask to int32 "
+          "[num_envs, num_players, num_distinct_actions] and current_player "
+          "to int32 [num_envs] arrays.")
+      .def(
+          "step",
+          [](VectorEnv& env,
+             py::array_t<Action, py::array::c_style | py::array::forcecast>
+                 actions,
+             py::array_t<double> observations,
+             py::array_t<int> legal_actions_mask,
+             py::array_t<int> current_player, py::array_t<double> rewards,
+             py::array_t<bool> dones) {
+            VectorEnvTimeStep time_step;
+            time_step.observations = MutableBuffer(observations);
+            time_step.legal_actions_mask = MutableBuffer(legal_actions_mask);
+            time_step.current_player = MutableBuffer(current_player);
+            time_step.rewards = MutableBuffer(rewards);
+            time_step.dones = MutableBuffer(dones);
+            py::gil_scoped_release release;
+            env.Step(absl::MakeConstSpan(actions.data(), actions.size()),
+                     time_step);
+          },
+          py::arg("actions"), py::arg("observations").noconvert(),
+          py::arg("legal_actions_mask").noconvert(),
+          py::arg("current_player").noconvert(),
+          py::arg("rewards").noconvert(), py::arg("dones").noconvert(),
+          "Applies actions_per_env() actions per environment, restarting the "
+          "episodes that end, and writes the next observations to the arrays "
+          "as in reset, the rewards to a float64 [num_envs, num_players] and "
+          "whether the episodes ended to a bool [num_envs] array.");
+
   // Game-Specific Query API.
   m.def("negotiation_item_pool", &open_spiel::query::NegotiationItemPool);
   m.def("negotiation_agent_utils", &open_spiel::query::NegotiationAgentUtils);
@@ -54,6 +54,7 @@ class PyspielTest(absltest.TestCase):
         "goofspiel",
         "havannah",
         "hex",
+        "instrumented",
         "kuhn_poker",
         "laser_tag",
         "leduc_poker",
@@ -112,6 +113,7 @@ class PyspielTest(absltest.TestCase):
     expected = [
         # Mandatory parameters prevent various sorts of automated testing.
         # Only add games here if there is no sensible default for a parameter.
+        "instrumented",
         "misere",
         "turn_based_simultaneous_game",
         "normal_form_extensive_game",
@@ -220,6 +222,18 @@ class PyspielTest(absltest.TestCase):
     state2.apply_actions([0] * game.num_players())
     self.assertEqual(state.history(), state2.history())
 
+  def test_instrumentation(self):
+    pyspiel.reset_instrumentation()
+    game = pyspiel.load_game("instrumented(game=kuhn_poker())")
+    state = game.new_initial_state()
+    state.apply_action(state.legal_actions()[0])
+    state.clone()
+    counts = pyspiel.instrumentation_counts()["kuhn_poker()"]
+    self.assertEqual(counts["apply_action"]["calls"], 1)
+    self.assertEqual(counts["clone"]["calls"], 1)
+    self.assertNotIn("to_string", counts)
+    self.assertIn("kuhn_poker()", pyspiel.instrumentation_json())
+
   def test_record_batched_trajectories(self):
     for game_name in ["kuhn_poker", "leduc_poker", "liars_dice"]:
       game = pyspiel.load_game(game_name)
@@ -0,0 +1,136 @@
+# Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Tests for pyspiel.VectorEnv."""
+
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+
+import threading
+
+from absl.testing import absltest
+import numpy as np
+
+import pyspiel
+
+
+def _make_buffers(game, env):
+  """Returns the arrays `env` writes its time steps to."""
+  num_envs = env.num_envs()
+  num_players = game.num_players()
+  return dict(
+      observations=np.zeros((num_envs, num_players, env.tensor_size())),
+      legal_actions_mask=np.zeros(
+          (num_envs, num_players, game.num_distinct_actions()), np.int32),
+      current_player=np.zeros(num_envs, np.int32),
+      rewards=np.zeros((num_envs, num_players)),
+      dones=np.zeros(num_envs, np.bool_))
+
+
+def _reset(env, buffers):
+  env.reset(buffers["observations"], buffers["legal_actions_mask"],
+            buffers["current_player"])
+
+
+def _step(env, actions, buffers):
+  env.step(actions, buffers["observations"], buffers["legal_actions_mask"],
+           buffers["current_player"], buffers["rewards"], buffers["dones"])
+
+
+def _first_legal_actions(buffers):
+  """The first legal action of the player to play in each environment."""
+  masks = buffers["legal_actions_mask"][np.arange(len(buffers["dones"])),
+                                        buffers["current_player"]]
+  return np.argmax(masks, axis=1)
+
+
+class VectorEnvTest(absltest.TestCase):
+
+  def test_time_steps_match_states(self):
+    game = pyspiel.load_game("kuhn_poker")
+    env = pyspiel.VectorEnv(game, num_envs=4, seed=1)
+    self.assertFalse(env.uses_observation())
+    buffers = _make_buffers(game, env)
+    _reset(env, buffers)
+    for _ in range(20):
+      for i in range(env.num_envs()):
+        state = env.get_state(i)
+        self.assertEqual(buffers["current_player"][i], state.current_player())
+        for player in range(game.num_players()):
+          np.testing.assert_array_equal(
+              buffers["observations"][i, player],
+              state.information_state_tensor(player))
+          np.testing.assert_array_equal(
+              buffers["legal_actions_mask"][i, player],
+              state.legal_actions_mask(player))
+      _step(env, _first_legal_actions(buffers), buffers)
+      # Kuhn poker episodes are 2 or 3 moves long, with zero-sum returns.
+      np.testing.assert_array_equal(buffers["rewards"].sum(axis=1), 0)
+      np.testing.assert_array_equal(buffers["rewards"][~buffers["dones"]], 0)
+
+  def test_rejects_buffers_of_the_wrong_type(self):
+    game = pyspiel.load_game("tic_tac_toe")
+    env = pyspiel.VectorEnv(game, num_envs=2, seed=0)
+    buffers = _make_buffers(game, env)
+    buffers["observations"] = buffers["observations"].astype(np.float32)
+    with self.assertRaises(TypeError):
+      _reset(env, buffers)
+
+  def test_threads(self):
+    game = pyspiel.load_game("tic_tac_toe")
+    envs = [pyspiel.VectorEnv(game, num_envs=16, seed=i) for i in range(4)]
+    num_episodes = [0] * len(envs)
+
+    def run(index):
+      env = envs[index]
+      buffers = _make_buffers(game, env)
+      _reset(env, buffers)
+      for _ in range(100):
+        _step(env, _first_legal_actions(buffers), buffers)
+        num_episodes[index] += buffers["dones"].sum()
+
+    threads = [
+        threading.Thread(target=run, args=(i,)) for i in range(len(envs))
+    ]
+    for thread in threads:
+      thread.start()
+    for thread in threads:
+      thread.join()
+    # Always playing the first legal action ends tic-tac-toe after 7 moves.
+    for count in num_episodes:
+      self.assertEqual(count, 16 * (100 // 7))
+
+  def test_simultaneous_game_on_threads(self):
+    game = pyspiel.load_game("goofspiel")
+    envs = [
+        pyspiel.VectorEnv(game, num_envs=7, seed=3, num_threads=num_threads)
+        for num_threads in (1, 3)
+    ]
+    self.assertEqual(envs[1].num_threads(), 3)
+    self.assertEqual(envs[0].actions_per_env(), 2)
+    all_buffers = [_make_buffers(game, env) for env in envs]
+    for env, buffers in zip(envs, all_buffers):
+      _reset(env, buffers)
+    for _ in range(30):
+      # Each player plays their first legal card.
+      actions = np.argmax(all_buffers[0]["legal_actions_mask"], axis=2)
+      for env, buffers in zip(envs, all_buffers):
+        _step(env, actions.flatten(), buffers)
+      for key in all_buffers[0]:
+        np.testing.assert_array_equal(all_buffers[0][key], all_buffers[1][key])
+
+
+if __name__ == "__main__":
+  absltest.main()
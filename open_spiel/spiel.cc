@@ -403,7 +403,8 @@ std::unique_ptr<State> Game::DeserializeState(const std::string& str) const {
   if (str.length() == 0) {
     return state;
   }
-  std::vector<std::string> lines = absl::StrSplit(str, '\n');
+  // Serialize ends each action with a newline, so the last line is empty.
+  std::vector<std::string> lines = absl::StrSplit(str, '\n', absl::SkipEmpty());
   for (int i = 0; i < lines.size(); ++i) {
     if (state->IsSimultaneousNode()) {
       std::vector<Action> actions;
@@ -15,6 +15,7 @@
 #ifndef OPEN_SPIEL_SPIEL_H_
 #define OPEN_SPIEL_SPIEL_H_
 
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <map>
@@ -407,6 +408,23 @@ class State {
     return InformationStateTensor(CurrentPlayer());
   }
 
+  // A compact integer form of the information state, so that tabular methods
+  // can index arrays with it instead of hashing strings. Two states have the
+  // same index for a player exactly when they have the same
+  // InformationStateString. The indices are in the range
+  // [0, Game::NumInformationStateIndices()), though not every index in the
+  // range needs to be used.
+  //
+  // Implementations should start with:
+  //   SPIEL_CHECK_GE(player, 0);
+  //   SPIEL_CHECK_LT(player, num_players_);
+  virtual int64_t InformationStateIndex(Player player) const {
+    SpielFatalError("InformationStateIndex is not implemented.");
+  }
+  int64_t InformationStateIndex() const {
+    return InformationStateIndex(CurrentPlayer());
+  }
+
   // We have functions for observations which are parallel to those for
   // information states. An observation should have the following properties:
   //  - It has at most the same information content as the information state
@@ -677,6 +695,10 @@ class Game : public std::enable_shared_from_this<Game> {
                                            std::multiplies<double>());
   }
 
+  // The bound on State::InformationStateIndex, or 0 if the game's states don't
+  // provide information state indices.
+  virtual int64_t NumInformationStateIndices() const { return 0; }
+
   // Describes the structure of the observation representation in a
   // tensor-like format. This is especially useful for experiments involving
   // reinforcement learning and neural networks. Note: the actual observation is
@@ -14,6 +14,7 @@
 
 #include "open_spiel/tests/basic_tests.h"
 
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <numeric>
@@ -22,6 +23,7 @@
 #include <set>
 #include <string>
 
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
 #include "open_spiel/abseil-cpp/absl/random/uniform_int_distribution.h"
 #include "open_spiel/abseil-cpp/absl/time/clock.h"
 #include "open_spiel/game_transforms/turn_based_simultaneous_game.h"
@@ -520,6 +522,46 @@ void CheckChanceOutcomes(const Game& game) {
   CheckChanceOutcomes(*game.NewInitialState());
 }
 
+namespace {
+
+void CheckInformationStateIndices(
+    const State& state, int64_t num_indices,
+    absl::flat_hash_map<std::string, int64_t>* index_of_string,
+    absl::flat_hash_map<int64_t, std::string>* string_of_index) {
+  for (Player player = 0; player < state.NumPlayers(); ++player) {
+    const std::string info_state = state.InformationStateString(player);
+    const int64_t index = state.InformationStateIndex(player);
+    SPIEL_CHECK_GE(index, 0);
+    SPIEL_CHECK_LT(index, num_indices);
+    auto [string_it, new_string] =
+        index_of_string->emplace(info_state, index);
+    auto [index_it, new_index] = string_of_index->emplace(index, info_state);
+    if (string_it->second != index || index_it->second != info_state) {
+      SpielFatalError(absl::StrCat(
+          "Information states and their indices don't match one-to-one: ",
+          info_state, " has index ", index, " but ", string_it->first,
+          " had index ", string_it->second, " and ", index_it->first,
+          " was the index of ", index_it->second));
+    }
+  }
+  if (state.IsTerminal()) return;
+  for (Action action : state.LegalActions()) {
+    CheckInformationStateIndices(*state.Child(action), num_indices,
+                                 index_of_string, string_of_index);
+  }
+}
+
+}  // namespace
+
+void CheckInformationStateIndices(const Game& game) {
+  const int64_t num_indices = game.NumInformationStateIndices();
+  SPIEL_CHECK_GT(num_indices, 0);
+  absl::flat_hash_map<std::string, int64_t> index_of_string;
+  absl::flat_hash_map<int64_t, std::string> string_of_index;
+  CheckInformationStateIndices(*game.NewInitialState(), num_indices,
+                               &index_of_string, &string_of_index);
+}
+
 // Verifies that ResampleFromInfostate is correctly implemented.
 void ResampleInfostateTest(const Game& game, int num_sims) {
   std::mt19937 rng;
@@ -546,5 +588,40 @@ void ResampleInfostateTest(const Game& game, int num_sims) {
   }
 }
 
+uint64_t RandomGamesHash(const Game& game, int num_games, int seed,
+                         const StateHashFn& hash_state,
+                         const StateHashFn& hash_terminal) {
+  std::mt19937 rng(seed);
+  SequenceHash hash;
+  for (int i = 0; i < num_games; ++i) {
+    std::unique_ptr<State> state = game.NewInitialState();
+    while (!state->IsTerminal()) {
+      if (hash_state) hash_state(*state, &hash);
+      std::vector<Action> actions = state->LegalActions();
+      state->ApplyAction(actions[rng() % actions.size()]);
+    }
+    if (hash_terminal) hash_terminal(*state, &hash);
+  }
+  return hash.Value();
+}
+
+uint64_t RandomGamesHash(const Game& game, int num_games, int seed) {
+  return RandomGamesHash(
+      game, num_games, seed,
+      [&game](const State& state, SequenceHash* hash) {
+        for (Action action : state.LegalActions()) hash->Mix(action);
+        for (Player player = 0; player < game.NumPlayers(); ++player) {
+          for (float value : state.ObservationTensor(player)) {
+            hash->Mix(value);
+          }
+        }
+      },
+      [](const State& state, SequenceHash* hash) {
+        for (float value : state.ObservationTensor(0)) hash->Mix(value);
+        hash->Mix(state.History().size());
+        hash->Mix(state.Returns()[0] + 1);
+      });
+}
+
 }  // namespace testing
 }  // namespace open_spiel
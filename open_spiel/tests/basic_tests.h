@@ -15,6 +15,8 @@
 #ifndef OPEN_SPIEL_TESTS_BASIC_TESTS_H_
 #define OPEN_SPIEL_TESTS_BASIC_TESTS_H_
 
+#include <cstdint>
+#include <functional>
 #include <random>
 #include <string>
 
@@ -48,6 +50,12 @@ void RandomSimTestWithUndo(const Game& game, int num_sims);
 // used for smallish games.
 void CheckChanceOutcomes(const Game& game);
 
+// Checks that InformationStateIndex is within the range the game gives, and
+// matches InformationStateString one-to-one, for every player in every state.
+// Performs an exhaustive search of the game tree, so should only be used for
+// smallish games.
+void CheckInformationStateIndices(const Game& game);
+
 // Same as above but without checking the serialization functions. Every game
 // should support serialization: only use this function when developing a new
 // game, in order to test the implementation using the basic tests before having
@@ -58,6 +66,33 @@ void RandomSimTestNoSerialize(const Game& game, int num_sims);
 // Verifies that ResampleFromInfostate is correctly implemented.
 void ResampleInfostateTest(const Game& game, int num_sims);
 
+// A 64-bit FNV-1a hash of a sequence of values.
+class SequenceHash {
+ public:
+  void Mix(uint64_t value) { hash_ = (hash_ ^ value) * 1099511628211ull; }
+  uint64_t Value() const { return hash_; }
+
+ private:
+  uint64_t hash_ = 14695981039346656037ull;
+};
+
+using StateHashFn = std::function<void(const State&, SequenceHash*)>;
+
+// Plays num_games games, choosing every action and chance outcome uniformly
+// from the legal actions with an std::mt19937 seeded with seed, and returns the
+// hash of what hash_state mixes in at every state before its action is
+// applied, and hash_terminal at the end of every game. Either may be empty.
+// Recording the hash and checking it after changing a game's implementation
+// checks the change didn't alter its behaviour.
+uint64_t RandomGamesHash(const Game& game, int num_games, int seed,
+                         const StateHashFn& hash_state,
+                         const StateHashFn& hash_terminal);
+
+// As above, hashing the legal actions and every player's observation tensor at
+// every state, and player 0's observation, the length and player 0's return at
+// the end of every game.
+uint64_t RandomGamesHash(const Game& game, int num_games, int seed = 7);
+
 }  // namespace testing
 }  // namespace open_spiel
 
@@ -208,6 +208,44 @@ void PolicyTest() {
   }
 }
 
+// Checks FillStatePolicy matches GetStatePolicy at every state, reusing one
+// list throughout.
+void CheckFillStatePolicy(const Policy& policy, const Game& game,
+                          bool by_info_state) {
+  ActionsAndProbs filled = {{-1, 0.5}};
+  std::vector<std::unique_ptr<State>> to_visit;
+  to_visit.push_back(game.NewInitialState());
+  while (!to_visit.empty()) {
+    std::unique_ptr<State> state = std::move(to_visit.back());
+    to_visit.pop_back();
+    for (Action action : state->LegalActions()) {
+      to_visit.push_back(state->Child(action));
+    }
+    if (state->IsChanceNode() || state->IsTerminal()) continue;
+    if (by_info_state) {
+      policy.FillStatePolicy(state->InformationStateString(), &filled);
+      SPIEL_CHECK_TRUE(
+          filled == policy.GetStatePolicy(state->InformationStateString()));
+    } else {
+      policy.FillStatePolicy(*state, &filled);
+      SPIEL_CHECK_TRUE(filled == policy.GetStatePolicy(*state));
+    }
+  }
+}
+
+void FillStatePolicyTest() {
+  std::shared_ptr<const Game> game = LoadGame("leduc_poker");
+  const TabularPolicy tabular = GetRandomPolicy(*game);
+  CheckFillStatePolicy(tabular, *game, /*by_info_state=*/true);
+  CheckFillStatePolicy(tabular, *game, /*by_info_state=*/false);
+  CheckFillStatePolicy(UniformPolicy(), *game, /*by_info_state=*/false);
+
+  // Missing information states clear the list.
+  ActionsAndProbs filled = {{0, 1.0}};
+  tabular.FillStatePolicy("not an information state", &filled);
+  SPIEL_CHECK_TRUE(filled.empty());
+}
+
 void LeducPokerDeserializeTest() {
   // Example Leduc state: player 1 gets the 0th card, player 2 gets the 3rd card
   // and the first two actions are: check, check.
@@ -292,6 +330,7 @@ int main(int argc, char** argv) {
   open_spiel::testing::TicTacToeTests();
   open_spiel::testing::FlatJointactionTest();
   open_spiel::testing::PolicyTest();
+  open_spiel::testing::FillStatePolicyTest();
   open_spiel::testing::LeducPokerDeserializeTest();
   open_spiel::testing::GameParametersTest();
 }